@@ -46,13 +46,20 @@ extern "C" {
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <sstream>
 
 #include "DwmMclogConfig.hh"
 #include "DwmMclogLogger.hh"
 #include "DwmMclogMulticastReceiver.hh"
 #include "DwmMclogMessageFilterDriver.hh"
+#include "DwmMclogPacketSummary.hh"
+#include "DwmMclogPayloadCompressor.hh"
 #include "DwmMclogSettings.hh"
 
+//  Called for each message read from a file that passes the filter.
+using MessageHandler = std::function<void(const Dwm::Mclog::Message &)>;
+
 //----------------------------------------------------------------------------
 //!  
 //----------------------------------------------------------------------------
@@ -92,7 +99,8 @@ private:
 //!  
 //----------------------------------------------------------------------------
 void ProcessBZ2File(const char *filename,
-                    std::shared_ptr<Dwm::Mclog::MessageFilterDriver> filter)
+                    std::shared_ptr<Dwm::Mclog::MessageFilterDriver> filter,
+                    const MessageHandler & handler)
 {
   BZFILE  *bzf = BZ2_bzopen(filename, "rb");
   if (bzf) {
@@ -100,7 +108,7 @@ void ProcessBZ2File(const char *filename,
     bool                 filterResult;
     while (msg.BZRead(bzf) > 0) {
       if ((! filter) || (filter->parse(&msg, filterResult) && filterResult)) {
-        std::cout << msg;
+        handler(msg);
       }
     }
     BZ2_bzclose(bzf);
@@ -112,7 +120,8 @@ void ProcessBZ2File(const char *filename,
 //!  
 //----------------------------------------------------------------------------
 void ProcessGZFile(const char *filename,
-                   std::shared_ptr<Dwm::Mclog::MessageFilterDriver> filter)
+                   std::shared_ptr<Dwm::Mclog::MessageFilterDriver> filter,
+                   const MessageHandler & handler)
 {
   gzFile  gzf = gzopen(filename, "rb");
   if (gzf) {
@@ -120,7 +129,7 @@ void ProcessGZFile(const char *filename,
     bool                 filterResult;
     while (msg.Read(gzf) > 0) {
       if ((! filter) || (filter->parse(&msg, filterResult) && filterResult)) {
-        std::cout << msg;
+        handler(msg);
       }
     }
     gzclose(gzf);
@@ -132,13 +141,14 @@ void ProcessGZFile(const char *filename,
 //!  
 //----------------------------------------------------------------------------
 void ProcessIstream(std::istream & is,
-                    std::shared_ptr<Dwm::Mclog::MessageFilterDriver> filter)
+                    std::shared_ptr<Dwm::Mclog::MessageFilterDriver> filter,
+                    const MessageHandler & handler)
 {
   Dwm::Mclog::Message  msg;
   bool                 filterResult;
   while (msg.Read(is)) {
     if ((! filter) || (filter->parse(&msg, filterResult) && filterResult)) {
-      std::cout << msg;
+      handler(msg);
     }
   }
   return;
@@ -148,11 +158,12 @@ void ProcessIstream(std::istream & is,
 //!  
 //----------------------------------------------------------------------------
 void ProcessBinaryFile(const char *filename,
-                       std::shared_ptr<Dwm::Mclog::MessageFilterDriver> filter)
+                       std::shared_ptr<Dwm::Mclog::MessageFilterDriver> filter,
+                       const MessageHandler & handler)
 {
   std::ifstream  is(filename);
   if (is) {
-    ProcessIstream(is, filter);
+    ProcessIstream(is, filter, handler);
     is.close();
   }
   return;
@@ -162,33 +173,95 @@ void ProcessBinaryFile(const char *filename,
 //!  
 //----------------------------------------------------------------------------
 void ProcessFile(const std::filesystem::path & path,
-                 std::shared_ptr<Dwm::Mclog::MessageFilterDriver> filter)
+                 std::shared_ptr<Dwm::Mclog::MessageFilterDriver> filter,
+                 const MessageHandler & handler)
 {
   if (path.string() == "-") {
-    ProcessIstream(std::cin, filter);
+    ProcessIstream(std::cin, filter, handler);
   }
   else {
     auto  ext = path.extension();
     if (ext.string() == ".bz2") {
-      ProcessBZ2File(path.string().c_str(), filter);
+      ProcessBZ2File(path.string().c_str(), filter, handler);
     }
     else if (ext.string() == ".gz") {
-      ProcessGZFile(path.string().c_str(), filter);
+      ProcessGZFile(path.string().c_str(), filter, handler);
     }
     else {
-      ProcessBinaryFile(path.string().c_str(), filter);
+      ProcessBinaryFile(path.string().c_str(), filter, handler);
     }
   }
   return;
 }
 
+//----------------------------------------------------------------------------
+//!  Trains a payload compression dictionary on the messages in the given
+//!  files that pass @c filter, and saves it to @c dictFile.  Returns true
+//!  on success, false on failure.
+//----------------------------------------------------------------------------
+static bool
+TrainDictionary(const std::string & dictFile, int argc, char *argv[],
+                std::shared_ptr<Dwm::Mclog::MessageFilterDriver> filter)
+{
+  using Dwm::Mclog::PayloadCompressor;
+  
+  //  Plenty of samples, without holding every message in memory.
+  static constexpr size_t  k_maxSampleBytes = 64 * 1024 * 1024;
+  std::vector<std::string>  samples;
+  size_t                    sampleBytes = 0;
+  auto  collect = [&] (const Dwm::Mclog::Message & msg)
+  {
+    if (sampleBytes < k_maxSampleBytes) {
+      std::ostringstream  os;
+      if (msg.Write(os)) {
+        samples.push_back(os.str());
+        sampleBytes += samples.back().size();
+      }
+    }
+  };
+  for (int i = 0; i < argc; ++i) {
+    ProcessFile(argv[i], filter, collect);
+  }
+  
+  std::string  dict;
+  size_t       maxLen = PayloadCompressor::k_maxDictionaryLen;
+  if (! PayloadCompressor::TrainDictionary(samples, maxLen, dict)) {
+    std::cerr << "Failed to train dictionary from " << samples.size()
+              << " messages\n";
+    return false;
+  }
+  std::ofstream  os(dictFile, std::ios::binary | std::ios::trunc);
+  if (! os.write(dict.data(), dict.size())) {
+    std::cerr << "Failed to write " << dictFile << '\n';
+    return false;
+  }
+  std::cerr << "Trained " << dict.size() << " byte dictionary from "
+            << samples.size() << " messages\n";
+  return true;
+}
+
+//----------------------------------------------------------------------------
+//!  Prints the reception counts of each multicast source to std::cerr.
+//----------------------------------------------------------------------------
+static void PrintSourceStats(Dwm::Mclog::MulticastReceiver & mcastRecv)
+{
+  for (const auto & [endpoint, stats] : mcastRecv.HarvestSourceStats()) {
+    std::cerr << endpoint << ": " << stats.Summary() << '\n';
+  }
+  std::cerr << std::flush;
+  return;
+}
+
 //----------------------------------------------------------------------------
 //!  
 //----------------------------------------------------------------------------
 static void Usage(const char *argv0)
 {
   std::cerr << "usage: " << argv0
-            << " [-c configFile] [-d] [-F filterExpression] [files...]\n";
+            << " [-c configFile] [-d] [-F filterExpression] [-s seconds]"
+            << " [files...]\n"
+            << "       " << argv0
+            << " -T dictFile [-F filterExpression] files...\n";
   return;
 }
 
@@ -200,8 +273,10 @@ int main(int argc, char *argv[])
   bool         debug = false;
   std::string  configFile{MCLOGD_DEFAULT_CONFIG_PATH};
   std::string  filtexpr;
+  std::string  dictFile;
+  unsigned int statsInterval = 0;
   int          optChar;
-  while ((optChar = getopt(argc, argv, "c:dF:")) != -1) {
+  while ((optChar = getopt(argc, argv, "c:dF:s:T:")) != -1) {
     switch (optChar) {
       case 'c':
         configFile = optarg;
@@ -212,6 +287,12 @@ int main(int argc, char *argv[])
       case 'F':
         filtexpr = optarg;
         break;
+      case 's':
+        statsInterval = strtoul(optarg, nullptr, 10);
+        break;
+      case 'T':
+        dictFile = optarg;
+        break;
       default:
         Usage(argv[0]);
         exit(1);
@@ -224,11 +305,22 @@ int main(int argc, char *argv[])
     filter = make_shared<Dwm::Mclog::MessageFilterDriver>(filtexpr);
   }
 
+  if (! dictFile.empty()) {
+    if (optind >= argc) {
+      Usage(argv[0]);
+      exit(1);
+    }
+    exit(TrainDictionary(dictFile, argc - optind, argv + optind, filter)
+         ? 0 : 1);
+  }
+  
   if (optind < argc) {
     //  We've been given filenames on command line.  Process them and
     //  then exit.
+    auto  print = [] (const Dwm::Mclog::Message & msg)
+    { std::cout << msg; };
     for (int i = optind; i < argc; ++i) {
-      ProcessFile(argv[i], filter);
+      ProcessFile(argv[i], filter, print);
     }
     exit(0);
   }
@@ -243,6 +335,10 @@ int main(int argc, char *argv[])
   Dwm::Mclog::Config  config;
   if (config.Parse(configFile)) {
     config.service.keyDirectory = keyDir;
+    if (filter) {
+      //  Don't decrypt packets that can't pass our filter.
+      mcastRecv.SummaryFilter(Dwm::Mclog::PacketSummaryFilter(*filter));
+    }
     if (mcastRecv.Open(config)) {
       MySink  mysink;
       if (! filtexpr.empty()) {
@@ -250,7 +346,13 @@ int main(int argc, char *argv[])
       }
       mcastRecv.AddSink(&mysink);
       for (;;) {
-        sleep(60);
+        if (statsInterval) {
+          sleep(statsInterval);
+          PrintSourceStats(mcastRecv);
+        }
+        else {
+          sleep(60);
+        }
       }
     }
   }
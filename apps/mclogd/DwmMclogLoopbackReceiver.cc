@@ -43,10 +43,13 @@ extern "C" {
 }
 
 #include <cstring>
+#include <vector>
 
 #include "DwmFormatters.hh"
 #include "DwmIpv4Address.hh"
+#include "DwmMclogFragmentReassembler.hh"
 #include "DwmMclogLogger.hh"
+#include "DwmMclogMessagePacket.hh"
 #include "DwmMclogLoopbackReceiver.hh"
 
 namespace Dwm {
@@ -56,7 +59,7 @@ namespace Dwm {
     //------------------------------------------------------------------------
     LoopbackReceiver::LoopbackReceiver()
         : _config(), _ifd(-1), _ifd6(-1), _run(false), _thread(),
-          _sinksMutex(), _sinks()
+          _sinksMutex(), _sinks(), _quotas(nullptr)
     {}
     
     //------------------------------------------------------------------------
@@ -237,6 +240,18 @@ namespace Dwm {
     
     //------------------------------------------------------------------------
     //!  
+    //------------------------------------------------------------------------
+    void LoopbackReceiver::Deliver(const Message & msg)
+    {
+      if (_quotas && (! _quotas->Admit(msg))) {
+        return;
+      }
+      for (auto sink : _sinks) {
+        sink->Process(msg);
+      }
+      return;
+    }
+    
     //------------------------------------------------------------------------
     void LoopbackReceiver::Run()
     {
@@ -266,31 +281,31 @@ namespace Dwm {
           FD_SET(_stopfds[0], &fds);
           maxfd = std::max({_stopfds[0], maxfd}) + 1;
         };
-        char     buf[1500];
-        Message  msg;
+        //  Big enough for the largest packet a LoopbackSender will send.
+        std::vector<char>    buf(MessagePacket::k_maxPacketLen);
+        Message              msg;
+        FragmentReassembler  reassembler;
         while (_run) {
           reset_fds();
           int selectrc = select(maxfd, &fds, nullptr, nullptr, nullptr);
           if (selectrc > 0) {
             if ((0 <= _ifd) && FD_ISSET(_ifd, &fds)) {
-              MessagePacket  pkt(buf, sizeof(buf));
+              MessagePacket  pkt(buf.data(), buf.size());
               socklen_t      fromAddrLen = sizeof(fromAddr);
               if (pkt.RecvFrom(_ifd, &fromAddr) > 0) {
-                while (msg.Read(pkt.Payload())) {
-                  for (auto sink : _sinks) {
-                    sink->Process(msg);
-                  }
+                std::string  src = UdpEndpoint(fromAddr);
+                while (reassembler.NextMessage(pkt.Payload(), src, msg)) {
+                  Deliver(msg);
                 }
               }
             }
             else if ((0 <= _ifd6) && FD_ISSET(_ifd6, &fds)) {
-              MessagePacket  pkt(buf, sizeof(buf));
+              MessagePacket  pkt(buf.data(), buf.size());
               socklen_t      fromAddrLen = sizeof(fromAddr6);
               if (pkt.RecvFrom(_ifd6, &fromAddr6) > 0) {
-                while (msg.Read(pkt.Payload())) {
-                  for (auto sink : _sinks) {
-                    sink->Process(msg);
-                  }
+                std::string  src = UdpEndpoint(fromAddr6);
+                while (reassembler.NextMessage(pkt.Payload(), src, msg)) {
+                  Deliver(msg);
                 }
               }
             }
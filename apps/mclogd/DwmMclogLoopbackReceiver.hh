@@ -45,6 +45,7 @@
 
 #include "DwmThreadQueue.hh"
 #include "DwmMclogConfig.hh"
+#include "DwmMclogIngestQuotas.hh"
 #include "DwmMclogMessageSink.hh"
 
 namespace Dwm {
@@ -62,6 +63,13 @@ namespace Dwm {
       bool Restart(const Config & config);
       void Stop();
       bool AddSink(MessageSink *msgQueue);
+
+      //----------------------------------------------------------------------
+      //!  Sets the ingest @c quotas received messages must be within to
+      //!  be delivered to our sinks.  Call before Start().
+      //----------------------------------------------------------------------
+      void Quotas(IngestQuotas *quotas)
+      { _quotas = quotas; }
       
     private:
       Config                      _config;
@@ -72,11 +80,13 @@ namespace Dwm {
       std::thread                 _thread;
       std::mutex                  _sinksMutex;
       std::vector<MessageSink *>  _sinks;
+      IngestQuotas               *_quotas;
 
       bool OpenIpv4Socket();
       bool OpenIpv6Socket();
       void SetRcvBuf(int fd);
       bool DesiredSocketsOpen() const;
+      void Deliver(const Message & msg);
       void Run();
     };
     
@@ -42,10 +42,14 @@ extern "C" {
   #include <unistd.h>
 }
 
+#include <algorithm>
 #include <cstdlib>
+#include <string>
+#include <vector>
 
 #include "DwmDaemonUtils.hh"
 #include "DwmSignal.hh"
+#include "DwmMclogIngestQuotas.hh"
 #include "DwmMclogLogger.hh"
 #include "DwmMclogLoopbackReceiver.hh"
 #include "DwmMclogMulticastSender.hh"
@@ -58,6 +62,7 @@ static Dwm::Mclog::LoopbackReceiver   g_loopbackReceiver;
 static Dwm::Mclog::MulticastSender    g_mcastSender;
 static Dwm::Mclog::MulticastReceiver  g_mcastReceiver;
 static Dwm::Mclog::FileLogger         g_fileLogger;
+static Dwm::Mclog::IngestQuotas       g_quotas;
 
 //----------------------------------------------------------------------------
 //!  
@@ -68,7 +73,8 @@ static bool Restart(const std::string & configPath)
   g_loopbackReceiver.Stop();
   
   if (g_config.Parse(configPath)) {
-    if (g_fileLogger.Restart(g_config.files)) {
+    g_quotas.Configure(g_config.quotas);
+    if (g_fileLogger.Restart(g_config.files, g_config.queues.files)) {
       if (g_mcastSender.Restart(g_config)) {
         if (g_mcastReceiver.Restart(g_config)) {
           rc = g_loopbackReceiver.Restart(g_config);
@@ -79,6 +85,158 @@ static bool Restart(const std::string & configPath)
   return rc;
 }
 
+//----------------------------------------------------------------------------
+//!  Logs the reception counts of all multicast sources, and of the few
+//!  sources with the most lost, duplicated or late packets.
+//----------------------------------------------------------------------------
+static void ReportSourceStats()
+{
+  using Dwm::Mclog::Severity, Dwm::Mclog::SourceStats;
+  
+  auto  sources = g_mcastReceiver.HarvestSourceStats();
+  if (sources.empty()) {
+    return;
+  }
+  SourceStats  total;
+  for (const auto & src : sources) {
+    total += src.second;
+  }
+  MCLOG((total.Impaired() ? Severity::warning : Severity::info),
+        "Multicast from {} sources: {}", sources.size(), total.Summary());
+  if (total.Impaired()) {
+    auto  impairment = [] (const auto & src)
+    { return (src.second.lost + src.second.duplicated + src.second.late); };
+    size_t  numWorst = std::min(sources.size(), (size_t)5);
+    std::partial_sort(sources.begin(), sources.begin() + numWorst,
+                      sources.end(),
+                      [&] (const auto & a, const auto & b)
+                      { return (impairment(a) > impairment(b)); });
+    for (size_t i = 0; i < numWorst; ++i) {
+      if (sources[i].second.Impaired()) {
+        MCLOG(Severity::warning, "Multicast from {}: {}",
+              sources[i].first, sources[i].second.Summary());
+      }
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Logs the few origins with the most messages suppressed by ingest
+//!  quotas (and a total for the rest), and the few origins that sent
+//!  us the most messages.
+//----------------------------------------------------------------------------
+static void ReportTalkers()
+{
+  using Dwm::Mclog::Severity;
+  
+  auto  talkers = g_quotas.Harvest();
+  if (talkers.empty()) {
+    return;
+  }
+  std::vector<const Dwm::Mclog::IngestQuotas::Talker *>  suppressed;
+  for (const auto & talker : talkers) {
+    if (talker.suppressed) {
+      suppressed.push_back(&talker);
+    }
+  }
+  size_t  numWorst = std::min(suppressed.size(), (size_t)5);
+  std::partial_sort(suppressed.begin(), suppressed.begin() + numWorst,
+                    suppressed.end(),
+                    [] (const auto *a, const auto *b)
+                    { return (a->suppressed > b->suppressed); });
+  for (size_t i = 0; i < numWorst; ++i) {
+    MCLOG(Severity::warning, "Suppressed {} messages from {}",
+          suppressed[i]->suppressed, suppressed[i]->origin);
+  }
+  if (suppressed.size() > numWorst) {
+    uint64_t  others = 0;
+    for (size_t i = numWorst; i < suppressed.size(); ++i) {
+      others += suppressed[i]->suppressed;
+    }
+    MCLOG(Severity::warning, "Suppressed {} messages from {} other origins",
+          others, suppressed.size() - numWorst);
+  }
+  std::string  top;
+  size_t       numTop = std::min(talkers.size(), (size_t)5);
+  for (size_t i = 0; i < numTop; ++i) {
+    if (! top.empty()) {
+      top += ", ";
+    }
+    top += talkers[i].origin + ' ' + std::to_string(talkers[i].Total());
+  }
+  MCLOG(Severity::info, "Top talkers: {}", top);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Logs what our internal queues dropped or sampled out, what the key
+//!  request listener turned away, which rolled log files we compressed,
+//!  what we resent to multicast receivers, what we received from
+//!  multicast sources and what ingest quotas suppressed since the last
+//!  report.
+//----------------------------------------------------------------------------
+static void ReportDrops()
+{
+  using Dwm::Mclog::DropCounts, Dwm::Mclog::Severity;
+  
+  auto  report = [] (const char *queueName, const DropCounts & drops)
+  {
+    if (drops.Total()) {
+      MCLOG(Severity::warning, "{} queue dropped {}", queueName,
+            drops.Summary());
+    }
+  };
+  report("FileLogger", g_fileLogger.HarvestDrops());
+  report("MulticastSender", g_mcastSender.HarvestDrops());
+  report("MulticastSource backlog", g_mcastReceiver.HarvestDrops());
+  report("MulticastReceiver worker", g_mcastReceiver.HarvestWorkerDrops());
+
+  auto  reportSampled = [] (const char *queueName, const DropCounts & drops)
+  {
+    if (drops.Total()) {
+      MCLOG(Severity::notice, "{} queue sampled out {}", queueName,
+            drops.Summary());
+    }
+  };
+  reportSampled("FileLogger", g_fileLogger.HarvestSampled());
+  reportSampled("MulticastSender", g_mcastSender.HarvestSampled());
+
+  auto  keyRequests = g_mcastSender.HarvestKeyRequestCounts();
+  if (keyRequests.Rejected() || keyRequests.badCookies) {
+    MCLOG(Severity::warning, "Key requests: {}", keyRequests.Summary());
+  }
+  else if (keyRequests.cookiesSent || keyRequests.admitted) {
+    MCLOG(Severity::info, "Key requests: {}", keyRequests.Summary());
+  }
+
+  auto  compressions = g_fileLogger.HarvestCompressions();
+  if (! compressions.Empty()) {
+    MCLOG((compressions.failed ? Severity::warning : Severity::info),
+          "Rolled log compression: {}", compressions.Summary());
+  }
+
+  auto  retransmits = g_mcastSender.HarvestRetransmitCounts();
+  if (! retransmits.Empty()) {
+    MCLOG(((retransmits.missed || retransmits.rateLimited)
+           ? Severity::warning : Severity::info),
+          "Multicast retransmits: {}", retransmits.Summary());
+  }
+
+  ReportSourceStats();
+  ReportTalkers();
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Schedules the next SIGALRM for ReportDrops().
+//----------------------------------------------------------------------------
+static void ScheduleDropReport()
+{
+  alarm(g_config.queues.reportInterval);
+  return;
+}
+
 //----------------------------------------------------------------------------
 //!  
 //----------------------------------------------------------------------------
@@ -89,6 +247,7 @@ static void BlockSigHupAndTerm()
   sigaddset(&blockSet, SIGHUP);
   sigaddset(&blockSet, SIGTERM);
   sigaddset(&blockSet, SIGINT);
+  sigaddset(&blockSet, SIGALRM);
   sigprocmask(SIG_BLOCK,&blockSet,NULL);
   return;
 }
@@ -103,10 +262,13 @@ static int WaitSigHupOrTerm()
   sigaddset(&sigSet, SIGHUP);
   sigaddset(&sigSet, SIGTERM);
   sigaddset(&sigSet, SIGINT);
+  sigaddset(&sigSet, SIGALRM);
   int  signum;
   sigwait(&sigSet, &signum);
-  Dwm::Signal  sig(signum);
-  MCLOG(Dwm::Mclog::Severity::info, "Received {}", sig.Name());
+  if (SIGALRM != signum) {
+    Dwm::Signal  sig(signum);
+    MCLOG(Dwm::Mclog::Severity::info, "Received {}", sig.Name());
+  }
   
   return signum;
 }
@@ -208,23 +370,36 @@ int main(int argc, char *argv[])
   }
   
   if (g_config.Parse(configPath)) {
+    //  Block the signals we sigwait() for before starting any threads, so
+    //  they inherit the mask and the signals are only delivered here.
+    BlockSigHupAndTerm();
     SavePID(pidFile);
     atexit(RemovePID);
+    g_quotas.Configure(g_config.quotas);
     g_mcastSender.Open(g_config);
-    g_fileLogger.Start(g_config.files);
+    g_fileLogger.Start(g_config.files, g_config.queues.files);
     g_loopbackReceiver.AddSink(&g_mcastSender);
     g_loopbackReceiver.AddSink(&g_fileLogger);
+    g_loopbackReceiver.Quotas(&g_quotas);
     g_loopbackReceiver.Start(g_config);
     g_mcastReceiver.AddSink(&g_fileLogger);
+    g_mcastReceiver.Quotas(&g_quotas);
     g_mcastReceiver.Open(g_config, false);
+    ScheduleDropReport();
     for (;;) {
       BlockSigHupAndTerm();
       int  sig = WaitSigHupOrTerm();
-      if (SIGHUP == sig) {
+      if (SIGALRM == sig) {
+        ReportDrops();
+        ScheduleDropReport();
+      }
+      else if (SIGHUP == sig) {
         Restart(configPath);
+        ScheduleDropReport();
       }
       else if ((SIGTERM == sig) || (SIGINT == sig)) {
         MCLOG(Dwm::Mclog::Severity::info, "Received exit signal");
+        ReportDrops();
         g_loopbackReceiver.Stop();
         g_mcastSender.Close();
         g_fileLogger.Stop();
@@ -0,0 +1,173 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogAdaptiveSampler.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::AdaptiveSampler class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGADAPTIVESAMPLER_HH_
+#define _DWMMCLOGADAPTIVESAMPLER_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "DwmMclogDropCounters.hh"
+#include "DwmMclogMessage.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Samples @c info and @c debug messages in front of a queue that is
+    //!  filling faster than it drains, so that a flood thins out evenly
+    //!  instead of the queue dropping whatever happens to arrive while
+    //!  it's full.  Messages of severity @c notice and above are never
+    //!  sampled.
+    //!
+    //!  The queue's length is checked as messages arrive, and compared
+    //!  with what we let in to measure how fast the queue drains.  Every
+    //!  k_interval, if the queue is past the threshold and growing (or
+    //!  would fill within the next interval), the sampling rate rises to
+    //!  what the drain rate can keep up with, at least doubling, up to 1
+    //!  in k_maxRate.  When the queue is well under the threshold, or
+    //!  under it and shrinking, the rate halves.
+    //!
+    //!  Whether a message is kept depends only on its origin host, ident
+    //!  and text, so every collector sampling the same flood keeps the
+    //!  same messages.  Since rates are powers of 2, the messages kept at
+    //!  a higher rate are a subset of those kept at a lower rate.  Kept
+    //!  messages carry the rate in a " [sampled 1/N]" suffix.  Threadsafe.
+    //------------------------------------------------------------------------
+    class AdaptiveSampler
+    {
+    public:
+      using Clock = std::chrono::steady_clock;
+      
+      //! Highest sampling rate (1 in k_maxRate kept).
+      static constexpr uint32_t  k_maxRate = 64;
+      //! How often we reconsider the sampling rate.
+      static constexpr std::chrono::milliseconds  k_interval{100};
+      
+      //----------------------------------------------------------------------
+      //!  Default constructor.  Disabled.
+      //----------------------------------------------------------------------
+      AdaptiveSampler();
+
+      //----------------------------------------------------------------------
+      //!  Samples in front of a queue of the given @c capacity once it
+      //!  is @c threshold percent full.  A @c threshold of 0 disables
+      //!  sampling.  Resets the sampling rate.
+      //----------------------------------------------------------------------
+      void Configure(uint32_t threshold, size_t capacity);
+
+      //----------------------------------------------------------------------
+      //!  Returns true if sampling is enabled.
+      //----------------------------------------------------------------------
+      bool Enabled() const;
+      
+      //----------------------------------------------------------------------
+      //!  Decides the fate of @c msg, arriving at a queue holding
+      //!  @c queueLength entries.  Returns false if @c msg should be
+      //!  dropped (the drop is counted), else true with @c rate set to the
+      //!  current sampling rate, N in 1 in N.  If @c rate is greater than
+      //!  1, the caller should queue Annotate(msg, rate) rather than
+      //!  @c msg.
+      //----------------------------------------------------------------------
+      bool Admit(const Message & msg, size_t queueLength, uint32_t & rate,
+                 Clock::time_point now = Clock::now());
+
+      //----------------------------------------------------------------------
+      //!  Returns the current sampling rate.
+      //----------------------------------------------------------------------
+      uint32_t Rate() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns the messages sampled out since the last call.
+      //----------------------------------------------------------------------
+      DropCounts HarvestSampled()
+      { return _sampled.Harvest(); }
+      
+      //----------------------------------------------------------------------
+      //!  Returns true if messages of the given @c severity may be
+      //!  sampled.
+      //----------------------------------------------------------------------
+      static bool Sampleable(Severity severity)
+      { return (severity >= Severity::info); }
+
+      //----------------------------------------------------------------------
+      //!  Returns true if @c msg is kept at a sampling rate of 1 in
+      //!  @c rate.  @c rate must be a power of 2.
+      //----------------------------------------------------------------------
+      static bool Selected(const Message & msg, uint32_t rate);
+      
+      //----------------------------------------------------------------------
+      //!  Returns a copy of @c msg marked as sampled at 1 in @c rate.  If
+      //!  @c msg was already sampled (by another collector), the mark
+      //!  shows the higher of the two rates.  The text is shortened if
+      //!  need be so the text and mark fit in Message::k_maxTextLen.
+      //----------------------------------------------------------------------
+      static Message Annotate(const Message & msg, uint32_t rate);
+
+      //----------------------------------------------------------------------
+      //!  Returns the sampling rate @c msg is marked with, or 1 if it's
+      //!  not marked.  If @c textLen is not nullptr, it is set to the
+      //!  length of the message text without the mark.
+      //----------------------------------------------------------------------
+      static uint32_t MarkedRate(const Message & msg,
+                                 size_t *textLen = nullptr);
+      
+    private:
+      mutable std::mutex  _mtx;
+      uint32_t            _threshold;
+      size_t              _capacity;
+      uint32_t            _rate;
+      Clock::time_point   _windowStart;
+      size_t              _windowStartLength;
+      uint64_t            _offered;  // sampleable arrivals this window
+      uint64_t            _urgent;   // other arrivals this window
+      uint64_t            _kept;     // arrivals kept this window
+      DropCounters        _sampled;
+
+      void Adjust(size_t queueLength, Clock::time_point now);
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGADAPTIVESAMPLER_HH_
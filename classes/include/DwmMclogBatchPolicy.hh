@@ -0,0 +1,144 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogBatchPolicy.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::BatchPolicy class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGBATCHPOLICY_HH_
+#define _DWMMCLOGBATCHPOLICY_HH_
+
+#include <algorithm>
+#include <chrono>
+
+#include "DwmMclogSeverity.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Encapsulates the policy used by our senders to decide when to send
+    //!  a partially filled MessagePacket.  A packet is sent when it is full,
+    //!  when the first message in it has waited MaxDelay(), or as soon as
+    //!  it contains a message at or above FlushSeverity().  Messages at
+    //!  @c err or above always bypass the batching delay, regardless of
+    //!  FlushSeverity().
+    //------------------------------------------------------------------------
+    class BatchPolicy
+    {
+    public:
+      using Usecs = std::chrono::microseconds;
+
+      static constexpr Usecs  k_minDelay     = Usecs(200);
+      static constexpr Usecs  k_maxDelay     = Usecs(50000);
+      static constexpr Usecs  k_defaultDelay = Usecs(5000);
+
+      //----------------------------------------------------------------------
+      //!  Default constructor.  Uses k_defaultDelay and flushes immediately
+      //!  for messages with severity @c err or higher.
+      //----------------------------------------------------------------------
+      BatchPolicy()
+          : _maxDelay(k_defaultDelay), _flushSeverity(Severity::err)
+      {}
+
+      //----------------------------------------------------------------------
+      //!  Construct from the given @c maxDelay and @c flushSeverity.
+      //----------------------------------------------------------------------
+      BatchPolicy(Usecs maxDelay, Severity flushSeverity)
+          : _maxDelay(Clamp(maxDelay)), _flushSeverity(flushSeverity)
+      {}
+
+      BatchPolicy(const BatchPolicy &) = default;
+      BatchPolicy & operator = (const BatchPolicy &) = default;
+
+      //----------------------------------------------------------------------
+      //!  Returns the maximum amount of time a message may be held in a
+      //!  partially filled packet.
+      //----------------------------------------------------------------------
+      Usecs MaxDelay() const
+      { return _maxDelay; }
+
+      //----------------------------------------------------------------------
+      //!  Sets and returns the maximum amount of time a message may be held
+      //!  in a partially filled packet.  The value is clamped to the range
+      //!  [k_minDelay, k_maxDelay].
+      //----------------------------------------------------------------------
+      Usecs MaxDelay(Usecs maxDelay)
+      { return _maxDelay = Clamp(maxDelay); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the severity at or above which a packet is sent without
+      //!  waiting for more messages.
+      //----------------------------------------------------------------------
+      Severity FlushSeverity() const
+      { return _flushSeverity; }
+
+      //----------------------------------------------------------------------
+      //!  Sets and returns the severity at or above which a packet is sent
+      //!  without waiting for more messages.
+      //----------------------------------------------------------------------
+      Severity FlushSeverity(Severity flushSeverity)
+      { return _flushSeverity = flushSeverity; }
+
+      //----------------------------------------------------------------------
+      //!  Returns true if a message with the given @c severity should cause
+      //!  an immediate send.  Note that lower Severity values are more
+      //!  severe.  Always true for @c err and above.
+      //----------------------------------------------------------------------
+      bool FlushNow(Severity severity) const
+      {
+        return ((severity <= Severity::err)
+                || (severity <= _flushSeverity));
+      }
+
+      //----------------------------------------------------------------------
+      //!  Clamps @c maxDelay to the range [k_minDelay, k_maxDelay].
+      //----------------------------------------------------------------------
+      static Usecs Clamp(Usecs maxDelay)
+      { return std::clamp(maxDelay, k_minDelay, k_maxDelay); }
+
+      bool operator == (const BatchPolicy &) const = default;
+      
+    private:
+      Usecs     _maxDelay;
+      Severity  _flushSeverity;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGBATCHPOLICY_HH_
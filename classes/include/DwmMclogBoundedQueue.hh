@@ -0,0 +1,617 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogBoundedQueue.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::BoundedQueue class template
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGBOUNDEDQUEUE_HH_
+#define _DWMMCLOGBOUNDEDQUEUE_HH_
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "DwmMclogConfig.hh"
+#include "DwmMclogDropCounters.hh"
+#include "DwmMclogSeverity.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  A threadsafe queue with a capacity and an OverflowPolicy, used in
+    //!  place of Thread::Queue where we need to choose what to lose when
+    //!  we're overloaded.  Every dropped entry is counted in the
+    //!  DropCounters given to Configure().
+    //!
+    //!  Entries are kept in three FIFO lanes by severity class: urgent
+    //!  (@c err and more severe), normal (@c warning and @c notice) and
+    //!  bulk (@c info and @c debug).  Consumers pop from the lanes per the
+    //!  configured DrainPolicy, so urgent entries don't wait behind a
+    //!  flood of bulk entries.  No overflow policy will ever drop an entry
+    //!  to make room for an entry in a less urgent lane.
+    //!
+    //!  If @c T has a @c Header() member returning a MessageHeader (i.e.
+    //!  @c T is a Message), entries are accounted by their severity and
+    //!  origin.  Otherwise all entries are treated as @c debug severity
+    //!  from the origin given to Configure(), and hence the queue behaves
+    //!  as a single FIFO.
+    //------------------------------------------------------------------------
+    template <typename T>
+    class BoundedQueue
+    {
+    public:
+      static constexpr size_t  k_numLanes = 3;
+      
+      //----------------------------------------------------------------------
+      //!  Default constructor.
+      //----------------------------------------------------------------------
+      BoundedQueue()
+          : _mtx(), _cv(), _spaceCv(), _lanes(), _size(0), _sevCounts(),
+            _credits(), _signals(0), _config(), _drops(nullptr),
+            _dropOrigin()
+      {
+        _sevCounts.fill(0);
+        _credits = _config.weights;
+      }
+
+      BoundedQueue(const BoundedQueue &) = delete;
+      BoundedQueue & operator = (const BoundedQueue &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Returns the lane index for the given @c severity.  0 is the
+      //!  urgent lane, 1 the normal lane and 2 the bulk lane.
+      //----------------------------------------------------------------------
+      static size_t LaneIndex(Severity severity)
+      {
+        if (severity <= Severity::err) {
+          return 0;
+        }
+        else if (severity <= Severity::notice) {
+          return 1;
+        }
+        return 2;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Sets the capacity, overflow policy and drain policy from
+      //!  @c config.  Drops will be counted in @c drops if it is not
+      //!  @c nullptr.  @c dropOrigin is the origin used to count drops of
+      //!  entries that have no message header.  If the queue holds more
+      //!  than the new capacity, the excess is dropped per the new policy.
+      //----------------------------------------------------------------------
+      void Configure(const QueueConfig & config, DropCounters *drops,
+                     const std::string & dropOrigin = std::string())
+      {
+        std::lock_guard  lck(_mtx);
+        _config = config;
+        if (0 == _config.capacity) {
+          _config.capacity = 1;
+        }
+        for (auto & weight : _config.weights) {
+          if (0 == weight) {
+            weight = 1;
+          }
+        }
+        _credits = _config.weights;
+        _drops = drops;
+        _dropOrigin = dropOrigin;
+        bool  dropNewest = ((OverflowPolicy::dropNewest == _config.overflow)
+                            || (OverflowPolicy::block == _config.overflow));
+        while (_size > _config.capacity) {
+          if (dropNewest || (! DropForNew(Severity::emerg))) {
+            DropNewestLeastUrgent();
+          }
+        }
+        return;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Returns the configuration.
+      //----------------------------------------------------------------------
+      QueueConfig Config() const
+      {
+        std::lock_guard  lck(_mtx);
+        return _config;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Adds @c entry to the back of its lane.  If the queue is full,
+      //!  the configured OverflowPolicy decides what is dropped.  Returns
+      //!  true if @c entry was queued, false if it was dropped.
+      //----------------------------------------------------------------------
+      bool PushBack(const T & entry)
+      { return Push(entry); }
+
+      //----------------------------------------------------------------------
+      //!  Like PushBack(const T &), but moves @c entry into the queue.
+      //!  If @c entry is dropped, it is left untouched so the caller may
+      //!  reuse it.
+      //----------------------------------------------------------------------
+      bool PushBack(T && entry)
+      { return Push(std::move(entry)); }
+      
+      //----------------------------------------------------------------------
+      //!  Puts @c entry back at the front of its lane.  Intended for
+      //!  returning an entry that was just popped, hence the capacity is
+      //!  not enforced.
+      //----------------------------------------------------------------------
+      bool PushFront(const T & entry)
+      {
+        {
+          std::lock_guard  lck(_mtx);
+          Severity  severity = EntrySeverity(entry);
+          _lanes[LaneIndex(severity)].push_front(entry);
+          ++_sevCounts[SevIndex(severity)];
+          ++_size;
+        }
+        _cv.notify_one();
+        return true;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Pops the next entry per the drain policy into @c entry.  Returns
+      //!  true on success, false if the queue was empty.
+      //----------------------------------------------------------------------
+      bool PopFront(T & entry)
+      {
+        bool  rc = false;
+        {
+          std::lock_guard  lck(_mtx);
+          rc = PopNext(entry);
+        }
+        if (rc) {
+          _spaceCv.notify_one();
+        }
+        return rc;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Drops every entry whose severity @c shed(severity) returns true
+      //!  for, counting each as a drop, and returns the number dropped.
+      //!  Lanes are walked from the least urgent to the most urgent, and
+      //!  a lane is skipped without looking at its entries if it holds
+      //!  no severity to shed.  The drain order of the remaining entries
+      //!  is unchanged.
+      //----------------------------------------------------------------------
+      template <typename Pred>
+      size_t Shed(Pred shed)
+      {
+        size_t  dropped = 0;
+        {
+          std::lock_guard  lck(_mtx);
+          for (size_t lane = k_numLanes; lane > 0; --lane) {
+            if (! LaneHas(lane - 1, shed)) {
+              continue;
+            }
+            auto & entries = _lanes[lane - 1];
+            for (auto it = entries.begin(); it != entries.end(); ) {
+              if (shed(EntrySeverity(*it))) {
+                CountDrop(*it);
+                --_sevCounts[SevIndex(EntrySeverity(*it))];
+                --_size;
+                it = entries.erase(it);
+                ++dropped;
+              }
+              else {
+                ++it;
+              }
+            }
+          }
+        }
+        if (dropped) {
+          _spaceCv.notify_all();
+        }
+        return dropped;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Swaps the contents of the queue with @c entries.  Typically used
+      //!  by a consumer with an empty @c entries to grab everything at
+      //!  once; the queued entries are placed in @c entries in drain
+      //!  order.  Any entries initially in @c entries are added to the
+      //!  queue without enforcing the capacity.
+      //----------------------------------------------------------------------
+      void Swap(std::deque<T> & entries)
+      {
+        {
+          std::lock_guard  lck(_mtx);
+          std::deque<T>  drained;
+          T  entry;
+          while (PopNext(entry)) {
+            drained.push_back(std::move(entry));
+          }
+          for (auto & e : entries) {
+            Severity  severity = EntrySeverity(e);
+            _lanes[LaneIndex(severity)].push_back(std::move(e));
+            ++_sevCounts[SevIndex(severity)];
+            ++_size;
+          }
+          entries.swap(drained);
+        }
+        _spaceCv.notify_all();
+        return;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Swaps the contents (not the configuration) of the queue with the
+      //!  contents of @c queue.
+      //----------------------------------------------------------------------
+      void Swap(BoundedQueue & queue)
+      {
+        if (this != &queue) {
+          std::scoped_lock  lck(_mtx, queue._mtx);
+          std::swap(_lanes, queue._lanes);
+          std::swap(_size, queue._size);
+          std::swap(_sevCounts, queue._sevCounts);
+        }
+        return;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Copies the contents (not the configuration) of the queue into
+      //!  @c queue.
+      //----------------------------------------------------------------------
+      void Copy(BoundedQueue & queue) const
+      {
+        if (this != &queue) {
+          std::scoped_lock  lck(_mtx, queue._mtx);
+          queue._lanes = _lanes;
+          queue._size = _size;
+          queue._sevCounts = _sevCounts;
+        }
+        return;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Returns true if the queue is empty.
+      //----------------------------------------------------------------------
+      bool Empty() const
+      {
+        std::lock_guard  lck(_mtx);
+        return (0 == _size);
+      }
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of entries in the queue.
+      //----------------------------------------------------------------------
+      size_t Length() const
+      {
+        std::lock_guard  lck(_mtx);
+        return _size;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of entries in the given @c lane.
+      //----------------------------------------------------------------------
+      size_t LaneLength(size_t lane) const
+      {
+        std::lock_guard  lck(_mtx);
+        return ((lane < k_numLanes) ? _lanes[lane].size() : 0);
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Empties the queue.  Cleared entries are not counted as drops.
+      //----------------------------------------------------------------------
+      void Clear()
+      {
+        {
+          std::lock_guard  lck(_mtx);
+          for (auto & lane : _lanes) {
+            lane.clear();
+          }
+          _size = 0;
+          _sevCounts.fill(0);
+        }
+        _spaceCv.notify_all();
+        return;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Waits until the queue is not empty or ConditionSignal() is
+      //!  called.
+      //----------------------------------------------------------------------
+      bool ConditionWait()
+      {
+        std::unique_lock  lck(_mtx);
+        uint64_t  signals = _signals;
+        _cv.wait(lck, [&] { return ((0 != _size)
+                                    || (signals != _signals)); });
+        return true;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Waits up to @c timeout for the queue to not be empty or for
+      //!  ConditionSignal() to be called.  Returns false on timeout.
+      //----------------------------------------------------------------------
+      template <typename Rep, typename Period>
+      bool ConditionTimedWait(const std::chrono::duration<Rep,Period> & timeout)
+      {
+        std::unique_lock  lck(_mtx);
+        uint64_t  signals = _signals;
+        return _cv.wait_for(lck, timeout,
+                            [&] { return ((0 != _size)
+                                          || (signals != _signals)); });
+      }
+
+      //----------------------------------------------------------------------
+      //!  Wakes the consumer waiting in ConditionWait() or
+      //!  ConditionTimedWait().
+      //----------------------------------------------------------------------
+      bool ConditionSignal()
+      {
+        {
+          std::lock_guard  lck(_mtx);
+          ++_signals;
+        }
+        _cv.notify_all();
+        return true;
+      }
+      
+    private:
+      mutable std::mutex                    _mtx;
+      std::condition_variable               _cv;
+      std::condition_variable               _spaceCv;
+      std::array<std::deque<T>,k_numLanes>  _lanes;
+      size_t                                _size;
+      std::array<size_t,8>                  _sevCounts;
+      std::array<uint32_t,k_numLanes>       _credits;
+      uint64_t                              _signals;
+      QueueConfig                           _config;
+      DropCounters                         *_drops;
+      std::string                           _dropOrigin;
+
+      //----------------------------------------------------------------------
+      template <typename U>
+      bool Push(U && entry)
+      {
+        bool  rc = false;
+        Severity  severity = EntrySeverity(entry);
+        std::unique_lock  lck(_mtx);
+        if ((_size >= _config.capacity)
+            && (OverflowPolicy::block == _config.overflow)) {
+          _spaceCv.wait_for(lck, _config.blockTimeout,
+                            [&] { return (_size < _config.capacity); });
+        }
+        if ((_size < _config.capacity) || DropForNew(severity)) {
+          _lanes[LaneIndex(severity)].push_back(std::forward<U>(entry));
+          ++_sevCounts[SevIndex(severity)];
+          ++_size;
+          rc = true;
+        }
+        else {
+          CountDrop(entry);
+        }
+        lck.unlock();
+        if (rc) {
+          _cv.notify_one();
+        }
+        return rc;
+      }
+      
+      //----------------------------------------------------------------------
+      static Severity EntrySeverity(const T & entry)
+      {
+        if constexpr (requires { entry.Header().severity(); }) {
+          return entry.Header().severity();
+        }
+        else {
+          return Severity::debug;
+        }
+      }
+
+      //----------------------------------------------------------------------
+      static size_t SevIndex(Severity severity)
+      { return ((uint8_t)severity & 0x07); }
+      
+      //----------------------------------------------------------------------
+      void CountDrop(const T & entry)
+      {
+        if (nullptr != _drops) {
+          if constexpr (requires { entry.Header().origin().hostname(); }) {
+            const auto & origin = entry.Header().origin();
+            _drops->Add(EntrySeverity(entry),
+                        origin.hostname() + '/' + origin.appname());
+          }
+          else {
+            _drops->Add(EntrySeverity(entry), _dropOrigin);
+          }
+        }
+        return;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Called with _mtx held.  Returns the index of the lane to pop
+      //!  from next, or k_numLanes if the queue is empty.  With the
+      //!  weighted policy, each lane may be popped as many times as its
+      //!  weight before the credits of all lanes are refilled.
+      //----------------------------------------------------------------------
+      size_t NextLane()
+      {
+        if (DrainPolicy::weighted == _config.drain) {
+          for (int pass = 0; pass < 2; ++pass) {
+            for (size_t lane = 0; lane < k_numLanes; ++lane) {
+              if ((! _lanes[lane].empty()) && (_credits[lane] > 0)) {
+                --_credits[lane];
+                return lane;
+              }
+            }
+            _credits = _config.weights;
+          }
+        }
+        for (size_t lane = 0; lane < k_numLanes; ++lane) {
+          if (! _lanes[lane].empty()) {
+            return lane;
+          }
+        }
+        return k_numLanes;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Called with _mtx held.  Pops the next entry per the drain policy
+      //!  into @c entry.  Returns false if the queue is empty.
+      //----------------------------------------------------------------------
+      bool PopNext(T & entry)
+      {
+        size_t  lane = NextLane();
+        if (lane < k_numLanes) {
+          entry = std::move(_lanes[lane].front());
+          _lanes[lane].pop_front();
+          --_sevCounts[SevIndex(EntrySeverity(entry))];
+          --_size;
+          return true;
+        }
+        return false;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Called with _mtx held.  Returns true if @c lane holds an entry
+      //!  with a severity for which @c pred(severity) returns true.
+      //----------------------------------------------------------------------
+      template <typename Pred>
+      bool LaneHas(size_t lane, Pred pred) const
+      {
+        for (size_t sev = 0; sev < _sevCounts.size(); ++sev) {
+          if (_sevCounts[sev] && (LaneIndex((Severity)sev) == lane)
+              && pred((Severity)sev)) {
+            return true;
+          }
+        }
+        return false;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Called with _mtx held.  Drops the entry at @c it in @c lane.
+      //----------------------------------------------------------------------
+      void Drop(std::deque<T> & lane, typename std::deque<T>::iterator it)
+      {
+        CountDrop(*it);
+        --_sevCounts[SevIndex(EntrySeverity(*it))];
+        --_size;
+        lane.erase(it);
+        return;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Called with _mtx held.  Drops the newest entry in the least
+      //!  urgent non-empty lane.
+      //----------------------------------------------------------------------
+      void DropNewestLeastUrgent()
+      {
+        for (size_t lane = k_numLanes; lane > 0; --lane) {
+          if (! _lanes[lane - 1].empty()) {
+            Drop(_lanes[lane - 1], std::prev(_lanes[lane - 1].end()));
+            break;
+          }
+        }
+        return;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Called with _mtx held when the queue is full and we want to add
+      //!  an entry with the given @c severity.  Drops an existing entry per
+      //!  our policy and returns true if there is now room for the new
+      //!  entry, else returns false (the new entry should be dropped).
+      //!  Never drops an entry from a lane more urgent than the new
+      //!  entry's lane.
+      //----------------------------------------------------------------------
+      bool DropForNew(Severity severity)
+      {
+        if (0 == _size) {
+          return true;
+        }
+        size_t  newLane = LaneIndex(severity);
+        switch (_config.overflow) {
+          case OverflowPolicy::dropOldest:
+            //  Drop the oldest entry of the least urgent lane that is not
+            //  more urgent than the new entry.
+            for (size_t lane = k_numLanes; lane > newLane; --lane) {
+              if (! _lanes[lane - 1].empty()) {
+                Drop(_lanes[lane - 1], _lanes[lane - 1].begin());
+                return true;
+              }
+            }
+            break;
+          case OverflowPolicy::dropLowestSeverity:
+            {
+              //  Find the least severe severity in the queue, then drop
+              //  the oldest entry with that severity if it's not more
+              //  severe than the new entry.
+              size_t  lowest = _sevCounts.size();
+              while ((lowest > 0) && (0 == _sevCounts[lowest - 1])) {
+                --lowest;
+              }
+              if ((lowest > 0) && ((lowest - 1) >= SevIndex(severity))) {
+                auto & lane = _lanes[LaneIndex((Severity)(lowest - 1))];
+                auto  dropit =
+                  std::find_if(lane.begin(), lane.end(),
+                               [&] (const T & entry)
+                               { return (SevIndex(EntrySeverity(entry))
+                                         == (lowest - 1)); });
+                if (dropit != lane.end()) {
+                  Drop(lane, dropit);
+                  return true;
+                }
+              }
+            }
+            break;
+          default:
+            //  dropNewest and block: the new entry is dropped unless a
+            //  less urgent lane has something we can drop instead, in
+            //  which case we drop the newest entry of that lane.
+            for (size_t lane = k_numLanes; lane > (newLane + 1); --lane) {
+              if (! _lanes[lane - 1].empty()) {
+                Drop(_lanes[lane - 1], std::prev(_lanes[lane - 1].end()));
+                return true;
+              }
+            }
+            break;
+        }
+        return false;
+      }
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGBOUNDEDQUEUE_HH_
@@ -0,0 +1,168 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogCipherSuite.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::CipherSuite and Dwm::Mclog::NonceSequence
+//!  declarations
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGCIPHERSUITE_HH_
+#define _DWMMCLOGCIPHERSUITE_HH_
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  AEAD used to encrypt multicast packets.  Values are carried on the
+    //!  wire (in the nonce header of a packet, and as bits of a suite mask
+    //!  in the key exchange), so never renumber them.
+    //------------------------------------------------------------------------
+    enum class CipherSuite : uint8_t {
+      xchacha20poly1305 = 1,
+      aes256gcm         = 2
+    };
+
+    //------------------------------------------------------------------------
+    //!  Returns the mask bit for @c suite.
+    //------------------------------------------------------------------------
+    inline uint8_t CipherSuiteBit(CipherSuite suite)
+    { return (1 << (uint8_t)suite); }
+    
+    //------------------------------------------------------------------------
+    //!  Returns the mask of cipher suites usable on this host.
+    //!  XChaCha20-Poly1305 is always usable; AES-256-GCM only if the CPU
+    //!  has hardware AES and carryless multiply.
+    //------------------------------------------------------------------------
+    uint8_t LocalCipherSuites();
+
+    //------------------------------------------------------------------------
+    //!  Returns the fastest cipher suite in the mask @c suites, or
+    //!  XChaCha20-Poly1305 if @c suites is empty.
+    //------------------------------------------------------------------------
+    CipherSuite BestCipherSuite(uint8_t suites);
+    
+    //------------------------------------------------------------------------
+    //!  Returns the string representation of the given @c suite.
+    //------------------------------------------------------------------------
+    std::string CipherSuiteName(CipherSuite suite);
+    
+    //------------------------------------------------------------------------
+    //!  Generates the 24-byte nonce header at the start of each encrypted
+    //!  multicast packet:
+    //!
+    //!    bytes  0..2   k_tag
+    //!    byte   3      cipher suite, with k_compressedFlag set if the
+    //!                  payload is compressed (see PayloadCompressor)
+    //!                  and k_summaryFlag set if a PacketSummary follows
+    //!                  the MAC
+    //!    bytes  4..17  random prefix, chosen per NonceSequence
+    //!    bytes 18..23  packet counter (big-endian)
+    //!
+    //!  XChaCha20-Poly1305 uses the whole header as its nonce.
+    //!  AES-256-GCM uses bytes 12..23 as its nonce (48 random bits and
+    //!  the counter) and authenticates bytes 0..11 as associated data.
+    //!  Either suite authenticates the PacketSummary, if any, as
+    //!  associated data.
+    //!  The counter lets a receiver reject replayed packets cheaply; see
+    //!  ReplayWindow.  Packets from older senders have a random 24-byte
+    //!  nonce, which is indistinguishable from an XChaCha20-Poly1305
+    //!  header to a receiver except that it won't have k_tag.
+    //------------------------------------------------------------------------
+    class NonceSequence
+    {
+    public:
+      static constexpr size_t    k_headerLen = 24;
+      static constexpr std::array<uint8_t,3>  k_tag = { 'M', 'C', 'N' };
+      static constexpr size_t    k_suiteOffset = 3;
+      static constexpr uint8_t   k_compressedFlag = 0x80;
+      static constexpr uint8_t   k_summaryFlag = 0x40;
+      static constexpr size_t    k_prefixOffset = 4;
+      static constexpr size_t    k_prefixLen = 14;
+      static constexpr size_t    k_counterOffset = 18;
+      static constexpr size_t    k_counterLen = 6;
+      static constexpr uint64_t  k_maxCounter = (1ULL << 48) - 1;
+      static constexpr size_t    k_gcmNonceOffset = 12;
+      
+      //----------------------------------------------------------------------
+      //!  Construct with a random prefix, using the given @c suite.
+      //----------------------------------------------------------------------
+      NonceSequence(CipherSuite suite = CipherSuite::xchacha20poly1305);
+
+      //----------------------------------------------------------------------
+      //!  Returns the cipher suite.
+      //----------------------------------------------------------------------
+      CipherSuite Suite() const
+      { return _suite; }
+
+      //----------------------------------------------------------------------
+      //!  Sets the cipher suite.  The counter continues, so nonces are not
+      //!  reused across a change.
+      //----------------------------------------------------------------------
+      void Suite(CipherSuite suite)
+      { _suite = suite; }
+      
+      //----------------------------------------------------------------------
+      //!  Writes the next nonce header to @c hdr, which must have room for
+      //!  k_headerLen bytes.  Chooses a new prefix when the counter is
+      //!  exhausted.
+      //----------------------------------------------------------------------
+      void Next(uint8_t *hdr);
+
+      //----------------------------------------------------------------------
+      //!  If @c hdr starts with k_tag, sets @c suite, @c prefix and
+      //!  @c counter from it and returns true.  Else returns false.
+      //!  k_compressedFlag and k_summaryFlag are not part of @c suite.
+      //----------------------------------------------------------------------
+      static bool Parse(const uint8_t *hdr, CipherSuite & suite,
+                        std::string & prefix, uint64_t & counter);
+      
+    private:
+      CipherSuite                     _suite;
+      std::array<uint8_t,k_prefixLen> _prefix;
+      uint64_t                        _counter;
+
+      void NewPrefix();
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGCIPHERSUITE_HH_
@@ -0,0 +1,203 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogCompressionPool.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::CompressionPool class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGCOMPRESSIONPOOL_HH_
+#define _DWMMCLOGCOMPRESSIONPOOL_HH_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  A pool of threads that compress rolled log files in the
+    //!  background, so rolling hundreds of log files at once doesn't
+    //!  start hundreds of compression processes.  At most the configured
+    //!  number of files are compressed at once, and the workers run at
+    //!  reduced CPU and I/O priority (per thread on Linux and macOS).
+    //!  Each file is compressed to a temporary file that is renamed into
+    //!  place when complete, after which the uncompressed file is
+    //!  removed.  Failures are logged and the uncompressed file is kept.
+    //------------------------------------------------------------------------
+    class CompressionPool
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Completion counts.
+      //----------------------------------------------------------------------
+      struct Counts
+      {
+        uint64_t  completed = 0;  //!< files compressed
+        uint64_t  failed    = 0;  //!< files that failed to compress
+        uint64_t  bytesIn   = 0;  //!< uncompressed bytes of completed
+        uint64_t  bytesOut  = 0;  //!< compressed bytes of completed
+
+        //!  Returns true if there's nothing to report.
+        bool Empty() const
+        { return ((0 == completed) && (0 == failed)); }
+        
+        //!  Returns a human-readable summary of the counts.
+        std::string Summary() const;
+      };
+      
+      //----------------------------------------------------------------------
+      //!  Default constructor.
+      //----------------------------------------------------------------------
+      CompressionPool();
+
+      CompressionPool(const CompressionPool &) = delete;
+      CompressionPool & operator = (const CompressionPool &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Destructor.  Stops the workers after they finish queued files.
+      //----------------------------------------------------------------------
+      ~CompressionPool();
+
+      //----------------------------------------------------------------------
+      //!  Starts @c numThreads workers (at least 1) with the given
+      //!  @c niceness (0 to 19).  Returns true on success, false if
+      //!  already started.
+      //----------------------------------------------------------------------
+      bool Start(uint32_t numThreads, int niceness);
+
+      //----------------------------------------------------------------------
+      //!  Stops the workers after they finish the files already queued.
+      //----------------------------------------------------------------------
+      void Stop();
+
+      //----------------------------------------------------------------------
+      //!  Returns true if the workers are running.
+      //----------------------------------------------------------------------
+      bool Running() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of running workers.
+      //----------------------------------------------------------------------
+      uint32_t Threads() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns the niceness of the workers.
+      //----------------------------------------------------------------------
+      int Niceness() const;
+      
+      //----------------------------------------------------------------------
+      //!  Queues the file at @c path to be compressed with @c compress
+      //!  ('bzip2' or 'gzip').  If the workers aren't running, the file
+      //!  is compressed before returning.  Returns false only if the
+      //!  file was compressed here and failed.
+      //----------------------------------------------------------------------
+      bool Submit(const std::string & path, const std::string & compress);
+
+      //----------------------------------------------------------------------
+      //!  Waits until the file at @c path is neither queued nor being
+      //!  compressed.  Used before reusing the name of a file that was
+      //!  submitted.
+      //----------------------------------------------------------------------
+      void Wait(const std::string & path);
+
+      //----------------------------------------------------------------------
+      //!  Waits until no files are queued or being compressed.
+      //----------------------------------------------------------------------
+      void WaitAll();
+      
+      //----------------------------------------------------------------------
+      //!  Returns the completion counts since the last call.
+      //----------------------------------------------------------------------
+      Counts Harvest();
+
+      //----------------------------------------------------------------------
+      //!  Compresses the file at @c path with @c compress ('bzip2' or
+      //!  'gzip'), replacing it with a file of the same name plus the
+      //!  extension for @c compress.  The compressed file keeps the
+      //!  permissions and (if possible) ownership of the original.  On
+      //!  success, sets @c bytesIn and @c bytesOut to the original and
+      //!  compressed sizes and returns true.  On failure, logs the
+      //!  reason and returns false.
+      //----------------------------------------------------------------------
+      static bool Compress(const std::string & path,
+                           const std::string & compress,
+                           uint64_t & bytesIn, uint64_t & bytesOut);
+
+      //----------------------------------------------------------------------
+      //!  Returns the file name extension for the given @c compress
+      //!  ('bz2' for 'bzip2', 'gz' for 'gzip').  Anything else is treated
+      //!  as 'bzip2'.
+      //----------------------------------------------------------------------
+      static std::string Extension(const std::string & compress);
+
+      //----------------------------------------------------------------------
+      //!  Returns true if @c compress is 'bzip2' or 'gzip'.
+      //----------------------------------------------------------------------
+      static bool Supported(const std::string & compress);
+      
+    private:
+      struct Job
+      {
+        std::string  path;
+        std::string  compress;
+      };
+      
+      mutable std::mutex         _mtx;
+      std::condition_variable    _cv;
+      std::deque<Job>            _jobs;
+      std::vector<std::string>   _active;
+      std::vector<std::thread>   _threads;
+      bool                       _run;
+      int                        _niceness;
+      Counts                     _counts;
+
+      bool Pending(const std::string & path) const;
+      void Record(const Job & job, bool ok, uint64_t bytesIn,
+                  uint64_t bytesOut);
+      static void Throttle(int niceness);
+      void Run();
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGCOMPRESSIONPOOL_HH_
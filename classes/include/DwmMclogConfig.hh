@@ -40,15 +40,44 @@
 #ifndef _DWMMCLOGCONFIG_HH_
 #define _DWMMCLOGCONFIG_HH_
 
+#include <array>
+#include <string>
+#include <vector>
+
 #include "DwmIpv4Address.hh"
 #include "DwmIpv6Address.hh"
+#include "DwmMclogBatchPolicy.hh"
+#include "DwmMclogFlushPolicy.hh"
+#include "DwmMclogDrainPolicy.hh"
 #include "DwmMclogFileFormat.hh"
+#include "DwmMclogOverflowPolicy.hh"
+#include "DwmMclogPacingPolicy.hh"
 #include "DwmMclogRollPeriod.hh"
 
 namespace Dwm {
 
   namespace Mclog {
 
+    //------------------------------------------------------------------------
+    //!  Multicast channel configuration (each entry in 'channels' in
+    //!  'multicast' in config file).  Messages that pass a channel's
+    //!  filter are sent to its groups instead of the default groups, so
+    //!  receivers that don't want them needn't join.
+    //------------------------------------------------------------------------
+    class ChannelConfig
+    {
+    public:
+      ChannelConfig()  { Init(); }
+      ChannelConfig(const ChannelConfig &) = default;
+      ChannelConfig & operator = (const ChannelConfig &) = default;
+      void Init();
+
+      std::string  name;        //! channel name, for logging
+      std::string  filter;      //! filter expression selecting messages
+      Ipv4Address  groupAddr;   //! ipv4 group address
+      Ipv6Address  groupAddr6;  //! ipv6 group address
+    };
+    
     //------------------------------------------------------------------------
     //!  Encapsulate multicast configuration ('multicast' in config file)
     //------------------------------------------------------------------------
@@ -62,6 +91,18 @@ namespace Dwm {
       bool ShouldSendIpv6() const;
       bool ShouldRunSender() const;
       void Init();
+
+      static constexpr uint32_t  k_minReceiveThreads = 1;
+      static constexpr uint32_t  k_maxReceiveThreads = 32;
+      static constexpr uint32_t  k_maxAutoReceiveThreads = 8;
+      static constexpr size_t    k_maxChannels = 16;
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of multicast receive worker threads to run.
+      //!  If @c receiveThreads is 0 (automatic), this is the number of
+      //!  hardware threads, at most k_maxAutoReceiveThreads.
+      //----------------------------------------------------------------------
+      uint32_t ReceiveThreads() const;
       
       Ipv4Address  groupAddr;   // ipv4 group address
       Ipv6Address  groupAddr6;  // ipv6 group address
@@ -70,6 +111,15 @@ namespace Dwm {
       Ipv6Address  intfAddr6;   // interface ipv6 address
       uint16_t     dstPort;     // destination port
       std::string  outFilter;   // output filter expression
+      BatchPolicy  batching;    // when to send partially filled packets
+      PacingPolicy pacing;      // packet and byte rate limits
+      uint32_t     packetSize;  // packet length, 0 to use interface MTU
+      uint32_t     receiveThreads;  // receive workers, 0 for automatic
+      uint32_t     fecData;     // data packets per FEC block
+      uint32_t     fecParity;   // parity packets per FEC block, 0 for none
+      std::string  compress;    // payload compression, "zstd" or "none"
+      std::string  dictionary;  // path of trained zstd dictionary
+      std::vector<ChannelConfig>  channels;  // groups selected by filter
     };
 
     //------------------------------------------------------------------------
@@ -125,10 +175,13 @@ namespace Dwm {
       std::string  group;         //! log file group
       std::string  compress;      //! compression ('bzip2' or 'gzip')
       FileFormat   format;        //! 'text' or 'binary'
+      FlushPolicy  flush;         //! when buffered messages are written
     };
     
     //------------------------------------------------------------------------
-    //!  Log files configuration ('files' in config file)
+    //!  Log files configuration ('files' in config file).  Rolled log
+    //!  files are compressed by @c compressThreads threads running at
+    //!  niceness @c compressNice (see CompressionPool).
     //------------------------------------------------------------------------
     class FilesConfig
     {
@@ -137,9 +190,88 @@ namespace Dwm {
       FilesConfig(const FilesConfig &) = default;
       FilesConfig & operator = (const FilesConfig &) = default;
       void Init();
+
+      static constexpr uint32_t  k_minCompressThreads = 1;
+      static constexpr uint32_t  k_maxCompressThreads = 16;
+      static constexpr int       k_maxCompressNice = 19;
       
       std::string                 logDirectory;
       std::vector<LogFileConfig>  logs;
+      uint32_t                    compressThreads;
+      int                         compressNice;
+    };
+    
+    //------------------------------------------------------------------------
+    //!  Configuration for a single BoundedQueue (each entry in 'queues' in
+    //!  config file).  If @c sampleThreshold is not 0, @c info and
+    //!  @c debug messages are sampled once the queue is that percent full
+    //!  and growing (see AdaptiveSampler).
+    //------------------------------------------------------------------------
+    class QueueConfig
+    {
+    public:
+      QueueConfig()  { Init(1000, OverflowPolicy::dropLowestSeverity); }
+      QueueConfig(size_t cap, OverflowPolicy policy)  { Init(cap, policy); }
+      QueueConfig(const QueueConfig &) = default;
+      QueueConfig & operator = (const QueueConfig &) = default;
+      void Init(size_t cap, OverflowPolicy policy)
+      {
+        capacity = cap;
+        overflow = policy;
+        blockTimeout = std::chrono::milliseconds(100);
+        drain = DrainPolicy::weighted;
+        weights = { 8, 4, 1 };
+        sampleThreshold = 0;
+      }
+      
+      size_t                     capacity;      //! maximum entries
+      OverflowPolicy             overflow;      //! what to do when full
+      std::chrono::milliseconds  blockTimeout;  //! max wait for 'block'
+      DrainPolicy                drain;         //! how lanes are drained
+      std::array<uint32_t,3>     weights;       //! lane weights, 'weighted'
+      uint32_t                   sampleThreshold;  //! % full to sample
+    };
+
+    //------------------------------------------------------------------------
+    //!  Internal queue configuration ('queues' in config file)
+    //------------------------------------------------------------------------
+    class QueuesConfig
+    {
+    public:
+      QueuesConfig()  { Init(); }
+      QueuesConfig(const QueuesConfig &) = default;
+      QueuesConfig & operator = (const QueuesConfig &) = default;
+      void Init();
+
+      QueueConfig  files;           //! FileLogger input queue
+      QueueConfig  multicast;       //! MulticastSender output queue
+      QueueConfig  backlog;         //! per-source MulticastSource backlog
+      uint32_t     reportInterval;  //! seconds between drop reports
+    };
+    
+    //------------------------------------------------------------------------
+    //!  Ingest quota configuration (each entry in 'quotas' in config
+    //!  file).  Each origin (host and ident) whose messages pass the
+    //!  filter may log at most @c rate messages per second, with bursts
+    //!  of up to @c burst messages.
+    //------------------------------------------------------------------------
+    class QuotaConfig
+    {
+    public:
+      QuotaConfig()  { Init(); }
+      QuotaConfig(const QuotaConfig &) = default;
+      QuotaConfig & operator = (const QuotaConfig &) = default;
+      void Init();
+
+      //----------------------------------------------------------------------
+      //!  Returns @c burst, or @c rate if @c burst is 0.
+      //----------------------------------------------------------------------
+      uint32_t Burst() const
+      { return (burst ? burst : rate); }
+      
+      std::string  filter;  //! filter expression selecting messages
+      uint32_t     rate;    //! messages per second per origin
+      uint32_t     burst;   //! bucket depth, 0 to use rate
     };
     
     //------------------------------------------------------------------------
@@ -161,6 +293,8 @@ namespace Dwm {
       ServiceConfig                          service;
       std::map<std::string,std::string>      filters;
       FilesConfig                            files;
+      QueuesConfig                           queues;
+      std::vector<QuotaConfig>               quotas;
     };
     
   }  // namespace Mclog
@@ -0,0 +1,75 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogDrainPolicy.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::DrainPolicy declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGDRAINPOLICY_HH_
+#define _DWMMCLOGDRAINPOLICY_HH_
+
+#include <cstdint>
+#include <string>
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  How a BoundedQueue chooses between its severity lanes when an
+    //!  entry is popped.
+    //------------------------------------------------------------------------
+    enum class DrainPolicy : uint8_t {
+      strict,    //!< always drain the most severe non-empty lane first
+      weighted   //!< weighted round robin across the non-empty lanes
+    };
+
+    //------------------------------------------------------------------------
+    //!  Returns the DrainPolicy for the given @c name.  Valid values for
+    //!  @c name: "strict" and "weighted".  For an invalid @c name, returns
+    //!  weighted.
+    //------------------------------------------------------------------------
+    DrainPolicy DrainPolicyValue(const std::string & name);
+
+    //------------------------------------------------------------------------
+    //!  Returns the string representation of the given @c policy.
+    //------------------------------------------------------------------------
+    std::string DrainPolicyName(DrainPolicy policy);
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGDRAINPOLICY_HH_
@@ -0,0 +1,155 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogDropCounters.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::DropCounters class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGDROPCOUNTERS_HH_
+#define _DWMMCLOGDROPCOUNTERS_HH_
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "DwmMclogSeverity.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Counts of dropped messages, by severity and by origin.
+    //------------------------------------------------------------------------
+    class DropCounts
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Origin key used once we're tracking k_maxOrigins distinct origins.
+      //----------------------------------------------------------------------
+      static inline const std::string  k_otherOrigin = "(other)";
+      static constexpr size_t          k_maxOrigins = 256;
+      
+      DropCounts();
+      DropCounts(const DropCounts &) = default;
+      DropCounts & operator = (const DropCounts &) = default;
+      DropCounts(DropCounts &&) = default;
+      DropCounts & operator = (DropCounts &&) = default;
+
+      //----------------------------------------------------------------------
+      //!  Adds a drop of a message with the given @c severity from the
+      //!  given @c origin.
+      //----------------------------------------------------------------------
+      void Add(Severity severity, const std::string & origin);
+
+      //----------------------------------------------------------------------
+      //!  Adds all of the counts in @c counts to our counts.
+      //----------------------------------------------------------------------
+      DropCounts & operator += (const DropCounts & counts);
+      
+      //----------------------------------------------------------------------
+      //!  Returns the total number of drops.
+      //----------------------------------------------------------------------
+      uint64_t Total() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of drops of messages with the given
+      //!  @c severity.
+      //----------------------------------------------------------------------
+      uint64_t BySeverity(Severity severity) const
+      { return _bySeverity[(uint8_t)severity & 0x07]; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the drop counts keyed by origin.
+      //----------------------------------------------------------------------
+      const std::map<std::string,uint64_t> & ByOrigin() const
+      { return _byOrigin; }
+
+      //----------------------------------------------------------------------
+      //!  Returns a human-readable summary, e.g.
+      //!  "12 (debug 10, info 2) from host1/app1 10, host2/app2 2".
+      //----------------------------------------------------------------------
+      std::string Summary() const;
+      
+      //----------------------------------------------------------------------
+      //!  Clears all counts.
+      //----------------------------------------------------------------------
+      void Clear();
+      
+    private:
+      std::array<uint64_t,8>           _bySeverity;
+      std::map<std::string,uint64_t>   _byOrigin;
+    };
+    
+    //------------------------------------------------------------------------
+    //!  Threadsafe drop accounting shared by a queue's producers.  Counts
+    //!  accumulate until harvested with Harvest(), so each harvest returns
+    //!  the exact drops since the previous one.
+    //------------------------------------------------------------------------
+    class DropCounters
+    {
+    public:
+      DropCounters();
+
+      //----------------------------------------------------------------------
+      //!  Adds a drop of a message with the given @c severity from the
+      //!  given @c origin.
+      //----------------------------------------------------------------------
+      void Add(Severity severity, const std::string & origin);
+
+      //----------------------------------------------------------------------
+      //!  Returns the drops since the last call to Harvest() and resets
+      //!  our counts.
+      //----------------------------------------------------------------------
+      DropCounts Harvest();
+
+      //----------------------------------------------------------------------
+      //!  Returns the total number of drops since construction.
+      //----------------------------------------------------------------------
+      uint64_t Total() const;
+      
+    private:
+      mutable std::mutex  _mtx;
+      DropCounts          _counts;
+      uint64_t            _total;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGDROPCOUNTERS_HH_
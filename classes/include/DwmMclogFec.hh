@@ -0,0 +1,238 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogFec.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::FecParityHeader, Dwm::Mclog::FecEncoder and
+//!  Dwm::Mclog::FecDecoder class declarations
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGFEC_HH_
+#define _DWMMCLOGFEC_HH_
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Forward error correction for the multicast stream.  After every
+    //!  K encrypted data packets, a sender emits M parity packets.
+    //!  Parity packet j is the XOR of data packets j, j+M, j+2M, ... of
+    //!  the block (zero-padded to the longest), so a receiver can rebuild
+    //!  any one of those packets from the others and the parity, and a
+    //!  burst of up to M consecutive lost packets is recoverable.  Parity
+    //!  is computed over the encrypted packets (including their nonce
+    //!  headers), so rebuilding a packet doesn't require the key, and a
+    //!  rebuilt packet is authenticated by decrypting it like any other.
+    //!
+    //!  The header at the start of each parity packet:
+    //!
+    //!    bytes  0..3   k_tag
+    //!    bytes  4..17  nonce prefix of the block's data packets
+    //!    bytes 18..23  counter of the block's first data packet
+    //!    byte   24     number of data packets in the block (K)
+    //!    byte   25     number of parity packets for the block (M)
+    //!    byte   26     index of this parity packet (j)
+    //!    byte   27     reserved, 0
+    //!    bytes 28..29  XOR of the lengths of the covered data packets
+    //!
+    //!  followed by the XOR of the covered data packets.
+    //------------------------------------------------------------------------
+    struct FecParityHeader
+    {
+      static constexpr std::array<uint8_t,4>  k_tag = { 'M', 'C', 'F', 'P' };
+      static constexpr size_t   k_len = 30;
+      static constexpr size_t   k_maxData = 32;
+      static constexpr size_t   k_maxParity = 8;
+
+      std::string  prefix;
+      uint64_t     first = 0;
+      uint8_t      numData = 0;
+      uint8_t      numParity = 0;
+      uint8_t      index = 0;
+      uint16_t     lengthXor = 0;
+
+      //----------------------------------------------------------------------
+      //!  Appends the encoded header to @c s.
+      //----------------------------------------------------------------------
+      void Encode(std::string & s) const;
+
+      //----------------------------------------------------------------------
+      //!  Parses the header from @c data of length @c len.  Returns false
+      //!  if @c data is not a parity packet or the header is invalid.
+      //----------------------------------------------------------------------
+      bool Parse(const char *data, size_t len);
+
+      //----------------------------------------------------------------------
+      //!  Returns true if @c data of length @c len starts with k_tag.
+      //----------------------------------------------------------------------
+      static bool IsParity(const char *data, size_t len);
+
+      //----------------------------------------------------------------------
+      //!  Returns true if this parity packet covers @c counter.
+      //----------------------------------------------------------------------
+      bool Covers(uint64_t counter) const;
+    };
+    
+    //------------------------------------------------------------------------
+    //!  Computes parity packets for a MulticastSender.  Not threadsafe.
+    //------------------------------------------------------------------------
+    class FecEncoder
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Construct with blocks of @c numData data packets and
+      //!  @c numParity parity packets.  @c numParity 0 disables FEC.
+      //----------------------------------------------------------------------
+      FecEncoder(size_t numData = 0, size_t numParity = 0);
+
+      //----------------------------------------------------------------------
+      //!  Sets the block shape and discards any partial block.
+      //!  @c numData is clamped to [2, k_maxData] and @c numParity to
+      //!  [0, min(numData, k_maxParity)].
+      //----------------------------------------------------------------------
+      void Configure(size_t numData, size_t numParity);
+
+      //----------------------------------------------------------------------
+      //!  Returns true if FEC is enabled.
+      //----------------------------------------------------------------------
+      bool Enabled() const
+      { return (_numParity > 0); }
+
+      //----------------------------------------------------------------------
+      //!  Returns true if there is a partial block.
+      //----------------------------------------------------------------------
+      bool Pending() const
+      { return (_count > 0); }
+      
+      //----------------------------------------------------------------------
+      //!  Adds the encrypted data packet @c data of length @c len to the
+      //!  current block.  If that completes the block, appends its parity
+      //!  packets to @c parity.  Returns the number of parity packets
+      //!  appended.  Packets without a NonceSequence header are ignored.
+      //----------------------------------------------------------------------
+      size_t Add(const char *data, size_t len,
+                 std::vector<std::string> & parity);
+
+      //----------------------------------------------------------------------
+      //!  Ends the current partial block, appending its parity packets to
+      //!  @c parity.  Returns the number of parity packets appended.
+      //----------------------------------------------------------------------
+      size_t Flush(std::vector<std::string> & parity);
+      
+    private:
+      size_t                    _numData;
+      size_t                    _numParity;
+      std::string               _prefix;
+      uint64_t                  _first;
+      size_t                    _count;
+      std::vector<std::string>  _xors;
+      std::vector<uint16_t>     _lengthXors;
+    };
+
+    //------------------------------------------------------------------------
+    //!  Rebuilds lost data packets from one multicast source using the
+    //!  source's parity packets.  Holds copies of the most recent
+    //!  k_maxHeld encrypted data packets, and parity packets that can't
+    //!  be used yet because two or more of the packets they cover are
+    //!  missing.  Not threadsafe.
+    //------------------------------------------------------------------------
+    class FecDecoder
+    {
+    public:
+      static constexpr size_t  k_maxHeld = 256;
+      static constexpr size_t  k_maxPendingParity = 64;
+
+      FecDecoder();
+
+      //----------------------------------------------------------------------
+      //!  Returns true once we've seen a parity packet, i.e. the source
+      //!  is sending them and we should hold data packets.
+      //----------------------------------------------------------------------
+      bool Active() const
+      { return _active; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of data packets per block in the most recent
+      //!  parity packet (0 if none).
+      //----------------------------------------------------------------------
+      size_t BlockSize() const
+      { return _blockSize; }
+      
+      //----------------------------------------------------------------------
+      //!  Holds the encrypted data packet @c data.  Appends any packets
+      //!  that can now be rebuilt to @c recovered and returns the number
+      //!  appended.
+      //----------------------------------------------------------------------
+      size_t AddData(std::string && data,
+                     std::vector<std::string> & recovered);
+
+      //----------------------------------------------------------------------
+      //!  Handles the parity packet @c data of length @c len.  Appends
+      //!  any packets that can now be rebuilt to @c recovered and returns
+      //!  the number appended.
+      //----------------------------------------------------------------------
+      size_t AddParity(const char *data, size_t len,
+                       std::vector<std::string> & recovered);
+      
+    private:
+      struct Parity
+      {
+        FecParityHeader  hdr;
+        std::string      xors;
+      };
+      
+      bool                             _active;
+      size_t                           _blockSize;
+      std::string                      _prefix;
+      std::map<uint64_t,std::string>   _held;
+      std::deque<Parity>               _pending;
+
+      void NewPrefix(const std::string & prefix);
+      bool Recover(const Parity & parity, std::string & packet,
+                   bool & done) const;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGFEC_HH_
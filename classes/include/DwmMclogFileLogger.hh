@@ -43,7 +43,8 @@
 #include <memory>
 #include <thread>
 
-#include "DwmThreadQueue.hh"
+#include "DwmMclogAdaptiveSampler.hh"
+#include "DwmMclogBoundedQueue.hh"
 #include "DwmMclogConfig.hh"
 #include "DwmMclogLogFiles.hh"
 #include "DwmMclogMessageSink.hh"
@@ -65,16 +66,19 @@ namespace Dwm {
       FileLogger();
       
       //----------------------------------------------------------------------
-      //!  Starts the FileLogger using the given @c filescfg.  Returns true on
-      //!  success, false on failure.
+      //!  Starts the FileLogger using the given @c filescfg, with an input
+      //!  queue configured per @c queuecfg.  Returns true on success, false
+      //!  on failure.
       //----------------------------------------------------------------------
-      bool Start(const FilesConfig & filescfg);
+      bool Start(const FilesConfig & filescfg,
+                 const QueueConfig & queuecfg = QueueConfig());
       
       //----------------------------------------------------------------------
-      //!  Restarts the FileLogger using the given @c filescfg.  Returns true
-      //!  on success, false on failure.
+      //!  Restarts the FileLogger using the given @c filescfg and
+      //!  @c queuecfg.  Returns true on success, false on failure.
       //----------------------------------------------------------------------
-      bool Restart(const FilesConfig & filescfg);
+      bool Restart(const FilesConfig & filescfg,
+                   const QueueConfig & queuecfg = QueueConfig());
       
       //----------------------------------------------------------------------
       //!  Stops the FileLogger.  Returns true on success, false on failure.
@@ -86,10 +90,33 @@ namespace Dwm {
       //!  on failure.
       //----------------------------------------------------------------------
       bool Process(const Message & msg) override;
+
+      //----------------------------------------------------------------------
+      //!  Returns the messages dropped from our input queue since the last
+      //!  call.
+      //----------------------------------------------------------------------
+      DropCounts HarvestDrops()
+      { return _drops.Harvest(); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the messages sampled out in front of our input queue
+      //!  since the last call.
+      //----------------------------------------------------------------------
+      DropCounts HarvestSampled()
+      { return _sampler.HarvestSampled(); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the rolled log file compression counts since the last
+      //!  call.
+      //----------------------------------------------------------------------
+      CompressionPool::Counts HarvestCompressions()
+      { return _logFiles.HarvestCompressions(); }
       
     private:
       std::thread               _thread;
-      Thread::Queue<Message>    _inQueue;
+      DropCounters              _drops;
+      AdaptiveSampler           _sampler;
+      BoundedQueue<Message>     _inQueue;
       std::atomic<bool>         _run;
       LogFiles                  _logFiles;
       
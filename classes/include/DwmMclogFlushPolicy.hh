@@ -0,0 +1,141 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogFlushPolicy.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::FlushPolicy class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGFLUSHPOLICY_HH_
+#define _DWMMCLOGFLUSHPOLICY_HH_
+
+#include <chrono>
+#include <cstdint>
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Encapsulates the policy used by LogFile to decide when to write
+    //!  the messages it has buffered.  By default, messages are written
+    //!  at the end of each batch (see FileLogger).  If Interval() or
+    //!  Bytes() is set, messages are instead written once the oldest has
+    //!  waited Interval() or Bytes() bytes are waiting, whichever comes
+    //!  first.  If only Bytes() is set, messages wait at most
+    //!  k_defaultMaxDelay.  If Sync() is true, each write is followed by
+    //!  fdatasync(), so the messages are on stable storage.
+    //------------------------------------------------------------------------
+    class FlushPolicy
+    {
+    public:
+      //! Longest messages wait if only Bytes() is set.
+      static constexpr std::chrono::milliseconds  k_defaultMaxDelay{1000};
+      
+      //----------------------------------------------------------------------
+      //!  Default constructor.  Write at the end of each batch, no sync.
+      //----------------------------------------------------------------------
+      FlushPolicy()
+          : _interval(0), _bytes(0), _sync(false)
+      {}
+
+      FlushPolicy(const FlushPolicy &) = default;
+      FlushPolicy & operator = (const FlushPolicy &) = default;
+
+      //----------------------------------------------------------------------
+      //!  Returns true if messages are written at the end of each batch.
+      //----------------------------------------------------------------------
+      bool PerBatch() const
+      { return ((0 == _interval.count()) && (0 == _bytes)); }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the longest the oldest buffered message may wait, 0 for
+      //!  no limit.
+      //----------------------------------------------------------------------
+      std::chrono::milliseconds Interval() const
+      { return _interval; }
+
+      //----------------------------------------------------------------------
+      //!  Sets and returns the longest the oldest buffered message may
+      //!  wait.
+      //----------------------------------------------------------------------
+      std::chrono::milliseconds Interval(std::chrono::milliseconds interval)
+      { return _interval = interval; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of buffered bytes that triggers a write, 0 for
+      //!  no limit.
+      //----------------------------------------------------------------------
+      uint64_t Bytes() const
+      { return _bytes; }
+
+      //----------------------------------------------------------------------
+      //!  Sets and returns the number of buffered bytes that triggers a
+      //!  write.
+      //----------------------------------------------------------------------
+      uint64_t Bytes(uint64_t bytes)
+      { return _bytes = bytes; }
+
+      //----------------------------------------------------------------------
+      //!  Returns true if writes are followed by fdatasync().
+      //----------------------------------------------------------------------
+      bool Sync() const
+      { return _sync; }
+
+      //----------------------------------------------------------------------
+      //!  Sets and returns whether writes are followed by fdatasync().
+      //----------------------------------------------------------------------
+      bool Sync(bool sync)
+      { return _sync = sync; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the longest the oldest buffered message may wait when
+      //!  not writing per batch.
+      //----------------------------------------------------------------------
+      std::chrono::milliseconds MaxDelay() const
+      { return (_interval.count() ? _interval : k_defaultMaxDelay); }
+      
+      bool operator == (const FlushPolicy &) const = default;
+      
+    private:
+      std::chrono::milliseconds  _interval;
+      uint64_t                   _bytes;
+      bool                       _sync;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGFLUSHPOLICY_HH_
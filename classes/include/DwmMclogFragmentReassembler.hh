@@ -0,0 +1,149 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogFragmentReassembler.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::FragmentReassembler class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGFRAGMENTREASSEMBLER_HH_
+#define _DWMMCLOGFRAGMENTREASSEMBLER_HH_
+
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "DwmMclogMessage.hh"
+#include "DwmMclogMessageBlock.hh"
+#include "DwmMclogMessageFragment.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Reassembles Messages from MessageFragments.  Memory is bounded:
+    //!  at most k_maxPending partial messages holding at most
+    //!  k_maxPendingBytes are kept, the oldest being discarded to make
+    //!  room, and a partial message is discarded if it isn't completed
+    //!  within k_timeout.
+    //------------------------------------------------------------------------
+    class FragmentReassembler
+    {
+    public:
+      using Clock = std::chrono::steady_clock;
+      
+      //! Maximum number of partial messages held.
+      static constexpr size_t  k_maxPending = 64;
+      //! Maximum number of fragment bytes held.
+      static constexpr size_t  k_maxPendingBytes = 1024 * 1024;
+      //! Time allowed for all fragments of a message to arrive.
+      static constexpr std::chrono::seconds  k_timeout{5};
+      
+      //----------------------------------------------------------------------
+      //!  Default constructor.
+      //----------------------------------------------------------------------
+      FragmentReassembler();
+
+      //----------------------------------------------------------------------
+      //!  Copy constructor.
+      //----------------------------------------------------------------------
+      FragmentReassembler(const FragmentReassembler & reassembler);
+
+      //----------------------------------------------------------------------
+      //!  Copy assignment.
+      //----------------------------------------------------------------------
+      FragmentReassembler &
+      operator = (const FragmentReassembler & reassembler);
+      
+      //----------------------------------------------------------------------
+      //!  Reads records from @c is until a complete Message is available,
+      //!  storing it in @c msg.  Fragments are attributed to @c source.
+      //!  A MessageBlock is read all at once, and its messages returned
+      //!  one per call.  Returns true if @c msg was populated, false when
+      //!  there are no more complete messages in @c is.
+      //----------------------------------------------------------------------
+      bool NextMessage(std::istream & is, const std::string & source,
+                       Message & msg);
+      
+      //----------------------------------------------------------------------
+      //!  Adds the fragment @c frag from @c source.  If it completes a
+      //!  message, the message is stored in @c msg and true is returned.
+      //!  Else returns false.
+      //----------------------------------------------------------------------
+      bool Add(const std::string & source, MessageFragment && frag,
+               Message & msg);
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of partial messages being held.
+      //----------------------------------------------------------------------
+      size_t Pending() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of partial messages discarded due to timeout,
+      //!  memory bounds or inconsistent fragments.
+      //----------------------------------------------------------------------
+      uint64_t Discarded() const;
+      
+    private:
+      struct Partial
+      {
+        Clock::time_point         firstSeen;
+        uint16_t                  received;
+        size_t                    bytes;
+        std::vector<std::string>  frags;
+      };
+      using Key = std::pair<std::string,uint32_t>;
+      
+      mutable std::mutex   _mtx;
+      std::map<Key,Partial> _pending;
+      size_t               _pendingBytes;
+      uint64_t             _discarded;
+      std::deque<Message>  _blockMsgs;
+
+      void Discard(std::map<Key,Partial>::iterator it);
+      void DiscardOldest();
+      void Expire(Clock::time_point now);
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGFRAGMENTREASSEMBLER_HH_
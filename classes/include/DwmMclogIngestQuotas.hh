@@ -0,0 +1,153 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogIngestQuotas.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::IngestQuotas class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGINGESTQUOTAS_HH_
+#define _DWMMCLOGINGESTQUOTAS_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DwmMclogConfig.hh"
+#include "DwmMclogMessage.hh"
+#include "DwmMclogMessageFilterDriver.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Per-origin ingest quotas, so one noisy application or host can't
+    //!  crowd everyone else out of mclogd's queues.  Each configured
+    //!  quota (see QuotaConfig) gives every origin (host and ident) whose
+    //!  messages pass its filter a token bucket of its own.  A message is
+    //!  subject to the first quota whose filter it passes, if any.  Also
+    //!  counts the messages admitted and suppressed from each origin, for
+    //!  a periodic top talkers report.  Threadsafe.
+    //------------------------------------------------------------------------
+    class IngestQuotas
+    {
+    public:
+      //! Maximum origins tracked per quota and for talker counts.
+      static constexpr size_t  k_maxOrigins = 4096;
+      
+      //----------------------------------------------------------------------
+      //!  Message counts for one origin since the previous Harvest().
+      //----------------------------------------------------------------------
+      struct Talker
+      {
+        std::string  origin;
+        uint64_t     admitted   = 0;
+        uint64_t     suppressed = 0;
+
+        uint64_t Total() const
+        { return (admitted + suppressed); }
+      };
+
+      //----------------------------------------------------------------------
+      //!  Origin used once we're tracking k_maxOrigins distinct origins.
+      //----------------------------------------------------------------------
+      static inline const std::string  k_otherOrigin = "(other)";
+      
+      //----------------------------------------------------------------------
+      //!  Default constructor.  No quotas.
+      //----------------------------------------------------------------------
+      IngestQuotas();
+
+      IngestQuotas(const IngestQuotas &) = delete;
+      IngestQuotas & operator = (const IngestQuotas &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Replaces our quotas with @c quotas.  Every origin starts with a
+      //!  full bucket.
+      //----------------------------------------------------------------------
+      void Configure(const std::vector<QuotaConfig> & quotas);
+
+      //----------------------------------------------------------------------
+      //!  Returns true if @c msg is within its origin's quota, false if
+      //!  it should be suppressed.
+      //----------------------------------------------------------------------
+      bool Admit(const Message & msg);
+
+      //----------------------------------------------------------------------
+      //!  Returns the counts of every origin since the last call, most
+      //!  talkative first, and resets them.
+      //----------------------------------------------------------------------
+      std::vector<Talker> Harvest();
+
+      //----------------------------------------------------------------------
+      //!  Returns the origin key of @c msg: "host/ident".
+      //----------------------------------------------------------------------
+      static std::string Origin(const Message & msg);
+      
+    private:
+      using Clock = std::chrono::steady_clock;
+
+      struct Bucket
+      {
+        double             tokens;
+        Clock::time_point  last;
+      };
+      
+      struct Quota
+      {
+        std::unique_ptr<MessageFilterDriver>     filter;
+        double                                   rate;
+        double                                   burst;
+        std::unordered_map<std::string,Bucket>   buckets;
+      };
+
+      std::mutex                               _mtx;
+      std::vector<Quota>                       _quotas;
+      std::unordered_map<std::string,Talker>   _talkers;
+
+      static bool TakeToken(Quota & quota, const std::string & origin,
+                            Clock::time_point now);
+      void Count(const std::string & origin, bool admitted);
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGINGESTQUOTAS_HH_
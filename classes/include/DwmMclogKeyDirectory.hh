@@ -0,0 +1,118 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogKeyDirectory.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::KeyDirectory class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGKEYDIRECTORY_HH_
+#define _DWMMCLOGKEYDIRECTORY_HH_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "DwmCredenceKeyStash.hh"
+#include "DwmCredenceKnownKeys.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  The Credence key material in a key directory (our Ed25519 key pair
+    //!  and the known_keys file), loaded once and shared by all key
+    //!  exchanges.  Get() returns the current instance for a directory,
+    //!  replacing it with a freshly loaded one when the key files change
+    //!  (detected with inotify on Linux, else by checking modification
+    //!  times at most once per second).  An instance is never modified
+    //!  after loading except for its lookup index, so holders of an old
+    //!  instance are unaffected by a reload.
+    //------------------------------------------------------------------------
+    class KeyDirectory
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Returns the current key material for @c keyDir.
+      //----------------------------------------------------------------------
+      static std::shared_ptr<KeyDirectory> Get(const std::string & keyDir);
+
+      //----------------------------------------------------------------------
+      //!  Returns @c keyDir with a leading '~' replaced by $HOME.  Returns
+      //!  an empty string if @c keyDir is empty or $HOME is needed but not
+      //!  set.
+      //----------------------------------------------------------------------
+      static std::string ExpandedPath(const std::string & keyDir);
+      
+      //----------------------------------------------------------------------
+      //!  Constructor.  Loads the key material from @c keyDir.
+      //----------------------------------------------------------------------
+      explicit KeyDirectory(const std::string & keyDir);
+
+      KeyDirectory(const KeyDirectory &) = delete;
+      KeyDirectory & operator = (const KeyDirectory &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Returns true if our Ed25519 key pair was loaded.
+      //----------------------------------------------------------------------
+      bool HaveMyKeys() const
+      { return _haveMyKeys; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns our Ed25519 key pair.  Only valid if HaveMyKeys().
+      //----------------------------------------------------------------------
+      const Credence::Ed25519KeyPair & MyKeys() const
+      { return _myKeys; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the public key of @c id from known_keys, or an empty
+      //!  string if @c id is not known.  Threadsafe.
+      //----------------------------------------------------------------------
+      std::string FindKnownKey(const std::string & id);
+      
+    private:
+      bool                                          _haveMyKeys;
+      Credence::Ed25519KeyPair                      _myKeys;
+      std::mutex                                    _mtx;
+      Credence::KnownKeys                           _knownKeys;
+      std::unordered_map<std::string,std::string>   _index;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGKEYDIRECTORY_HH_
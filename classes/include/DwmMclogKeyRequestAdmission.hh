@@ -0,0 +1,191 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogKeyRequestAdmission.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::KeyRequestAdmission class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGKEYREQUESTADMISSION_HH_
+#define _DWMMCLOGKEYREQUESTADMISSION_HH_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "DwmMclogUdpEndpoint.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Decides whether a key request from a new client may create
+    //!  per-client state in a KeyRequestListener.  Before we generate a
+    //!  key pair for a client, the client must echo a stateless cookie
+    //!  (an HMAC over its address, port and public KX key, keyed with a
+    //!  secret we rotate every k_secretLifetime).  This keeps a spoofed
+    //!  source address from costing us anything more than one reply
+    //!  that is smaller than the request.  Clients that do echo a valid
+    //!  cookie are then subject to a per-address token bucket and a cap
+    //!  on concurrent handshakes.
+    //!
+    //!  Not threadsafe except for Harvest(), which may be called from
+    //!  any thread.
+    //------------------------------------------------------------------------
+    class KeyRequestAdmission
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Prefix of the cookie reply's value, so a client can tell it
+      //!  apart from the server's public KX key.
+      //----------------------------------------------------------------------
+      static constexpr std::string_view  k_cookieTag{"MCCK"};
+      static constexpr size_t            k_cookieLen = 16;
+      static constexpr std::chrono::seconds  k_secretLifetime{30};
+      static constexpr double            k_defaultRate = 1.0;
+      static constexpr double            k_defaultBurst = 5.0;
+      static constexpr size_t            k_defaultMaxHandshakes = 64;
+      static constexpr size_t            k_maxTrackedAddrs = 4096;
+      
+      //----------------------------------------------------------------------
+      //!  Admission decision for a packet from a client that has no
+      //!  state in the listener.
+      //----------------------------------------------------------------------
+      enum class Verdict {
+        e_admit,       //!< create client state and process the packet
+        e_sendCookie,  //!< send the cookie reply and discard the packet
+        e_drop         //!< discard the packet
+      };
+
+      //----------------------------------------------------------------------
+      //!  Admission counts since the previous Harvest().
+      //----------------------------------------------------------------------
+      struct Counts
+      {
+        uint64_t  cookiesSent  = 0;
+        uint64_t  badCookies   = 0;
+        uint64_t  malformed    = 0;
+        uint64_t  rateLimited  = 0;
+        uint64_t  overCapacity = 0;
+        uint64_t  admitted     = 0;
+
+        //--------------------------------------------------------------------
+        //!  Returns the number of requests dropped after a cookie check
+        //!  (malformed, rate limited or over capacity).
+        //--------------------------------------------------------------------
+        uint64_t Rejected() const
+        { return (malformed + rateLimited + overCapacity); }
+
+        //--------------------------------------------------------------------
+        //!  Returns a human-readable summary of the counts.
+        //--------------------------------------------------------------------
+        std::string Summary() const;
+      };
+      
+      //----------------------------------------------------------------------
+      //!  Construct.  @c rate is the sustained number of handshakes per
+      //!  second permitted from a single address, @c burst the number
+      //!  permitted back to back.  @c maxHandshakes is the maximum number
+      //!  of concurrent handshakes.
+      //----------------------------------------------------------------------
+      KeyRequestAdmission(double rate = k_defaultRate,
+                          double burst = k_defaultBurst,
+                          size_t maxHandshakes = k_defaultMaxHandshakes);
+
+      KeyRequestAdmission(const KeyRequestAdmission &) = delete;
+      KeyRequestAdmission & operator = (const KeyRequestAdmission &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Decides what to do with the first packet of a handshake from
+      //!  @c src.  @c activeHandshakes is the caller's current number of
+      //!  client states.  On e_sendCookie, @c reply holds the datagram
+      //!  to send back to @c src.
+      //----------------------------------------------------------------------
+      Verdict Admit(const UdpEndpoint & src, const char *buf, size_t buflen,
+                    size_t activeHandshakes, std::string & reply);
+
+      //----------------------------------------------------------------------
+      //!  Returns true if @c value (the value of the first ShortString
+      //!  in a reply to our KX key) is a cookie, in which case the
+      //!  cookie is stored in @c cookie.
+      //----------------------------------------------------------------------
+      static bool IsCookieReply(const std::string & value,
+                                std::string & cookie);
+      
+      //----------------------------------------------------------------------
+      //!  Returns the counts since the last call to Harvest() and resets
+      //!  them.
+      //----------------------------------------------------------------------
+      Counts Harvest();
+      
+    private:
+      using Clock = std::chrono::steady_clock;
+      
+      struct Bucket
+      {
+        double             tokens;
+        Clock::time_point  last;
+      };
+
+      double                                   _rate;
+      double                                   _burst;
+      size_t                                   _maxHandshakes;
+      std::string                              _secret;
+      std::string                              _prevSecret;
+      Clock::time_point                        _secretTime;
+      std::unordered_map<std::string,Bucket>   _buckets;
+      std::atomic<uint64_t>                    _cookiesSent;
+      std::atomic<uint64_t>                    _badCookies;
+      std::atomic<uint64_t>                    _malformed;
+      std::atomic<uint64_t>                    _rateLimited;
+      std::atomic<uint64_t>                    _overCapacity;
+      std::atomic<uint64_t>                    _admitted;
+
+      void RotateSecret(Clock::time_point now);
+      std::string Cookie(const std::string & secret, const UdpEndpoint & src,
+                         const std::string & kx) const;
+      bool ValidCookie(const UdpEndpoint & src, const std::string & kx,
+                       const std::string & cookie) const;
+      bool TakeToken(const UdpEndpoint & src, Clock::time_point now);
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGKEYREQUESTADMISSION_HH_
@@ -52,6 +52,10 @@ extern "C" {
 
 #include "DwmCredenceKXKeyPair.hh"
 #include "DwmCredenceKeyStash.hh"
+#include "DwmMclogCipherSuite.hh"
+#include "DwmMclogMessageBlock.hh"
+#include "DwmMclogPacketSummary.hh"
+#include "DwmMclogPayloadCompressor.hh"
 #include "DwmMclogUdpEndpoint.hh"
 
 namespace Dwm {
@@ -71,10 +75,13 @@ namespace Dwm {
       
       //----------------------------------------------------------------------
       //!  Construct with a pointer to the path of our Credence key storage
-      //!  directory and a pointer to the multicast decryption key.
+      //!  directory, a pointer to the multicast decryption key and a
+      //!  pointer to the payload compression dictionary (@c nullptr if
+      //!  we don't compress).
       //----------------------------------------------------------------------
       KeyRequestClientState(const std::string *keyDir,
-                            const std::string *mcastKey);
+                            const std::string *mcastKey,
+                            const std::string *dictionary = nullptr);
 
       //----------------------------------------------------------------------
       //!  Destructor.
@@ -137,6 +144,35 @@ namespace Dwm {
       //----------------------------------------------------------------------
       bool Success()
       { return (_state == &KeyRequestClientState::IDSent); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the mask of cipher suites the client can decrypt (see
+      //!  CipherSuiteBit()).  Clients that predate cipher suite
+      //!  negotiation only support XChaCha20-Poly1305.
+      //----------------------------------------------------------------------
+      uint8_t TheirCipherSuites() const
+      { return _theirSuites; }
+
+      //----------------------------------------------------------------------
+      //!  Returns true if the client can decompress payloads compressed
+      //!  by a PayloadCompressor.
+      //----------------------------------------------------------------------
+      bool TheirCompression() const
+      { return (_theirPayloadFormats & PayloadCompressor::k_zstd); }
+
+      //----------------------------------------------------------------------
+      //!  Returns true if the client can read payloads holding
+      //!  MessageBlocks.
+      //----------------------------------------------------------------------
+      bool TheirMessageBlocks() const
+      { return (_theirPayloadFormats & MessageBlock::k_capability); }
+
+      //----------------------------------------------------------------------
+      //!  Returns true if the client can read packets carrying a
+      //!  PacketSummary.
+      //----------------------------------------------------------------------
+      bool TheirSummaries() const
+      { return (_theirPayloadFormats & PacketSummary::k_capability); }
       
     private:
       uint16_t                    _port;
@@ -146,8 +182,11 @@ namespace Dwm {
       Credence::ShortString<255>  _theirKX;
       std::string                 _sharedKey;
       std::string                 _theirId;
+      uint8_t                     _theirSuites;
+      uint8_t                     _theirPayloadFormats;
       const std::string          *_keyDir;
       const std::string          *_mcastKey;
+      const std::string          *_dictionary;
       
       void ChangeState(State newState, const UdpEndpoint & src);
       bool SendIdAndSig(int fd, const UdpEndpoint & dst);
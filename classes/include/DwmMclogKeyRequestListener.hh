@@ -40,12 +40,18 @@
 #ifndef _DWMMCLOGKEYREQUESTLISTENER_HH_
 #define _DWMMCLOGKEYREQUESTLISTENER_HH_
 
+#include <atomic>
 #include <cstdint>
+#include <ctime>
 #include <deque>
-#include <map>
+#include <functional>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
+#include "DwmMclogKeyRequestAdmission.hh"
 #include "DwmMclogKeyRequestClientState.hh"
+#include "DwmMclogTimerWheel.hh"
 #include "DwmMclogUdpEndpoint.hh"
 
 namespace Dwm {
@@ -54,17 +60,35 @@ namespace Dwm {
 
     //------------------------------------------------------------------------
     //!  Encapsulates a thread that handles requests for a multicast
-    //!  decryption key.  Only used by mclogd.
+    //!  decryption key.  Only used by mclogd.  NACKs from multicast
+    //!  receivers (see Nack) arrive on the same sockets and are passed
+    //!  to a NackHandler.
     //------------------------------------------------------------------------
     class KeyRequestListener
     {
     public:
+      //! Called with the socket descriptor a NACK arrived on, the sender
+      //! of the NACK and the NACK datagram.
+      using NackHandler = std::function<void(int fd, const UdpEndpoint & src,
+                                             const char *buf, size_t buflen)>;
+      
+      //! How long a client lacking our best cipher suite holds us to
+      //! XChaCha20-Poly1305 (or a client that can't decompress or read
+      //! MessageBlocks or PacketSummary instances holds us to packets it
+      //! can read) after its key request.
+      static constexpr time_t  k_limitedPeerHold = 24 * 60 * 60;
+      //! How long a client's state is kept after its last state change.
+      static constexpr time_t  k_clientTimeout = 5;
+      
       //----------------------------------------------------------------------
       //!  Default constructor.
       //----------------------------------------------------------------------
       KeyRequestListener()
-          : _keyDir(nullptr), _mcastKey(nullptr), _fd(-1), _fd6(-1),
-            _thread(), _run(false), _clients(), _clientsDone()
+          : _keyDir(nullptr), _mcastKey(nullptr), _dictionary(nullptr),
+            _fds(), _fds6(), _thread(), _run(false), _admission(),
+            _lastLimitedPeer(0), _lastNoCompressPeer(0),
+            _lastNoBlockPeer(0), _lastNoSummaryPeer(0), _clients(),
+            _clientsDone(), _clientExpiry(), _expired(), _nackHandler()
       {
         _stopfds[0] = -1;
         _stopfds[1] = -1;
@@ -76,32 +100,87 @@ namespace Dwm {
       ~KeyRequestListener();
 
       //----------------------------------------------------------------------
-      //!  Start handling key requests arriving on @c fd and @c fd6.
+      //!  Start handling key requests arriving on the IPv4 sockets @c fds
+      //!  and the IPv6 sockets @c fds6 (one of each per multicast
+      //!  channel).
       //!  @c keyDir is a pointer to the path to the directory containing our
       //!  Credence key files.  @c mcastKey is a pointer to the multicast
-      //!  decryption key.
+      //!  decryption key.  @c dictionary is a pointer to the payload
+      //!  compression dictionary handed out with the key, or @c nullptr
+      //!  if we don't compress.  NACKs are passed to @c nackHandler if it
+      //!  is set, else ignored.
       //----------------------------------------------------------------------
-      bool Start(int fd, int fd6, const std::string *keyDir,
-                 const std::string *mcastKey);
+      bool Start(const std::vector<int> & fds, const std::vector<int> & fds6,
+                 const std::string *keyDir,
+                 const std::string *mcastKey,
+                 const std::string *dictionary = nullptr,
+                 NackHandler nackHandler = nullptr);
 
       //----------------------------------------------------------------------
       //!  Stop handling key requests.
       //----------------------------------------------------------------------
       bool Stop();
+
+      //----------------------------------------------------------------------
+      //!  Returns the admission counts (cookies, rate limiting, handshake
+      //!  cap) since the previous call and resets them.
+      //----------------------------------------------------------------------
+      KeyRequestAdmission::Counts HarvestCounts()
+      { return _admission.Harvest(); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the cipher suite to use for multicast: the best suite we
+      //!  support, unless a client that completed a key request in the
+      //!  last k_limitedPeerHold seconds can't decrypt it.
+      //----------------------------------------------------------------------
+      CipherSuite MulticastCipherSuite() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns true if we may compress multicast payloads: we have a
+      //!  dictionary pointer and no client that completed a key request
+      //!  in the last k_limitedPeerHold seconds lacks compression.
+      //----------------------------------------------------------------------
+      bool MulticastCompression() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns true if we may encode multicast payloads as
+      //!  MessageBlocks: no client that completed a key request in the
+      //!  last k_limitedPeerHold seconds can't read them.
+      //----------------------------------------------------------------------
+      bool MulticastMessageBlocks() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns true if multicast packets may carry a PacketSummary: no
+      //!  client that completed a key request in the last
+      //!  k_limitedPeerHold seconds can't read them.
+      //----------------------------------------------------------------------
+      bool MulticastSummaries() const;
       
     private:
       const std::string  *_keyDir;
       const std::string  *_mcastKey;
-      int                 _fd;
-      int                 _fd6;
+      const std::string  *_dictionary;
+      std::vector<int>    _fds;
+      std::vector<int>    _fds6;
       int                 _stopfds[2];
       std::thread         _thread;
       std::atomic<bool>   _run;
+      KeyRequestAdmission _admission;
+      std::atomic<time_t> _lastLimitedPeer;
+      std::atomic<time_t> _lastNoCompressPeer;
+      std::atomic<time_t> _lastNoBlockPeer;
+      std::atomic<time_t> _lastNoSummaryPeer;
       
-      std::map<UdpEndpoint,KeyRequestClientState>               _clients;
+      std::unordered_map<UdpEndpoint,KeyRequestClientState>     _clients;
       std::deque<std::pair<UdpEndpoint,KeyRequestClientState>>  _clientsDone;
+      TimerWheel<UdpEndpoint>                                   _clientExpiry;
+      std::vector<UdpEndpoint>                                  _expired;
+      NackHandler                                               _nackHandler;
       
       void ClearExpired();
+      void ScheduleExpiry(const UdpEndpoint & endpoint, time_t lastChange);
+      void HandlePacket(int fd, const UdpEndpoint & src, char *buf,
+                        size_t buflen);
       void Run();
       bool Listen();
     };
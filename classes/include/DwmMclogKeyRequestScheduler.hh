@@ -0,0 +1,208 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogKeyRequestScheduler.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::KeyRequestScheduler class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGKEYREQUESTSCHEDULER_HH_
+#define _DWMMCLOGKEYREQUESTSCHEDULER_HH_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DwmMclogKeyRequesterState.hh"
+#include "DwmMclogMulticastSourceKey.hh"
+#include "DwmMclogUdpEndpoint.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Runs multicast decryption key requests for any number of multicast
+    //!  sources in a single thread, using one non-blocking socket per
+    //!  address family.  At most a fixed number of handshakes are in
+    //!  flight at once; the rest wait their turn.  A failed or timed out
+    //!  handshake is retried with exponential backoff and jitter, up to
+    //!  a fixed number of attempts.  When a request completes (with or
+    //!  without a key), its callback is called from the scheduler's
+    //!  thread.
+    //------------------------------------------------------------------------
+    class KeyRequestScheduler
+    {
+    public:
+      using Clock = std::chrono::steady_clock;
+      using Callback = std::function<void(const MulticastSourceKey &)>;
+
+      //! Default maximum number of handshakes in flight.
+      static constexpr size_t                     k_defaultMaxActive = 32;
+      //! Default time allowed for a handshake to complete.
+      static constexpr std::chrono::milliseconds  k_defaultTimeout{3000};
+      //! Default number of handshake attempts per request.
+      static constexpr uint32_t                   k_defaultMaxAttempts = 5;
+      //! Delay before the first retry.  Doubles with each retry.
+      static constexpr std::chrono::milliseconds  k_initialBackoff{1000};
+      //! Maximum delay between retries.
+      static constexpr std::chrono::milliseconds  k_maxBackoff{30000};
+      
+      //----------------------------------------------------------------------
+      //!  Construct with a pointer to the path of our Credence key
+      //!  directory, the maximum number of handshakes in flight
+      //!  @c maxActive, the time allowed for each handshake @c timeout and
+      //!  the number of handshake attempts per request @c maxAttempts.
+      //----------------------------------------------------------------------
+      KeyRequestScheduler(const std::string *keyDir,
+                          size_t maxActive = k_defaultMaxActive,
+                          std::chrono::milliseconds timeout
+                          = k_defaultTimeout,
+                          uint32_t maxAttempts = k_defaultMaxAttempts);
+
+      KeyRequestScheduler(const KeyRequestScheduler &) = delete;
+      KeyRequestScheduler & operator = (const KeyRequestScheduler &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Destructor.  Stops the thread without calling the callbacks of
+      //!  outstanding requests.
+      //----------------------------------------------------------------------
+      ~KeyRequestScheduler();
+      
+      //----------------------------------------------------------------------
+      //!  Schedules a request for the decryption key of the multicast
+      //!  source at @c srcEndpoint.  @c callback is called with the result
+      //!  (whose Value() is empty on failure) unless the request is
+      //!  cancelled first.  The callback is called from the scheduler's
+      //!  thread without its internal mutex held, but it must not call
+      //!  Cancel().  Returns the ID of the request (never 0), or 0 if the
+      //!  scheduler's thread could not be started.
+      //----------------------------------------------------------------------
+      uint64_t Request(const UdpEndpoint & srcEndpoint, Callback && callback);
+
+      //----------------------------------------------------------------------
+      //!  Cancels the request with the given @c requestId.  On return, the
+      //!  request's callback has not been called and will not be called,
+      //!  or has already completed.  If the callback is running, waits
+      //!  for it to return.
+      //----------------------------------------------------------------------
+      void Cancel(uint64_t requestId);
+
+      //----------------------------------------------------------------------
+      //!  Stops the scheduler's thread.  Outstanding requests are
+      //!  discarded without calling their callbacks.
+      //----------------------------------------------------------------------
+      void Stop();
+      
+      //----------------------------------------------------------------------
+      //!  Returns the number of handshakes in flight.
+      //----------------------------------------------------------------------
+      size_t Active() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of requests waiting to start (or retry) a
+      //!  handshake.
+      //----------------------------------------------------------------------
+      size_t Waiting() const;
+      
+    private:
+      struct Entry
+      {
+        using SysTime = MulticastSourceKey::Clock::time_point;
+        
+        uint64_t                            id;
+        UdpEndpoint                         endpoint;
+        Callback                            callback;
+        uint32_t                            attempts;
+        Clock::time_point                   notBefore;
+        Clock::time_point                   deadline;
+        SysTime                             requested;
+        std::unique_ptr<KeyRequesterState>  state;
+      };
+
+      //  A finished request whose callback is yet to be called.
+      struct Completion
+      {
+        uint64_t            id;
+        Callback            callback;
+        MulticastSourceKey  key;
+      };
+      
+      const std::string                 *_keyDir;
+      size_t                             _maxActive;
+      std::chrono::milliseconds          _timeout;
+      uint32_t                           _maxAttempts;
+      mutable std::mutex                 _mtx;
+      uint64_t                           _nextId;
+      std::deque<Entry>                  _waiting;
+      std::map<UdpEndpoint,Entry>        _active;
+      std::vector<Completion>            _completed;
+      std::mutex                         _callbackMtx;
+      std::mt19937                       _rng;
+      int                                _fd;
+      int                                _fd6;
+      int                                _wakefds[2];
+      std::atomic<bool>                  _run;
+      std::thread                        _thread;
+
+      bool Start();
+      bool OpenSockets();
+      void CloseSockets();
+      void Wake();
+      void Run();
+      void StartHandshakes(Clock::time_point now);
+      bool SendKX(Entry & entry);
+      void Receive(int fd);
+      void ExpireHandshakes(Clock::time_point now);
+      void Finish(std::map<UdpEndpoint,Entry>::iterator it, bool success);
+      void Retry(Entry && entry, Clock::time_point now);
+      void RunCallbacks();
+      Clock::duration Backoff(uint32_t attempts);
+      Clock::time_point NextWakeTime(Clock::time_point now) const;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGKEYREQUESTSCHEDULER_HH_
@@ -138,6 +138,14 @@ namespace Dwm {
       //----------------------------------------------------------------------
       const std::string & McastKey() const
       { return _mcastKey; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the payload compression dictionary the sender gave us
+      //!  with the multicast key.  Empty if it didn't give us one.  Only
+      //!  valid when state is Success().
+      //----------------------------------------------------------------------
+      const std::string & Dictionary() const
+      { return _dictionary; }
       
     private:
       std::string                _keyDir;
@@ -149,7 +157,10 @@ namespace Dwm {
       std::string                _sharedKey;
       std::string                _theirId;
       std::string                _mcastKey;
+      std::string                _dictionary;
       
+      bool SendKXWithCookie(int fd, const UdpEndpoint & dst,
+                            const std::string & cookie);
       bool SendIdAndSig(int fd, const UdpEndpoint & dst);
       bool IsValidUser(const std::string & id, const std::string & signedMsg);
     };
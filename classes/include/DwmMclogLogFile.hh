@@ -42,11 +42,14 @@
 
 #include <chrono>
 #include <filesystem>
-#include <fstream>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include "DwmMclogCompressionPool.hh"
 #include "DwmMclogMessageSink.hh"
 #include "DwmMclogFileFormat.hh"
+#include "DwmMclogFlushPolicy.hh"
 #include "DwmMclogRollInterval.hh"
 
 namespace Dwm {
@@ -56,11 +59,20 @@ namespace Dwm {
     //------------------------------------------------------------------------
     //!  Encapsulates a log file and its archives.  An instance of this
     //!  class may be used as a sink of the Logger.
+    //!
+    //!  Messages given to Append() are buffered and written with a single
+    //!  writev() when the FlushPolicy says so, or when Flush() is called.
+    //!  Process() writes immediately.
+    //!
+    //!  When the file is rolled, it's compressed by the CompressionPool
+    //!  set with Compressor(), or in the calling thread if none is set.
     //------------------------------------------------------------------------
     class LogFile
       : public MessageSink
     {
     public:
+      using Clock = std::chrono::steady_clock;
+      
       //----------------------------------------------------------------------
       //!  Delete the default constructor.
       //----------------------------------------------------------------------
@@ -128,6 +140,28 @@ namespace Dwm {
       //!  
       //----------------------------------------------------------------------
       const std::string & Compression(const std::string & compress);
+
+      //----------------------------------------------------------------------
+      //!  Returns the flush policy.
+      //----------------------------------------------------------------------
+      const FlushPolicy & Flushing() const;
+
+      //----------------------------------------------------------------------
+      //!  Sets and returns the flush policy.
+      //----------------------------------------------------------------------
+      const FlushPolicy & Flushing(const FlushPolicy & flushPolicy);
+
+      //----------------------------------------------------------------------
+      //!  Returns the pool that compresses rolled files.
+      //----------------------------------------------------------------------
+      CompressionPool *Compressor() const;
+
+      //----------------------------------------------------------------------
+      //!  Sets and returns the pool that compresses rolled files.  May be
+      //!  nullptr (the default), to compress in the thread that rolls the
+      //!  file.  The pool must outlive the LogFile.
+      //----------------------------------------------------------------------
+      CompressionPool *Compressor(CompressionPool *compressor);
       
       //----------------------------------------------------------------------
       //!  Opens the log file.  Returns true on success, false on failure.
@@ -140,23 +174,55 @@ namespace Dwm {
       void Close();
 
       //----------------------------------------------------------------------
-      //!  Processes the given @c msg.  Returns true on success, false on
-      //!  failure.
+      //!  Writes the given @c msg (and anything already buffered).  Returns
+      //!  true on success, false on failure.
       //----------------------------------------------------------------------
       bool Process(const Message & msg) override;
 
+      //----------------------------------------------------------------------
+      //!  Buffers the given @c msg, writing the buffer if it has reached
+      //!  the flush policy's size.  Returns true on success, false on
+      //!  failure.
+      //----------------------------------------------------------------------
+      bool Append(const Message & msg);
+
+      //----------------------------------------------------------------------
+      //!  Writes any buffered messages, and syncs them if the flush policy
+      //!  says to.  Returns true on success, false on failure.
+      //----------------------------------------------------------------------
+      bool Flush();
+
+      //----------------------------------------------------------------------
+      //!  Called at the end of a batch of Append() calls.  Writes the
+      //!  buffered messages if the flush policy is per batch or if they
+      //!  are due at @c now.  Returns true on success, false on failure.
+      //----------------------------------------------------------------------
+      bool EndBatch(Clock::time_point now = Clock::now());
+
+      //----------------------------------------------------------------------
+      //!  Returns when the buffered messages are due to be written, or
+      //!  Clock::time_point::max() if nothing is buffered.
+      //----------------------------------------------------------------------
+      Clock::time_point FlushDeadline() const;
+      
     private:
-      std::mutex             _mtx;
-      std::filesystem::path  _path;
-      mode_t                 _permissions;
-      uint32_t               _keep;
-      std::ofstream          _ofs;
-      RollInterval           _rollInterval;
-      int64_t                _rollSize;
-      uid_t                  _user;
-      gid_t                  _group;
-      std::string            _compress;
-      FileFormat             _format;
+      mutable std::mutex        _mtx;
+      std::filesystem::path     _path;
+      mode_t                    _permissions;
+      uint32_t                  _keep;
+      int                       _fd;
+      int64_t                   _size;
+      RollInterval              _rollInterval;
+      int64_t                   _rollSize;
+      uid_t                     _user;
+      gid_t                     _group;
+      std::string               _compress;
+      FileFormat                _format;
+      FlushPolicy               _flushPolicy;
+      std::vector<std::string>  _pending;
+      uint64_t                  _pendingBytes;
+      Clock::time_point         _pendingSince;
+      CompressionPool          *_compressor;
       
       //----------------------------------------------------------------------
       //!  
@@ -184,6 +250,9 @@ namespace Dwm {
       bool EnsureParentDirectory() const;
       bool SetPermissions() const;
       bool SetOwnership() const;
+      bool AppendNoLock(const Message & msg);
+      bool FlushNoLock();
+      void CloseNoLock();
       bool RollCriteriaMet(const Message & msg);
       void RollArchives() const;
       void RollCurrent();
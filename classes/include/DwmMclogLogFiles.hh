@@ -40,9 +40,12 @@
 #ifndef _DWMMCLOGLOGFILES_HH_
 #define _DWMMCLOGLOGFILES_HH_
 
+#include <deque>
 #include <map>
+#include <memory>
 #include <mutex>
 
+#include "DwmMclogCompressionPool.hh"
 #include "DwmMclogMessageFilterDriver.hh"
 #include "DwmMclogLogFile.hh"
 #include "DwmMclogMessageSink.hh"
@@ -54,7 +57,8 @@ namespace Dwm {
 
     //------------------------------------------------------------------------
     //!  Encapsulates multiple log files, with configuration determining
-    //!  which messages are logged to which files.
+    //!  which messages are logged to which files.  Rolled log files are
+    //!  compressed by a CompressionPool shared by all of the log files.
     //------------------------------------------------------------------------
     class LogFiles
       : public MessageSink
@@ -87,9 +91,36 @@ namespace Dwm {
       bool Process(const Message & msg) override;
 
       //----------------------------------------------------------------------
-      //!  Close the LogFiles.
+      //!  Process (log) the given batch of messages @c msgs.  Each log
+      //!  file's messages are buffered and written per its FlushPolicy,
+      //!  typically with one writev() per file.  Returns true on success,
+      //!  false on failure.
+      //----------------------------------------------------------------------
+      bool Process(const std::deque<Message> & msgs);
+
+      //----------------------------------------------------------------------
+      //!  Writes the buffered messages of every log file whose messages
+      //!  are due at @c now.  Returns true on success, false on failure.
+      //----------------------------------------------------------------------
+      bool Flush(LogFile::Clock::time_point now = LogFile::Clock::now());
+
+      //----------------------------------------------------------------------
+      //!  Returns the earliest time buffered messages are due to be
+      //!  written, or LogFile::Clock::time_point::max() if nothing is
+      //!  buffered.
+      //----------------------------------------------------------------------
+      LogFile::Clock::time_point FlushDeadline() const;
+
+      //----------------------------------------------------------------------
+      //!  Close the LogFiles.  Rolled files already queued for compression
+      //!  are still compressed.
       //----------------------------------------------------------------------
       void Close();
+
+      //----------------------------------------------------------------------
+      //!  Returns the rolled file compression counts since the last call.
+      //----------------------------------------------------------------------
+      CompressionPool::Counts HarvestCompressions();
       
     private:
       using FilteredLogConfig =
@@ -145,7 +176,10 @@ namespace Dwm {
       std::vector<FilteredLogConfig>         _filteredLogConfigs;
       std::map<std::string,LogFile>          _logFiles;
       std::map<LogPathCacheKey,std::string>  _logPathCache;
+      std::unique_ptr<CompressionPool>       _compressor;
 
+      LogFile *OpenLogFile(const std::string & path,
+                           const LogFileConfig & logFileConfig);
       std::string LogPathFromCache(const Message & msg,
                                    const LogFileConfig & logFileConfig);
       std::string LogPath(const Message & msg,
@@ -171,6 +171,13 @@ namespace Dwm {
       Severity MinimumSeverity(const std::string & minSeverity)
       { return _minimumSeverity = SeverityValue(minSeverity); }
       
+      //----------------------------------------------------------------------
+      //!  Sets the batching policy of the LoopbackSender sink used when
+      //!  Open() is called with no sinks.  This may be called before or
+      //!  after Open().
+      //----------------------------------------------------------------------
+      void Batching(const BatchPolicy & batching);
+      
       //----------------------------------------------------------------------
       //!  
       //----------------------------------------------------------------------
@@ -218,6 +225,7 @@ namespace Dwm {
       std::mutex                   _sinksMtx;
       std::vector<MessageSink *>   _sinks;
       LoopbackSender              *_loopbackSender;
+      BatchPolicy                  _batching;
       OstreamSink                  _cerrSink;
       SyslogSink                  *_syslogSink;
       
@@ -40,11 +40,13 @@
 #ifndef _DWMMCLOGLOOPBACKSENDER_HH_
 #define _DWMMCLOGLOOPBACKSENDER_HH_
 
+#include <mutex>
 #include <thread>
 
 #include "DwmThreadQueue.hh"
-#include "DwmMclogMessagePacket.hh"
+#include "DwmMclogBatchPolicy.hh"
 #include "DwmMclogMessageSink.hh"
+#include "DwmMclogPacketBatch.hh"
 
 namespace Dwm {
 
@@ -87,6 +89,18 @@ namespace Dwm {
       //----------------------------------------------------------------------
       bool Process(const Message & msg) override;
 
+      //----------------------------------------------------------------------
+      //!  Returns the policy used to decide when to send a partially
+      //!  filled packet.
+      //----------------------------------------------------------------------
+      BatchPolicy Batching() const;
+
+      //----------------------------------------------------------------------
+      //!  Sets the policy used to decide when to send a partially filled
+      //!  packet.  Takes effect for the next message processed.
+      //----------------------------------------------------------------------
+      void Batching(const BatchPolicy & batching);
+
     private:
       std::atomic<bool>       _run;
       int                     _ofd;
@@ -94,10 +108,14 @@ namespace Dwm {
       std::thread             _thread;
       Clock::time_point       _nextSendTime;
       std::atomic<bool>       _running;
+      mutable std::mutex      _batchingMtx;
+      BatchPolicy             _batching;
+      size_t                  _packetLen;
       
       void Run();
       bool OpenSocket();
-      bool SendPacket(MessagePacket & pkt);
+      bool SendBatch(PacketBatch & batch);
+      void FlushBatch(PacketBatch & batch);
       void SetSndBuf(int fd);
     };
     
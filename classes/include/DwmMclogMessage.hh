@@ -55,6 +55,9 @@ namespace Dwm {
     class Message
     {
     public:
+      //! Maximum length of the message text.
+      static constexpr size_t  k_maxTextLen = 1500;
+      
       //----------------------------------------------------------------------
       //!  Default constructor
       //----------------------------------------------------------------------
@@ -163,7 +166,7 @@ namespace Dwm {
       
     private:
       MessageHeader                _header;
-      Credence::ShortString<1500>  _message;
+      Credence::ShortString<k_maxTextLen>  _message;
     };
     
   }  // namespace Mclog
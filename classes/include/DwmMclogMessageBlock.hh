@@ -0,0 +1,139 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogMessageBlock.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::MessageBlock class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGMESSAGEBLOCK_HH_
+#define _DWMMCLOGMESSAGEBLOCK_HH_
+
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+#include "DwmMclogMessage.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Encodes a run of Messages compactly for a packet payload.  A
+    //!  block starts with a base Timestamp followed by k_marker where a
+    //!  Message would have its facility, then holds one entry per message
+    //!  to the end of the payload.  Each entry has:
+    //!
+    //!  - an index into the block's origin table; an index one past the
+    //!    end of the table is followed by the MessageOrigin it adds
+    //!  - the facility and severity, OR'ed as in a syslog priority
+    //!  - the timestamp, as an encoded (zigzag) offset from the base
+    //!  - the message text, with an encoded length
+    //!
+    //!  Since origins are added where first used, any prefix of a block
+    //!  ending on an entry boundary is a valid block.  Readers that don't
+    //!  know about blocks stop reading the payload when they see k_marker,
+    //!  since it is not a valid facility.
+    //------------------------------------------------------------------------
+    class MessageBlock
+    {
+    public:
+      //! Marker in place of the facility of a Message.
+      static constexpr uint8_t   k_marker = 0xFE;
+      //! Bit in the payload formats a key requester says it can read.
+      static constexpr uint8_t   k_capability = 0x02;
+      //! Maximum number of origins in a block.
+      static constexpr size_t    k_maxOrigins = 255;
+      //! Maximum length of the text of a message, as for Message.
+      static constexpr uint64_t  k_maxTextLen = Message::k_maxTextLen;
+      
+      //----------------------------------------------------------------------
+      //!  Default constructor.
+      //----------------------------------------------------------------------
+      MessageBlock();
+
+      //----------------------------------------------------------------------
+      //!  Starts a new block.
+      //----------------------------------------------------------------------
+      void Clear();
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of origins in the block's origin table.
+      //----------------------------------------------------------------------
+      size_t NumOrigins() const
+      { return _origins.size(); }
+      
+      //----------------------------------------------------------------------
+      //!  Returns true if @c msg can be added to the block, i.e. its origin
+      //!  is in the origin table or there is room to add it.
+      //----------------------------------------------------------------------
+      bool Accepts(const Message & msg) const;
+      
+      //----------------------------------------------------------------------
+      //!  Writes @c msg to @c os as the next entry of the block, preceded
+      //!  by the block header if it's the first.  Returns @c os.
+      //----------------------------------------------------------------------
+      std::ostream & Write(std::ostream & os, const Message & msg);
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of bytes that would be written if we called
+      //!  Write() with @c msg.
+      //----------------------------------------------------------------------
+      uint64_t StreamedLength(const Message & msg) const;
+
+      //----------------------------------------------------------------------
+      //!  Reads a block from @c is, to the end of @c is, appending its
+      //!  messages to @c msgs.  Sets failbit on @c is if what's read is
+      //!  not a valid block, though messages read before the problem are
+      //!  kept.  Returns @c is.
+      //----------------------------------------------------------------------
+      static std::istream & Read(std::istream & is,
+                                 std::deque<Message> & msgs);
+      
+    private:
+      bool                        _started;
+      uint64_t                    _base;
+      std::vector<MessageOrigin>  _origins;
+
+      size_t FindOrigin(const MessageOrigin & origin) const;
+      uint64_t Offset(const Timestamp & timestamp) const;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGMESSAGEBLOCK_HH_
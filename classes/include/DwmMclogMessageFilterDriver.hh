@@ -77,6 +77,12 @@ namespace Dwm {
       MessageFilterParser::symbol_type next_token();
       bool is_valid();
       bool parse(const Message *msg, bool & result);
+
+      //----------------------------------------------------------------------
+      //!  Returns true if the expression tests nothing but facility and
+      //!  severity (see PacketSummaryFilter).
+      //----------------------------------------------------------------------
+      bool priority_only();
     };
     
   }  // namespace Mclog
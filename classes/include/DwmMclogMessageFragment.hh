@@ -0,0 +1,145 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogMessageFragment.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::MessageFragment class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGMESSAGEFRAGMENT_HH_
+#define _DWMMCLOGMESSAGEFRAGMENT_HH_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "DwmMclogMessage.hh"
+#include "DwmMclogTimestamp.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  A piece of a serialized Message that is too large to fit in a
+    //!  single packet.  Fragments share the packet payload with Messages;
+    //!  on the wire a fragment starts with a Timestamp followed by
+    //!  k_marker where a Message would have its facility.  Since k_marker
+    //!  is not a valid facility, readers that don't know about fragments
+    //!  stop reading the payload when they encounter one.
+    //------------------------------------------------------------------------
+    class MessageFragment
+    {
+    public:
+      //! Marker in place of the facility of a Message.
+      static constexpr uint8_t   k_marker = 0xFF;
+      //! Maximum number of fragments for one message.
+      static constexpr uint16_t  k_maxCount = 64;
+      
+      //----------------------------------------------------------------------
+      //!  Default constructor.
+      //----------------------------------------------------------------------
+      MessageFragment();
+
+      //----------------------------------------------------------------------
+      //!  Construct fragment @c index of @c count fragments of the message
+      //!  with ID @c id, holding @c data.
+      //----------------------------------------------------------------------
+      MessageFragment(uint32_t id, uint16_t index, uint16_t count,
+                      std::string && data);
+      
+      //----------------------------------------------------------------------
+      //!  Returns the ID of the message of which we are a fragment.
+      //----------------------------------------------------------------------
+      uint32_t Id() const
+      { return _id; }
+
+      //----------------------------------------------------------------------
+      //!  Returns our index in the sequence of fragments.
+      //----------------------------------------------------------------------
+      uint16_t Index() const
+      { return _index; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of fragments in the message.
+      //----------------------------------------------------------------------
+      uint16_t Count() const
+      { return _count; }
+
+      //----------------------------------------------------------------------
+      //!  Returns our piece of the serialized message.
+      //----------------------------------------------------------------------
+      const std::string & Data() const
+      { return _data; }
+      
+      //----------------------------------------------------------------------
+      //!  Reads the fragment from the given istream @c is.  Sets failbit
+      //!  on @c is if what's read is not a valid fragment.  Returns @c is.
+      //----------------------------------------------------------------------
+      std::istream & Read(std::istream & is);
+
+      //----------------------------------------------------------------------
+      //!  Writes the fragment to the given ostream @c os.  Returns @c os.
+      //----------------------------------------------------------------------
+      std::ostream & Write(std::ostream & os) const;
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of bytes that would be written if we called
+      //!  the Write() member.
+      //----------------------------------------------------------------------
+      uint64_t StreamedLength() const;
+
+      //----------------------------------------------------------------------
+      //!  Splits @c msg into fragments with ID @c id whose streamed
+      //!  lengths are no more than @c maxLen, appending them to @c frags.
+      //!  Returns false if @c maxLen is too small to hold any data or the
+      //!  message would need more than k_maxCount fragments.
+      //----------------------------------------------------------------------
+      static bool Split(const Message & msg, uint32_t id, size_t maxLen,
+                        std::vector<MessageFragment> & frags);
+      
+    private:
+      Timestamp    _timestamp;
+      uint32_t     _id;
+      uint16_t     _index;
+      uint16_t     _count;
+      std::string  _data;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGMESSAGEFRAGMENT_HH_
@@ -79,6 +79,16 @@ namespace Dwm {
             _origin(origin)
       {}
 
+      //----------------------------------------------------------------------
+      //!  Construct from the given @c timestamp, @c facility, @c severity
+      //!  and @c origin.
+      //----------------------------------------------------------------------
+      MessageHeader(const Timestamp & timestamp, Facility facility,
+                    Severity severity, const MessageOrigin & origin)
+          : _timestamp(timestamp), _facility(facility), _severity(severity),
+            _origin(origin)
+      {}
+
       //----------------------------------------------------------------------
       //!  operator ==
       //----------------------------------------------------------------------
@@ -47,6 +47,7 @@ extern "C" {
 }
 
 #include <span>
+#include <string>
 #include <version>
 
 #if defined(__cpp_lib_spanstream)
@@ -62,7 +63,10 @@ extern "C" {
 #  include "spanstream.hh"
 #endif
 
+#include "DwmIpv4Address.hh"
 #include "DwmStreamIO.hh"
+#include "DwmMclogCipherSuite.hh"
+#include "DwmMclogPacketSummary.hh"
 #include "DwmMclogUdpEndpoint.hh"
 
 namespace Dwm {
@@ -74,13 +78,24 @@ namespace Dwm {
     //!  used for network transport (including bytes needed for encryption
     //!  and AEAD).  Note that MessagePacket does NOT own the buffer and
     //!  does not participate in the lifetime of the buffer.
+    //!
+    //!  A packet encrypted with a NonceSequence may carry a PacketSummary
+    //!  after the MAC, in the clear but authenticated as associated data.
     //------------------------------------------------------------------------
     class MessagePacket
     {
     public:
       static const size_t k_nonceLen = crypto_secretbox_NONCEBYTES;
+      static_assert(k_nonceLen == NonceSequence::k_headerLen);
       static const size_t k_macLen = crypto_aead_xchacha20poly1305_ietf_ABYTES;
       static const size_t k_minPacketLen = k_nonceLen + k_macLen;
+      //! Packet length used when none is configured or discoverable.
+      static constexpr size_t k_defaultPacketLen = 1200;
+      //! Smallest packet length we'll send.
+      static constexpr size_t k_minSendPacketLen = 512;
+      //! Largest UDP payload (IPv4), hence the largest packet we'll send
+      //! and the receive buffer size needed to receive any packet.
+      static constexpr size_t k_maxPacketLen = 65507;
 
       //----------------------------------------------------------------------
       //!  Construct from the buffer @c buf of length @c buflen.  Note that
@@ -92,7 +107,8 @@ namespace Dwm {
           : _buf(buf), _buflen(buflen),
             _payload{std::span{buf + k_nonceLen,
                                buflen - (k_nonceLen + k_macLen)}},
-            _payloadLength(0)
+            _payloadLength(0), _compressed(false), _summarize(false),
+            _summary()
       { assert(_buf && (_buflen > k_minPacketLen)); }
 
       //----------------------------------------------------------------------
@@ -166,11 +182,48 @@ namespace Dwm {
       ssize_t RecvFrom(int fd, struct sockaddr_in6 *src);
 
       //----------------------------------------------------------------------
-      //!  Encrypts the packet with the given @c secretKey.  Returns true
-      //!  on success, false on failure.
+      //!  Encrypts the packet with XChaCha20-Poly1305 using the given
+      //!  @c secretKey and a random nonce.  Returns true on success, false
+      //!  on failure.
       //----------------------------------------------------------------------
       bool Encrypt(const std::string & secretKey);
 
+      //----------------------------------------------------------------------
+      //!  Encrypts the packet with the given @c secretKey, using the next
+      //!  nonce and the cipher suite from @c nonces.  Returns true on
+      //!  success, false on failure.
+      //----------------------------------------------------------------------
+      bool Encrypt(const std::string & secretKey, NonceSequence & nonces);
+
+      //----------------------------------------------------------------------
+      //!  Replaces the payload with the @c len bytes at @c data, which are
+      //!  compressed if @c compressed is true.  Returns false (leaving the
+      //!  payload alone) if @c data won't fit.
+      //----------------------------------------------------------------------
+      bool Payload(const char *data, size_t len, bool compressed);
+      
+      //----------------------------------------------------------------------
+      //!  Appends Summary() to the packet when it's encrypted with a
+      //!  NonceSequence if @c summarize is true, leaving that much less
+      //!  room for the payload.  Only takes effect if the payload is
+      //!  empty; returns true if it did.
+      //----------------------------------------------------------------------
+      bool Summarize(bool summarize);
+      
+      //----------------------------------------------------------------------
+      //!  Returns the summary of the messages in the payload, which is up
+      //!  to whoever adds them.  After Decrypt(), this is the summary the
+      //!  packet carried (empty if none).
+      //----------------------------------------------------------------------
+      PacketSummary & Summary()
+      { return _summary; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the summary of the messages in the payload.
+      //----------------------------------------------------------------------
+      const PacketSummary & Summary() const
+      { return _summary; }
+      
       //----------------------------------------------------------------------
       //!  Clears the payload of the packet.
       //----------------------------------------------------------------------
@@ -182,24 +235,110 @@ namespace Dwm {
       //!  (@c recvlen on success, -1 on failure).
       //----------------------------------------------------------------------
       ssize_t Decrypt(size_t recvlen, const std::string & secretKey);
+
+      //----------------------------------------------------------------------
+      //!  If the packet was encrypted with a NonceSequence, sets @c prefix
+      //!  and @c counter from its nonce and returns true.  Only meaningful
+      //!  after a successful Decrypt().
+      //----------------------------------------------------------------------
+      bool Sequence(std::string & prefix, uint64_t & counter) const;
       
       //----------------------------------------------------------------------
       //!  Returns true if the packet has a non-empty payload.
       //----------------------------------------------------------------------
-      bool HasPayload()
+      bool HasPayload() const
       { return _payloadLength > 0; }
 
+      //----------------------------------------------------------------------
+      //!  Returns true if the payload is compressed.  After Decrypt(), this
+      //!  reflects the flag in the nonce header.
+      //----------------------------------------------------------------------
+      bool Compressed() const
+      { return _compressed; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the largest payload the packet can hold.
+      //----------------------------------------------------------------------
+      size_t PayloadCapacity() const
+      { return _buflen - (k_minPacketLen + SummaryLen()); }
+      
+      //----------------------------------------------------------------------
+      //!  Returns a pointer to the start of the packet as sent on the wire.
+      //----------------------------------------------------------------------
+      const char *Data() const
+      { return _buf; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the length of the packet as sent on the wire.
+      //----------------------------------------------------------------------
+      size_t Length() const
+      { return k_nonceLen + k_macLen + _payloadLength + SummaryLen(); }
+
       //----------------------------------------------------------------------
       //!  Returns the payload.
       //----------------------------------------------------------------------
       std::spanstream & Payload()
       { return _payload; }
+
+      //----------------------------------------------------------------------
+      //!  Returns a pointer to the start of the payload.
+      //----------------------------------------------------------------------
+      const char *PayloadData() const
+      { return _buf + k_nonceLen; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the length of the payload.
+      //----------------------------------------------------------------------
+      size_t PayloadLength() const
+      { return _payloadLength; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the MTU of the interface named @c intfName, or 0 if it
+      //!  can't be determined.
+      //----------------------------------------------------------------------
+      static size_t InterfaceMtu(const std::string & intfName);
+
+      //----------------------------------------------------------------------
+      //!  Returns the MTU of the interface with the IPv4 address
+      //!  @c intfAddr, or 0 if it can't be determined.
+      //----------------------------------------------------------------------
+      static size_t InterfaceMtu(const Ipv4Address & intfAddr);
+
+      //----------------------------------------------------------------------
+      //!  Returns the largest packet length that will fit in a single
+      //!  datagram on a link with the given @c mtu, clamped to
+      //!  [k_minSendPacketLen, k_maxPacketLen].  @c ipv6 should be true if
+      //!  the packet will be sent via IPv6.  If @c mtu is 0, returns
+      //!  k_defaultPacketLen.
+      //----------------------------------------------------------------------
+      static size_t PacketLenForMtu(size_t mtu, bool ipv6);
+
+      //----------------------------------------------------------------------
+      //!  Returns the packet length to use when sending to the IPv4
+      //!  loopback address, based on the MTU of the loopback interface.
+      //----------------------------------------------------------------------
+      static size_t LoopbackPacketLen();
+
+      //----------------------------------------------------------------------
+      //!  If the encrypted packet @c data of length @c datalen carries a
+      //!  PacketSummary, sets @c summary from it and returns true.  The
+      //!  summary is not authenticated until the packet is decrypted.
+      //----------------------------------------------------------------------
+      static bool PeekSummary(const char *data, size_t datalen,
+                              PacketSummary & summary);
       
     private:
       char             *_buf;
       size_t            _buflen;
       std::spanstream   _payload;
       size_t            _payloadLength;
+      bool              _compressed;
+      bool              _summarize;
+      PacketSummary     _summary;
+
+      size_t SummaryLen() const
+      { return (_summarize ? PacketSummary::k_len : 0); }
+      size_t AssociatedData(CipherSuite suite, uint8_t *ad) const;
     };
     
   }  // namespace Mclog
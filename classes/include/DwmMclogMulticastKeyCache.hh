@@ -0,0 +1,136 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogMulticastKeyCache.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::MulticastKeyCache class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGMULTICASTKEYCACHE_HH_
+#define _DWMMCLOGMULTICASTKEYCACHE_HH_
+
+extern "C" {
+  #include <sys/types.h>
+}
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "DwmMclogMulticastSourceKey.hh"
+#include "DwmMclogUdpEndpoint.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Persistent cache of multicast source decryption keys, kept in
+    //!  @c <keyDirectory>/mcast_keys so that a restarted mclogd (or an
+    //!  invocation of mclog using the same key directory) can decrypt
+    //!  packets from known sources without a key exchange.  The file is
+    //!  written with mode 0600 and ignored unless it's owned by us and
+    //!  inaccessible to others.  Entries expire after k_maxAge, and are
+    //!  removed by Invalidate() when a source has re-keyed.
+    //------------------------------------------------------------------------
+    class MulticastKeyCache
+    {
+    public:
+      //! Maximum age of a cached key.
+      static constexpr std::chrono::hours  k_maxAge{12};
+      //! Name of the cache file in the key directory.
+      static constexpr const char         *k_fileName = "mcast_keys";
+      
+      //----------------------------------------------------------------------
+      //!  Construct with a pointer to the path of our Credence key
+      //!  directory.  If @c keyDir is @c nullptr, the cache is disabled.
+      //----------------------------------------------------------------------
+      MulticastKeyCache(const std::string *keyDir);
+
+      MulticastKeyCache(const MulticastKeyCache &) = delete;
+      MulticastKeyCache & operator = (const MulticastKeyCache &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Looks up the key for the multicast source at @c src.  Returns
+      //!  true and sets @c key if an unexpired key is found, else returns
+      //!  false.
+      //----------------------------------------------------------------------
+      bool Get(const UdpEndpoint & src, MulticastSourceKey & key);
+
+      //----------------------------------------------------------------------
+      //!  Saves the key for the multicast source at @c src.  Returns true
+      //!  on success, false on failure.
+      //----------------------------------------------------------------------
+      bool Put(const UdpEndpoint & src, const MulticastSourceKey & key);
+
+      //----------------------------------------------------------------------
+      //!  Removes the key for the multicast source at @c src if it's
+      //!  @c keyValue (i.e. @c keyValue failed to decrypt a packet from
+      //!  @c src).  A different key was saved by someone else after
+      //!  @c keyValue and is left alone.
+      //----------------------------------------------------------------------
+      void Invalidate(const UdpEndpoint & src, const std::string & keyValue);
+
+      //----------------------------------------------------------------------
+      //!  Returns the path of the cache file, or an empty string if the
+      //!  cache is disabled.
+      //----------------------------------------------------------------------
+      std::string Path() const;
+      
+    private:
+      //  (address, port) -> (key, seconds since epoch when updated)
+      using EntryKey = std::pair<std::string,uint16_t>;
+      using Entry = std::pair<std::string,uint64_t>;
+      
+      const std::string            *_keyDir;
+      std::mutex                    _mtx;
+      std::map<EntryKey,Entry>      _entries;
+      std::string                   _loadedPath;
+      ino_t                         _loadedIno;
+      time_t                        _loadedMtime;
+      
+      static EntryKey MakeKey(const UdpEndpoint & src);
+      static bool IsExpired(const Entry & entry);
+      bool Load(const std::string & path);
+      bool Save(const std::string & path);
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGMULTICASTKEYCACHE_HH_
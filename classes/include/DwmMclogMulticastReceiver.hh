@@ -40,7 +40,7 @@
 #ifndef _DWMMCLOGMULTICASTRECEIVER_HH_
 #define _DWMMCLOGMULTICASTRECEIVER_HH_
 
-#include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <vector>
 
@@ -49,16 +49,28 @@
 #include "DwmMclogConfig.hh"
 #include "DwmMclogMessageSink.hh"
 #include "DwmMclogMulticastSources.hh"
+#include "DwmMclogNackSender.hh"
+#include "DwmMclogPacketSummary.hh"
+#include "DwmMclogReceiveWorkers.hh"
 
 namespace Dwm {
 
   namespace Mclog {
 
     //------------------------------------------------------------------------
-    //!  Encapsulates a multicast receiver of log messages.  Runs in its own
-    //!  thread, sending each message received via multicast to each of the
+    //!  Encapsulates a multicast receiver of log messages.  Reads packets
+    //!  in its own thread and hands them to a pool of ReceiveWorkers,
+    //!  which send each message received via multicast to each of the
     //!  contained sinks (which are configured via AddSink(), RemoveSink()
-    //!  and ClearSinks()).
+    //!  and ClearSinks()).  Sinks must be threadsafe, since messages from
+    //!  different sources may be delivered concurrently.  Packets a
+    //!  source missed are NACKed via a NackSender, and the resent packets
+    //!  arrive on its sockets.
+    //!
+    //!  If channels are configured (see ChannelConfig), we only join the
+    //!  groups whose channel may carry messages that pass our summary
+    //!  filter (see SummaryFilter()).  Without a summary filter we join
+    //!  every group.
     //------------------------------------------------------------------------
     class MulticastReceiver
     {
@@ -110,23 +122,68 @@ namespace Dwm {
       //!  Removes all sinks from the multicast receiver.
       //----------------------------------------------------------------------
       void ClearSinks();
+
+      //----------------------------------------------------------------------
+      //!  Sets the filter used to skip decrypting packets none of whose
+      //!  messages could pass it (see PacketSummaryFilter), and to choose
+      //!  which channels' groups to join.  Call before Open().
+      //----------------------------------------------------------------------
+      void SummaryFilter(const PacketSummaryFilter & summaryFilter)
+      { _summaryFilter = summaryFilter; }
+
+      //----------------------------------------------------------------------
+      //!  Sets the ingest @c quotas received messages must be within to
+      //!  be delivered to our sinks (see IngestQuotas).  Call before
+      //!  Open().
+      //----------------------------------------------------------------------
+      void Quotas(IngestQuotas *quotas)
+      { _workers.Quotas(quotas); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the packets dropped from multicast source backlogs since
+      //!  the last call.
+      //----------------------------------------------------------------------
+      DropCounts HarvestDrops()
+      { return _sources.HarvestDrops(); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the packets dropped because a receive worker's queue was
+      //!  full since the last call.
+      //----------------------------------------------------------------------
+      DropCounts HarvestWorkerDrops()
+      { return _workers.HarvestDrops(); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the reception counts (packets received, lost, reordered
+      //!  and duplicated, and message lag) of each multicast source since
+      //!  the last call.
+      //----------------------------------------------------------------------
+      MulticastSources::StatsVector HarvestSourceStats()
+      { return _sources.HarvestStats(); }
       
     private:
       Config                      _config;
-      int                         _fd;
-      int                         _fd6;
+      std::vector<int>            _fds;
+      std::vector<int>            _fds6;
       bool                        _acceptLocal;
-      std::mutex                  _sinksMutex;
+      std::shared_mutex           _sinksMutex;
       std::vector<MessageSink *>  _sinks;
       std::thread                 _thread;
       int                         _stopfds[2];
       std::atomic<bool>           _run;
+      NackSender                  _nacks;
+      PacketSummaryFilter         _summaryFilter;
       MulticastSources            _sources;
+      ReceiveWorkers              _workers;
       
-      bool BindSocket();
-      bool BindSocket6();
-      bool JoinGroup();
-      bool JoinGroup6();
+      void SelectGroups(std::vector<Ipv4Address> & groups,
+                        std::vector<Ipv6Address> & groups6) const;
+      bool BindSocket(int fd, const Ipv4Address & group);
+      bool BindSocket6(int fd, const Ipv6Address & group);
+      bool JoinGroup(int fd, const Ipv4Address & group);
+      bool JoinGroup6(int fd, const Ipv6Address & group);
+      int OpenGroup(const Ipv4Address & group);
+      int OpenGroup6(const Ipv6Address & group);
       void Run();
     };
     
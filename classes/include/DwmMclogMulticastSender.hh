@@ -43,16 +43,23 @@
 #include <chrono>
 #include <memory>
 #include <span>
+#include <string>
+#include <vector>
 
 #include "DwmIpv4Address.hh"
-#include "DwmThreadQueue.hh"
+#include "DwmMclogAdaptiveSampler.hh"
+#include "DwmMclogBoundedQueue.hh"
 #include "DwmCredenceKeyStash.hh"
 #include "DwmCredenceKnownKeys.hh"
 #include "DwmMclogConfig.hh"
+#include "DwmMclogFec.hh"
 #include "DwmMclogMessageFilterDriver.hh"
 #include "DwmMclogMessageSink.hh"
-#include "DwmMclogMessagePacket.hh"
+#include "DwmMclogPacketBatch.hh"
+#include "DwmMclogPayloadCompressor.hh"
 #include "DwmMclogKeyRequestListener.hh"
+#include "DwmMclogRetransmitRing.hh"
+#include "DwmMclogTokenBucket.hh"
 
 namespace Dwm {
 
@@ -60,7 +67,25 @@ namespace Dwm {
 
     //------------------------------------------------------------------------
     //!  Encapsulates a thread to transmit log messages via multicast,
-    //!  encrypted.
+    //!  encrypted.  Recently sent packets are kept in a RetransmitRing
+    //!  per channel and resent to receivers that NACK them.  If FEC is
+    //!  configured, parity packets follow each block of data packets
+    //!  (see FecEncoder).  If compression is configured, payloads are
+    //!  compressed while every receiver supports it (see
+    //!  PayloadCompressor).  Likewise, messages are encoded as
+    //!  MessageBlocks, and each packet carries a PacketSummary, while
+    //!  every receiver can read them.
+    //!
+    //!  Messages that pass the filter of a configured channel (see
+    //!  ChannelConfig) are sent to the channel's groups rather than the
+    //!  default groups, so receivers that don't want them needn't join
+    //!  those groups.  A message goes to the first channel whose filter
+    //!  it passes.
+    //!
+    //!  If pacing is configured (see PacingPolicy), the sender's packet
+    //!  and byte rates are limited by a TokenBucket.  If sampling is
+    //!  configured for the output queue, an AdaptiveSampler thins out
+    //!  @c info and @c debug messages while the queue is backing up.
     //------------------------------------------------------------------------
     class MulticastSender
       : public MessageSink
@@ -98,7 +123,7 @@ namespace Dwm {
       //----------------------------------------------------------------------
       //!  Returns a pointer to the message queue (do I need this?).
       //----------------------------------------------------------------------
-      Thread::Queue<Message> *OutputQueue()
+      BoundedQueue<Message> *OutputQueue()
       { return &_outQueue; }
 
       //----------------------------------------------------------------------
@@ -112,26 +137,99 @@ namespace Dwm {
       //----------------------------------------------------------------------
       std::string Key() const
       { return _key; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the messages dropped from our output queue since the last
+      //!  call.
+      //----------------------------------------------------------------------
+      DropCounts HarvestDrops()
+      { return _drops.Harvest(); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the messages sampled out in front of our output queue
+      //!  since the last call.
+      //----------------------------------------------------------------------
+      DropCounts HarvestSampled()
+      { return _sampler.HarvestSampled(); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the key request admission counts since the last call.
+      //----------------------------------------------------------------------
+      KeyRequestAdmission::Counts HarvestKeyRequestCounts()
+      { return _keyRequestListener.HarvestCounts(); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the retransmit counts since the last call.
+      //----------------------------------------------------------------------
+      RetransmitRing::Counts HarvestRetransmitCounts();
         
     private:
-      int                            _fd;
-      int                            _fd6;
+      //----------------------------------------------------------------------
+      //!  A multicast channel.  Channel 0 is the default channel (the
+      //!  configured groupAddr and groupAddr6 and dstPort).  Other
+      //!  channels send from their own sockets, so receivers see each
+      //!  channel as a separate source, with its own nonce sequence, FEC
+      //!  blocks and retransmit ring.
+      //----------------------------------------------------------------------
+      struct Channel
+      {
+        std::string                           name;
+        std::unique_ptr<MessageFilterDriver>  filter;
+        int                                   fd = -1;
+        int                                   fd6 = -1;
+        UdpEndpoint                           dst;
+        UdpEndpoint                           dst6;
+        NonceSequence                         nonces;
+        FecEncoder                            fec;
+        std::unique_ptr<RetransmitRing>       retransmits =
+          std::make_unique<RetransmitRing>();
+        std::vector<std::string>              parity;
+        std::unique_ptr<PacketBatch>          batch;
+        Clock::time_point                     nextSendTime;
+        bool                                  flushNow = false;
+      };
+      
+      std::vector<Channel>           _channels;
       std::atomic<bool>              _run;
       std::thread                    _thread;
-      Thread::Queue<Message>         _outQueue;
+      DropCounters                   _drops;
+      BoundedQueue<Message>          _outQueue;
       Config                         _config;
-      UdpEndpoint                    _dstEndpoint;
-      UdpEndpoint                    _dstEndpoint6;
       std::string                    _key;
-      Clock::time_point              _nextSendTime;
+      size_t                         _packetLen;
       KeyRequestListener             _keyRequestListener;
+      PayloadCompressor              _compressor;
+      bool                           _compress;
       std::unique_ptr<MessageFilterDriver>  _filterDriver;
+      TokenBucket                    _pacer;
+      AdaptiveSampler                _sampler;
+
+      //  Longest we sleep at once while held back, so Close() needn't
+      //  wait long.
+      static constexpr std::chrono::microseconds  k_maxPaceWait{50000};
       
+      void ConfigureChannels();
       bool DesiredSocketsOpen() const;
-      bool OpenSocket();
-      bool OpenSocket6();
-      bool SendPacket(MessagePacket & pkt);
-      bool PassesFilter(const Message & msg);
+      void SetPacingRate(int fd) const;
+      int OpenSocket(uint16_t port);
+      int OpenSocket6(uint16_t port);
+      size_t PacketLen() const;
+      bool LoadDictionary();
+      void ConfigureBatch(PacketBatch & batch);
+      bool SendBatch(Channel & chan);
+      void FlushBatch(Channel & chan);
+      void Batch(Channel & chan, const Message & msg);
+      void FlushFec(Channel & chan);
+      void SendParity(Channel & chan);
+      Clock::time_point NextSendTime() const;
+      bool FecPending() const;
+      static size_t Copies(const Channel & chan);
+      void Shed();
+      static bool PassesFilter(MessageFilterDriver *filter,
+                               const Message & msg);
+      Channel & ChannelFor(const Message & msg);
+      void HandleNack(int fd, const UdpEndpoint & src, const char *buf,
+                      size_t buflen);
       void Run();
     };
     
@@ -40,13 +40,25 @@
 #ifndef _DWMMCLOGMULTICASTSOURCE_HH_
 #define _DWMMCLOGMULTICASTSOURCE_HH_
 
+#include <atomic>
 #include <chrono>
+#include <mutex>
 #include <span>
-#include <thread>
+#include <vector>
 
-#include "DwmThreadQueue.hh"
-#include "DwmMclogMessageSink.hh"
+#include "DwmMclogBoundedQueue.hh"
+#include "DwmMclogFec.hh"
+#include "DwmMclogFragmentReassembler.hh"
+#include "DwmMclogKeyRequestScheduler.hh"
+#include "DwmMclogMulticastKeyCache.hh"
+#include "DwmMclogMessagePacket.hh"
+#include "DwmMclogMessage.hh"
 #include "DwmMclogMulticastSourceKey.hh"
+#include "DwmMclogNackSender.hh"
+#include "DwmMclogPacketSummary.hh"
+#include "DwmMclogPayloadCompressor.hh"
+#include "DwmMclogReplayWindow.hh"
+#include "DwmMclogSourceStats.hh"
 #include "DwmMclogUdpEndpoint.hh"
 
 namespace Dwm {
@@ -55,10 +67,13 @@ namespace Dwm {
 
     //------------------------------------------------------------------------
     //!  When I process a packet...
-    //!  - If I don't yet have a muticast decryption key, put packet on
-    //!    backlog and start query thread if one is not running.
-    //!  - If I fail to decrypt with existing key... put packet on backlog,
-    //!    start fetch of new decryption key.
+    //!  - If I don't yet have a muticast decryption key, look for one in
+    //!    the persistent key cache.
+    //!  - If I still don't have a muticast decryption key, put packet on
+    //!    backlog and schedule a key request if one is not outstanding.
+    //!  - If I fail to decrypt with existing key... invalidate it in the
+    //!    key cache, put packet on backlog, start fetch of new decryption
+    //!    key.
     //!  - Process backlog.  For each entry...
     //!    - If I have a decryption key that is newer than backlog entry,
     //!      try decrypting with new key.  If this fails, do nothing
@@ -70,11 +85,38 @@ namespace Dwm {
     //!
     //!  This all seems a bit complicated.  Is it more complicated than
     //!  necessary for the desired functionality?
+    //!
+    //!  If we have a NackSender, we also ask the source to resend packets
+    //!  we missed: once a counter is k_nackDelay behind the highest we've
+    //!  seen, we NACK it (at most one NACK every k_nackInterval).  A
+    //!  resent packet must arrive while its counter is still in the
+    //!  ReplayWindow, else it's rejected as late.
+    //!
+    //!  Once the source sends FEC parity packets, we hold its recent
+    //!  (still encrypted) packets in a FecDecoder and rebuild lost ones
+    //!  from parity before resorting to a NACK.
+    //!
+    //!  Given a PacketSummaryFilter, we don't decrypt packets whose
+    //!  PacketSummary it rejects.  The summary isn't authenticated until
+    //!  decryption, so a forged one can only cost us the packet it's on.
+    //!  A skipped packet's counter is only used to keep it from being
+    //!  NACKed or counted as lost.
+    //!
+    //!  A dual-stack sender sends each packet to both its IPv4 and IPv6
+    //!  groups.  MulticastSources hands us the copies from the sender's
+    //!  other endpoint, and we drop any copy whose counter we've already
+    //!  accepted before decrypting it.
     //------------------------------------------------------------------------
     class MulticastSource
     {
     public:
       using Clock = std::chrono::system_clock;
+
+      //! How far behind the highest counter a missing counter must be
+      //! before we NACK it, so mere reordering doesn't cause a NACK.
+      static constexpr uint64_t  k_nackDelay = 3;
+      //! Minimum time between NACKs to one source.
+      static constexpr std::chrono::milliseconds  k_nackInterval{100};
       
       //----------------------------------------------------------------------
       //!  Default constructor.
@@ -87,14 +129,22 @@ namespace Dwm {
       ~MulticastSource();
       
       //----------------------------------------------------------------------
-      //!  Construct from the given @c srcEndpoint, pointer to the path to
-      //!  our Credence key directory @c keyDir and pointer to a collection
-      //!  of sinks that will receive messages from packets processed with
-      //!  ProcessPacket().
+      //!  Construct from the given @c srcEndpoint, pointer to the scheduler
+      //!  that will request our decryption key @c keyRequests and pointer
+      //!  to the persistent key cache @c keyCache (may be @c nullptr).
+      //!  The packet backlog is configured per @c backlogCfg (defaults if
+      //!  @c nullptr), and packets dropped from the backlog are counted in
+      //!  @c drops if it is not @c nullptr.  NACKs for missing packets
+      //!  are sent via @c nacks if it is not @c nullptr.  Packets that
+      //!  @c summaryFilter rejects are skipped if it is not @c nullptr.
       //----------------------------------------------------------------------
       MulticastSource(const UdpEndpoint & srcEndpoint,
-                      const std::string *keyDir,
-                      std::vector<MessageSink *> *sinks);
+                      KeyRequestScheduler *keyRequests,
+                      MulticastKeyCache *keyCache,
+                      const QueueConfig *backlogCfg = nullptr,
+                      DropCounters *drops = nullptr,
+                      NackSender *nacks = nullptr,
+                      const PacketSummaryFilter *summaryFilter = nullptr);
       
       //----------------------------------------------------------------------
       //!  Copy constructor.
@@ -117,26 +167,46 @@ namespace Dwm {
       MulticastSource & operator = (MulticastSource && src);
       
       //----------------------------------------------------------------------
-      //!  Returns the decryption key.
+      //!  Returns the decryption key.  Threadsafe.
       //----------------------------------------------------------------------
       MulticastSourceKey Key() const;
       
       //----------------------------------------------------------------------
-      //!  Sets the decryption key.
+      //!  Sets the decryption key.  Threadsafe, since the key arrives on
+      //!  the KeyRequestScheduler's thread while packets are processed on
+      //!  a receive worker's thread.
       //----------------------------------------------------------------------
       void Key(const MulticastSourceKey & key);
       
       //----------------------------------------------------------------------
-      //!  Process the packet @c data of length @c datalen.  Returns true
-      //!  on success, false on failure.
+      //!  Process the packet @c data of length @c datalen, appending the
+      //!  messages it completes (along with any from backlogged packets
+      //!  we can now decrypt) to @c msgs.  @c mirror should be true if
+      //!  the packet arrived from another endpoint (e.g. the sender's
+      //!  other address family) and was routed here by its nonce prefix.
+      //!  Such a packet is dropped if we can't decrypt it, rather than
+      //!  resetting our key.  Returns true on success, false on failure.
       //----------------------------------------------------------------------
-      bool ProcessPacket(char *data, size_t datalen);
+      bool ProcessPacket(char *data, size_t datalen,
+                         std::vector<Message> & msgs, bool mirror = false);
       
       //----------------------------------------------------------------------
       //!  Returns the last time we received a packet from the multicast
       //!  source.
       //----------------------------------------------------------------------
       Clock::time_point LastReceiveTime() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns the reception counts since the last call and resets
+      //!  them.
+      //----------------------------------------------------------------------
+      SourceStats HarvestStats();
+
+      //----------------------------------------------------------------------
+      //!  Returns the window of packet counters we've accepted.
+      //----------------------------------------------------------------------
+      const ReplayWindow & Replay() const
+      { return _replay; }
       
     private:
       //----------------------------------------------------------------------
@@ -165,17 +235,48 @@ namespace Dwm {
 
       UdpEndpoint                   _endpoint;
       MulticastSourceKey            _key;
-      Thread::Queue<BacklogEntry>   _backlog;
-      const std::string            *_keyDir;
-      std::vector<MessageSink *>   *_sinks;
-      std::atomic<bool>             _queryDone;
-      std::thread                   _queryThread;
+      mutable std::mutex            _keyMtx;
+      BoundedQueue<BacklogEntry>    _backlog;
+      FragmentReassembler           _reassembler;
+      ReplayWindow                  _replay;
+      SourceStats                   _stats;
+      DropCounters                 *_drops;
+      KeyRequestScheduler          *_keyRequests;
+      MulticastKeyCache            *_keyCache;
+      std::atomic<uint64_t>         _queryId;
       Clock::time_point             _lastReceiveTime;
+      NackSender                   *_nacks;
+      std::string                   _nackPrefix;
+      uint64_t                      _nackFrom;
+      Clock::time_point             _nextNackTime;
+      FecDecoder                    _fec;
+      PayloadDecompressor           _decompressor;
+      std::string                   _plain;
+      const PacketSummaryFilter    *_summaryFilter;
+      bool                          _mirrored;
       
-      bool ProcessBacklog();
+      void ConfigureBacklog(const QueueConfig & cfg);
+      bool ProcessBacklog(std::vector<Message> & msgs);
       void ClearOldBacklog();
+      std::string CachedKey();
+      bool Reassemble(MessagePacket & pkt, std::vector<Message> & msgs);
+      bool NextMessages(std::istream & is, std::vector<Message> & msgs);
+      bool Decompress(const MessagePacket & pkt);
+      void DropUnauthenticated(size_t datalen);
+      bool IsReplay(const MessagePacket & pkt);
+      bool IsCopy(const char *data, size_t datalen);
+      void CountCopy();
+      bool Skip(const char *data, size_t datalen,
+                std::vector<Message> & msgs);
+      void ProcessParity(const char *data, size_t datalen,
+                         std::vector<Message> & msgs);
+      void ProcessRecovered(std::vector<std::string> & recovered,
+                            const std::string & mcastKey,
+                            std::vector<Message> & msgs);
+      void RequestRepairs(const MessagePacket & pkt,
+                          const std::string & mcastKey);
       void StartQuery();
-      void QueryForKey();
+      void CancelQuery();
     };
     
   }  // namespace Mclog
@@ -41,6 +41,7 @@
 #define _DWMMCLOGMULTICASTSOURCEKEY_HH_
 
 #include <chrono>
+#include <memory>
 #include <mutex>
 #include <string>
 
@@ -121,6 +122,17 @@ namespace Dwm {
       //!  decryption key.
       //----------------------------------------------------------------------
       void LastUpdated(Clock::time_point lastUpdated);
+
+      //----------------------------------------------------------------------
+      //!  Returns the payload compression dictionary that came with the
+      //!  key (@c nullptr if none).
+      //----------------------------------------------------------------------
+      std::shared_ptr<const std::string> Dictionary() const;
+
+      //----------------------------------------------------------------------
+      //!  Sets the payload compression dictionary.
+      //----------------------------------------------------------------------
+      void Dictionary(std::shared_ptr<const std::string> dictionary);
       
     private:
       mutable std::mutex  _mtx;
@@ -128,6 +140,7 @@ namespace Dwm {
       Clock::time_point   _lastRequested;
       Clock::time_point   _lastQueried;
       Clock::time_point   _lastUpdated;
+      std::shared_ptr<const std::string>  _dictionary;
     };
 
   }  // namespace Mclog
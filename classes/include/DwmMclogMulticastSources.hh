@@ -40,52 +40,162 @@
 #ifndef _DWMMCLOGMULTICASTSOURCES_HH_
 #define _DWMMCLOGMULTICASTSOURCES_HH_
 
-#include <map>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
-#include "DwmThreadQueue.hh"
-#include "DwmMclogMessageSink.hh"
+#include "DwmMclogDropCounters.hh"
+#include "DwmMclogKeyRequestScheduler.hh"
+#include "DwmMclogMulticastKeyCache.hh"
+#include "DwmMclogMessage.hh"
 #include "DwmMclogUdpEndpoint.hh"
 #include "DwmMclogMulticastSource.hh"
+#include "DwmMclogSourceStats.hh"
+#include "DwmMclogTimerWheel.hh"
 
 namespace Dwm {
 
   namespace Mclog {
 
     //------------------------------------------------------------------------
-    //!  Encapsulates a map of UDP endpoints to multicast log message
-    //!  sources and a set of sinks which will receive messages we receive
-    //!  from the multicast log message sources.
+    //!  Encapsulates a hash table of UDP endpoints to multicast log
+    //!  message sources.  The table is split into shards by source, each
+    //!  with its own mutex, so that packets from different sources may be
+    //!  processed concurrently by different threads.  A thread that
+    //!  handles every packet for the sources in a shard will see each
+    //!  source's messages in order.
+    //!
+    //!  Sources are constructed in place and never moved while in use.
+    //!  Each shard has a TimerWheel that expires sources we haven't heard
+    //!  from in k_sourceTimeout, so churn among many short-lived senders
+    //!  costs O(1) per source instead of a scan of every source.
+    //!
+    //!  A dual-stack sender sends each packet to both its IPv4 and IPv6
+    //!  groups, from two endpoints.  The nonce prefix of its packets
+    //!  (see NonceSequence) identifies it across both, so once a source
+    //!  has authenticated a packet with a prefix, we hand it the packets
+    //!  with that prefix from any endpoint.  The sender's other endpoint
+    //!  then needs no key exchange of its own, and the source drops the
+    //!  second copy of each packet without decrypting it.
     //------------------------------------------------------------------------
     class MulticastSources
     {
     public:
+      //! How long a source may be silent before we forget it.
+      static constexpr std::chrono::seconds  k_sourceTimeout{20};
+      //! Most expired sources per shard whose unharvested reception
+      //! counts we keep for the next HarvestStats().
+      static constexpr size_t  k_maxRetiredStats = 1024;
+
+      using StatsVector = std::vector<std::pair<UdpEndpoint,SourceStats>>;
+      
       //----------------------------------------------------------------------
       //!  Default constructor.
       //----------------------------------------------------------------------
       MulticastSources();
       
       //----------------------------------------------------------------------
-      //!  Construct from the given Credence key directory path @c keyDir
-      //!  and a pointer to the sinks which will receive log messages
-      //!  arriving from any of the m,ulticast sources.
+      //!  Construct from the given Credence key directory path @c keyDir.
+      //!  Each source's packet backlog will be configured per
+      //!  @c backlogCfg.  Decryption keys for all sources are requested
+      //!  by a single KeyRequestScheduler and saved in a
+      //!  MulticastKeyCache in @c keyDir.  If @c nacks is not @c nullptr,
+      //!  sources use it to NACK packets they missed.  If
+      //!  @c summaryFilter is not @c nullptr, sources skip the packets it
+      //!  rejects.
       //----------------------------------------------------------------------
       MulticastSources(const std::string *keyDir,
-                       std::vector<MessageSink *> *sinks);
+                       const QueueConfig *backlogCfg = nullptr,
+                       NackSender *nacks = nullptr,
+                       const PacketSummaryFilter *summaryFilter = nullptr);
+
+      //----------------------------------------------------------------------
+      //!  Sets the number of shards to @c numShards (at least 1), moving
+      //!  existing sources to their new shards.  Must not be called while
+      //!  another thread is in ProcessPacket().
+      //----------------------------------------------------------------------
+      void Shards(size_t numShards);
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of shards.
+      //----------------------------------------------------------------------
+      size_t Shards() const
+      { return _shards.size(); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the index of the shard holding the source at @c src.
+      //----------------------------------------------------------------------
+      size_t Shard(const UdpEndpoint & src) const;
+
+      //----------------------------------------------------------------------
+      //!  Returns the index of the shard holding the source that will
+      //!  process the packet @c data of length @c datalen from @c src.
+      //!  This is the shard of @c src unless the packet is from another
+      //!  endpoint of a sender we know.  Threadsafe.
+      //----------------------------------------------------------------------
+      size_t Shard(const UdpEndpoint & src, const char *data,
+                   size_t datalen);
       
       //----------------------------------------------------------------------
       //!  Processes the packet @c data of length @c datalen from the
-      //!  multicast source at @c src.
+      //!  multicast source at @c src (or from the source at another
+      //!  endpoint of the same sender), appending the messages it
+      //!  completes to @c msgs.  Threadsafe.
       //----------------------------------------------------------------------
       void ProcessPacket(const UdpEndpoint & src, char *data,
-                         size_t datalen);
+                         size_t datalen, std::vector<Message> & msgs);
+
+      //----------------------------------------------------------------------
+      //!  Returns the packets dropped from source backlogs since the last
+      //!  call.  Threadsafe.
+      //----------------------------------------------------------------------
+      DropCounts HarvestDrops()
+      { return _backlogDrops.Harvest(); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the reception counts of each source (including sources
+      //!  that have since expired) with anything to report since the last
+      //!  call.  Threadsafe.
+      //----------------------------------------------------------------------
+      StatsVector HarvestStats();
       
     private:
-      std::map<UdpEndpoint,MulticastSource>   _sources;
-      std::vector<MessageSink *>             *_sinks;
-      const std::string                      *_keyDir;
+      struct SourceShard
+      {
+        std::mutex                                        mtx;
+        std::unordered_map<UdpEndpoint,MulticastSource>   sources;
+        TimerWheel<UdpEndpoint,MulticastSource::Clock>    expiry;
+        std::vector<UdpEndpoint>                          expired;
+        StatsVector                                       retired;
+      };
+      
+      //  Declared before _shards so they outlive the sources; each source
+      //  cancels its outstanding key request when destroyed.
+      MulticastKeyCache                          _keyCache;
+      KeyRequestScheduler                        _keyRequests;
+      std::vector<std::unique_ptr<SourceShard>>  _shards;
+      std::atomic<size_t>                        _numSources;
+      const std::string                         *_keyDir;
+      const QueueConfig                         *_backlogCfg;
+      DropCounters                               _backlogDrops;
+      NackSender                                *_nacks;
+      const PacketSummaryFilter                 *_summaryFilter;
+      std::shared_mutex                          _sendersMtx;
+      std::unordered_map<std::string,UdpEndpoint>  _senders;
 
-      void ClearOld();
+      bool FindSender(const std::string & prefix, UdpEndpoint & endpoint);
+      void AddSender(const std::string & prefix,
+                     const UdpEndpoint & endpoint);
+      void RemoveSender(const UdpEndpoint & endpoint,
+                        const MulticastSource & source);
+      void ClearOld(SourceShard & shard,
+                    MulticastSource::Clock::time_point now);
     };
     
   }  // namespace Mclog
@@ -0,0 +1,159 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogNack.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::Nack class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGNACK_HH_
+#define _DWMMCLOGNACK_HH_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  A negative acknowledgement: a request from a multicast receiver
+    //!  to a sender for the packets with the given counters (see
+    //!  NonceSequence) that the receiver did not get.  Sent unicast to
+    //!  the sender's multicast source endpoint, which is also where the
+    //!  sender's KeyRequestListener listens.  On the wire:
+    //!
+    //!    bytes  0..3   k_tag
+    //!    bytes  4..17  nonce prefix
+    //!    byte   18     number of ranges (at most k_maxRanges)
+    //!    then for each range, a 6-byte first counter and a 2-byte count
+    //!    (big-endian), followed by a crypto_auth() MAC of all of the
+    //!    above keyed with a key derived from the multicast key.
+    //!
+    //!  The MAC means only holders of the multicast key can make a sender
+    //!  retransmit, so a NACK with a spoofed source address can't be used
+    //!  to aim our traffic at someone else.
+    //------------------------------------------------------------------------
+    class Nack
+    {
+    public:
+      static constexpr std::string_view  k_tag{"MCNK"};
+      static constexpr size_t            k_maxRanges = 32;
+      
+      //----------------------------------------------------------------------
+      //!  A run of @c count consecutive counters starting at @c first.
+      //----------------------------------------------------------------------
+      struct Range
+      {
+        uint64_t  first;
+        uint16_t  count;
+      };
+      
+      //----------------------------------------------------------------------
+      //!  Construct an empty NACK.
+      //----------------------------------------------------------------------
+      Nack();
+
+      //----------------------------------------------------------------------
+      //!  Construct an empty NACK for packets with the given nonce
+      //!  @c prefix.
+      //----------------------------------------------------------------------
+      Nack(const std::string & prefix);
+
+      //----------------------------------------------------------------------
+      //!  Returns the nonce prefix.
+      //----------------------------------------------------------------------
+      const std::string & Prefix() const
+      { return _prefix; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the requested ranges.
+      //----------------------------------------------------------------------
+      const std::vector<Range> & Ranges() const
+      { return _ranges; }
+
+      //----------------------------------------------------------------------
+      //!  Adds @c counter to the request.  Counters must be added in
+      //!  ascending order; consecutive counters share a range.  Returns
+      //!  false (and adds nothing) if we already have k_maxRanges ranges
+      //!  and @c counter doesn't extend the last one.
+      //----------------------------------------------------------------------
+      bool Add(uint64_t counter);
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of counters requested.
+      //----------------------------------------------------------------------
+      size_t NumCounters() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns true if no counters are requested.
+      //----------------------------------------------------------------------
+      bool Empty() const
+      { return _ranges.empty(); }
+      
+      //----------------------------------------------------------------------
+      //!  Encodes the NACK into @c datagram, authenticated with the
+      //!  multicast key @c mcastKey.  Returns true on success, false on
+      //!  failure.
+      //----------------------------------------------------------------------
+      bool Encode(const std::string & mcastKey, std::string & datagram) const;
+
+      //----------------------------------------------------------------------
+      //!  Decodes the NACK in @c buf of length @c buflen, verifying it
+      //!  with the multicast key @c mcastKey.  Returns true on success,
+      //!  false if the datagram is malformed or fails verification.
+      //----------------------------------------------------------------------
+      bool Decode(const std::string & mcastKey, const char *buf,
+                  size_t buflen);
+      
+      //----------------------------------------------------------------------
+      //!  Returns true if @c buf of length @c buflen looks like a NACK,
+      //!  i.e. starts with k_tag.  Doesn't verify it.
+      //----------------------------------------------------------------------
+      static bool IsNack(const char *buf, size_t buflen);
+      
+    private:
+      std::string         _prefix;
+      std::vector<Range>  _ranges;
+
+      static bool MacKey(const std::string & mcastKey, std::string & macKey);
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGNACK_HH_
@@ -0,0 +1,112 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogNackSender.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::NackSender class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGNACKSENDER_HH_
+#define _DWMMCLOGNACKSENDER_HH_
+
+#include <string>
+
+#include "DwmMclogUdpEndpoint.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  The unicast UDP sockets a MulticastReceiver uses to send NACKs
+    //!  (see Nack) to multicast senders.  Senders resend the requested
+    //!  packets to the socket the NACK came from, so the receiver must
+    //!  also read from Fd() and Fd6().
+    //------------------------------------------------------------------------
+    class NackSender
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Default constructor.
+      //----------------------------------------------------------------------
+      NackSender();
+
+      //----------------------------------------------------------------------
+      //!  Destructor.
+      //----------------------------------------------------------------------
+      ~NackSender();
+
+      NackSender(const NackSender &) = delete;
+      NackSender & operator = (const NackSender &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Opens the IPv4 and IPv6 sockets.  Returns true if at least one
+      //!  is open.
+      //----------------------------------------------------------------------
+      bool Open();
+
+      //----------------------------------------------------------------------
+      //!  Closes the sockets.
+      //----------------------------------------------------------------------
+      void Close();
+
+      //----------------------------------------------------------------------
+      //!  Sends @c datagram to @c dst from the socket of the same address
+      //!  family.  Doesn't block.  Threadsafe.  Returns true on success,
+      //!  false on failure.
+      //----------------------------------------------------------------------
+      bool Send(const UdpEndpoint & dst, const std::string & datagram);
+
+      //----------------------------------------------------------------------
+      //!  Returns the IPv4 socket descriptor (-1 if not open).
+      //----------------------------------------------------------------------
+      int Fd() const
+      { return _fd; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the IPv6 socket descriptor (-1 if not open).
+      //----------------------------------------------------------------------
+      int Fd6() const
+      { return _fd6; }
+      
+    private:
+      int  _fd;
+      int  _fd6;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGNACKSENDER_HH_
@@ -0,0 +1,163 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogPacingPolicy.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::PacingPolicy class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGPACINGPOLICY_HH_
+#define _DWMMCLOGPACINGPOLICY_HH_
+
+#include <algorithm>
+#include <cstdint>
+
+#include "DwmMclogSeverity.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Encapsulates the policy used by MulticastSender to limit the rate
+    //!  at which it sends packets (see TokenBucket).  PacketRate() and
+    //!  ByteRate() are per second, 0 meaning no limit.  Burst() is the
+    //!  number of packets that may be sent back to back after an idle
+    //!  period.  While the sender is held back, messages wait in its
+    //!  queue, where urgent messages go ahead of bulk ones; messages at or
+    //!  below ShedSeverity() (if set) are dropped instead of waiting.
+    //------------------------------------------------------------------------
+    class PacingPolicy
+    {
+    public:
+      static constexpr uint32_t  k_minBurst     = 1;
+      static constexpr uint32_t  k_maxBurst     = 1024;
+      static constexpr uint32_t  k_defaultBurst = 32;
+      
+      //----------------------------------------------------------------------
+      //!  Default constructor.  No limits, and nothing is shed.
+      //----------------------------------------------------------------------
+      PacingPolicy()
+          : _packetRate(0), _byteRate(0), _burst(k_defaultBurst),
+            _shed(false), _shedSeverity(Severity::debug)
+      {}
+
+      PacingPolicy(const PacingPolicy &) = default;
+      PacingPolicy & operator = (const PacingPolicy &) = default;
+
+      //----------------------------------------------------------------------
+      //!  Returns true if a packet or byte rate limit is set.
+      //----------------------------------------------------------------------
+      bool Enabled() const
+      { return ((0 != _packetRate) || (0 != _byteRate)); }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the maximum packets per second, 0 for no limit.
+      //----------------------------------------------------------------------
+      uint32_t PacketRate() const
+      { return _packetRate; }
+
+      //----------------------------------------------------------------------
+      //!  Sets and returns the maximum packets per second.
+      //----------------------------------------------------------------------
+      uint32_t PacketRate(uint32_t packetRate)
+      { return _packetRate = packetRate; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the maximum bytes per second, 0 for no limit.
+      //----------------------------------------------------------------------
+      uint64_t ByteRate() const
+      { return _byteRate; }
+
+      //----------------------------------------------------------------------
+      //!  Sets and returns the maximum bytes per second.
+      //----------------------------------------------------------------------
+      uint64_t ByteRate(uint64_t byteRate)
+      { return _byteRate = byteRate; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the burst allowance, in packets.
+      //----------------------------------------------------------------------
+      uint32_t Burst() const
+      { return _burst; }
+
+      //----------------------------------------------------------------------
+      //!  Sets and returns the burst allowance, in packets.  The value is
+      //!  clamped to the range [k_minBurst, k_maxBurst].
+      //----------------------------------------------------------------------
+      uint32_t Burst(uint32_t burst)
+      { return _burst = Clamp(burst); }
+
+      //----------------------------------------------------------------------
+      //!  Sets the severity at or below which messages are dropped while
+      //!  the sender is held back.
+      //----------------------------------------------------------------------
+      void ShedSeverity(Severity severity)
+      {
+        _shed = true;
+        _shedSeverity = severity;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Returns true if a message with the given @c severity should be
+      //!  dropped while the sender is held back.  Note that lower Severity
+      //!  values are more severe.  Never true for @c err and above.
+      //----------------------------------------------------------------------
+      bool Shed(Severity severity) const
+      {
+        return (_shed && (severity > Severity::err)
+                && (severity >= _shedSeverity));
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Clamps @c burst to the range [k_minBurst, k_maxBurst].
+      //----------------------------------------------------------------------
+      static uint32_t Clamp(uint32_t burst)
+      { return std::clamp(burst, k_minBurst, k_maxBurst); }
+      
+      bool operator == (const PacingPolicy &) const = default;
+      
+    private:
+      uint32_t  _packetRate;
+      uint64_t  _byteRate;
+      uint32_t  _burst;
+      bool      _shed;
+      Severity  _shedSeverity;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGPACINGPOLICY_HH_
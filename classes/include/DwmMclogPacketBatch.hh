@@ -0,0 +1,240 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogPacketBatch.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::PacketBatch class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGPACKETBATCH_HH_
+#define _DWMMCLOGPACKETBATCH_HH_
+
+extern "C" {
+  #include <sys/socket.h>
+  #include <sys/uio.h>
+}
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "DwmMclogMessage.hh"
+#include "DwmMclogMessageBlock.hh"
+#include "DwmMclogMessagePacket.hh"
+#include "DwmMclogPayloadCompressor.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  A run of MessagePackets sharing one buffer, filled in order and
+    //!  sent together.  Where available, the packets are sent with a
+    //!  single sendmmsg() call instead of one sendto() per packet.
+    //!
+    //!  With a PayloadCompressor, messages are staged uncompressed and
+    //!  each packet holds as many as still compress to fit.  We only
+    //!  compress to check the fit once the staged messages are expected
+    //!  to be near full, and a packet is sealed (compressed into place)
+    //!  when the next message won't fit or the batch is encrypted.
+    //!  Messages that don't make it into the last packet of a batch stay
+    //!  staged for the next batch.
+    //!
+    //!  In compact mode, messages are staged the same way (compressed or
+    //!  not), encoded as a MessageBlock per packet.
+    //------------------------------------------------------------------------
+    class PacketBatch
+    {
+    public:
+      //! Upper bound on the buffer space used by a batch.
+      static constexpr size_t k_maxBatchBytes = 256 * 1024;
+      //! Upper bound on the number of packets in a batch.
+      static constexpr size_t k_maxPackets = 16;
+      
+      //----------------------------------------------------------------------
+      //!  Construct a batch of packets of length @c packetLen.  The number
+      //!  of packets is chosen to stay within k_maxBatchBytes and
+      //!  k_maxPackets, but is at least 1.
+      //----------------------------------------------------------------------
+      PacketBatch(size_t packetLen);
+
+      PacketBatch(const PacketBatch &) = delete;
+      PacketBatch & operator = (const PacketBatch &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Appends @c t to the current packet, moving on to the next packet
+      //!  if the current one is full.  Returns false if @c t will not fit
+      //!  (all packets are full, or @c t is larger than an empty packet).
+      //----------------------------------------------------------------------
+      template <typename T>
+      bool Add(const T & t)
+      {
+        if (_packets[_current].Add(t)) {
+          return true;
+        }
+        if (_packets[_current].HasPayload()
+            && ((_current + 1) < _packets.size())) {
+          ++_current;
+          return _packets[_current].Add(t);
+        }
+        return false;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Appends @c msg to the batch.  If @c msg is too large to fit in
+      //!  an empty packet, it is split into MessageFragments, each placed
+      //!  at the start of its own packet.  Returns false if @c msg will
+      //!  not fit in the remaining packets (or can't be fragmented).
+      //----------------------------------------------------------------------
+      bool Add(const Message & msg);
+      
+      //----------------------------------------------------------------------
+      //!  Compresses payloads with @c compressor from now on, or stops
+      //!  compressing if @c compressor is @c nullptr.  Only takes effect
+      //!  if the batch is empty; returns true if it did.
+      //----------------------------------------------------------------------
+      bool Compressor(PayloadCompressor *compressor);
+
+      //----------------------------------------------------------------------
+      //!  Encodes messages as MessageBlocks from now on if @c compact is
+      //!  true, else as plain Messages.  Only takes effect if the batch is
+      //!  empty; returns true if it did.
+      //----------------------------------------------------------------------
+      bool Compact(bool compact);
+
+      //----------------------------------------------------------------------
+      //!  Appends a PacketSummary of its messages to each packet from now
+      //!  on if @c summarize is true (see MessagePacket::Summarize()).
+      //!  Only takes effect if the batch is empty; returns true if it did.
+      //----------------------------------------------------------------------
+      bool Summarize(bool summarize);
+      
+      //----------------------------------------------------------------------
+      //!  Returns true if any packet has a non-empty payload (or messages
+      //!  are staged).
+      //----------------------------------------------------------------------
+      bool HasPayload() const
+      { return (_packets[0].HasPayload() || (! _raw.empty())); }
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of packets that are full, i.e. those before
+      //!  the packet currently being filled.
+      //----------------------------------------------------------------------
+      size_t FullPackets() const
+      { return _current; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the number of packets with a non-empty payload.
+      //----------------------------------------------------------------------
+      size_t NumPackets() const
+      {
+        return _current + ((_packets[_current].HasPayload()
+                            || (! _raw.empty())) ? 1 : 0);
+      }
+
+      //----------------------------------------------------------------------
+      //!  Returns the length of each packet.
+      //----------------------------------------------------------------------
+      size_t PacketLen() const
+      { return _packetLen; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the packet at index @c i, which must be less than
+      //!  NumPackets().
+      //----------------------------------------------------------------------
+      const MessagePacket & Packet(size_t i) const
+      { return _packets[i]; }
+      
+      //----------------------------------------------------------------------
+      //!  Encrypts every packet with a non-empty payload using the given
+      //!  @c secretKey and the next nonces from @c nonces, first sealing
+      //!  any staged messages.  Returns true on success, false on
+      //!  failure.
+      //----------------------------------------------------------------------
+      bool Encrypt(const std::string & secretKey, NonceSequence & nonces);
+
+      //----------------------------------------------------------------------
+      //!  Sends every packet with a non-empty payload to @c dst via the
+      //!  descriptor @c fd, first sealing any staged messages.  The
+      //!  packets must already be encrypted if encryption is desired.
+      //!  Returns the number of packets sent.
+      //----------------------------------------------------------------------
+      size_t SendTo(int fd, const UdpEndpoint & dst);
+
+      //----------------------------------------------------------------------
+      //!  Clears all packets.  Messages still staged are kept for the next
+      //!  batch.
+      //----------------------------------------------------------------------
+      void Reset();
+      
+    private:
+      size_t                      _packetLen;
+      std::vector<char>           _storage;
+      std::deque<MessagePacket>   _packets;
+      size_t                      _current;
+      uint32_t                    _nextFragmentId;
+      std::vector<struct iovec>   _iovs;
+#if (defined(__FreeBSD__) || defined(__linux__))
+      std::vector<struct mmsghdr> _mmsgs;
+#endif
+      PayloadCompressor          *_compressor;
+      bool                        _compact;
+      MessageBlock                _block;     // encodes _raw when compact
+      std::deque<Message>         _staged;    // messages in _raw when compact
+      std::string                 _raw;       // staged, uncompressed
+      std::vector<size_t>         _rawEnds;   // end of each message in _raw
+      std::vector<PacketSummary>  _rawSummaries;  // of each message in _raw
+      size_t                      _fitLen;    // prefix of _raw known to fit
+      std::string                 _fitData;   // _fitLen bytes compressed
+      size_t                      _trialLen;  // compress to check past this
+      std::string                 _scratch;
+
+      bool AddFragments(const Message & msg);
+      bool Stage(const Message & msg);
+      bool Append(const Message & msg);
+      void Unstage(size_t n);
+      void Reencode();
+      bool Encode(size_t len, std::string & out, bool & compressed);
+      bool Fits(size_t len);
+      bool Seal();
+      bool SealStaged();
+      void RestartFit();
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGPACKETBATCH_HH_
@@ -0,0 +1,214 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogPacketSummary.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::PacketSummary and Dwm::Mclog::PacketSummaryFilter
+//!  class declarations
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGPACKETSUMMARY_HH_
+#define _DWMMCLOGPACKETSUMMARY_HH_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "DwmMclogFacility.hh"
+#include "DwmMclogSeverity.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    class MessageFilterDriver;
+    
+    //------------------------------------------------------------------------
+    //!  The facilities and severities of the messages in a multicast
+    //!  packet.  A sender appends it to each encrypted packet in the
+    //!  clear, authenticated as associated data (see MessagePacket), so a
+    //!  receiver whose filter can't pass any of the packet's messages can
+    //!  skip decrypting it.  On the wire:
+    //!
+    //!    bytes 0..2  facility bitmap (big-endian); bit n set if a
+    //!                message has the facility with code n (the
+    //!                syslog facility shifted right 3 bits)
+    //!    byte  3     severity bitmap; bit n set if a message has
+    //!                severity n
+    //!
+    //!  The two bitmaps don't say which facilities go with which
+    //!  severities, so a summary may admit pairings the packet doesn't
+    //!  hold.  That's fine for skipping: we only skip a packet when no
+    //!  pairing could pass.
+    //------------------------------------------------------------------------
+    class PacketSummary
+    {
+    public:
+      //! Length on the wire.
+      static constexpr size_t   k_len = 4;
+      //! Number of facility codes.
+      static constexpr size_t   k_numFacilities = 24;
+      //! Bit in the payload formats a key requester says it can read.
+      static constexpr uint8_t  k_capability = 0x04;
+      
+      //----------------------------------------------------------------------
+      //!  Construct an empty summary.
+      //----------------------------------------------------------------------
+      PacketSummary()
+          : _facilities(0), _severities(0)
+      {}
+
+      //----------------------------------------------------------------------
+      //!  Adds a message with the given @c facility and @c severity.
+      //----------------------------------------------------------------------
+      void Add(Facility facility, Severity severity)
+      {
+        _facilities |= (1U << FacilityCode(facility));
+        _severities |= (1U << ((uint8_t)severity & 0x07));
+      }
+
+      //----------------------------------------------------------------------
+      //!  Adds the messages in @c summary.
+      //----------------------------------------------------------------------
+      PacketSummary & operator |= (const PacketSummary & summary)
+      {
+        _facilities |= summary._facilities;
+        _severities |= summary._severities;
+        return *this;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Returns true if no messages have been added.
+      //----------------------------------------------------------------------
+      bool Empty() const
+      { return (0 == _facilities); }
+
+      //----------------------------------------------------------------------
+      //!  Clears the summary.
+      //----------------------------------------------------------------------
+      void Clear()
+      { _facilities = 0;  _severities = 0; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the facility bitmap.
+      //----------------------------------------------------------------------
+      uint32_t Facilities() const
+      { return _facilities; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the severity bitmap.
+      //----------------------------------------------------------------------
+      uint8_t Severities() const
+      { return _severities; }
+      
+      //----------------------------------------------------------------------
+      //!  Writes the k_len byte wire form to @c buf.
+      //----------------------------------------------------------------------
+      void Encode(uint8_t *buf) const;
+
+      //----------------------------------------------------------------------
+      //!  Reads the k_len byte wire form from @c buf.
+      //----------------------------------------------------------------------
+      void Decode(const uint8_t *buf);
+
+      //----------------------------------------------------------------------
+      //!  Returns the code of @c facility, i.e. its bit in a facility
+      //!  bitmap.
+      //----------------------------------------------------------------------
+      static uint8_t FacilityCode(Facility facility)
+      { return ((((uint8_t)facility) >> 3) % k_numFacilities); }
+      
+    private:
+      uint32_t  _facilities;
+      uint8_t   _severities;
+    };
+
+    //------------------------------------------------------------------------
+    //!  The facility and severity pairings that pass a MessageFilterDriver,
+    //!  for checking PacketSummary instances.  Only filters that test
+    //!  nothing but facility and severity can be reduced to pairings; any
+    //!  other filter yields an inactive PacketSummaryFilter, which lets
+    //!  every packet through.
+    //------------------------------------------------------------------------
+    class PacketSummaryFilter
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Construct an inactive filter.
+      //----------------------------------------------------------------------
+      PacketSummaryFilter();
+
+      //----------------------------------------------------------------------
+      //!  Construct from @c filter, by evaluating it for every facility
+      //!  and severity.
+      //----------------------------------------------------------------------
+      PacketSummaryFilter(MessageFilterDriver & filter);
+
+      //----------------------------------------------------------------------
+      //!  Returns true if the filter can reject packets.
+      //----------------------------------------------------------------------
+      bool Active() const
+      { return _active; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns true unless no message summarized by @c summary could
+      //!  pass the filter.
+      //----------------------------------------------------------------------
+      bool MayPass(const PacketSummary & summary) const;
+
+      //----------------------------------------------------------------------
+      //!  Returns true if some facility and severity may pass both this
+      //!  filter and @c other.  An inactive filter passes everything.
+      //----------------------------------------------------------------------
+      bool Overlaps(const PacketSummaryFilter & other) const;
+
+      //----------------------------------------------------------------------
+      //!  Returns true if some facility and severity may pass this filter
+      //!  but none of @c others.  Always true if any of @c others is
+      //!  inactive, since it may reject any facility and severity.
+      //----------------------------------------------------------------------
+      bool PassesOutside(const std::vector<PacketSummaryFilter> & others)
+        const;
+      
+    private:
+      bool  _active;
+      //  Severity bitmap of the passing severities of each facility.
+      std::array<uint8_t,PacketSummary::k_numFacilities>  _passing;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGPACKETSUMMARY_HH_
@@ -0,0 +1,200 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogPayloadCompressor.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::PayloadCompressor and
+//!  Dwm::Mclog::PayloadDecompressor class declarations
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGPAYLOADCOMPRESSOR_HH_
+#define _DWMMCLOGPAYLOADCOMPRESSOR_HH_
+
+extern "C" {
+  #include <zstd.h>
+}
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Compresses multicast packet payloads with zstd, optionally using a
+    //!  dictionary trained on our own log messages (see
+    //!  TrainDictionary()).  Log messages are short and repetitive, so a
+    //!  dictionary is what makes per-packet compression worthwhile.  The
+    //!  dictionary is handed to receivers with the multicast key.
+    //------------------------------------------------------------------------
+    class PayloadCompressor
+    {
+    public:
+      //! zstd compression level.  We favor speed; the dictionary does
+      //! most of the work.
+      static constexpr int     k_level = 1;
+      //! Largest dictionary we'll use, since it must fit in the key
+      //! exchange reply with room to spare.
+      static constexpr size_t  k_maxDictionaryLen = 16 * 1024;
+      //! Largest uncompressed payload we'll put in one packet.
+      static constexpr size_t  k_maxRawLen = 256 * 1024;
+      //! Value sent in the key exchange by peers that can decompress
+      //! payloads.
+      static constexpr uint8_t k_zstd = 1;
+      
+      //----------------------------------------------------------------------
+      //!  Default constructor.  No dictionary.
+      //----------------------------------------------------------------------
+      PayloadCompressor();
+
+      PayloadCompressor(const PayloadCompressor &) = delete;
+      PayloadCompressor & operator = (const PayloadCompressor &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Destructor.
+      //----------------------------------------------------------------------
+      ~PayloadCompressor();
+
+      //----------------------------------------------------------------------
+      //!  Uses the dictionary @c dict, or none if @c dict is empty.
+      //!  Returns true on success, false on failure (in which case we
+      //!  have no dictionary).
+      //----------------------------------------------------------------------
+      bool Dictionary(const std::string & dict);
+
+      //----------------------------------------------------------------------
+      //!  Returns the dictionary (empty if none).
+      //----------------------------------------------------------------------
+      const std::string & Dictionary() const
+      { return _dict; }
+      
+      //----------------------------------------------------------------------
+      //!  Compresses the @c srcLen bytes at @c src into @c dst, which has
+      //!  room for @c dstCap bytes.  Returns the compressed length, or 0
+      //!  if the result won't fit in @c dstCap bytes (or on failure).
+      //----------------------------------------------------------------------
+      size_t Compress(const char *src, size_t srcLen,
+                      char *dst, size_t dstCap);
+
+      //----------------------------------------------------------------------
+      //!  Trains a dictionary of at most @c maxLen bytes from the given
+      //!  @c samples (e.g. serialized log messages) and stores it in
+      //!  @c dict.  Returns true on success, false on failure.
+      //----------------------------------------------------------------------
+      static bool TrainDictionary(const std::vector<std::string> & samples,
+                                  size_t maxLen, std::string & dict);
+
+      //----------------------------------------------------------------------
+      //!  Reads the dictionary at @c path into @c dict.  Returns true on
+      //!  success, false on failure (including a file larger than
+      //!  k_maxDictionaryLen).
+      //----------------------------------------------------------------------
+      static bool LoadDictionary(const std::string & path,
+                                 std::string & dict);
+      
+    private:
+      ZSTD_CCtx     *_cctx;
+      ZSTD_CDict    *_cdict;
+      std::string    _dict;
+    };
+
+    //------------------------------------------------------------------------
+    //!  Decompresses payloads compressed by a PayloadCompressor.  The
+    //!  dictionary comes with the multicast key, so it's shared with
+    //!  the MulticastSourceKey that carries it.
+    //------------------------------------------------------------------------
+    class PayloadDecompressor
+    {
+    public:
+      using DictPtr = std::shared_ptr<const std::string>;
+      
+      //----------------------------------------------------------------------
+      //!  Default constructor.  No dictionary.
+      //----------------------------------------------------------------------
+      PayloadDecompressor();
+
+      //----------------------------------------------------------------------
+      //!  Copy constructor.  Contexts aren't shared, only the dictionary.
+      //----------------------------------------------------------------------
+      PayloadDecompressor(const PayloadDecompressor & decomp);
+
+      //----------------------------------------------------------------------
+      //!  Copy assignment.
+      //----------------------------------------------------------------------
+      PayloadDecompressor & operator = (const PayloadDecompressor & decomp);
+      
+      //----------------------------------------------------------------------
+      //!  Destructor.
+      //----------------------------------------------------------------------
+      ~PayloadDecompressor();
+
+      //----------------------------------------------------------------------
+      //!  Returns the dictionary (@c nullptr if none).
+      //----------------------------------------------------------------------
+      const DictPtr & Dictionary() const
+      { return _dict; }
+      
+      //----------------------------------------------------------------------
+      //!  Uses the dictionary @c dict (none if @c nullptr or empty).
+      //----------------------------------------------------------------------
+      void Dictionary(const DictPtr & dict);
+      
+      //----------------------------------------------------------------------
+      //!  Decompresses the @c srcLen bytes at @c src into @c out.  Returns
+      //!  true on success, false on failure.
+      //----------------------------------------------------------------------
+      bool Decompress(const char *src, size_t srcLen, std::string & out);
+
+      //----------------------------------------------------------------------
+      //!  Returns true if the compressed payload @c src of length @c srcLen
+      //!  was compressed with a dictionary other than ours, i.e. we need
+      //!  a fresh dictionary from the sender.
+      //----------------------------------------------------------------------
+      bool WrongDictionary(const char *src, size_t srcLen) const;
+      
+    private:
+      ZSTD_DCtx     *_dctx;
+      ZSTD_DDict    *_ddict;
+      DictPtr        _dict;
+      unsigned       _dictId;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGPAYLOADCOMPRESSOR_HH_
@@ -0,0 +1,169 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogReceiveWorkers.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::ReceiveWorkers class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGRECEIVEWORKERS_HH_
+#define _DWMMCLOGRECEIVEWORKERS_HH_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "DwmMclogBoundedQueue.hh"
+#include "DwmMclogDropCounters.hh"
+#include "DwmMclogIngestQuotas.hh"
+#include "DwmMclogMessageSink.hh"
+#include "DwmMclogMulticastSources.hh"
+#include "DwmMclogUdpEndpoint.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  A pool of threads that decrypt and decode multicast packets and
+    //!  deliver the resulting messages to sinks, so the thread reading
+    //!  from the network only has to hand off each packet.  Each worker
+    //!  owns one shard of the MulticastSources, and every packet from a
+    //!  source goes to the worker owning that source's shard, so each
+    //!  source's packets are processed in the order received.
+    //------------------------------------------------------------------------
+    class ReceiveWorkers
+    {
+    public:
+      //! Maximum packets waiting for each worker.
+      static constexpr size_t  k_queueCapacity = 1024;
+      //! Maximum idle packet buffers kept for reuse.
+      static constexpr size_t  k_maxPooledBuffers = 256;
+      
+      //----------------------------------------------------------------------
+      //!  Construct with the given @c sources that will process packets
+      //!  and the @c sinks that will receive messages, guarded by
+      //!  @c sinksMutex.  Workers take a shared lock on @c sinksMutex
+      //!  while delivering messages.
+      //----------------------------------------------------------------------
+      ReceiveWorkers(MulticastSources *sources,
+                     std::vector<MessageSink *> *sinks,
+                     std::shared_mutex *sinksMutex);
+
+      //----------------------------------------------------------------------
+      //!  Destructor.  Stops the workers.
+      //----------------------------------------------------------------------
+      ~ReceiveWorkers();
+      
+      //----------------------------------------------------------------------
+      //!  Starts @c numWorkers workers (at least 1), resharding the
+      //!  sources to match.  Returns true on success, false if already
+      //!  started.
+      //----------------------------------------------------------------------
+      bool Start(size_t numWorkers);
+
+      //----------------------------------------------------------------------
+      //!  Stops the workers.  Packets not yet processed are discarded.
+      //----------------------------------------------------------------------
+      void Stop();
+
+      //----------------------------------------------------------------------
+      //!  Sets the ingest @c quotas messages must be within to be
+      //!  delivered.  @c quotas may be nullptr (the default), for no
+      //!  quotas.  Must be called before Start().
+      //----------------------------------------------------------------------
+      void Quotas(IngestQuotas *quotas)
+      { _quotas = quotas; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the number of running workers.
+      //----------------------------------------------------------------------
+      size_t Size() const
+      { return _workers.size(); }
+      
+      //----------------------------------------------------------------------
+      //!  Copies the packet @c data of length @c datalen from @c src into
+      //!  a pooled buffer and queues it for the worker responsible for
+      //!  @c src.  Returns true if queued, false if the worker's queue is
+      //!  full (in which case the drop is counted) or no workers are
+      //!  running.  Must not be called concurrently with Start() or
+      //!  Stop().
+      //----------------------------------------------------------------------
+      bool Dispatch(const UdpEndpoint & src, const char *data,
+                    size_t datalen);
+
+      //----------------------------------------------------------------------
+      //!  Returns the packets dropped due to full worker queues since the
+      //!  last call.  Threadsafe.
+      //----------------------------------------------------------------------
+      DropCounts HarvestDrops()
+      { return _drops.Harvest(); }
+      
+    private:
+      struct Packet
+      {
+        UdpEndpoint        src;
+        std::vector<char>  data;
+      };
+
+      struct Worker
+      {
+        BoundedQueue<Packet>  queue;
+        std::thread           thread;
+      };
+
+      MulticastSources                       *_sources;
+      std::vector<MessageSink *>             *_sinks;
+      std::shared_mutex                      *_sinksMutex;
+      IngestQuotas                           *_quotas;
+      std::vector<std::unique_ptr<Worker>>    _workers;
+      std::atomic<bool>                       _run;
+      std::mutex                              _poolMtx;
+      std::vector<std::vector<char>>          _pool;
+      DropCounters                            _drops;
+
+      std::vector<char> Buffer();
+      void Release(std::vector<char> && buf);
+      void Deliver(const std::vector<Message> & msgs);
+      void Run(Worker *worker);
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGRECEIVEWORKERS_HH_
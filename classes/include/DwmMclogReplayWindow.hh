@@ -0,0 +1,171 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogReplayWindow.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::ReplayWindow class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGREPLAYWINDOW_HH_
+#define _DWMMCLOGREPLAYWINDOW_HH_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "DwmMclogSourceStats.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Sliding window of packet counters seen from one multicast source,
+    //!  used to reject duplicate and replayed packets.  Counters are only
+    //!  meaningful within a nonce prefix (see NonceSequence), so we keep
+    //!  a window for each of the k_maxPrefixes most recently used
+    //!  prefixes; a sender that restarts gets a new prefix.  Only call
+    //!  Accept() for packets that decrypted successfully, since the
+    //!  counter is only authenticated then.
+    //!
+    //!  Accept() can also do loss accounting.  A counter is counted as
+    //!  lost when it slides out of the window without having been seen,
+    //!  so a packet that arrives late but within the window is counted
+    //!  as reordered, not lost.  Missing() reports the counters that
+    //!  may still be repaired before they're counted as lost.  Counters
+    //!  of packets we received but didn't decrypt (see Skip()) are
+    //!  neither lost nor missing.
+    //------------------------------------------------------------------------
+    class ReplayWindow
+    {
+    public:
+      //! Number of counters below the highest seen that we track.
+      static constexpr uint64_t  k_windowSize = 64;
+      static constexpr size_t    k_maxPrefixes = 4;
+      //! Most runs of skipped counters we remember per prefix.
+      static constexpr size_t    k_maxSkipRuns = 16;
+      
+      ReplayWindow();
+
+      //----------------------------------------------------------------------
+      //!  Returns true and records @c counter if we have not seen it with
+      //!  the given @c prefix and it is within the window.  Returns false
+      //!  for duplicates and for counters too far behind the window.
+      //!  If @c stats is not @c nullptr, adds lost, reordered, duplicated
+      //!  and late packets to it (but not received packets; that's up to
+      //!  the caller).
+      //----------------------------------------------------------------------
+      bool Accept(const std::string & prefix, uint64_t counter,
+                  SourceStats *stats = nullptr);
+
+      //----------------------------------------------------------------------
+      //!  Appends to @c counters, in ascending order, the counters with
+      //!  the given @c prefix that are at least @c from, at least
+      //!  @c minBehind below the highest counter seen and still in the
+      //!  window, but that we haven't seen.  Returns the number of
+      //!  counters appended.
+      //----------------------------------------------------------------------
+      size_t Missing(const std::string & prefix, uint64_t from,
+                     uint64_t minBehind,
+                     std::vector<uint64_t> & counters) const;
+
+      //----------------------------------------------------------------------
+      //!  Records that we received the packet with the given @c prefix
+      //!  and @c counter but didn't decrypt it (see PacketSummaryFilter),
+      //!  so it's not counted as lost or reported by Missing().  Since the
+      //!  counter isn't authenticated, it has no effect on Accept().
+      //!  Ignored if we haven't accepted a packet with @c prefix.
+      //----------------------------------------------------------------------
+      void Skip(const std::string & prefix, uint64_t counter);
+
+      //----------------------------------------------------------------------
+      //!  Returns true if we've accepted @c counter with the given
+      //!  @c prefix and it's still in the window.  Unlike Accept(), this
+      //!  may be used before decryption: a packet with a counter we've
+      //!  accepted is a copy or a forgery, either way not worth
+      //!  decrypting.
+      //----------------------------------------------------------------------
+      bool Seen(const std::string & prefix, uint64_t counter) const;
+
+      //----------------------------------------------------------------------
+      //!  Returns true if @c counter with the given @c prefix was passed
+      //!  to Skip() and is still in the window.
+      //----------------------------------------------------------------------
+      bool Skipped(const std::string & prefix, uint64_t counter) const;
+
+      //----------------------------------------------------------------------
+      //!  Returns the prefixes we have windows for, most recently used
+      //!  first.
+      //----------------------------------------------------------------------
+      std::vector<std::string> Prefixes() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns true if we have a window for @c prefix, i.e. we've
+      //!  accepted a packet with it.
+      //----------------------------------------------------------------------
+      bool Tracks(const std::string & prefix) const
+      { return (nullptr != Find(prefix)); }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the number of packets rejected by Accept().
+      //----------------------------------------------------------------------
+      uint64_t Rejected() const
+      { return _rejected; }
+      
+    private:
+      struct Window
+      {
+        std::string  prefix;
+        uint64_t     highest;
+        uint64_t     bitmap;   // bit n set if (highest - n) was seen
+        uint64_t     floor;    // lowest counter seen
+        std::vector<std::pair<uint64_t,uint64_t>>  skipped;  // first, last
+      };
+
+      const Window *Find(const std::string & prefix) const;
+      static uint64_t Advance(Window & w, uint64_t counter);
+      static uint64_t SkippedBits(const Window & w);
+      static uint64_t NumSkipped(const Window & w, uint64_t first,
+                                 uint64_t last);
+
+      std::vector<Window>  _windows;   // most recently used first
+      uint64_t             _rejected;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGREPLAYWINDOW_HH_
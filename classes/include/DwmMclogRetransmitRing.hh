@@ -0,0 +1,189 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogRetransmitRing.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::RetransmitRing class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGRETRANSMITRING_HH_
+#define _DWMMCLOGRETRANSMITRING_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DwmMclogNack.hh"
+#include "DwmMclogUdpEndpoint.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  The most recent encrypted packets sent by a MulticastSender, kept
+    //!  so that we can resend them to receivers that NACK them (see
+    //!  Nack).  Packets are stored by counter, so a packet is available
+    //!  until k_capacity newer packets have been sent.
+    //!
+    //!  A packet requested by one receiver is resent to that receiver
+    //!  alone.  Once k_multicastThreshold different receivers have
+    //!  requested the same packet, the loss was probably upstream of all
+    //!  of them and we resend it to the multicast group instead, once.
+    //!  Each receiver address is held to a token bucket of packets.
+    //!
+    //!  Threadsafe; the sender thread adds packets while the key request
+    //!  listener thread handles NACKs.
+    //------------------------------------------------------------------------
+    class RetransmitRing
+    {
+    public:
+      static constexpr size_t  k_defaultCapacity = 1024;
+      static constexpr size_t  k_multicastThreshold = 3;
+      static constexpr double  k_defaultRate = 500.0;
+      static constexpr double  k_defaultBurst = 1000.0;
+      static constexpr size_t  k_maxTrackedAddrs = 1024;
+
+      //----------------------------------------------------------------------
+      //!  A packet to resend.
+      //----------------------------------------------------------------------
+      struct Retransmit
+      {
+        std::string  data;       //!< the packet as originally sent
+        bool         multicast;  //!< send to the group, not the requester
+      };
+      
+      //----------------------------------------------------------------------
+      //!  Counts since the previous Harvest().
+      //----------------------------------------------------------------------
+      struct Counts
+      {
+        uint64_t  requested   = 0;   //!< counters requested in NACKs
+        uint64_t  unicast     = 0;   //!< packets resent to a requester
+        uint64_t  multicast   = 0;   //!< packets resent to the group
+        uint64_t  missed      = 0;   //!< requested but no longer held
+        uint64_t  rateLimited = 0;   //!< requested but over the limit
+
+        //!  Returns true if there's nothing to report.
+        bool Empty() const
+        { return (0 == requested); }
+        
+        //!  Adds all of the counts in @c counts to our counts.
+        Counts & operator += (const Counts & counts);
+        
+        //!  Returns a human-readable summary of the counts.
+        std::string Summary() const;
+      };
+
+      //----------------------------------------------------------------------
+      //!  Construct a ring of @c capacity packets.  Each receiver address
+      //!  may have a sustained @c rate packets per second resent to it,
+      //!  and @c burst back to back.
+      //----------------------------------------------------------------------
+      RetransmitRing(size_t capacity = k_defaultCapacity,
+                     double rate = k_defaultRate,
+                     double burst = k_defaultBurst);
+
+      RetransmitRing(const RetransmitRing &) = delete;
+      RetransmitRing & operator = (const RetransmitRing &) = delete;
+
+      //----------------------------------------------------------------------
+      //!  Saves the encrypted packet @c data of length @c len, replacing
+      //!  the oldest packet if the ring is full.  Ignores packets without
+      //!  a NonceSequence header.
+      //----------------------------------------------------------------------
+      void Add(const char *data, size_t len);
+
+      //----------------------------------------------------------------------
+      //!  Appends the packets requested in @c nack by the receiver at
+      //!  @c src to @c repairs.  Returns the number of packets appended.
+      //----------------------------------------------------------------------
+      size_t Repairs(const Nack & nack, const UdpEndpoint & src,
+                     std::vector<Retransmit> & repairs);
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of packets held.
+      //----------------------------------------------------------------------
+      size_t Size() const;
+      
+      //----------------------------------------------------------------------
+      //!  Discards all packets.
+      //----------------------------------------------------------------------
+      void Clear();
+      
+      //----------------------------------------------------------------------
+      //!  Returns the counts since the last call and resets them.
+      //----------------------------------------------------------------------
+      Counts Harvest();
+      
+    private:
+      using Clock = std::chrono::steady_clock;
+      
+      struct Slot
+      {
+        std::string               prefix;
+        uint64_t                  counter = 0;
+        std::string               data;
+        std::vector<UdpEndpoint>  requesters;
+        bool                      multicast = false;
+      };
+
+      struct Bucket
+      {
+        double             tokens;
+        Clock::time_point  last;
+      };
+      
+      mutable std::mutex                       _mtx;
+      std::vector<Slot>                        _slots;
+      size_t                                   _size;
+      double                                   _rate;
+      double                                   _burst;
+      std::unordered_map<std::string,Bucket>   _buckets;
+      Counts                                   _counts;
+
+      bool Repair(const std::string & prefix, uint64_t counter,
+                  const UdpEndpoint & src,
+                  std::vector<Retransmit> & repairs);
+      bool TakeToken(const UdpEndpoint & src, Clock::time_point now);
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGRETRANSMITRING_HH_
@@ -0,0 +1,122 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogSourceStats.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::SourceStats class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGSOURCESTATS_HH_
+#define _DWMMCLOGSOURCESTATS_HH_
+
+#include <cstdint>
+#include <string>
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Reception counts for one multicast source.  Sequence accounting
+    //!  uses the packet counter in each packet's nonce header (see
+    //!  NonceSequence and ReplayWindow), so packets from senders too old
+    //!  to have one are only counted in @c received.
+    //------------------------------------------------------------------------
+    class SourceStats
+    {
+    public:
+      uint64_t  received;     //! packets decrypted and accepted
+      uint64_t  lost;         //! packets never received
+      uint64_t  reordered;    //! packets received after a later packet
+      uint64_t  duplicated;   //! duplicate (or replayed) packets
+      uint64_t  late;         //! packets too far behind to check
+      uint64_t  nacked;       //! packets we asked the sender to resend
+      uint64_t  recovered;    //! packets rebuilt from FEC parity
+      uint64_t  skipped;      //! packets no message of which could pass
+                              //! our filter, so not decrypted
+      uint64_t  mirrored;     //! copies from the sender's other address
+                              //! family, so not decrypted
+      uint64_t  messages;     //! messages delivered
+      int64_t   lagTotal;     //! sum of message lag, microseconds
+      int64_t   lagMax;       //! largest message lag, microseconds
+
+      SourceStats();
+      SourceStats(const SourceStats &) = default;
+      SourceStats & operator = (const SourceStats &) = default;
+
+      //----------------------------------------------------------------------
+      //!  Records the delivery of a message that was sent @c lagUsecs
+      //!  microseconds ago, per its timestamp.  Includes any clock offset
+      //!  between the sender and us.
+      //----------------------------------------------------------------------
+      void AddMessage(int64_t lagUsecs);
+
+      //----------------------------------------------------------------------
+      //!  Adds all of the counts in @c stats to our counts.
+      //----------------------------------------------------------------------
+      SourceStats & operator += (const SourceStats & stats);
+      
+      //----------------------------------------------------------------------
+      //!  Returns the mean message lag in microseconds.
+      //----------------------------------------------------------------------
+      int64_t LagMean() const
+      { return (messages ? (lagTotal / (int64_t)messages) : 0); }
+
+      //----------------------------------------------------------------------
+      //!  Returns true if packets were lost, duplicated or late.
+      //----------------------------------------------------------------------
+      bool Impaired() const
+      { return (lost || duplicated || late); }
+      
+      //----------------------------------------------------------------------
+      //!  Returns true if nothing has been counted.
+      //----------------------------------------------------------------------
+      bool Empty() const
+      { return (! (received || Impaired() || nacked || recovered
+                 || skipped || mirrored || messages)); }
+      
+      //----------------------------------------------------------------------
+      //!  Returns a human-readable summary, e.g.
+      //!  "1000 pkts, 3 lost, 1 reordered, 0 dup, 0 late, 4 nacked,
+      //!   2 recovered, 0 skipped, 1000 mirrored, 5120 msgs,
+      //!   lag 2.1ms mean 15.0ms max".
+      //----------------------------------------------------------------------
+      std::string Summary() const;
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGSOURCESTATS_HH_
@@ -0,0 +1,199 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogTimerWheel.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::TimerWheel class template
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGTIMERWHEEL_HH_
+#define _DWMMCLOGTIMERWHEEL_HH_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  A hashed timer wheel for expiring large numbers of entries (e.g.
+    //!  multicast sources) cheaply.  Schedule() and Expire() are O(1)
+    //!  amortized per entry instead of a scan of every entry.  Time is
+    //!  kept in ticks; an entry is returned by Expire() within one tick
+    //!  after its scheduled time.
+    //!
+    //!  A typical user schedules each entry once, and when it's returned
+    //!  by Expire() checks whether it's really idle, removing it if so or
+    //!  scheduling it again for its new expiry time if not.  That avoids
+    //!  touching the wheel on every use of an entry.
+    //!
+    //!  Not threadsafe; callers must provide their own locking.
+    //------------------------------------------------------------------------
+    template <typename Key, typename Clock = std::chrono::system_clock>
+    class TimerWheel
+    {
+    public:
+      using TimePoint = typename Clock::time_point;
+      using Duration = typename Clock::duration;
+      
+      //----------------------------------------------------------------------
+      //!  Construct with the given @c tick length and number of slots
+      //!  @c numSlots.  Entries scheduled further than
+      //!  @c tick * @c numSlots in the future are checked (and kept) once
+      //!  per revolution of the wheel.
+      //----------------------------------------------------------------------
+      TimerWheel(Duration tick = std::chrono::seconds(1),
+                 size_t numSlots = 64)
+          : _tick(std::max(tick, Duration(1))),
+            _slots(std::max(numSlots, (size_t)1)),
+            _lastTick(k_notStarted), _size(0)
+      {}
+
+      //----------------------------------------------------------------------
+      //!  Schedules @c key to be returned by Expire() at or after @c when.
+      //!  A key scheduled more than once will be returned once for each
+      //!  time it was scheduled.
+      //----------------------------------------------------------------------
+      void Schedule(const Key & key, TimePoint when)
+      {
+        int64_t  tick = Tick(when);
+        if ((k_notStarted != _lastTick) && (tick <= _lastTick)) {
+          //  Already passed that slot; use the next one we'll visit.
+          tick = _lastTick + 1;
+        }
+        _slots[SlotIndex(tick)].push_back(Entry{tick, key});
+        ++_size;
+        return;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Removes the entries whose scheduled time has passed as of @c now
+      //!  and appends their keys to @c expired.  Returns the number of
+      //!  keys appended.
+      //----------------------------------------------------------------------
+      size_t Expire(TimePoint now, std::vector<Key> & expired)
+      {
+        size_t   rc = 0;
+        int64_t  nowTick = Tick(now);
+        //  Only visit ticks that are entirely in the past.
+        if ((k_notStarted == _lastTick)
+            || ((nowTick - _lastTick) > (int64_t)_slots.size())) {
+          for (auto & slot : _slots) {
+            rc += ExpireSlot(slot, nowTick, expired);
+          }
+        }
+        else {
+          for (int64_t tick = _lastTick + 1; tick < nowTick; ++tick) {
+            rc += ExpireSlot(_slots[SlotIndex(tick)], nowTick, expired);
+          }
+        }
+        _lastTick = std::max(_lastTick, nowTick - 1);
+        return rc;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of scheduled entries.
+      //----------------------------------------------------------------------
+      size_t Size() const
+      { return _size; }
+      
+      //----------------------------------------------------------------------
+      //!  Removes all scheduled entries.
+      //----------------------------------------------------------------------
+      void Clear()
+      {
+        for (auto & slot : _slots) {
+          slot.clear();
+        }
+        _size = 0;
+        return;
+      }
+      
+    private:
+      static constexpr int64_t  k_notStarted =
+        std::numeric_limits<int64_t>::min();
+      
+      struct Entry
+      {
+        int64_t  tick;
+        Key      key;
+      };
+
+      Duration                          _tick;
+      std::vector<std::vector<Entry>>   _slots;
+      int64_t                           _lastTick;
+      size_t                            _size;
+
+      //----------------------------------------------------------------------
+      int64_t Tick(TimePoint tp) const
+      { return (tp.time_since_epoch() / _tick); }
+
+      //----------------------------------------------------------------------
+      size_t SlotIndex(int64_t tick) const
+      {
+        int64_t  n = _slots.size();
+        return (((tick % n) + n) % n);
+      }
+      
+      //----------------------------------------------------------------------
+      size_t ExpireSlot(std::vector<Entry> & slot, int64_t nowTick,
+                        std::vector<Key> & expired)
+      {
+        size_t  rc = 0;
+        for (size_t i = 0; i < slot.size(); ) {
+          if (slot[i].tick < nowTick) {
+            expired.push_back(std::move(slot[i].key));
+            slot[i] = std::move(slot.back());
+            slot.pop_back();
+            ++rc;
+          }
+          else {
+            ++i;
+          }
+        }
+        _size -= rc;
+        return rc;
+      }
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGTIMERWHEEL_HH_
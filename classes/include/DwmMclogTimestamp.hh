@@ -60,6 +60,13 @@ namespace Dwm {
       //!  Default constructor
       //----------------------------------------------------------------------
       Timestamp();
+
+      //----------------------------------------------------------------------
+      //!  Construct from microseconds since the UNIX epoch.
+      //----------------------------------------------------------------------
+      explicit Timestamp(uint64_t usecs)
+          : _usecs(usecs)
+      {}
       
       //----------------------------------------------------------------------
       //!  Copy constructor
@@ -138,6 +145,12 @@ namespace Dwm {
       uint64_t Usecs() const
       { return _usecs % 1000000ull; }
 
+      //----------------------------------------------------------------------
+      //!  Returns the timestamp as microseconds since the UNIX epoch.
+      //----------------------------------------------------------------------
+      uint64_t Microseconds() const
+      { return _usecs; }
+
       //----------------------------------------------------------------------
       //!  Print a timestamp to an ostream in human-readable form.
       //----------------------------------------------------------------------
@@ -0,0 +1,116 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogTokenBucket.hh
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::TokenBucket class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMMCLOGTOKENBUCKET_HH_
+#define _DWMMCLOGTOKENBUCKET_HH_
+
+#include <chrono>
+#include <cstdint>
+
+#include "DwmMclogPacingPolicy.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    //!  Packet and byte token buckets used to pace a sender per a
+    //!  PacingPolicy.  Both buckets hold up to the policy's burst (in
+    //!  packets, and in packets of the configured length) and refill at
+    //!  the policy's rates.  A sender checks Ready() before sending and
+    //!  calls Consume() afterward.  Consume() may leave a bucket in debt,
+    //!  so a batch of packets can be sent whole; the sender then waits
+    //!  until the debt is repaid.  Not threadsafe.
+    //------------------------------------------------------------------------
+    class TokenBucket
+    {
+    public:
+      using Clock = std::chrono::steady_clock;
+      
+      //----------------------------------------------------------------------
+      //!  Default constructor.  Never holds a sender back.
+      //----------------------------------------------------------------------
+      TokenBucket();
+
+      //----------------------------------------------------------------------
+      //!  Configures from @c policy for packets of length @c packetLen,
+      //!  with full buckets.
+      //----------------------------------------------------------------------
+      void Configure(const PacingPolicy & policy, size_t packetLen,
+                     Clock::time_point now = Clock::now());
+
+      //----------------------------------------------------------------------
+      //!  Returns true if we have a packet or byte limit.
+      //----------------------------------------------------------------------
+      bool Enabled() const
+      { return ((_packetRate > 0) || (_byteRate > 0)); }
+      
+      //----------------------------------------------------------------------
+      //!  Returns true if a sender may send at time @c now.
+      //----------------------------------------------------------------------
+      bool Ready(Clock::time_point now = Clock::now());
+
+      //----------------------------------------------------------------------
+      //!  Returns the time from @c now until Ready() will be true.
+      //----------------------------------------------------------------------
+      std::chrono::microseconds Wait(Clock::time_point now = Clock::now());
+
+      //----------------------------------------------------------------------
+      //!  Takes @c packets packets totaling @c bytes bytes from the
+      //!  buckets.
+      //----------------------------------------------------------------------
+      void Consume(size_t packets, size_t bytes);
+      
+    private:
+      double             _packetRate;
+      double             _byteRate;
+      double             _maxPackets;
+      double             _maxBytes;
+      double             _packets;
+      double             _bytes;
+      Clock::time_point  _last;
+
+      void Refill(Clock::time_point now);
+    };
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
+
+#endif  // _DWMMCLOGTOKENBUCKET_HH_
@@ -48,6 +48,8 @@
 #  endif
 #endif
 
+#include <functional>
+
 #include "DwmIpAddress.hh"
 
 namespace Dwm {
@@ -145,6 +147,12 @@ namespace Dwm {
       //----------------------------------------------------------------------
       bool operator == (const UdpEndpoint &) const = default;
 
+      //----------------------------------------------------------------------
+      //!  Returns a hash of the address and port, for unordered
+      //!  containers.
+      //----------------------------------------------------------------------
+      size_t Hash() const;
+      
       //----------------------------------------------------------------------
       //!  Return the end point as a human-readable string.
       //----------------------------------------------------------------------
@@ -165,6 +173,18 @@ namespace Dwm {
 
 }  // namespace Dwm
 
+namespace std {
+  //--------------------------------------------------------------------------
+  //!  Hash for Dwm::Mclog::UdpEndpoint
+  //--------------------------------------------------------------------------
+  template <>
+  struct hash<Dwm::Mclog::UdpEndpoint>
+  {
+    size_t operator () (const Dwm::Mclog::UdpEndpoint & ep) const noexcept
+    { return ep.Hash(); }
+  };
+}
+
 #if __has_include(<format>)
 
 namespace std {
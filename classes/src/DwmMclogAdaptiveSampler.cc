@@ -0,0 +1,254 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogAdaptiveSampler.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::AdaptiveSampler class implementation
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+
+#include "DwmMclogAdaptiveSampler.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    namespace {
+
+      const std::string  k_markPrefix(" [sampled 1/");
+      
+      //----------------------------------------------------------------------
+      //!  64-bit FNV-1a, with a final avalanche so the low bits we test
+      //!  depend on every input byte.  Must be the same everywhere, since
+      //!  collectors rely on agreeing about which messages to keep.
+      //----------------------------------------------------------------------
+      class SampleHash
+      {
+      public:
+        void Add(const char *data, size_t len)
+        {
+          for (size_t i = 0; i < len; ++i) {
+            _hash ^= (uint8_t)data[i];
+            _hash *= 0x100000001b3ULL;
+          }
+        }
+        
+        void Add(const std::string & s)
+        { Add(s.data(), s.size()); }
+        
+        uint64_t Value() const
+        {
+          uint64_t  h = _hash;
+          h ^= h >> 33;
+          h *= 0xff51afd7ed558ccdULL;
+          h ^= h >> 33;
+          h *= 0xc4ceb9fe1a85ec53ULL;
+          h ^= h >> 33;
+          return h;
+        }
+        
+      private:
+        uint64_t  _hash = 0xcbf29ce484222325ULL;
+      };
+      
+    }  // anonymous namespace
+    
+    //------------------------------------------------------------------------
+    AdaptiveSampler::AdaptiveSampler()
+        : _mtx(), _threshold(0), _capacity(0), _rate(1), _windowStart(),
+          _windowStartLength(0), _offered(0), _urgent(0), _kept(0),
+          _sampled()
+    {}
+
+    //------------------------------------------------------------------------
+    void AdaptiveSampler::Configure(uint32_t threshold, size_t capacity)
+    {
+      std::lock_guard  lck(_mtx);
+      _threshold = std::min(threshold, (uint32_t)100);
+      _capacity = capacity;
+      _rate = 1;
+      _windowStart = Clock::now();
+      _windowStartLength = 0;
+      _offered = 0;
+      _urgent = 0;
+      _kept = 0;
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    bool AdaptiveSampler::Enabled() const
+    {
+      std::lock_guard  lck(_mtx);
+      return (_threshold && _capacity);
+    }
+    
+    //------------------------------------------------------------------------
+    bool AdaptiveSampler::Admit(const Message & msg, size_t queueLength,
+                                uint32_t & rate, Clock::time_point now)
+    {
+      rate = 1;
+      std::lock_guard  lck(_mtx);
+      if (! (_threshold && _capacity)) {
+        return true;
+      }
+      Adjust(queueLength, now);
+      if (! Sampleable(msg.Header().severity())) {
+        ++_urgent;
+        ++_kept;
+        return true;
+      }
+      ++_offered;
+      if ((_rate > 1) && (! Selected(msg, _rate))) {
+        _sampled.Add(msg.Header().severity(), msg.Header().origin().hostname()
+                     + '/' + msg.Header().origin().appname());
+        return false;
+      }
+      ++_kept;
+      rate = _rate;
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    uint32_t AdaptiveSampler::Rate() const
+    {
+      std::lock_guard  lck(_mtx);
+      return _rate;
+    }
+
+    //------------------------------------------------------------------------
+    bool AdaptiveSampler::Selected(const Message & msg, uint32_t rate)
+    {
+      if (rate <= 1) {
+        return true;
+      }
+      size_t  textLen;
+      MarkedRate(msg, &textLen);
+      const MessageOrigin  & origin = msg.Header().origin();
+      SampleHash  hash;
+      hash.Add(origin.hostname());
+      hash.Add("/", 1);
+      hash.Add(origin.appname());
+      hash.Add("/", 1);
+      hash.Add(msg.Data().data(), textLen);
+      return ((hash.Value() & (rate - 1)) == 0);
+    }
+
+    //------------------------------------------------------------------------
+    Message AdaptiveSampler::Annotate(const Message & msg, uint32_t rate)
+    {
+      size_t    textLen;
+      uint32_t  marked = MarkedRate(msg, &textLen);
+      std::string  mark = k_markPrefix
+        + std::to_string(std::max(rate, marked)) + ']';
+      size_t    maxLen = Message::k_maxTextLen - mark.size();
+      std::string  text(msg.Data(), 0, std::min(textLen, maxLen));
+      return Message(msg.Header(), text + mark);
+    }
+
+    //------------------------------------------------------------------------
+    uint32_t AdaptiveSampler::MarkedRate(const Message & msg,
+                                         size_t *textLen)
+    {
+      const std::string  & data = msg.Data();
+      uint32_t  rc = 1;
+      size_t    len = data.size();
+      if ((! data.empty()) && (data.back() == ']')) {
+        size_t  idx = data.rfind(k_markPrefix);
+        if (idx != std::string::npos) {
+          const char  *first = data.data() + idx + k_markPrefix.size();
+          const char  *last = data.data() + data.size() - 1;
+          uint32_t     val;
+          auto  [ptr, ec] = std::from_chars(first, last, val);
+          if ((ec == std::errc()) && (ptr == last)
+              && std::has_single_bit(val)) {
+            rc = val;
+            len = idx;
+          }
+        }
+      }
+      if (textLen) {
+        *textLen = len;
+      }
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  At the end of each interval, compares the queue's growth to what
+    //!  was kept to learn how fast it drained.  If it's past the threshold
+    //!  and still growing, or would fill during the next interval, we
+    //!  raise the rate to what the drain rate can keep up with, and at
+    //!  least double it.  If it's well under the threshold, or under the
+    //!  threshold and shrinking, we halve the rate.
+    //------------------------------------------------------------------------
+    void AdaptiveSampler::Adjust(size_t queueLength, Clock::time_point now)
+    {
+      if ((now - _windowStart) < k_interval) {
+        return;
+      }
+      std::chrono::duration<double>  elapsed = now - _windowStart;
+      int64_t  growth = (int64_t)queueLength - (int64_t)_windowStartLength;
+      //  Projected growth over the next interval at this interval's rates.
+      double   projected =
+        growth * (std::chrono::duration<double>(k_interval) / elapsed);
+      uint64_t  fill = (queueLength * 100) / _capacity;
+      
+      if (((fill >= _threshold) && (growth > 0))
+          || ((growth > 0) && ((queueLength + projected) >= _capacity))) {
+        uint64_t  drained = std::max<int64_t>(0, (int64_t)_kept - growth);
+        uint64_t  needed = k_maxRate;
+        if (drained > _urgent) {
+          needed = (_offered + (drained - _urgent) - 1)
+            / (drained - _urgent);
+        }
+        needed = std::max<uint64_t>(std::bit_ceil(needed), _rate * 2);
+        _rate = (uint32_t)std::min<uint64_t>(needed, k_maxRate);
+      }
+      else if ((fill < (_threshold / 2))
+               || ((fill < _threshold) && (growth < 0))) {
+        _rate = std::max(_rate / 2, (uint32_t)1);
+      }
+      _windowStart = now;
+      _windowStartLength = queueLength;
+      _offered = 0;
+      _urgent = 0;
+      _kept = 0;
+      return;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
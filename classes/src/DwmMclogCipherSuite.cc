@@ -0,0 +1,142 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogCipherSuite.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::CipherSuite and Dwm::Mclog::NonceSequence
+//!  implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sodium.h>
+}
+
+#include <algorithm>
+#include <cstring>
+
+#include "DwmMclogCipherSuite.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    uint8_t LocalCipherSuites()
+    {
+      static const uint8_t  suites = [] () {
+        uint8_t  rc = CipherSuiteBit(CipherSuite::xchacha20poly1305);
+        //  sodium_init() detects CPU features.  It's idempotent.
+        if ((sodium_init() >= 0) && crypto_aead_aes256gcm_is_available()) {
+          rc |= CipherSuiteBit(CipherSuite::aes256gcm);
+        }
+        return rc;
+      }();
+      return suites;
+    }
+
+    //------------------------------------------------------------------------
+    CipherSuite BestCipherSuite(uint8_t suites)
+    {
+      if (suites & CipherSuiteBit(CipherSuite::aes256gcm)) {
+        return CipherSuite::aes256gcm;
+      }
+      return CipherSuite::xchacha20poly1305;
+    }
+    
+    //------------------------------------------------------------------------
+    std::string CipherSuiteName(CipherSuite suite)
+    {
+      switch (suite) {
+        case CipherSuite::xchacha20poly1305:
+          return "XChaCha20-Poly1305";
+        case CipherSuite::aes256gcm:
+          return "AES-256-GCM";
+        default:
+          break;
+      }
+      return "unknown";
+    }
+    
+    //------------------------------------------------------------------------
+    NonceSequence::NonceSequence(CipherSuite suite)
+        : _suite(suite), _prefix(), _counter(0)
+    {
+      NewPrefix();
+    }
+
+    //------------------------------------------------------------------------
+    void NonceSequence::Next(uint8_t *hdr)
+    {
+      if (_counter > k_maxCounter) {
+        NewPrefix();
+      }
+      std::copy(k_tag.begin(), k_tag.end(), hdr);
+      hdr[k_suiteOffset] = (uint8_t)_suite;
+      memcpy(hdr + k_prefixOffset, _prefix.data(), k_prefixLen);
+      for (size_t i = 0; i < k_counterLen; ++i) {
+        hdr[k_counterOffset + i] =
+          (_counter >> (8 * (k_counterLen - 1 - i))) & 0xFF;
+      }
+      ++_counter;
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    bool NonceSequence::Parse(const uint8_t *hdr, CipherSuite & suite,
+                              std::string & prefix, uint64_t & counter)
+    {
+      if (! std::equal(k_tag.begin(), k_tag.end(), hdr)) {
+        return false;
+      }
+      suite = (CipherSuite)(hdr[k_suiteOffset]
+                            & ~(k_compressedFlag | k_summaryFlag));
+      prefix.assign((const char *)hdr + k_prefixOffset, k_prefixLen);
+      counter = 0;
+      for (size_t i = 0; i < k_counterLen; ++i) {
+        counter = (counter << 8) | hdr[k_counterOffset + i];
+      }
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    void NonceSequence::NewPrefix()
+    {
+      randombytes_buf(_prefix.data(), _prefix.size());
+      _counter = 0;
+      return;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
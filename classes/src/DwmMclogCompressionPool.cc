@@ -0,0 +1,484 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogCompressionPool.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::CompressionPool implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/resource.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#if defined(__linux__)
+  #include <sys/syscall.h>
+#endif
+  #include <bzlib.h>
+  #include <zlib.h>
+}
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <utility>
+
+#include "DwmMclogCompressionPool.hh"
+#include "DwmMclogLogger.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    static const std::map<std::string,std::string>  sg_compressionExt = {
+      { "bzip2", "bz2" },
+      { "gzip",  "gz"  }
+    };
+
+    static constexpr size_t  k_bufferSize = 64 * 1024;
+    
+    //------------------------------------------------------------------------
+    //!  Reads up to @c len bytes from @c fd into @c buf, retrying if
+    //!  interrupted.  Returns the number of bytes read, 0 at end of file
+    //!  or -1 on error.
+    //------------------------------------------------------------------------
+    static ssize_t ReadSome(int fd, char *buf, size_t len)
+    {
+      ssize_t  rc;
+      do {
+        rc = read(fd, buf, len);
+      } while ((rc < 0) && (EINTR == errno));
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Compresses from @c ifd to @c ofd with bzip2.  Closes @c ofd.
+    //------------------------------------------------------------------------
+    static bool Bzip2(int ifd, int ofd, const std::string & path)
+    {
+      FILE  *f = fdopen(ofd, "wb");
+      if (! f) {
+        MCLOG(Severity::err, "fdopen() failed for '{}': {}",
+              path, strerror(errno));
+        close(ofd);
+        return false;
+      }
+      int      bzerr = BZ_OK;
+      BZFILE  *bzf = BZ2_bzWriteOpen(&bzerr, f, 9, 0, 0);
+      if (BZ_OK != bzerr) {
+        MCLOG(Severity::err, "BZ2_bzWriteOpen() failed for '{}': {}",
+              path, bzerr);
+        fclose(f);
+        return false;
+      }
+      std::vector<char>  buf(k_bufferSize);
+      bool     rc = true;
+      ssize_t  n;
+      while ((n = ReadSome(ifd, buf.data(), buf.size())) > 0) {
+        BZ2_bzWrite(&bzerr, bzf, buf.data(), n);
+        if (BZ_OK != bzerr) {
+          MCLOG(Severity::err, "BZ2_bzWrite() failed for '{}': {}",
+                path, bzerr);
+          rc = false;
+          break;
+        }
+      }
+      if (n < 0) {
+        MCLOG(Severity::err, "read() failed for '{}': {}",
+              path, strerror(errno));
+        rc = false;
+      }
+      BZ2_bzWriteClose(&bzerr, bzf, (rc ? 0 : 1), nullptr, nullptr);
+      if (rc && (BZ_OK != bzerr)) {
+        MCLOG(Severity::err, "BZ2_bzWriteClose() failed for '{}': {}",
+              path, bzerr);
+        rc = false;
+      }
+      if (0 != fclose(f)) {
+        if (rc) {
+          MCLOG(Severity::err, "fclose() failed for '{}': {}",
+                path, strerror(errno));
+        }
+        rc = false;
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Compresses from @c ifd to @c ofd with gzip.  Closes @c ofd.
+    //------------------------------------------------------------------------
+    static bool Gzip(int ifd, int ofd, const std::string & path)
+    {
+      gzFile  gzf = gzdopen(ofd, "wb");
+      if (! gzf) {
+        MCLOG(Severity::err, "gzdopen() failed for '{}'", path);
+        close(ofd);
+        return false;
+      }
+      std::vector<char>  buf(k_bufferSize);
+      bool     rc = true;
+      ssize_t  n;
+      while ((n = ReadSome(ifd, buf.data(), buf.size())) > 0) {
+        if (gzwrite(gzf, buf.data(), n) != n) {
+          int  zerr;
+          MCLOG(Severity::err, "gzwrite() failed for '{}': {}",
+                path, gzerror(gzf, &zerr));
+          rc = false;
+          break;
+        }
+      }
+      if (n < 0) {
+        MCLOG(Severity::err, "read() failed for '{}': {}",
+              path, strerror(errno));
+        rc = false;
+      }
+      int  zerr = gzclose(gzf);
+      if (rc && (Z_OK != zerr)) {
+        MCLOG(Severity::err, "gzclose() failed for '{}': {}", path, zerr);
+        rc = false;
+      }
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    std::string CompressionPool::Counts::Summary() const
+    {
+      using std::to_string;
+      return ("completed " + to_string(completed)
+              + ", failed " + to_string(failed)
+              + ", " + to_string(bytesIn) + " bytes compressed to "
+              + to_string(bytesOut));
+    }
+    
+    //------------------------------------------------------------------------
+    CompressionPool::CompressionPool()
+        : _mtx(), _cv(), _jobs(), _active(), _threads(), _run(false),
+          _niceness(0), _counts()
+    {}
+
+    //------------------------------------------------------------------------
+    CompressionPool::~CompressionPool()
+    {
+      Stop();
+    }
+
+    //------------------------------------------------------------------------
+    bool CompressionPool::Start(uint32_t numThreads, int niceness)
+    {
+      numThreads = std::max(numThreads, (uint32_t)1);
+      {
+        std::lock_guard  lck(_mtx);
+        if (! _threads.empty()) {
+          return false;
+        }
+        _niceness = std::clamp(niceness, 0, 19);
+        _run = true;
+        for (uint32_t i = 0; i < numThreads; ++i) {
+          _threads.push_back(std::thread(&CompressionPool::Run, this));
+#if (defined(__FreeBSD__) || defined(__linux__))
+          std::string  threadName("Compress" + std::to_string(i));
+          pthread_setname_np(_threads.back().native_handle(),
+                             threadName.c_str());
+#endif
+        }
+      }
+      MCLOG(Severity::info, "Started {} log compression workers (nice {})",
+            numThreads, _niceness);
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    void CompressionPool::Stop()
+    {
+      std::vector<std::thread>  threads;
+      size_t  queued;
+      {
+        std::lock_guard  lck(_mtx);
+        _run = false;
+        threads.swap(_threads);
+        queued = _jobs.size();
+      }
+      if (queued) {
+        MCLOG(Severity::info, "Finishing {} queued log compressions",
+              queued);
+      }
+      _cv.notify_all();
+      for (auto & thread : threads) {
+        if (thread.joinable()) {
+          thread.join();
+        }
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    bool CompressionPool::Running() const
+    {
+      std::lock_guard  lck(_mtx);
+      return (! _threads.empty());
+    }
+
+    //------------------------------------------------------------------------
+    uint32_t CompressionPool::Threads() const
+    {
+      std::lock_guard  lck(_mtx);
+      return _threads.size();
+    }
+
+    //------------------------------------------------------------------------
+    int CompressionPool::Niceness() const
+    {
+      std::lock_guard  lck(_mtx);
+      return _niceness;
+    }
+    
+    //------------------------------------------------------------------------
+    bool CompressionPool::Submit(const std::string & path,
+                                 const std::string & compress)
+    {
+      {
+        std::lock_guard  lck(_mtx);
+        if (_run) {
+          _jobs.push_back(Job{path, compress});
+          _cv.notify_all();
+          return true;
+        }
+      }
+      uint64_t  bytesIn = 0, bytesOut = 0;
+      bool  rc = Compress(path, compress, bytesIn, bytesOut);
+      Record(Job{path, compress}, rc, bytesIn, bytesOut);
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    void CompressionPool::Wait(const std::string & path)
+    {
+      std::unique_lock  lck(_mtx);
+      _cv.wait(lck, [&] { return (! Pending(path)); });
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    void CompressionPool::WaitAll()
+    {
+      std::unique_lock  lck(_mtx);
+      _cv.wait(lck, [&] { return (_jobs.empty() && _active.empty()); });
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    CompressionPool::Counts CompressionPool::Harvest()
+    {
+      std::lock_guard  lck(_mtx);
+      return std::exchange(_counts, Counts());
+    }
+    
+    //------------------------------------------------------------------------
+    bool CompressionPool::Compress(const std::string & path,
+                                   const std::string & compress,
+                                   uint64_t & bytesIn, uint64_t & bytesOut)
+    {
+      int  ifd = open(path.c_str(), O_RDONLY|O_CLOEXEC);
+      if (0 > ifd) {
+        MCLOG(Severity::err, "Failed to open '{}' for compression: {}",
+              path, strerror(errno));
+        return false;
+      }
+      struct stat  st;
+      if (0 != fstat(ifd, &st)) {
+        MCLOG(Severity::err, "fstat() failed for '{}': {}",
+              path, strerror(errno));
+        close(ifd);
+        return false;
+      }
+      std::string  dst(path + "." + Extension(compress));
+      std::string  tmp(dst + ".tmp");
+      int  ofd = open(tmp.c_str(), O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC,
+                      st.st_mode & 0777);
+      if (0 > ofd) {
+        MCLOG(Severity::err, "Failed to open '{}': {}",
+              tmp, strerror(errno));
+        close(ifd);
+        return false;
+      }
+      //  Only root can give the file away, so failure here is expected
+      //  when we're not running as root.
+      if (0 != fchown(ofd, st.st_uid, st.st_gid)) {
+        MCLOG(Severity::debug, "fchown() failed for '{}': {}",
+              tmp, strerror(errno));
+      }
+      
+      bool  rc = ("gzip" == compress) ? Gzip(ifd, ofd, path)
+                                      : Bzip2(ifd, ofd, path);
+      close(ifd);
+      if (rc) {
+        if (0 != rename(tmp.c_str(), dst.c_str())) {
+          MCLOG(Severity::err, "Failed to rename '{}' to '{}': {}",
+                tmp, dst, strerror(errno));
+          rc = false;
+        }
+      }
+      if (! rc) {
+        unlink(tmp.c_str());
+        return false;
+      }
+      unlink(path.c_str());
+      struct stat  dstst;
+      bytesIn = st.st_size;
+      bytesOut = (0 == stat(dst.c_str(), &dstst)) ? dstst.st_size : 0;
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    std::string CompressionPool::Extension(const std::string & compress)
+    {
+      auto  it = sg_compressionExt.find(compress);
+      if (it != sg_compressionExt.end()) {
+        return it->second;
+      }
+      return "bz2";
+    }
+    
+    //------------------------------------------------------------------------
+    bool CompressionPool::Supported(const std::string & compress)
+    {
+      return (sg_compressionExt.find(compress) != sg_compressionExt.end());
+    }
+    
+    //------------------------------------------------------------------------
+    bool CompressionPool::Pending(const std::string & path) const
+    {
+      return ((std::find(_active.cbegin(), _active.cend(), path)
+               != _active.cend())
+              || (std::find_if(_jobs.cbegin(), _jobs.cend(),
+                               [&] (const Job & job)
+                               { return (job.path == path); })
+                  != _jobs.cend()));
+    }
+
+    //------------------------------------------------------------------------
+    void CompressionPool::Record(const Job & job, bool ok, uint64_t bytesIn,
+                                 uint64_t bytesOut)
+    {
+      {
+        std::lock_guard  lck(_mtx);
+        if (ok) {
+          ++_counts.completed;
+          _counts.bytesIn += bytesIn;
+          _counts.bytesOut += bytesOut;
+        }
+        else {
+          ++_counts.failed;
+        }
+      }
+      if (ok) {
+        MCLOG(Severity::debug, "Compressed '{}' with {} ({} -> {} bytes)",
+              job.path, job.compress, bytesIn, bytesOut);
+      }
+      else {
+        MCLOG(Severity::err, "Failed to compress '{}' with {}",
+              job.path, job.compress);
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void CompressionPool::Throttle(int niceness)
+    {
+      if (0 == niceness) {
+        return;
+      }
+#if defined(__linux__)
+      //  On Linux, niceness and I/O priority are per thread.  Use the
+      //  best-effort I/O class at the level the kernel would derive from
+      //  our niceness, like ionice(1) -c2.
+      pid_t  tid = syscall(SYS_gettid);
+      if (0 != setpriority(PRIO_PROCESS, tid, niceness)) {
+        MCLOG(Severity::warning, "setpriority() failed: {}",
+              strerror(errno));
+      }
+      static constexpr int  k_ioprioWhoProcess = 1;
+      static constexpr int  k_ioprioClassBestEffort = 2;
+      static constexpr int  k_ioprioClassShift = 13;
+      int  ioprio = (k_ioprioClassBestEffort << k_ioprioClassShift)
+        | ((niceness + 20) / 5);
+      if (0 != syscall(SYS_ioprio_set, k_ioprioWhoProcess, tid, ioprio)) {
+        MCLOG(Severity::warning, "ioprio_set() failed: {}",
+              strerror(errno));
+      }
+#elif defined(__APPLE__)
+      //  Background the thread, which lowers its CPU and I/O priority.
+      if (0 != setpriority(PRIO_DARWIN_THREAD, 0, PRIO_DARWIN_BG)) {
+        MCLOG(Severity::warning, "setpriority() failed: {}",
+              strerror(errno));
+      }
+#endif
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void CompressionPool::Run()
+    {
+#if (__APPLE__)
+      pthread_setname_np("Compress");
+#endif
+      Throttle(Niceness());
+      std::unique_lock  lck(_mtx);
+      for (;;) {
+        _cv.wait(lck, [&] { return ((! _run) || (! _jobs.empty())); });
+        if (_jobs.empty()) {
+          break;
+        }
+        Job  job = std::move(_jobs.front());
+        _jobs.pop_front();
+        _active.push_back(job.path);
+        lck.unlock();
+        
+        uint64_t  bytesIn = 0, bytesOut = 0;
+        bool  ok = Compress(job.path, job.compress, bytesIn, bytesOut);
+        Record(job, ok, bytesIn, bytesOut);
+        
+        lck.lock();
+        _active.erase(std::find(_active.begin(), _active.end(), job.path));
+        _cv.notify_all();
+      }
+      return;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
@@ -41,6 +41,7 @@
 
 %code requires
 {
+  #include <array>
   #include <string>
   #include <map>
   #include <vector>
@@ -63,8 +64,10 @@
     extern FILE *mclogcfgin;
   }
 
+  #include <algorithm>
   #include <map>
   #include <string>
+  #include <thread>
   #include <vector>
   #include <boost/regex.hpp>
 
@@ -73,6 +76,8 @@
   #include "DwmLocalInterfaces.hh"
   #include "DwmSysLogger.hh"
   #include "DwmMclogConfig.hh"
+  #include "DwmMclogFec.hh"
+  #include "DwmMclogMessagePacket.hh"
 
   using namespace std;
   
@@ -166,6 +171,12 @@
     return rc;
   }
 
+  //--------------------------------------------------------------------------
+  //!  Defaults for the queue stanza being parsed, since they differ between
+  //!  the message queues and the multicast source backlog.
+  //--------------------------------------------------------------------------
+  static Dwm::Mclog::QueueConfig  g_queueDefaults;
+  
   //--------------------------------------------------------------------------
   static uint64_t LogSize(const std::string & s)
   {
@@ -215,10 +226,20 @@
   pair<string,string>                       *stringPairVal;
   Dwm::Mclog::LogFileConfig                 *logFileVal;
   vector<Dwm::Mclog::LogFileConfig>         *logFilesVal;
+  Dwm::Mclog::ChannelConfig                 *channelVal;
+  vector<Dwm::Mclog::ChannelConfig>         *channelsVal;
+  Dwm::Mclog::QuotaConfig                   *quotaVal;
+  vector<Dwm::Mclog::QuotaConfig>           *quotasVal;
   Dwm::Mclog::RollPeriod                     rollPeriodVal;
   int64_t                                    int64Val;
   Dwm::Mclog::FileFormat                     fileFormatVal;
   bool                                       boolVal;
+  Dwm::Mclog::Severity                       severityVal;
+  Dwm::Mclog::QueueConfig                   *queueConfigVal;
+  Dwm::Mclog::QueuesConfig                  *queuesConfigVal;
+  Dwm::Mclog::OverflowPolicy                 overflowPolicyVal;
+  Dwm::Mclog::DrainPolicy                    drainPolicyVal;
+  std::array<uint32_t,3>                    *weightsVal;
 }
 
 %code provides
@@ -231,21 +252,39 @@
   YY_DECL;
 }
 
-%token BINARY COMPRESS FACILITY FILES FILTER FILTERS FORMAT GROUP GROUPADDR
-%token GROUPADDR6 HOST IDENT INTFADDR INTFADDR6 INTFNAME KEEP KEYDIRECTORY
-%token LISTENV4 LISTENV6 LOGICALOR LOGICALAND LOOPBACK LOGDIRECTORY LOGS
-%token MINIMUMSEVERITY MULTICAST NOT OUTFILTER PATH PERIOD PERMS PORT
-%token SERVICE SIZE TEXT USER
+%token BACKLOG BINARY BLOCKTIMEOUT CAPACITY CHANNELS COMPRESS COMPRESSNICE
+%token COMPRESSTHREADS DICTIONARY
+%token DRAIN FACILITY FECDATA
+%token FECPARITY FILES FILTER FILTERS FLUSHINTERVAL FLUSHSEVERITY FLUSHSIZE
+%token FLUSHSYNC FORMAT GROUP GROUPADDR
+%token GROUPADDR6 HOST IDENT INTFADDR INTFADDR6 INTFNAME KEEP KEYDIRECTORY LISTENV4 LISTENV6
+%token LOGICALOR LOGICALAND LOOPBACK LOGDIRECTORY LOGS MAXBATCHDELAY
+%token MAXBYTERATE MAXPACKETRATE MESSAGEBURST MESSAGERATE
+%token MINIMUMSEVERITY MULTICAST NAME NOT OUTFILTER OVERFLOW PACKETSIZE PATH
+%token PERIOD PERMS PORT QUEUES QUOTAS RATEBURST RECEIVETHREADS REPORTINTERVAL
+%token SAMPLETHRESHOLD SERVICE SHEDSEVERITY SIZE TEXT USER WEIGHTS
 
 %token<stringVal>  STRING
 %token<intVal>     INTEGER
 
 %type<uint16Val>          UDP4Port Port
 %type<stringVal>          Filter IntfName KeyDirectory LogDirectory
-%type<intVal>             Keep Permissions
+%type<intVal>             BlockTimeout Capacity FecData FecParity Keep
+%type<intVal>             MaxBatchDelay MaxByteRate MaxPacketRate Permissions
+%type<intVal>             MessageBurst MessageRate RateBurst
+%type<intVal>             PacketSize ReceiveThreads ReportInterval
+%type<intVal>             FlushInterval SampleThreshold
+%type<intVal>             CompressNice CompressThreads
+%type<overflowPolicyVal>  Overflow
+%type<drainPolicyVal>     Drain
+%type<weightsVal>         Weights
+%type<queueConfigVal>     QueueSettings
+%type<queuesConfigVal>    QueuesSettings
+%type<severityVal>        FlushSeverity ShedSeverity
 %type<rollPeriodVal>      RollPeriod
 %type<fileFormatVal>      Format
-%type<stringVal>          Compress Group OutFilter Path User
+%type<stringVal>          Compress Dictionary Group McastCompress OutFilter
+%type<stringVal>          Name Path User
 %type<serviceConfigVal>   ServiceSettings
 %type<loopbackConfigVal>  LoopbackSettings
 %type<filesConfigVal>     FilesSettings
@@ -257,13 +296,19 @@
 %type<stringPairVal>      FilterExpr
 %type<logFilesVal>        Logs LogList
 %type<logFileVal>         Log LogSettings
-%type<int64Val>           RollSize
+%type<channelsVal>        Channels ChannelList
+%type<channelVal>         Channel ChannelSettings
+%type<quotasVal>          QuotaList
+%type<quotaVal>           Quota QuotaSettings
+%type<int64Val>           FlushSize RollSize
+%type<boolVal>            FlushSync
 
 %%
 
 Config: TopStanza | Config TopStanza;
 
-TopStanza: Service | Loopback | Multicast | Files | Filters;
+TopStanza: Service | Loopback | Multicast | Files | Filters | Queues
+| Quotas;
 
 Service: SERVICE '{' ServiceSettings '}' ';'
 {
@@ -364,6 +409,16 @@ FilesSettings: LogDirectory
   $$->logs = *($1);
   delete $1;
 }
+| CompressThreads
+{
+  $$ = new Dwm::Mclog::FilesConfig();
+  $$->compressThreads = $1;
+}
+| CompressNice
+{
+  $$ = new Dwm::Mclog::FilesConfig();
+  $$->compressNice = $1;
+}
 | FilesSettings LogDirectory
 {
   $$->logDirectory = *($2);
@@ -373,6 +428,14 @@ FilesSettings: LogDirectory
 {
   $$->logs = *($2);
   delete $2;
+}
+| FilesSettings CompressThreads
+{
+  $$->compressThreads = $2;
+}
+| FilesSettings CompressNice
+{
+  $$->compressNice = $2;
 };
 
 LogDirectory: LOGDIRECTORY '=' STRING ';'
@@ -380,6 +443,25 @@ LogDirectory: LOGDIRECTORY '=' STRING ';'
   $$ = $3;
 };
 
+CompressThreads: COMPRESSTHREADS '=' INTEGER ';'
+{
+  using Dwm::Mclog::FilesConfig;
+  $$ = std::clamp<int>($3, FilesConfig::k_minCompressThreads,
+                       FilesConfig::k_maxCompressThreads);
+  if ($$ != $3) {
+    mclogcfgerror("compressThreads %d out of range, using %d", $3, $$);
+  }
+};
+
+CompressNice: COMPRESSNICE '=' INTEGER ';'
+{
+  using Dwm::Mclog::FilesConfig;
+  $$ = std::clamp<int>($3, 0, FilesConfig::k_maxCompressNice);
+  if ($$ != $3) {
+    mclogcfgerror("compressNice %d out of range, using %d", $3, $$);
+  }
+};
+
 Multicast: MULTICAST '{' MulticastSettings '}' ';'
 {
   if (g_config) {
@@ -429,6 +511,74 @@ MulticastSettings: GroupAddr
     $$->outFilter = *($1);
     delete $1;
 }
+| MaxBatchDelay
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->batching.MaxDelay(std::chrono::microseconds($1));
+}
+| FlushSeverity
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->batching.FlushSeverity($1);
+}
+| MaxPacketRate
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->pacing.PacketRate($1);
+}
+| MaxByteRate
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->pacing.ByteRate($1);
+}
+| RateBurst
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->pacing.Burst($1);
+}
+| ShedSeverity
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->pacing.ShedSeverity($1);
+}
+| PacketSize
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->packetSize = $1;
+}
+| ReceiveThreads
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->receiveThreads = $1;
+}
+| FecData
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->fecData = $1;
+}
+| FecParity
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->fecParity = $1;
+}
+| McastCompress
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->compress = *($1);
+  delete $1;
+}
+| Dictionary
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->dictionary = *($1);
+  delete $1;
+}
+| Channels
+{
+  $$ = new Dwm::Mclog::MulticastConfig();
+  $$->channels = *($1);
+  delete $1;
+}
 | MulticastSettings GroupAddr
 {
   $$->groupAddr = *($2);
@@ -463,8 +613,155 @@ MulticastSettings: GroupAddr
   $$->intfName = *($2);
   delete $2;
 }
+| MulticastSettings MaxBatchDelay
+{
+  $$->batching.MaxDelay(std::chrono::microseconds($2));
+}
+| MulticastSettings FlushSeverity
+{
+  $$->batching.FlushSeverity($2);
+}
+| MulticastSettings MaxPacketRate
+{
+  $$->pacing.PacketRate($2);
+}
+| MulticastSettings MaxByteRate
+{
+  $$->pacing.ByteRate($2);
+}
+| MulticastSettings RateBurst
+{
+  $$->pacing.Burst($2);
+}
+| MulticastSettings ShedSeverity
+{
+  $$->pacing.ShedSeverity($2);
+}
+| MulticastSettings PacketSize
+{
+  $$->packetSize = $2;
+}
+| MulticastSettings ReceiveThreads
+{
+  $$->receiveThreads = $2;
+}
+| MulticastSettings FecData
+{
+  $$->fecData = $2;
+}
+| MulticastSettings FecParity
+{
+  $$->fecParity = $2;
+}
+| MulticastSettings McastCompress
+{
+  $$->compress = *($2);
+  delete $2;
+}
+| MulticastSettings Dictionary
+{
+  $$->dictionary = *($2);
+  delete $2;
+}
+| MulticastSettings Channels
+{
+  $$->channels = *($2);
+  delete $2;
+}
 ;
 
+Channels: CHANNELS '{' ChannelList '}' ';'
+{
+  using Dwm::Mclog::MulticastConfig;
+  if ($3->size() > MulticastConfig::k_maxChannels) {
+    mclogcfgerror("too many multicast channels (%zu, max %zu)",
+                  $3->size(), MulticastConfig::k_maxChannels);
+    delete $3;
+    return 1;
+  }
+  $$ = $3;
+};
+
+ChannelList: Channel
+{
+  $$ = new std::vector<Dwm::Mclog::ChannelConfig>();
+  $$->push_back(*($1));
+  delete $1;
+}
+| ChannelList ',' Channel
+{
+  $$->push_back(*($3));
+  delete $3;
+};
+
+Channel: '{' ChannelSettings '}'
+{
+  $$ = $2;
+  if ($$->filter.empty()) {
+    mclogcfgerror("multicast channel '%s' has no filter",
+                  $$->name.c_str());
+    delete $$;
+    return 1;
+  }
+  if (($$->groupAddr == Ipv4Address())
+      && ($$->groupAddr6 == Ipv6Address())) {
+    mclogcfgerror("multicast channel '%s' has no group address",
+                  $$->name.c_str());
+    delete $$;
+    return 1;
+  }
+};
+
+ChannelSettings: Name
+{
+  $$ = new Dwm::Mclog::ChannelConfig();
+  $$->name = *($1);
+  delete $1;
+}
+| Filter
+{
+  $$ = new Dwm::Mclog::ChannelConfig();
+  $$->filter = *($1);
+  delete $1;
+}
+| GroupAddr
+{
+  $$ = new Dwm::Mclog::ChannelConfig();
+  $$->groupAddr = *($1);
+  delete $1;
+}
+| GroupAddr6
+{
+  $$ = new Dwm::Mclog::ChannelConfig();
+  $$->groupAddr6 = *($1);
+  delete $1;
+}
+| ChannelSettings Name
+{
+  $$->name = *($2);
+  delete $2;
+}
+| ChannelSettings Filter
+{
+  $$->filter = *($2);
+  delete $2;
+}
+| ChannelSettings GroupAddr
+{
+  $$->groupAddr = *($2);
+  delete $2;
+}
+| ChannelSettings GroupAddr6
+{
+  $$->groupAddr6 = *($2);
+  delete $2;
+};
+
+Name: NAME '=' STRING ';'
+{
+  $$ = $3;
+};
+
 GroupAddr: GROUPADDR '=' STRING ';'
 {
   $$ = new Dwm::Ipv4Address(*$3);
@@ -551,6 +848,140 @@ UDP4Port: INTEGER
   delete $1;
 };
 
+MaxBatchDelay: MAXBATCHDELAY '=' INTEGER ';'
+{
+  using Dwm::Mclog::BatchPolicy;
+  $$ = $3;
+  if (($$ < BatchPolicy::k_minDelay.count())
+      || ($$ > BatchPolicy::k_maxDelay.count())) {
+    $$ = BatchPolicy::Clamp(std::chrono::microseconds($3)).count();
+    mclogcfgerror("maxBatchDelay %d out of range, using %d", $3, $$);
+  }
+};
+
+MaxPacketRate: MAXPACKETRATE '=' INTEGER ';'
+{
+  if (0 > $3) {
+    mclogcfgerror("invalid maxPacketRate %d", $3);
+    return 1;
+  }
+  $$ = $3;
+};
+
+MaxByteRate: MAXBYTERATE '=' INTEGER ';'
+{
+  if (0 > $3) {
+    mclogcfgerror("invalid maxByteRate %d", $3);
+    return 1;
+  }
+  $$ = $3;
+};
+
+RateBurst: RATEBURST '=' INTEGER ';'
+{
+  using Dwm::Mclog::PacingPolicy;
+  $$ = PacingPolicy::Clamp(std::max($3, 0));
+  if ($$ != $3) {
+    mclogcfgerror("rateBurst %d out of range, using %d", $3, $$);
+  }
+};
+
+PacketSize: PACKETSIZE '=' INTEGER ';'
+{
+  using Dwm::Mclog::MessagePacket;
+  $$ = std::clamp((size_t)$3, MessagePacket::k_minSendPacketLen,
+                  MessagePacket::k_maxPacketLen);
+  if ($$ != $3) {
+    mclogcfgerror("packetSize %d out of range, using %d", $3, $$);
+  }
+}
+| PACKETSIZE '=' STRING ';'
+{
+  if (*($3) != "auto") {
+    mclogcfgerror("invalid packetSize '%s'", $3->c_str());
+    delete $3;
+    return 1;
+  }
+  $$ = 0;
+  delete $3;
+};
+
+ReceiveThreads: RECEIVETHREADS '=' INTEGER ';'
+{
+  using Dwm::Mclog::MulticastConfig;
+  $$ = std::clamp<int>($3, MulticastConfig::k_minReceiveThreads,
+                       MulticastConfig::k_maxReceiveThreads);
+  if ($$ != $3) {
+    mclogcfgerror("receiveThreads %d out of range, using %d", $3, $$);
+  }
+}
+| RECEIVETHREADS '=' STRING ';'
+{
+  if (*($3) != "auto") {
+    mclogcfgerror("invalid receiveThreads '%s'", $3->c_str());
+    delete $3;
+    return 1;
+  }
+  $$ = 0;
+  delete $3;
+};
+
+McastCompress: COMPRESS '=' STRING ';'
+{
+  if ((*($3) != "zstd") && (*($3) != "none")) {
+    mclogcfgerror("invalid multicast compress '%s' (zstd or none)",
+                  $3->c_str());
+    delete $3;
+    return 1;
+  }
+  $$ = $3;
+};
+
+Dictionary: DICTIONARY '=' STRING ';'
+{
+  $$ = $3;
+};
+
+FecData: FECDATA '=' INTEGER ';'
+{
+  using Dwm::Mclog::FecParityHeader;
+  $$ = std::clamp<int>($3, 2, FecParityHeader::k_maxData);
+  if ($$ != $3) {
+    mclogcfgerror("fecData %d out of range, using %d", $3, $$);
+  }
+};
+
+FecParity: FECPARITY '=' INTEGER ';'
+{
+  using Dwm::Mclog::FecParityHeader;
+  $$ = std::clamp<int>($3, 0, FecParityHeader::k_maxParity);
+  if ($$ != $3) {
+    mclogcfgerror("fecParity %d out of range, using %d", $3, $$);
+  }
+};
+
+FlushSeverity: FLUSHSEVERITY '=' STRING ';'
+{
+  $$ = Dwm::Mclog::SeverityValue(*($3));
+  if (Dwm::Mclog::SeverityName($$) != *($3)) {
+    mclogcfgerror("invalid flushSeverity '%s'", $3->c_str());
+    delete $3;
+    return 1;
+  }
+  delete $3;
+};
+
+ShedSeverity: SHEDSEVERITY '=' STRING ';'
+{
+  $$ = Dwm::Mclog::SeverityValue(*($3));
+  if (Dwm::Mclog::SeverityName($$) != *($3)) {
+    mclogcfgerror("invalid shedSeverity '%s'", $3->c_str());
+    delete $3;
+    return 1;
+  }
+  delete $3;
+};
+
 Filters: FILTERS '{' FilterList '}' ';'
 {
   if (g_config) {
@@ -673,6 +1104,21 @@ LogSettings: Filter
   $$ = new Dwm::Mclog::LogFileConfig();
   $$->format = $1;
 }
+| FlushInterval
+{
+  $$ = new Dwm::Mclog::LogFileConfig();
+  $$->flush.Interval(std::chrono::milliseconds($1));
+}
+| FlushSize
+{
+  $$ = new Dwm::Mclog::LogFileConfig();
+  $$->flush.Bytes($1);
+}
+| FlushSync
+{
+  $$ = new Dwm::Mclog::LogFileConfig();
+  $$->flush.Sync($1);
+}
 | LogSettings Filter
 {
   $$->filter = *($2);
@@ -729,6 +1175,62 @@ LogSettings: Filter
 | LogSettings Format
 {
   $$->format = $2;
+}
+| LogSettings FlushInterval
+{
+  $$->flush.Interval(std::chrono::milliseconds($2));
+}
+| LogSettings FlushSize
+{
+  $$->flush.Bytes($2);
+}
+| LogSettings FlushSync
+{
+  $$->flush.Sync($2);
+};
+
+FlushInterval: FLUSHINTERVAL '=' INTEGER ';'
+{
+  if (0 > $3) {
+    mclogcfgerror("invalid flushInterval %d", $3);
+    return 1;
+  }
+  $$ = $3;
+};
+
+FlushSize: FLUSHSIZE '=' STRING ';'
+{
+  $$ = LogSize(*($3));
+  if (0 == $$) {
+    mclogcfgerror("invalid flushSize '%s'", $3->c_str());
+    delete $3;
+    return 1;
+  }
+  delete $3;
+}
+| FLUSHSIZE '=' INTEGER ';'
+{
+  if (0 > $3) {
+    mclogcfgerror("invalid flushSize %d", $3);
+    return 1;
+  }
+  $$ = $3;
+};
+
+FlushSync: FLUSHSYNC '=' STRING ';'
+{
+  if ("true" == *($3)) {
+    $$ = true;
+  }
+  else if ("false" == *($3)) {
+    $$ = false;
+  }
+  else {
+    mclogcfgerror("invalid flushSync '%s'", $3->c_str());
+    delete $3;
+    return 1;
+  }
+  delete $3;
 };
 
 Filter: FILTER '=' STRING ';'
@@ -779,6 +1281,271 @@ Compress: COMPRESS '=' STRING ';'
   $$ = $3;
 };
 
+Quotas: QUOTAS '{' QuotaList '}' ';'
+{
+  if (g_config) {
+    g_config->quotas = *($3);
+  }
+  delete $3;
+};
+
+QuotaList: Quota
+{
+  $$ = new std::vector<Dwm::Mclog::QuotaConfig>();
+  $$->push_back(*($1));
+  delete $1;
+}
+| QuotaList ',' Quota
+{
+  $$->push_back(*($3));
+  delete $3;
+};
+
+Quota: '{' QuotaSettings '}'
+{
+  $$ = $2;
+  if ($$->filter.empty()) {
+    mclogcfgerror("quota has no filter");
+    delete $$;
+    return 1;
+  }
+  if (0 == $$->rate) {
+    mclogcfgerror("quota for '%s' has no messageRate",
+                  $$->filter.c_str());
+    delete $$;
+    return 1;
+  }
+};
+
+QuotaSettings: Filter
+{
+  $$ = new Dwm::Mclog::QuotaConfig();
+  $$->filter = *($1);
+  delete $1;
+}
+| MessageRate
+{
+  $$ = new Dwm::Mclog::QuotaConfig();
+  $$->rate = $1;
+}
+| MessageBurst
+{
+  $$ = new Dwm::Mclog::QuotaConfig();
+  $$->burst = $1;
+}
+| QuotaSettings Filter
+{
+  $$->filter = *($2);
+  delete $2;
+}
+| QuotaSettings MessageRate
+{
+  $$->rate = $2;
+}
+| QuotaSettings MessageBurst
+{
+  $$->burst = $2;
+};
+
+MessageRate: MESSAGERATE '=' INTEGER ';'
+{
+  if (0 >= $3) {
+    mclogcfgerror("invalid messageRate %d", $3);
+    return 1;
+  }
+  $$ = $3;
+};
+
+MessageBurst: MESSAGEBURST '=' INTEGER ';'
+{
+  if (0 > $3) {
+    mclogcfgerror("invalid messageBurst %d", $3);
+    return 1;
+  }
+  $$ = $3;
+};
+
+Queues: QUEUES '{' QueuesSettings '}' ';'
+{
+  if (g_config) {
+    g_config->queues = *($3);
+  }
+  delete $3;
+};
+
+QueuesSettings: ReportInterval
+{
+  $$ = new Dwm::Mclog::QueuesConfig();
+  $$->reportInterval = $1;
+}
+| FILES '{' { g_queueDefaults = Dwm::Mclog::QueuesConfig().files; }
+  QueueSettings '}' ';'
+{
+  $$ = new Dwm::Mclog::QueuesConfig();
+  $$->files = *($4);
+  delete $4;
+}
+| MULTICAST '{' { g_queueDefaults = Dwm::Mclog::QueuesConfig().multicast; }
+  QueueSettings '}' ';'
+{
+  $$ = new Dwm::Mclog::QueuesConfig();
+  $$->multicast = *($4);
+  delete $4;
+}
+| BACKLOG '{' { g_queueDefaults = Dwm::Mclog::QueuesConfig().backlog; }
+  QueueSettings '}' ';'
+{
+  $$ = new Dwm::Mclog::QueuesConfig();
+  $$->backlog = *($4);
+  delete $4;
+}
+| QueuesSettings ReportInterval
+{
+  $$->reportInterval = $2;
+}
+| QueuesSettings FILES '{'
+  { g_queueDefaults = Dwm::Mclog::QueuesConfig().files; }
+  QueueSettings '}' ';'
+{
+  $$->files = *($5);
+  delete $5;
+}
+| QueuesSettings MULTICAST '{'
+  { g_queueDefaults = Dwm::Mclog::QueuesConfig().multicast; }
+  QueueSettings '}' ';'
+{
+  $$->multicast = *($5);
+  delete $5;
+}
+| QueuesSettings BACKLOG '{'
+  { g_queueDefaults = Dwm::Mclog::QueuesConfig().backlog; }
+  QueueSettings '}' ';'
+{
+  $$->backlog = *($5);
+  delete $5;
+};
+
+QueueSettings: Capacity
+{
+  $$ = new Dwm::Mclog::QueueConfig(g_queueDefaults);
+  $$->capacity = $1;
+}
+| Overflow
+{
+  $$ = new Dwm::Mclog::QueueConfig(g_queueDefaults);
+  $$->overflow = $1;
+}
+| BlockTimeout
+{
+  $$ = new Dwm::Mclog::QueueConfig(g_queueDefaults);
+  $$->blockTimeout = std::chrono::milliseconds($1);
+}
+| Drain
+{
+  $$ = new Dwm::Mclog::QueueConfig(g_queueDefaults);
+  $$->drain = $1;
+}
+| Weights
+{
+  $$ = new Dwm::Mclog::QueueConfig(g_queueDefaults);
+  $$->weights = *($1);
+  delete $1;
+}
+| SampleThreshold
+{
+  $$ = new Dwm::Mclog::QueueConfig(g_queueDefaults);
+  $$->sampleThreshold = $1;
+}
+| QueueSettings Capacity
+{
+  $$->capacity = $2;
+}
+| QueueSettings Overflow
+{
+  $$->overflow = $2;
+}
+| QueueSettings BlockTimeout
+{
+  $$->blockTimeout = std::chrono::milliseconds($2);
+}
+| QueueSettings Drain
+{
+  $$->drain = $2;
+}
+| QueueSettings Weights
+{
+  $$->weights = *($2);
+  delete $2;
+}
+| QueueSettings SampleThreshold
+{
+  $$->sampleThreshold = $2;
+};
+
+Capacity: CAPACITY '=' INTEGER ';'
+{
+  if ($3 > 0) {
+    $$ = $3;
+  }
+  else {
+    mclogcfgerror("invalid queue capacity %d", $3);
+    return 1;
+  }
+};
+
+Overflow: OVERFLOW '=' STRING ';'
+{
+  $$ = Dwm::Mclog::OverflowPolicyValue(*($3));
+  if (Dwm::Mclog::OverflowPolicyName($$) != *($3)) {
+    mclogcfgerror("invalid overflow policy '%s'", $3->c_str());
+    delete $3;
+    return 1;
+  }
+  delete $3;
+};
+
+BlockTimeout: BLOCKTIMEOUT '=' INTEGER ';'
+{
+  $$ = $3;
+};
+
+SampleThreshold: SAMPLETHRESHOLD '=' INTEGER ';'
+{
+  if ((0 > $3) || (100 < $3)) {
+    mclogcfgerror("invalid sampleThreshold %d", $3);
+    return 1;
+  }
+  $$ = $3;
+};
+
+Drain: DRAIN '=' STRING ';'
+{
+  $$ = Dwm::Mclog::DrainPolicyValue(*($3));
+  if (Dwm::Mclog::DrainPolicyName($$) != *($3)) {
+    mclogcfgerror("invalid drain policy '%s'", $3->c_str());
+    delete $3;
+    return 1;
+  }
+  delete $3;
+};
+
+Weights: WEIGHTS '=' '[' INTEGER ',' INTEGER ',' INTEGER ']' ';'
+{
+  if (($4 > 0) && ($6 > 0) && ($8 > 0)) {
+    $$ = new std::array<uint32_t,3>({ (uint32_t)$4, (uint32_t)$6,
+                                      (uint32_t)$8 });
+  }
+  else {
+    mclogcfgerror("invalid lane weights [%d, %d, %d]", $4, $6, $8);
+    return 1;
+  }
+};
+
+ReportInterval: REPORTINTERVAL '=' INTEGER ';'
+{
+  $$ = $3;
+};
+
 Format: FORMAT '=' TEXT ';'
 {
   $$ = Dwm::Mclog::FileFormat::text;
@@ -820,6 +1587,18 @@ namespace Dwm {
     {
       return (ShouldSendIpv4() || ShouldSendIpv6());
     }
+
+    //-----------------------------------------------------------------------
+    uint32_t MulticastConfig::ReceiveThreads() const
+    {
+      if (0 != receiveThreads) {
+        return std::clamp(receiveThreads, k_minReceiveThreads,
+                          k_maxReceiveThreads);
+      }
+      uint32_t  hwThreads = std::thread::hardware_concurrency();
+      return std::clamp(hwThreads, k_minReceiveThreads,
+                        k_maxAutoReceiveThreads);
+    }
     
     //-----------------------------------------------------------------------
     void MulticastConfig::Init()
@@ -831,6 +1610,25 @@ namespace Dwm {
       dstPort = 3737;
       intfName.clear();
       outFilter.clear();
+      batching = BatchPolicy();
+      pacing = PacingPolicy();
+      packetSize = MessagePacket::k_defaultPacketLen;
+      receiveThreads = 0;
+      fecData = 8;
+      fecParity = 0;
+      compress = "none";
+      dictionary.clear();
+      channels.clear();
+    }
+    
+    //------------------------------------------------------------------------
+    void ChannelConfig::Init()
+    {
+      name.clear();
+      filter.clear();
+      groupAddr = Ipv4Address();
+      groupAddr6 = Ipv6Address();
+      return;
     }
     
     //------------------------------------------------------------------------
@@ -857,6 +1655,7 @@ namespace Dwm {
       group.clear();
       compress = "bzip2";
       format = FileFormat::text;
+      flush = FlushPolicy();
     }
     
     //-----------------------------------------------------------------------
@@ -864,9 +1663,30 @@ namespace Dwm {
     {
         logDirectory = "/usr/local/var/mclog";
         logs.clear();
+        compressThreads = 2;
+        compressNice = 10;
         return;
     }
     
+    //-----------------------------------------------------------------------
+    void QueuesConfig::Init()
+    {
+      files.Init(1000, OverflowPolicy::dropLowestSeverity);
+      multicast.Init(1000, OverflowPolicy::dropLowestSeverity);
+      backlog.Init(100, OverflowPolicy::dropOldest);
+      reportInterval = 300;
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void QuotaConfig::Init()
+    {
+      filter.clear();
+      rate = 0;
+      burst = 0;
+      return;
+    }
+    
     //------------------------------------------------------------------------
     void Config::Init()
     {
@@ -874,6 +1694,8 @@ namespace Dwm {
       mcast.Init();
       service.Init();
       files.Init();
+      queues.Init();
+      quotas.clear();
       
       return;
     }
@@ -0,0 +1,173 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogDropCounters.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::DropCounters class implementation
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "DwmMclogDropCounters.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    using namespace std;
+
+    //------------------------------------------------------------------------
+    DropCounts::DropCounts()
+        : _bySeverity(), _byOrigin()
+    {
+      _bySeverity.fill(0);
+    }
+    
+    //------------------------------------------------------------------------
+    void DropCounts::Add(Severity severity, const string & origin)
+    {
+      ++_bySeverity[(uint8_t)severity & 0x07];
+      auto  it = _byOrigin.find(origin);
+      if (it != _byOrigin.end()) {
+        ++(it->second);
+      }
+      else if (_byOrigin.size() < k_maxOrigins) {
+        _byOrigin[origin] = 1;
+      }
+      else {
+        ++_byOrigin[k_otherOrigin];
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    DropCounts & DropCounts::operator += (const DropCounts & counts)
+    {
+      for (size_t i = 0; i < _bySeverity.size(); ++i) {
+        _bySeverity[i] += counts._bySeverity[i];
+      }
+      for (const auto & origin : counts._byOrigin) {
+        auto  it = _byOrigin.find(origin.first);
+        if (it != _byOrigin.end()) {
+          it->second += origin.second;
+        }
+        else if (_byOrigin.size() < k_maxOrigins) {
+          _byOrigin[origin.first] = origin.second;
+        }
+        else {
+          _byOrigin[k_otherOrigin] += origin.second;
+        }
+      }
+      return *this;
+    }
+    
+    //------------------------------------------------------------------------
+    uint64_t DropCounts::Total() const
+    {
+      return accumulate(_bySeverity.begin(), _bySeverity.end(), uint64_t(0));
+    }
+
+    //------------------------------------------------------------------------
+    string DropCounts::Summary() const
+    {
+      string  rc = to_string(Total()) + " (";
+      string  sep;
+      for (uint8_t sev = 0; sev < _bySeverity.size(); ++sev) {
+        if (_bySeverity[sev]) {
+          rc += sep + SeverityName((Severity)sev) + ' '
+            + to_string(_bySeverity[sev]);
+          sep = ", ";
+        }
+      }
+      rc += ')';
+
+      //  Only list the top few origins, most drops first.
+      vector<pair<string,uint64_t>>  origins(_byOrigin.begin(),
+                                             _byOrigin.end());
+      size_t  numOrigins = std::min(origins.size(), (size_t)5);
+      partial_sort(origins.begin(), origins.begin() + numOrigins,
+                   origins.end(),
+                   [] (const auto & a, const auto & b)
+                   { return (a.second > b.second); });
+      sep = " from ";
+      for (size_t i = 0; i < numOrigins; ++i) {
+        rc += sep + origins[i].first + ' ' + to_string(origins[i].second);
+        sep = ", ";
+      }
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    void DropCounts::Clear()
+    {
+      _bySeverity.fill(0);
+      _byOrigin.clear();
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    DropCounters::DropCounters()
+        : _mtx(), _counts(), _total(0)
+    {}
+
+    //------------------------------------------------------------------------
+    void DropCounters::Add(Severity severity, const string & origin)
+    {
+      lock_guard  lck(_mtx);
+      _counts.Add(severity, origin);
+      ++_total;
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    DropCounts DropCounters::Harvest()
+    {
+      lock_guard  lck(_mtx);
+      DropCounts  rc(std::move(_counts));
+      _counts.Clear();
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    uint64_t DropCounters::Total() const
+    {
+      lock_guard  lck(_mtx);
+      return _total;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
@@ -0,0 +1,341 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogFec.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::FecParityHeader, Dwm::Mclog::FecEncoder and
+//!  Dwm::Mclog::FecDecoder class implementations
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+
+#include "DwmMclogCipherSuite.hh"
+#include "DwmMclogFec.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    namespace {
+
+      //----------------------------------------------------------------------
+      //!  XORs @c len bytes at @c data into @c acc, growing @c acc with
+      //!  zeros if @c data is longer.
+      //----------------------------------------------------------------------
+      void XorInto(std::string & acc, const char *data, size_t len)
+      {
+        if (acc.size() < len) {
+          acc.resize(len, '\0');
+        }
+        for (size_t i = 0; i < len; ++i) {
+          acc[i] ^= data[i];
+        }
+        return;
+      }
+
+      //----------------------------------------------------------------------
+      bool Sequence(const char *data, size_t len, std::string & prefix,
+                    uint64_t & counter)
+      {
+        CipherSuite  suite;
+        return ((len >= NonceSequence::k_headerLen)
+                && NonceSequence::Parse((const uint8_t *)data, suite,
+                                        prefix, counter));
+      }
+      
+    }  // anonymous namespace
+    
+    //------------------------------------------------------------------------
+    void FecParityHeader::Encode(std::string & s) const
+    {
+      s.append((const char *)k_tag.data(), k_tag.size());
+      s.append(prefix);
+      for (size_t i = NonceSequence::k_counterLen; i > 0; --i) {
+        s.push_back((char)((first >> ((i - 1) * 8)) & 0xFF));
+      }
+      s.push_back((char)numData);
+      s.push_back((char)numParity);
+      s.push_back((char)index);
+      s.push_back('\0');
+      s.push_back((char)(lengthXor >> 8));
+      s.push_back((char)(lengthXor & 0xFF));
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    bool FecParityHeader::Parse(const char *data, size_t len)
+    {
+      if ((len <= k_len) || (! IsParity(data, len))) {
+        return false;
+      }
+      const uint8_t  *p = (const uint8_t *)data + k_tag.size();
+      prefix.assign((const char *)p, NonceSequence::k_prefixLen);
+      p += NonceSequence::k_prefixLen;
+      first = 0;
+      for (size_t i = 0; i < NonceSequence::k_counterLen; ++i) {
+        first = (first << 8) | *p++;
+      }
+      numData = *p++;
+      numParity = *p++;
+      index = *p++;
+      ++p;
+      lengthXor = (uint16_t)((p[0] << 8) | p[1]);
+      return ((numData > 0) && (numData <= k_maxData)
+              && (numParity > 0) && (numParity <= k_maxParity)
+              && (index < numParity) && (index < numData));
+    }
+
+    //------------------------------------------------------------------------
+    bool FecParityHeader::IsParity(const char *data, size_t len)
+    {
+      return ((len >= k_tag.size())
+              && std::equal(k_tag.begin(), k_tag.end(),
+                            (const uint8_t *)data));
+    }
+
+    //------------------------------------------------------------------------
+    bool FecParityHeader::Covers(uint64_t counter) const
+    {
+      return ((counter >= first) && (counter < (first + numData))
+              && (((counter - first) % numParity) == index));
+    }
+    
+    //========================================================================
+    //========================================================================
+
+    //------------------------------------------------------------------------
+    FecEncoder::FecEncoder(size_t numData, size_t numParity)
+        : _numData(0), _numParity(0), _prefix(), _first(0), _count(0),
+          _xors(), _lengthXors()
+    {
+      Configure(numData, numParity);
+    }
+
+    //------------------------------------------------------------------------
+    void FecEncoder::Configure(size_t numData, size_t numParity)
+    {
+      _numData = std::clamp(numData, (size_t)2, FecParityHeader::k_maxData);
+      _numParity = std::min({numParity, _numData,
+                             FecParityHeader::k_maxParity});
+      _xors.assign(_numParity, std::string());
+      _lengthXors.assign(_numParity, 0);
+      _count = 0;
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    size_t FecEncoder::Add(const char *data, size_t len,
+                           std::vector<std::string> & parity)
+    {
+      std::string  prefix;
+      uint64_t     counter;
+      if ((! Enabled()) || (len > 0xFFFF)
+          || (! Sequence(data, len, prefix, counter))) {
+        return 0;
+      }
+      size_t  rc = 0;
+      if (_count
+          && ((prefix != _prefix) || (counter != (_first + _count)))) {
+        rc += Flush(parity);
+      }
+      if (0 == _count) {
+        _prefix = prefix;
+        _first = counter;
+        for (auto & x : _xors) {
+          x.clear();
+        }
+        std::fill(_lengthXors.begin(), _lengthXors.end(), 0);
+      }
+      size_t  j = _count % _numParity;
+      XorInto(_xors[j], data, len);
+      _lengthXors[j] ^= (uint16_t)len;
+      if (++_count == _numData) {
+        rc += Flush(parity);
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    size_t FecEncoder::Flush(std::vector<std::string> & parity)
+    {
+      size_t  rc = std::min(_numParity, _count);
+      for (size_t j = 0; j < rc; ++j) {
+        FecParityHeader  hdr{_prefix, _first, (uint8_t)_count,
+                             (uint8_t)_numParity, (uint8_t)j,
+                             _lengthXors[j]};
+        std::string  pkt;
+        pkt.reserve(FecParityHeader::k_len + _xors[j].size());
+        hdr.Encode(pkt);
+        pkt += _xors[j];
+        parity.push_back(std::move(pkt));
+      }
+      _count = 0;
+      return rc;
+    }
+    
+    //========================================================================
+    //========================================================================
+
+    //------------------------------------------------------------------------
+    FecDecoder::FecDecoder()
+        : _active(false), _blockSize(0), _prefix(), _held(), _pending()
+    {}
+
+    //------------------------------------------------------------------------
+    size_t FecDecoder::AddData(std::string && data,
+                               std::vector<std::string> & recovered)
+    {
+      std::string  prefix;
+      uint64_t     counter;
+      if (! Sequence(data.data(), data.size(), prefix, counter)) {
+        return 0;
+      }
+      if (prefix != _prefix) {
+        NewPrefix(prefix);
+      }
+      _held[counter] = std::move(data);
+      while (_held.size() > k_maxHeld) {
+        _held.erase(_held.begin());
+      }
+
+      size_t  rc = 0;
+      for (auto it = _pending.begin(); it != _pending.end(); ) {
+        bool  done = false;
+        if (it->hdr.Covers(counter)) {
+          std::string  pkt;
+          if (Recover(*it, pkt, done)) {
+            uint64_t  c = 0;
+            if (Sequence(pkt.data(), pkt.size(), prefix, c)
+                && (prefix == _prefix)) {
+              _held[c] = pkt;
+            }
+            recovered.push_back(std::move(pkt));
+            ++rc;
+          }
+        }
+        it = (done ? _pending.erase(it) : std::next(it));
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    size_t FecDecoder::AddParity(const char *data, size_t len,
+                                 std::vector<std::string> & recovered)
+    {
+      Parity  parity;
+      if (! parity.hdr.Parse(data, len)) {
+        return 0;
+      }
+      _active = true;
+      _blockSize = parity.hdr.numData;
+      if (parity.hdr.prefix != _prefix) {
+        NewPrefix(parity.hdr.prefix);
+      }
+      parity.xors.assign(data + FecParityHeader::k_len,
+                         len - FecParityHeader::k_len);
+      
+      bool         done = false;
+      std::string  pkt;
+      if (Recover(parity, pkt, done)) {
+        std::string  prefix;
+        uint64_t     c = 0;
+        if (Sequence(pkt.data(), pkt.size(), prefix, c)
+            && (prefix == _prefix)) {
+          _held[c] = pkt;
+        }
+        recovered.push_back(std::move(pkt));
+        return 1;
+      }
+      if (! done) {
+        if (_pending.size() >= k_maxPendingParity) {
+          _pending.pop_front();
+        }
+        _pending.push_back(std::move(parity));
+      }
+      return 0;
+    }
+
+    //------------------------------------------------------------------------
+    void FecDecoder::NewPrefix(const std::string & prefix)
+    {
+      _prefix = prefix;
+      _held.clear();
+      _pending.clear();
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Rebuilds the one missing packet covered by @c parity into
+    //!  @c packet and returns true.  Sets @c done if @c parity is of no
+    //!  further use: nothing it covers is missing, or we've rebuilt the
+    //!  missing packet, or the covered packets don't add up.
+    //------------------------------------------------------------------------
+    bool FecDecoder::Recover(const Parity & parity, std::string & packet,
+                             bool & done) const
+    {
+      const FecParityHeader  & hdr = parity.hdr;
+      size_t    numMissing = 0;
+      uint64_t  missing = 0;
+      for (uint64_t i = hdr.index; i < hdr.numData; i += hdr.numParity) {
+        if (_held.find(hdr.first + i) == _held.end()) {
+          ++numMissing;
+          missing = hdr.first + i;
+        }
+      }
+      done = (numMissing < 2);
+      if (1 != numMissing) {
+        return false;
+      }
+      packet = parity.xors;
+      uint16_t  len = hdr.lengthXor;
+      for (uint64_t i = hdr.index; i < hdr.numData; i += hdr.numParity) {
+        if ((hdr.first + i) != missing) {
+          const std::string  & held = _held.find(hdr.first + i)->second;
+          if (held.size() > packet.size()) {
+            return false;
+          }
+          XorInto(packet, held.data(), held.size());
+          len ^= (uint16_t)held.size();
+        }
+      }
+      if ((len < NonceSequence::k_headerLen) || (len > packet.size())) {
+        return false;
+      }
+      packet.resize(len);
+      return true;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
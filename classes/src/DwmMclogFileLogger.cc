@@ -46,16 +46,20 @@ namespace Dwm {
 
     //------------------------------------------------------------------------
     FileLogger::FileLogger()
-        : _thread(), _inQueue(), _run(false), _logFiles()
+        : _thread(), _drops(), _sampler(), _inQueue(), _run(false),
+          _logFiles()
     {
-      _inQueue.MaxLength(1000);
+      _inQueue.Configure(QueueConfig(), &_drops);
     }
     
     //------------------------------------------------------------------------
-    bool FileLogger::Start(const FilesConfig & filescfg)
+    bool FileLogger::Start(const FilesConfig & filescfg,
+                           const QueueConfig & queuecfg)
     {
       using namespace std;
 
+      _inQueue.Configure(queuecfg, &_drops);
+      _sampler.Configure(queuecfg.sampleThreshold, queuecfg.capacity);
       if (filescfg.logs.empty()) {
         return true;
       }
@@ -71,11 +75,12 @@ namespace Dwm {
     }
 
     //------------------------------------------------------------------------
-    bool FileLogger::Restart(const FilesConfig & filescfg)
+    bool FileLogger::Restart(const FilesConfig & filescfg,
+                             const QueueConfig & queuecfg)
     {
       bool  rc = false;
       Stop();
-      return Start(filescfg);
+      return Start(filescfg, queuecfg);
     }
 
     //------------------------------------------------------------------------
@@ -97,6 +102,16 @@ namespace Dwm {
     //------------------------------------------------------------------------
     bool FileLogger::Process(const Message & msg)
     {
+      if (! _run.load()) {
+        return false;
+      }
+      uint32_t  rate;
+      if (! _sampler.Admit(msg, _inQueue.Length(), rate)) {
+        return false;
+      }
+      if (rate > 1) {
+        return _inQueue.PushBack(AdaptiveSampler::Annotate(msg, rate));
+      }
       return _inQueue.PushBack(msg);
     }
     
@@ -109,12 +124,25 @@ namespace Dwm {
 #endif
       std::deque<Message>  msgs;
       while (_run.load()) {
-        _inQueue.ConditionWait();
+        //  If messages are buffered, wake up in time to write them.
+        auto  deadline = _logFiles.FlushDeadline();
+        if (deadline == LogFile::Clock::time_point::max()) {
+          _inQueue.ConditionWait();
+        }
+        else {
+          auto  now = LogFile::Clock::now();
+          if (deadline > now) {
+            _inQueue.ConditionTimedWait(deadline - now);
+          }
+        }
         _inQueue.Swap(msgs);
-        for (const auto & msg : msgs) {
-          _logFiles.Process(msg);
+        if (! msgs.empty()) {
+          _logFiles.Process(msgs);
+          msgs.clear();
+        }
+        if (deadline != LogFile::Clock::time_point::max()) {
+          _logFiles.Flush();
         }
-        msgs.clear();
       }
       MCLOG(Severity::info, "FileLogger thread done");
       return;
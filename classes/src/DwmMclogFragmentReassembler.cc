@@ -0,0 +1,222 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogFragmentReassembler.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::FragmentReassembler class implementation
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <sstream>
+
+#include "DwmMclogFragmentReassembler.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    FragmentReassembler::FragmentReassembler()
+        : _mtx(), _pending(), _pendingBytes(0), _discarded(0), _blockMsgs()
+    {}
+
+    //------------------------------------------------------------------------
+    FragmentReassembler::
+    FragmentReassembler(const FragmentReassembler & reassembler)
+        : _mtx()
+    {
+      std::lock_guard  lck(reassembler._mtx);
+      _pending = reassembler._pending;
+      _pendingBytes = reassembler._pendingBytes;
+      _discarded = reassembler._discarded;
+      _blockMsgs = reassembler._blockMsgs;
+    }
+
+    //------------------------------------------------------------------------
+    FragmentReassembler &
+    FragmentReassembler::operator = (const FragmentReassembler & reassembler)
+    {
+      if (this != &reassembler) {
+        std::scoped_lock  lck(_mtx, reassembler._mtx);
+        _pending = reassembler._pending;
+        _pendingBytes = reassembler._pendingBytes;
+        _discarded = reassembler._discarded;
+        _blockMsgs = reassembler._blockMsgs;
+      }
+      return *this;
+    }
+    
+    //------------------------------------------------------------------------
+    bool FragmentReassembler::NextMessage(std::istream & is,
+                                          const std::string & source,
+                                          Message & msg)
+    {
+      while (_blockMsgs.empty() && is) {
+        auto  pos = is.tellg();
+        MessageFragment  frag;
+        if (frag.Read(is)) {
+          if (Add(source, std::move(frag), msg)) {
+            return true;
+          }
+        }
+        else {
+          //  Not a fragment, try reading it as a MessageBlock.
+          is.clear();
+          is.seekg(pos);
+          if ((! MessageBlock::Read(is, _blockMsgs)) && _blockMsgs.empty()) {
+            //  Not a block either, try reading it as a Message.
+            is.clear();
+            is.seekg(pos);
+            return (bool)msg.Read(is);
+          }
+        }
+      }
+      if (! _blockMsgs.empty()) {
+        msg = std::move(_blockMsgs.front());
+        _blockMsgs.pop_front();
+        return true;
+      }
+      return false;
+    }
+    
+    //------------------------------------------------------------------------
+    bool FragmentReassembler::Add(const std::string & source,
+                                  MessageFragment && frag, Message & msg)
+    {
+      bool  rc = false;
+      std::lock_guard  lck(_mtx);
+      auto  now = Clock::now();
+      Expire(now);
+
+      Key   key(source, frag.Id());
+      auto  it = _pending.find(key);
+      if ((it != _pending.end())
+          && (it->second.frags.size() != frag.Count())) {
+        //  Same ID, different fragment count.  Sender restarted?
+        Discard(it);
+        it = _pending.end();
+      }
+      if (it == _pending.end()) {
+        if (_pending.size() >= k_maxPending) {
+          DiscardOldest();
+        }
+        Partial  partial;
+        partial.firstSeen = now;
+        partial.received = 0;
+        partial.bytes = 0;
+        partial.frags.resize(frag.Count());
+        it = _pending.emplace(key, std::move(partial)).first;
+      }
+      
+      auto  & partial = it->second;
+      auto  & slot = partial.frags[frag.Index()];
+      if (slot.empty() && (! frag.Data().empty())) {
+        slot = frag.Data();
+        partial.bytes += slot.size();
+        _pendingBytes += slot.size();
+        ++partial.received;
+      }
+      
+      if (partial.received == partial.frags.size()) {
+        std::string  bytes;
+        bytes.reserve(partial.bytes);
+        for (const auto & f : partial.frags) {
+          bytes += f;
+        }
+        _pendingBytes -= partial.bytes;
+        _pending.erase(it);
+        std::istringstream  is(bytes);
+        rc = (bool)msg.Read(is);
+      }
+      else {
+        while ((_pendingBytes > k_maxPendingBytes) && (! _pending.empty())) {
+          DiscardOldest();
+        }
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    size_t FragmentReassembler::Pending() const
+    {
+      std::lock_guard  lck(_mtx);
+      return _pending.size();
+    }
+
+    //------------------------------------------------------------------------
+    uint64_t FragmentReassembler::Discarded() const
+    {
+      std::lock_guard  lck(_mtx);
+      return _discarded;
+    }
+    
+    //------------------------------------------------------------------------
+    void FragmentReassembler::Discard(std::map<Key,Partial>::iterator it)
+    {
+      _pendingBytes -= it->second.bytes;
+      _pending.erase(it);
+      ++_discarded;
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void FragmentReassembler::DiscardOldest()
+    {
+      auto  oldest =
+        std::min_element(_pending.begin(), _pending.end(),
+                         [] (const auto & a, const auto & b)
+                         { return (a.second.firstSeen
+                                   < b.second.firstSeen); });
+      if (oldest != _pending.end()) {
+        Discard(oldest);
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void FragmentReassembler::Expire(Clock::time_point now)
+    {
+      for (auto it = _pending.begin(); it != _pending.end(); ) {
+        auto  next = std::next(it);
+        if ((now - it->second.firstSeen) > k_timeout) {
+          Discard(it);
+        }
+        it = next;
+      }
+      return;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
@@ -0,0 +1,186 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogIngestQuotas.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::IngestQuotas class implementation
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+
+#include "DwmMclogIngestQuotas.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    IngestQuotas::IngestQuotas()
+        : _mtx(), _quotas(), _talkers()
+    {}
+
+    //------------------------------------------------------------------------
+    void IngestQuotas::Configure(const std::vector<QuotaConfig> & quotas)
+    {
+      std::vector<Quota>  newQuotas;
+      for (const auto & qc : quotas) {
+        Quota  quota;
+        quota.filter = std::make_unique<MessageFilterDriver>(qc.filter);
+        quota.rate = qc.rate;
+        quota.burst = qc.Burst();
+        newQuotas.push_back(std::move(quota));
+      }
+      std::lock_guard  lck(_mtx);
+      _quotas = std::move(newQuotas);
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    bool IngestQuotas::Admit(const Message & msg)
+    {
+      std::string  origin = Origin(msg);
+      std::lock_guard  lck(_mtx);
+      bool  rc = true;
+      for (auto & quota : _quotas) {
+        bool  passes = false;
+        if (quota.filter->parse(&msg, passes) && passes) {
+          rc = TakeToken(quota, origin, Clock::now());
+          break;
+        }
+      }
+      Count(origin, rc);
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    std::vector<IngestQuotas::Talker> IngestQuotas::Harvest()
+    {
+      std::vector<Talker>  rc;
+      {
+        std::lock_guard  lck(_mtx);
+        rc.reserve(_talkers.size());
+        for (auto & talker : _talkers) {
+          rc.push_back(std::move(talker.second));
+        }
+        _talkers.clear();
+      }
+      std::sort(rc.begin(), rc.end(),
+                [] (const Talker & a, const Talker & b)
+                { return ((a.Total() > b.Total())
+                          || ((a.Total() == b.Total())
+                              && (a.origin < b.origin))); });
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    std::string IngestQuotas::Origin(const Message & msg)
+    {
+      const MessageOrigin  & origin = msg.Header().origin();
+      return (origin.hostname() + '/' + origin.appname());
+    }
+    
+    //------------------------------------------------------------------------
+    bool IngestQuotas::TakeToken(Quota & quota, const std::string & origin,
+                                 Clock::time_point now)
+    {
+      auto  refill = [&] (Bucket & bucket) {
+        std::chrono::duration<double>  elapsed = now - bucket.last;
+        bucket.tokens = std::min(quota.burst,
+                                 bucket.tokens
+                                 + (elapsed.count() * quota.rate));
+        bucket.last = now;
+      };
+
+      auto  it = quota.buckets.find(origin);
+      if (it == quota.buckets.end()) {
+        if (quota.buckets.size() >= k_maxOrigins) {
+          //  Forget origins whose buckets have refilled; they're
+          //  indistinguishable from origins we've never seen.
+          for (auto bit = quota.buckets.begin();
+               bit != quota.buckets.end(); ) {
+            refill(bit->second);
+            if (bit->second.tokens >= quota.burst) {
+              bit = quota.buckets.erase(bit);
+            }
+            else {
+              ++bit;
+            }
+          }
+        }
+        if (quota.buckets.size() >= k_maxOrigins) {
+          //  Too many busy origins.  Newcomers share one bucket.
+          it = quota.buckets.find(k_otherOrigin);
+          if (it == quota.buckets.end()) {
+            it = quota.buckets.emplace(k_otherOrigin,
+                                       Bucket{quota.burst, now}).first;
+          }
+          else {
+            refill(it->second);
+          }
+        }
+        else {
+          it = quota.buckets.emplace(origin, Bucket{quota.burst, now}).first;
+        }
+      }
+      else {
+        refill(it->second);
+      }
+      if (it->second.tokens >= 1.0) {
+        it->second.tokens -= 1.0;
+        return true;
+      }
+      return false;
+    }
+
+    //------------------------------------------------------------------------
+    void IngestQuotas::Count(const std::string & origin, bool admitted)
+    {
+      auto  it = _talkers.find(origin);
+      if (it == _talkers.end()) {
+        const std::string & key =
+          (_talkers.size() < k_maxOrigins) ? origin : k_otherOrigin;
+        it = _talkers.try_emplace(key, Talker{key, 0, 0}).first;
+      }
+      if (admitted) {
+        ++it->second.admitted;
+      }
+      else {
+        ++it->second.suppressed;
+      }
+      return;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
@@ -0,0 +1,235 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogKeyDirectory.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::KeyDirectory class implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/stat.h>
+#if defined(__linux__)
+  #include <sys/inotify.h>
+#endif
+  #include <unistd.h>
+}
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+
+#include "DwmFormatters.hh"
+#include "DwmSysLogger.hh"
+#include "DwmMclogKeyDirectory.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    namespace {
+
+      //----------------------------------------------------------------------
+      //!  Files in a key directory whose changes cause a reload.
+      //----------------------------------------------------------------------
+      const std::array<std::string,3>  g_keyFiles = {
+        "id_ed25519", "id_ed25519.pub", "known_keys"
+      };
+      
+      //----------------------------------------------------------------------
+      //!  Watches a key directory for changes to the key files.
+      //----------------------------------------------------------------------
+      class KeyDirWatch
+      {
+      public:
+        using Clock = std::chrono::steady_clock;
+        
+        KeyDirWatch(const std::string & dir)
+            : _dir(dir), _fd(-1), _lastChecked(Clock::now()), _mtimes()
+        {
+#if defined(__linux__)
+          _fd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+          if (0 <= _fd) {
+            if (0 > inotify_add_watch(_fd, _dir.c_str(),
+                                      IN_CLOSE_WRITE|IN_MOVED_TO|IN_CREATE
+                                      |IN_DELETE|IN_MOVED_FROM|IN_ATTRIB)) {
+              ::close(_fd);
+              _fd = -1;
+            }
+          }
+#endif
+          _mtimes = MTimes();
+        }
+
+        ~KeyDirWatch()
+        {
+          if (0 <= _fd) {
+            ::close(_fd);
+          }
+        }
+
+        KeyDirWatch(const KeyDirWatch &) = delete;
+        KeyDirWatch & operator = (const KeyDirWatch &) = delete;
+        
+        //--------------------------------------------------------------------
+        //!  Returns true if any of the key files changed since the last
+        //!  call.
+        //--------------------------------------------------------------------
+        bool Changed()
+        {
+          bool  rc = false;
+#if defined(__linux__)
+          if (0 <= _fd) {
+            alignas(struct inotify_event) char  buf[4096];
+            ssize_t  len;
+            while ((len = ::read(_fd, buf, sizeof(buf))) > 0) {
+              for (char *p = buf; p < buf + len; ) {
+                auto  ev = (const struct inotify_event *)p;
+                if (ev->len
+                    && (std::find(g_keyFiles.begin(), g_keyFiles.end(),
+                                  std::string(ev->name))
+                        != g_keyFiles.end())) {
+                  rc = true;
+                }
+                p += sizeof(struct inotify_event) + ev->len;
+              }
+            }
+            return rc;
+          }
+#endif
+          auto  now = Clock::now();
+          if ((now - _lastChecked) >= std::chrono::seconds(1)) {
+            _lastChecked = now;
+            auto  mtimes = MTimes();
+            rc = (mtimes != _mtimes);
+            _mtimes = mtimes;
+          }
+          return rc;
+        }
+
+      private:
+        std::string                    _dir;
+        int                            _fd;
+        Clock::time_point              _lastChecked;
+        std::array<time_t,3>           _mtimes;
+
+        std::array<time_t,3> MTimes() const
+        {
+          std::array<time_t,3>  rc = { 0, 0, 0 };
+          for (size_t i = 0; i < g_keyFiles.size(); ++i) {
+            struct stat  statbuf;
+            std::string  path = _dir + '/' + g_keyFiles[i];
+            if (0 == stat(path.c_str(), &statbuf)) {
+              rc[i] = statbuf.st_mtime;
+            }
+          }
+          return rc;
+        }
+      };
+
+      struct Loaded
+      {
+        std::unique_ptr<KeyDirWatch>   watch;
+        std::shared_ptr<KeyDirectory>  keys;
+      };
+      
+      std::mutex                     g_loadedMtx;
+      std::map<std::string,Loaded>   g_loaded;
+      
+    }  // anonymous namespace
+    
+    //------------------------------------------------------------------------
+    std::shared_ptr<KeyDirectory> KeyDirectory::Get(const std::string & keyDir)
+    {
+      std::lock_guard  lck(g_loadedMtx);
+      auto  it = g_loaded.find(keyDir);
+      if (it == g_loaded.end()) {
+        Loaded  loaded;
+        loaded.watch = std::make_unique<KeyDirWatch>(ExpandedPath(keyDir));
+        loaded.keys = std::make_shared<KeyDirectory>(keyDir);
+        it = g_loaded.emplace(keyDir, std::move(loaded)).first;
+      }
+      else if (it->second.watch->Changed()) {
+        it->second.keys = std::make_shared<KeyDirectory>(keyDir);
+        FSyslog(LOG_INFO, "Reloaded Credence keys from {}", keyDir);
+      }
+      return it->second.keys;
+    }
+
+    //------------------------------------------------------------------------
+    std::string KeyDirectory::ExpandedPath(const std::string & keyDir)
+    {
+      std::string  rc(keyDir);
+      if ((! rc.empty()) && (rc[0] == '~')) {
+        const char  *home = getenv("HOME");
+        if (nullptr == home) {
+          return std::string();
+        }
+        rc.replace(0, 1, home);
+      }
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    KeyDirectory::KeyDirectory(const std::string & keyDir)
+        : _haveMyKeys(false), _myKeys(), _mtx(), _knownKeys(keyDir),
+          _index()
+    {
+      Credence::KeyStash  keyStash(keyDir);
+      _haveMyKeys = keyStash.Get(_myKeys);
+      if (! _haveMyKeys) {
+        FSyslog(LOG_ERR, "Failed to get my keys from key stash {}", keyDir);
+      }
+    }
+
+    //------------------------------------------------------------------------
+    std::string KeyDirectory::FindKnownKey(const std::string & id)
+    {
+      std::lock_guard  lck(_mtx);
+      auto  it = _index.find(id);
+      if (it != _index.end()) {
+        return it->second;
+      }
+      //  Only hits are indexed, so unknown ids can't grow the index.
+      std::string  key = _knownKeys.Find(id);
+      if (! key.empty()) {
+        _index.emplace(id, key);
+      }
+      return key;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
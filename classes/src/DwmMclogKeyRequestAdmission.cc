@@ -0,0 +1,243 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogKeyRequestAdmission.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::KeyRequestAdmission class implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sodium.h>
+}
+
+#include <algorithm>
+#include <functional>
+#include <spanstream>
+#include <sstream>
+
+#include "DwmCredenceShortString.hh"
+#include "DwmStreamIO.hh"
+#include "DwmMclogKeyRequestAdmission.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    std::string KeyRequestAdmission::Counts::Summary() const
+    {
+      using std::to_string;
+      return ("cookies sent " + to_string(cookiesSent)
+              + ", bad cookies " + to_string(badCookies)
+              + ", malformed " + to_string(malformed)
+              + ", rate limited " + to_string(rateLimited)
+              + ", over capacity " + to_string(overCapacity)
+              + ", admitted " + to_string(admitted));
+    }
+    
+    //------------------------------------------------------------------------
+    KeyRequestAdmission::KeyRequestAdmission(double rate, double burst,
+                                             size_t maxHandshakes)
+        : _rate(rate), _burst(std::max(burst, 1.0)),
+          _maxHandshakes(maxHandshakes), _secret(), _prevSecret(),
+          _secretTime(), _buckets(), _cookiesSent(0), _badCookies(0),
+          _malformed(0), _rateLimited(0), _overCapacity(0), _admitted(0)
+    {
+      RotateSecret(Clock::now());
+      _prevSecret = _secret;
+    }
+
+    //------------------------------------------------------------------------
+    KeyRequestAdmission::Verdict
+    KeyRequestAdmission::Admit(const UdpEndpoint & src, const char *buf,
+                               size_t buflen, size_t activeHandshakes,
+                               std::string & reply)
+    {
+      auto  now = Clock::now();
+      if ((now - _secretTime) >= k_secretLifetime) {
+        RotateSecret(now);
+      }
+      
+      std::ispanstream             is{std::span{buf,buflen}};
+      Credence::ShortString<255>   kx, cookie;
+      if ((! StreamIO::Read(is, kx))
+          || (kx.Value().size() != crypto_kx_PUBLICKEYBYTES)) {
+        ++_malformed;
+        return Verdict::e_drop;
+      }
+      if (! StreamIO::Read(is, cookie)) {
+        //  First packet of a handshake.  Reply with a cookie.
+        reply.clear();
+      }
+      else if (! ValidCookie(src, kx.Value(), cookie.Value())) {
+        //  Possibly just a cookie from before the last two rotations.
+        //  Reply with a fresh one.
+        ++_badCookies;
+      }
+      else if (! TakeToken(src, now)) {
+        ++_rateLimited;
+        return Verdict::e_drop;
+      }
+      else if (activeHandshakes >= _maxHandshakes) {
+        ++_overCapacity;
+        return Verdict::e_drop;
+      }
+      else {
+        ++_admitted;
+        return Verdict::e_admit;
+      }
+
+      Credence::ShortString<255>  value(std::string(k_cookieTag)
+                                        + Cookie(_secret, src, kx.Value()));
+      std::ostringstream  os;
+      if (StreamIO::Write(os, value)) {
+        reply = os.str();
+        ++_cookiesSent;
+        return Verdict::e_sendCookie;
+      }
+      return Verdict::e_drop;
+    }
+
+    //------------------------------------------------------------------------
+    bool KeyRequestAdmission::IsCookieReply(const std::string & value,
+                                            std::string & cookie)
+    {
+      if ((value.size() == (k_cookieTag.size() + k_cookieLen))
+          && value.starts_with(k_cookieTag)) {
+        cookie = value.substr(k_cookieTag.size());
+        return true;
+      }
+      return false;
+    }
+    
+    //------------------------------------------------------------------------
+    KeyRequestAdmission::Counts KeyRequestAdmission::Harvest()
+    {
+      Counts  counts;
+      counts.cookiesSent = _cookiesSent.exchange(0);
+      counts.badCookies = _badCookies.exchange(0);
+      counts.malformed = _malformed.exchange(0);
+      counts.rateLimited = _rateLimited.exchange(0);
+      counts.overCapacity = _overCapacity.exchange(0);
+      counts.admitted = _admitted.exchange(0);
+      return counts;
+    }
+
+    //------------------------------------------------------------------------
+    void KeyRequestAdmission::RotateSecret(Clock::time_point now)
+    {
+      _prevSecret = _secret;
+      _secret.resize(crypto_auth_KEYBYTES);
+      crypto_auth_keygen((unsigned char *)_secret.data());
+      _secretTime = now;
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    std::string KeyRequestAdmission::Cookie(const std::string & secret,
+                                            const UdpEndpoint & src,
+                                            const std::string & kx) const
+    {
+      std::string    input = (std::string)src;
+      input.push_back('\0');
+      input += kx;
+      unsigned char  mac[crypto_auth_BYTES];
+      crypto_auth(mac, (const unsigned char *)input.data(), input.size(),
+                  (const unsigned char *)secret.data());
+      return std::string((const char *)mac, k_cookieLen);
+    }
+
+    //------------------------------------------------------------------------
+    bool KeyRequestAdmission::ValidCookie(const UdpEndpoint & src,
+                                          const std::string & kx,
+                                          const std::string & cookie) const
+    {
+      if (cookie.size() != k_cookieLen) {
+        return false;
+      }
+      for (const auto & secret : { std::cref(_secret),
+                                   std::cref(_prevSecret) }) {
+        std::string  expected = Cookie(secret, src, kx);
+        if (0 == sodium_memcmp(expected.data(), cookie.data(), k_cookieLen)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    //------------------------------------------------------------------------
+    bool KeyRequestAdmission::TakeToken(const UdpEndpoint & src,
+                                        Clock::time_point now)
+    {
+      auto  refill = [&] (Bucket & bucket) {
+        std::chrono::duration<double>  elapsed = now - bucket.last;
+        bucket.tokens = std::min(_burst,
+                                 bucket.tokens + (elapsed.count() * _rate));
+        bucket.last = now;
+      };
+      
+      std::string  addr = (std::string)src.Addr();
+      auto  it = _buckets.find(addr);
+      if (it == _buckets.end()) {
+        if (_buckets.size() >= k_maxTrackedAddrs) {
+          //  Forget addresses whose buckets have refilled; they're
+          //  indistinguishable from addresses we've never seen.
+          for (auto bit = _buckets.begin(); bit != _buckets.end(); ) {
+            refill(bit->second);
+            if (bit->second.tokens >= _burst) {
+              bit = _buckets.erase(bit);
+            }
+            else {
+              ++bit;
+            }
+          }
+          if (_buckets.size() >= k_maxTrackedAddrs) {
+            return false;
+          }
+        }
+        it = _buckets.emplace(addr, Bucket{_burst, now}).first;
+      }
+      else {
+        refill(it->second);
+      }
+      if (it->second.tokens >= 1.0) {
+        it->second.tokens -= 1.0;
+        return true;
+      }
+      return false;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
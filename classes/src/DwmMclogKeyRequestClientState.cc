@@ -45,9 +45,9 @@
 #include "DwmCredenceXChaCha20Poly1305Istream.hh"
 #include "DwmCredenceXChaCha20Poly1305Ostream.hh"
 #include "DwmCredenceSigner.hh"
-#include "DwmCredenceKnownKeys.hh"
 #include "DwmCredenceUtils.hh"
 #include "DwmCredenceXChaCha20Poly1305.hh"
+#include "DwmMclogKeyDirectory.hh"
 #include "DwmMclogKeyRequestClientState.hh"
 #include "DwmMclogLogger.hh"
 #include "DwmMclogMessagePacket.hh"
@@ -73,11 +73,16 @@ namespace Dwm {
     }
     
     //------------------------------------------------------------------------
-    KeyRequestClientState::KeyRequestClientState(const std::string *keyDir,
-                                                 const std::string *mcastKey)
+    KeyRequestClientState::
+    KeyRequestClientState(const std::string *keyDir,
+                          const std::string *mcastKey,
+                          const std::string *dictionary)
         : _state(&KeyRequestClientState::Initial),
           _lastStateChangeTime(time((time_t *)0)), _keyPair(), _sharedKey(),
-          _theirId(), _keyDir(keyDir), _mcastKey(mcastKey)
+          _theirId(),
+          _theirSuites(CipherSuiteBit(CipherSuite::xchacha20poly1305)),
+          _theirPayloadFormats(0), _keyDir(keyDir), _mcastKey(mcastKey),
+          _dictionary(dictionary)
     {}
     
     //------------------------------------------------------------------------
@@ -139,17 +144,26 @@ namespace Dwm {
       
       bool  rc = false;
       
-      char  sendbuf[1500];
-      std::spanstream  sps{std::span{sendbuf,sizeof(sendbuf)}};
-      Credence::Ed25519KeyPair  myKeys;
-      Credence::KeyStash  keyStash(*_keyDir);
-      if (keyStash.Get(myKeys)) {
-        MessagePacket  pkt(sendbuf, sizeof(sendbuf));
+      //  Room for the compression dictionary.
+      std::vector<char>  sendbuf(MessagePacket::k_maxPacketLen);
+      auto  keyDir = KeyDirectory::Get(*_keyDir);
+      if (keyDir->HaveMyKeys()) {
+        const auto  & myKeys = keyDir->MyKeys();
+        MessagePacket  pkt(sendbuf.data(), sendbuf.size());
         pkt.Add(myKeys.PublicKey().Id());
         std::string  signedMsg;
         if (Signer::Sign(_theirKX.Value() + *_mcastKey,
                          myKeys.SecretKey().Key(), signedMsg)) {
           pkt.Add(signedMsg);
+          //  The cipher suite we agree to.  Older clients ignore it.
+          pkt.Add((uint8_t)BestCipherSuite(_theirSuites
+                                           & LocalCipherSuites()));
+          //  The compression we'll use and its dictionary, only for
+          //  clients that can decompress.
+          if (TheirCompression() && (nullptr != _dictionary)) {
+            pkt.Add(PayloadCompressor::k_zstd);
+            pkt.Add(*_dictionary);
+          }
           if (pkt.SendTo(fd, _sharedKey, dst) > 0) {
             rc = true;
           }
@@ -163,8 +177,7 @@ namespace Dwm {
                                             const std::string & signedMsg)
     {
       bool  rc = false;
-      Credence::KnownKeys  knownKeys(*_keyDir);
-      std::string  key = knownKeys.Find(id);
+      std::string  key = KeyDirectory::Get(*_keyDir)->FindKnownKey(id);
       if (! key.empty()) {
         std::string  origMsg;
         if (Credence::Signer::Open(signedMsg, key, origMsg)) {
@@ -205,6 +218,11 @@ namespace Dwm {
         if (StreamIO::Read(pkt.Payload(), _theirId)) {
           std::string  signedMsg;
           if (StreamIO::Read(pkt.Payload(), signedMsg)) {
+            uint8_t  suites;
+            if (StreamIO::Read(pkt.Payload(), suites)) {
+              _theirSuites |= suites;
+              StreamIO::Read(pkt.Payload(), _theirPayloadFormats);
+            }
             if (IsValidUser(_theirId, signedMsg)) {
               if (SendIdAndSig(fd, src)) {
                 rc = true;
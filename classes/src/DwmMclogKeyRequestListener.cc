@@ -46,11 +46,33 @@ extern "C" {
 
 #include "DwmMclogLogger.hh"
 #include "DwmMclogKeyRequestListener.hh"
+#include "DwmMclogNack.hh"
 
 namespace Dwm {
 
   namespace Mclog {
 
+    namespace {
+
+      //----------------------------------------------------------------------
+      bool SendTo(int fd, const UdpEndpoint & dst, const std::string & data)
+      {
+        ssize_t  sendrc = -1;
+        if (dst.Addr().Family() == AF_INET) {
+          sockaddr_in  dstAddr = dst;
+          sendrc = sendto(fd, data.data(), data.size(), 0,
+                          (const sockaddr *)&dstAddr, sizeof(dstAddr));
+        }
+        else {
+          sockaddr_in6  dstAddr = dst;
+          sendrc = sendto(fd, data.data(), data.size(), 0,
+                          (const sockaddr *)&dstAddr, sizeof(dstAddr));
+        }
+        return (sendrc == (ssize_t)data.size());
+      }
+      
+    }  // anonymous namespace
+    
     //------------------------------------------------------------------------
     KeyRequestListener::~KeyRequestListener()
     {
@@ -60,35 +82,103 @@ namespace Dwm {
     //------------------------------------------------------------------------
     bool KeyRequestListener::Listen()
     {
-      return ((0 <= _fd) || (0 <= _fd6));
+      return ((! _fds.empty()) || (! _fds6.empty()));
     }
 
     //------------------------------------------------------------------------
     void KeyRequestListener::ClearExpired()
     {
-      time_t  expTime = time((time_t *)0) - 5;
-      auto  expired =
-        [&] (auto && c) { return (c.second.LastStateChangeTime() < expTime); };
-      
-      if (! _clientsDone.empty()) { std::erase_if(_clientsDone, expired); }
-      if (! _clients.empty())     { std::erase_if(_clients, expired); }
+      using Clock = std::chrono::system_clock;
       
+      time_t  now = time((time_t *)0);
+      time_t  expTime = now - k_clientTimeout;
+
+      //  Clients are added to _clientsDone as they finish, so the oldest
+      //  are at the front.
+      while ((! _clientsDone.empty())
+             && (_clientsDone.front().second.LastStateChangeTime()
+                 < expTime)) {
+        _clientsDone.pop_front();
+      }
+
+      _expired.clear();
+      if (_clientExpiry.Expire(Clock::from_time_t(now), _expired)) {
+        for (const auto & endpoint : _expired) {
+          auto  it = _clients.find(endpoint);
+          if (it != _clients.end()) {
+            time_t  lastChange = it->second.LastStateChangeTime();
+            if (lastChange < expTime) {
+              _clients.erase(it);
+            }
+            else {
+              ScheduleExpiry(endpoint, lastChange);
+            }
+          }
+        }
+      }
       return;
     }
 
     //------------------------------------------------------------------------
-    bool KeyRequestListener::Start(int fd, int fd6, const std::string *keyDir,
-                                   const std::string *mcastKey)
+    void KeyRequestListener::ScheduleExpiry(const UdpEndpoint & endpoint,
+                                            time_t lastChange)
+    {
+      //  Expired once lastChange < (now - k_clientTimeout).
+      using Clock = std::chrono::system_clock;
+      time_t  expireTime = lastChange + k_clientTimeout + 1;
+      _clientExpiry.Schedule(endpoint, Clock::from_time_t(expireTime));
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    CipherSuite KeyRequestListener::MulticastCipherSuite() const
+    {
+      uint8_t  suites = LocalCipherSuites();
+      if ((time((time_t *)0) - _lastLimitedPeer) < k_limitedPeerHold) {
+        suites &= CipherSuiteBit(CipherSuite::xchacha20poly1305);
+      }
+      return BestCipherSuite(suites);
+    }
+
+    //------------------------------------------------------------------------
+    bool KeyRequestListener::MulticastCompression() const
+    {
+      return ((nullptr != _dictionary)
+              && ((time((time_t *)0) - _lastNoCompressPeer)
+                  >= k_limitedPeerHold));
+    }
+
+    //------------------------------------------------------------------------
+    bool KeyRequestListener::MulticastMessageBlocks() const
+    {
+      return ((time((time_t *)0) - _lastNoBlockPeer) >= k_limitedPeerHold);
+    }
+
+    //------------------------------------------------------------------------
+    bool KeyRequestListener::MulticastSummaries() const
+    {
+      return ((time((time_t *)0) - _lastNoSummaryPeer) >= k_limitedPeerHold);
+    }
+    
+    //------------------------------------------------------------------------
+    bool KeyRequestListener::Start(const std::vector<int> & fds,
+                                   const std::vector<int> & fds6,
+                                   const std::string *keyDir,
+                                   const std::string *mcastKey,
+                                   const std::string *dictionary,
+                                   NackHandler nackHandler)
     {
-      assert((0 <= fd) || (0 <= fd6));
+      assert((! fds.empty()) || (! fds6.empty()));
       assert(mcastKey->size() == crypto_aead_xchacha20poly1305_ietf_KEYBYTES);
       
       if (! _run) {
         _keyDir = keyDir;
         _mcastKey = mcastKey;
+        _dictionary = dictionary;
+        _nackHandler = std::move(nackHandler);
         if (0 == pipe(_stopfds)) {
-          _fd = fd;
-          _fd6 = fd6;
+          _fds = fds;
+          _fds6 = fds6;
           _run = true;
           _thread = std::thread(&KeyRequestListener::Run, this);
 #if (defined(__FreeBSD__) || defined (__linux__))
@@ -117,6 +207,83 @@ namespace Dwm {
       return false;
     }
     
+    //------------------------------------------------------------------------
+    void KeyRequestListener::HandlePacket(int fd, const UdpEndpoint & src,
+                                          char *buf, size_t buflen)
+    {
+      auto  clientit = _clients.find(src);
+      if ((clientit == _clients.end()) && Nack::IsNack(buf, buflen)) {
+        //  Receivers send NACKs from a socket they don't use for key
+        //  requests, so a NACK never interrupts a handshake.
+        if (_nackHandler) {
+          _nackHandler(fd, src, buf, buflen);
+        }
+        return;
+      }
+      if ((clientit != _clients.end())
+          && (clientit->second.CurrentState()
+              == &KeyRequestClientState::Failure)) {
+        //  Client is retrying after a failed handshake.
+        _clients.erase(clientit);
+        clientit = _clients.end();
+      }
+      if (clientit == _clients.end()) {
+        //  No per-client state (or key pair) until the client has echoed
+        //  our cookie and passed the rate limit and handshake cap.
+        std::string  reply;
+        switch (_admission.Admit(src, buf, buflen, _clients.size(), reply)) {
+          case KeyRequestAdmission::Verdict::e_admit:
+            clientit =
+              _clients.emplace(src, KeyRequestClientState(_keyDir,
+                                                          _mcastKey,
+                                                          _dictionary)).first;
+            ScheduleExpiry(src, clientit->second.LastStateChangeTime());
+            break;
+          case KeyRequestAdmission::Verdict::e_sendCookie:
+            if (! SendTo(fd, src, reply)) {
+              MCLOG(Severity::err, "sendto({},{},...) failed: {}",
+                    fd, src, strerror(errno));
+            }
+            return;
+          default:
+            return;
+        }
+      }
+      if (clientit->second.ProcessPacket(fd, src, buf, buflen)) {
+        if (clientit->second.Success()) {
+          uint8_t  theirSuites = clientit->second.TheirCipherSuites();
+          if ((LocalCipherSuites() & ~theirSuites) != 0) {
+            MCLOG(Severity::info, "{} can't use {}, multicast will use {}",
+                  src, CipherSuiteName(BestCipherSuite(LocalCipherSuites())),
+                  CipherSuiteName(BestCipherSuite(LocalCipherSuites()
+                                                  & theirSuites)));
+            _lastLimitedPeer = time((time_t *)0);
+          }
+          if ((nullptr != _dictionary)
+              && (! clientit->second.TheirCompression())) {
+            MCLOG(Severity::info, "{} can't decompress, multicast payloads"
+                  " won't be compressed", src);
+            _lastNoCompressPeer = time((time_t *)0);
+          }
+          if (! clientit->second.TheirMessageBlocks()) {
+            MCLOG(Severity::info, "{} can't read message blocks, multicast"
+                  " payloads won't be compacted", src);
+            _lastNoBlockPeer = time((time_t *)0);
+          }
+          if (! clientit->second.TheirSummaries()) {
+            MCLOG(Severity::info, "{} can't read packet summaries, multicast"
+                  " packets won't carry them", src);
+            _lastNoSummaryPeer = time((time_t *)0);
+          }
+          _clientsDone.push_back(*clientit);
+          _clients.erase(clientit);
+          MCLOG(Severity::debug, "_clientsDone.size(): {}",
+                _clientsDone.size());
+        }
+      }
+      return;
+    }
+    
     //------------------------------------------------------------------------
     void KeyRequestListener::Run()
     {
@@ -128,67 +295,55 @@ namespace Dwm {
         while (_run) {
           fd_set  fds;
           FD_ZERO(&fds);
-          if (0 <= _fd) { FD_SET(_fd, &fds); }
-          if (0 <= _fd6)  { FD_SET(_fd6, &fds); }
+          int  maxfd = _stopfds[0];
+          for (int fd : _fds) {
+            FD_SET(fd, &fds);
+            maxfd = std::max(maxfd, fd);
+          }
+          for (int fd : _fds6) {
+            FD_SET(fd, &fds);
+            maxfd = std::max(maxfd, fd);
+          }
           FD_SET(_stopfds[0], &fds);
-          int  maxfd = std::max({_fd, _fd6, _stopfds[0]}) + 1;
-          int  selectrc = select(maxfd, &fds, nullptr, nullptr, nullptr);
+          int  selectrc = select(maxfd + 1, &fds, nullptr, nullptr, nullptr);
           if (selectrc > 0) {
             if (FD_ISSET(_stopfds[0], &fds)) {
               break;
             }
-            if ((0 <= _fd) && FD_ISSET(_fd, &fds)) {
-              struct sockaddr_in  clientAddr;
-              socklen_t           clientAddrLen = sizeof(clientAddr);
-              char  buf[1500];
-              ssize_t  recvrc = recvfrom(_fd, buf, sizeof(buf), 0,
-                                         (struct sockaddr *)&clientAddr,
-                                         &clientAddrLen);
-              if (recvrc) {
-                std::string  s(buf, recvrc);
-                UdpEndpoint krcAddr(clientAddr);
-                auto [clientit, dontCare] =
-                  _clients.insert({krcAddr,KeyRequestClientState(_keyDir, _mcastKey)});
-                if (clientit->second.ProcessPacket(_fd, krcAddr, buf, recvrc)) {
-                  if (clientit->second.Success()) {
-                    _clientsDone.push_back(*clientit);
-                    _clients.erase(clientit);
-                    MCLOG(Severity::debug, "_clientsDone.size(): {}",
-                          _clientsDone.size());
-                  }
+            for (int fd : _fds) {
+              if (FD_ISSET(fd, &fds)) {
+                struct sockaddr_in  clientAddr;
+                socklen_t           clientAddrLen = sizeof(clientAddr);
+                char  buf[1500];
+                ssize_t  recvrc = recvfrom(fd, buf, sizeof(buf), 0,
+                                           (struct sockaddr *)&clientAddr,
+                                           &clientAddrLen);
+                if (recvrc > 0) {
+                  HandlePacket(fd, UdpEndpoint(clientAddr), buf, recvrc);
+                }
+                else {
+                  MCLOG(Severity::err, "recvfrom({}) failed: {}",
+                        fd, strerror(errno));
                 }
-              }
-              else {
-                MCLOG(Severity::err, "recvfrom({}) failed: {}", _fd, strerror(errno));
               }
             }
-            if ((0 <= _fd6) && FD_ISSET(_fd6, &fds)) {
-              struct sockaddr_in6  clientAddr;
-              socklen_t            clientAddrLen = sizeof(clientAddr);
-              char  buf[1500];
-              ssize_t  recvrc = recvfrom(_fd6, buf, sizeof(buf), 0,
-                                         (struct sockaddr *)&clientAddr,
-                                         &clientAddrLen);
-              if (recvrc > 0) {
-                std::string  s(buf, recvrc);
-                UdpEndpoint  krcAddr(clientAddr);
-                auto [clientit, dontCare] =
-                  _clients.insert({krcAddr,KeyRequestClientState(_keyDir, _mcastKey)});
-                if (clientit->second.ProcessPacket(_fd6, krcAddr, buf, recvrc)) {
-                  if (clientit->second.Success()) {
-                    _clientsDone.push_back(*clientit);
-                    _clients.erase(clientit);
-                    MCLOG(Severity::debug, "_clientsDone.size(): {}",
-                          _clientsDone.size());
-                  }
+            for (int fd : _fds6) {
+              if (FD_ISSET(fd, &fds)) {
+                struct sockaddr_in6  clientAddr;
+                socklen_t            clientAddrLen = sizeof(clientAddr);
+                char  buf[1500];
+                ssize_t  recvrc = recvfrom(fd, buf, sizeof(buf), 0,
+                                           (struct sockaddr *)&clientAddr,
+                                           &clientAddrLen);
+                if (recvrc > 0) {
+                  HandlePacket(fd, UdpEndpoint(clientAddr), buf, recvrc);
+                }
+                else {
+                  MCLOG(Severity::err, "recvfrom({}) failed: {}",
+                        fd, strerror(errno));
                 }
-              }
-              else {
-                MCLOG(Severity::err, "recvfrom({}) failed: {}",
-                      _fd6, strerror(errno));
               }
             }
-            
           }
           ClearExpired();
         }
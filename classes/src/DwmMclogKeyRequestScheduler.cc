@@ -0,0 +1,477 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogKeyRequestScheduler.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::KeyRequestScheduler implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/types.h>
+  #include <sys/socket.h>
+  #include <netinet/in.h>
+  #include <sys/select.h>
+  #include <sys/time.h>
+  #include <fcntl.h>
+  #include <pthread.h>
+  #include <unistd.h>
+}
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "DwmFormatters.hh"
+#include "DwmSysLogger.hh"
+#include "DwmMclogKeyRequestScheduler.hh"
+#include "DwmMclogMessagePacket.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    KeyRequestScheduler::KeyRequestScheduler(const std::string *keyDir,
+                                             size_t maxActive,
+                                             std::chrono::milliseconds timeout,
+                                             uint32_t maxAttempts)
+        : _keyDir(keyDir), _maxActive(std::max(maxActive, (size_t)1)),
+          _timeout(timeout), _maxAttempts(std::max(maxAttempts, 1U)),
+          _mtx(), _nextId(1), _waiting(), _active(), _completed(),
+          _callbackMtx(),
+          _rng(std::random_device()()), _fd(-1), _fd6(-1), _run(false),
+          _thread()
+    {
+      _wakefds[0] = -1;
+      _wakefds[1] = -1;
+    }
+
+    //------------------------------------------------------------------------
+    KeyRequestScheduler::~KeyRequestScheduler()
+    {
+      Stop();
+    }
+    
+    //------------------------------------------------------------------------
+    uint64_t KeyRequestScheduler::Request(const UdpEndpoint & srcEndpoint,
+                                          Callback && callback)
+    {
+      std::lock_guard  lck(_mtx);
+      if (! Start()) {
+        return 0;
+      }
+      Entry  entry;
+      entry.id = _nextId++;
+      entry.endpoint = srcEndpoint;
+      entry.callback = std::move(callback);
+      entry.attempts = 0;
+      entry.notBefore = Clock::now();
+      entry.requested = MulticastSourceKey::Clock::now();
+      _waiting.push_back(std::move(entry));
+      Wake();
+      return _nextId - 1;
+    }
+
+    //------------------------------------------------------------------------
+    void KeyRequestScheduler::Cancel(uint64_t requestId)
+    {
+      {
+        std::lock_guard  lck(_mtx);
+        std::erase_if(_waiting, [&] (const auto & e)
+                                { return (e.id == requestId); });
+        std::erase_if(_active, [&] (const auto & e)
+                               { return (e.second.id == requestId); });
+        std::erase_if(_completed, [&] (const auto & c)
+                                  { return (c.id == requestId); });
+      }
+      //  If RunCallbacks() already took the callback, wait for it.
+      std::lock_guard  cbLck(_callbackMtx);
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    void KeyRequestScheduler::Stop()
+    {
+      if (_run) {
+        _run = false;
+        Wake();
+        if (_thread.joinable()) {
+          _thread.join();
+        }
+        ::close(_wakefds[1]);  _wakefds[1] = -1;
+        ::close(_wakefds[0]);  _wakefds[0] = -1;
+        CloseSockets();
+        std::lock_guard  lck(_mtx);
+        _waiting.clear();
+        _active.clear();
+        _completed.clear();
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    size_t KeyRequestScheduler::Active() const
+    {
+      std::lock_guard  lck(_mtx);
+      return _active.size();
+    }
+
+    //------------------------------------------------------------------------
+    size_t KeyRequestScheduler::Waiting() const
+    {
+      std::lock_guard  lck(_mtx);
+      return _waiting.size();
+    }
+
+    //------------------------------------------------------------------------
+    bool KeyRequestScheduler::Start()
+    {
+      if (_run) {
+        return true;
+      }
+      if (! OpenSockets()) {
+        return false;
+      }
+      if (0 != pipe(_wakefds)) {
+        FSyslog(LOG_ERR, "pipe() failed: {}", strerror(errno));
+        CloseSockets();
+        return false;
+      }
+      fcntl(_wakefds[0], F_SETFL, fcntl(_wakefds[0], F_GETFL) | O_NONBLOCK);
+      fcntl(_wakefds[1], F_SETFL, fcntl(_wakefds[1], F_GETFL) | O_NONBLOCK);
+      _run = true;
+      _thread = std::thread(&KeyRequestScheduler::Run, this);
+#if (defined(__FreeBSD__) || defined (__linux__))
+      pthread_setname_np(_thread.native_handle(), "KeyReqScheduler");
+#endif
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    bool KeyRequestScheduler::OpenSockets()
+    {
+      _fd = socket(PF_INET, SOCK_DGRAM, IPPROTO_UDP);
+      if (0 <= _fd) {
+        fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) | O_NONBLOCK);
+      }
+      else {
+        FSyslog(LOG_ERR, "Failed to open IPv4 socket: {}", strerror(errno));
+      }
+      _fd6 = socket(PF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+      if (0 <= _fd6) {
+        fcntl(_fd6, F_SETFL, fcntl(_fd6, F_GETFL) | O_NONBLOCK);
+      }
+      else {
+        FSyslog(LOG_ERR, "Failed to open IPv6 socket: {}", strerror(errno));
+      }
+      return ((0 <= _fd) || (0 <= _fd6));
+    }
+
+    //------------------------------------------------------------------------
+    void KeyRequestScheduler::CloseSockets()
+    {
+      if (0 <= _fd)   { ::close(_fd);   _fd = -1; }
+      if (0 <= _fd6)  { ::close(_fd6);  _fd6 = -1; }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    void KeyRequestScheduler::Wake()
+    {
+      if (0 <= _wakefds[1]) {
+        char  c = 'w';
+        ::write(_wakefds[1], &c, sizeof(c));
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void KeyRequestScheduler::Run()
+    {
+      Syslog(LOG_INFO, "KeyRequestScheduler thread started");
+      while (_run) {
+        Clock::time_point  wakeTime;
+        {
+          std::lock_guard  lck(_mtx);
+          auto  now = Clock::now();
+          ExpireHandshakes(now);
+          StartHandshakes(now);
+          wakeTime = NextWakeTime(now);
+        }
+        RunCallbacks();
+        fd_set  fds;
+        FD_ZERO(&fds);
+        if (0 <= _fd)   { FD_SET(_fd, &fds); }
+        if (0 <= _fd6)  { FD_SET(_fd6, &fds); }
+        FD_SET(_wakefds[0], &fds);
+        int  maxfd = std::max({_fd, _fd6, _wakefds[0]}) + 1;
+        auto  wait = std::chrono::duration_cast<std::chrono::microseconds>
+          (std::max(wakeTime - Clock::now(), Clock::duration::zero()));
+        timeval  timeout = { (time_t)(wait.count() / 1000000),
+                             (suseconds_t)(wait.count() % 1000000) };
+        if (select(maxfd, &fds, nullptr, nullptr, &timeout) > 0) {
+          if (FD_ISSET(_wakefds[0], &fds)) {
+            char  buf[64];
+            while (::read(_wakefds[0], buf, sizeof(buf)) > 0) { }
+          }
+          if ((0 <= _fd) && FD_ISSET(_fd, &fds)) {
+            Receive(_fd);
+          }
+          if ((0 <= _fd6) && FD_ISSET(_fd6, &fds)) {
+            Receive(_fd6);
+          }
+          RunCallbacks();
+        }
+      }
+      Syslog(LOG_INFO, "KeyRequestScheduler thread done");
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    void KeyRequestScheduler::StartHandshakes(Clock::time_point now)
+    {
+      size_t  numWaiting = _waiting.size();
+      size_t  i = 0;
+      while ((i < numWaiting) && (_active.size() < _maxActive)) {
+        if ((_waiting[i].notBefore <= now)
+            && (! _active.contains(_waiting[i].endpoint))) {
+          Entry  entry = std::move(_waiting[i]);
+          _waiting.erase(_waiting.begin() + i);
+          --numWaiting;
+          ++entry.attempts;
+          if (SendKX(entry)) {
+            entry.deadline = now + _timeout;
+            UdpEndpoint  endpoint = entry.endpoint;
+            _active.emplace(endpoint, std::move(entry));
+          }
+          else {
+            Retry(std::move(entry), now);
+          }
+        }
+        else {
+          ++i;
+        }
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    bool KeyRequestScheduler::SendKX(Entry & entry)
+    {
+      bool  rc = false;
+      int   fd = (entry.endpoint.Addr().Family() == PF_INET) ? _fd : _fd6;
+      if ((0 <= fd) && (nullptr != _keyDir)) {
+        entry.state =
+          std::make_unique<KeyRequesterState>(entry.endpoint.Port(),
+                                              *_keyDir);
+        char  buf[1500] = {0};
+        std::spanstream  ss{std::span{buf,sizeof(buf)}};
+        entry.state->KX().PublicKey().Write(ss);
+        ssize_t  sendrc;
+        if (entry.endpoint.Addr().Family() == PF_INET) {
+          struct sockaddr_in  dstAddr = entry.endpoint;
+          sendrc = sendto(fd, buf, ss.tellp(), 0,
+                          (const sockaddr *)&dstAddr, sizeof(dstAddr));
+        }
+        else {
+          struct sockaddr_in6  dstAddr = entry.endpoint;
+          sendrc = sendto(fd, buf, ss.tellp(), 0,
+                          (const sockaddr *)&dstAddr, sizeof(dstAddr));
+        }
+        if (sendrc == ss.tellp()) {
+          entry.state->ChangeState(&KeyRequesterState::KXKeySent,
+                                   entry.endpoint);
+          rc = true;
+        }
+        else {
+          FSyslog(LOG_ERR, "sendto({},{}) failed: {}",
+                  fd, entry.endpoint, strerror(errno));
+        }
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    void KeyRequestScheduler::Receive(int fd)
+    {
+      //  Replies can carry a compression dictionary.
+      std::vector<char>  buf(MessagePacket::k_maxPacketLen);
+      for (;;) {
+        sockaddr_storage  srcAddr;
+        socklen_t         srcAddrLen = sizeof(srcAddr);
+        ssize_t  recvrc = recvfrom(fd, buf.data(), buf.size(), 0,
+                                   (sockaddr *)&srcAddr, &srcAddrLen);
+        if (recvrc <= 0) {
+          break;
+        }
+        UdpEndpoint  src;
+        if (srcAddr.ss_family == PF_INET) {
+          src = UdpEndpoint(*(const sockaddr_in *)&srcAddr);
+        }
+        else {
+          src = UdpEndpoint(*(const sockaddr_in6 *)&srcAddr);
+        }
+        std::lock_guard  lck(_mtx);
+        auto  it = _active.find(src);
+        if (it != _active.end()) {
+          auto  & state = *(it->second.state);
+          bool  ok = state.ProcessPacket(fd, src, buf.data(), recvrc);
+          if (state.CurrentState() == &KeyRequesterState::Success) {
+            Finish(it, true);
+          }
+          else if ((! ok)
+                   || (state.CurrentState() == &KeyRequesterState::Failure)) {
+            Finish(it, false);
+          }
+        }
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    void KeyRequestScheduler::ExpireHandshakes(Clock::time_point now)
+    {
+      for (auto it = _active.begin(); it != _active.end(); ) {
+        auto  next = std::next(it);
+        if (it->second.deadline <= now) {
+          FSyslog(LOG_INFO, "Key request to {} timed out in state {}",
+                  it->first, it->second.state->StateName());
+          Finish(it, false);
+        }
+        it = next;
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void KeyRequestScheduler::Finish(std::map<UdpEndpoint,Entry>::iterator it,
+                                     bool success)
+    {
+      Entry  entry = std::move(it->second);
+      _active.erase(it);
+      if (success) {
+        MulticastSourceKey  key;
+        key.LastRequested(entry.requested);
+        key.LastUpdated(MulticastSourceKey::Clock::now());
+        key.Value(entry.state->McastKey());
+        if (! entry.state->Dictionary().empty()) {
+          key.Dictionary(std::make_shared<const std::string>
+                         (entry.state->Dictionary()));
+        }
+        _completed.push_back({entry.id, std::move(entry.callback), key});
+      }
+      else {
+        Retry(std::move(entry), Clock::now());
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    void KeyRequestScheduler::Retry(Entry && entry, Clock::time_point now)
+    {
+      entry.state.reset();
+      if (entry.attempts < _maxAttempts) {
+        auto  backoff = Backoff(entry.attempts);
+        entry.notBefore = now + backoff;
+        FSyslog(LOG_INFO, "Retrying key request to {} in {} ms",
+                entry.endpoint,
+                std::chrono::duration_cast<std::chrono::milliseconds>(backoff)
+                .count());
+        _waiting.push_back(std::move(entry));
+      }
+      else {
+        FSyslog(LOG_ERR, "Key request to {} failed after {} attempts",
+                entry.endpoint, entry.attempts);
+        MulticastSourceKey  key;
+        key.LastRequested(entry.requested);
+        _completed.push_back({entry.id, std::move(entry.callback), key});
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Calls the callbacks of finished requests without holding _mtx, so
+    //!  a callback that takes other locks (or writes the key cache) never
+    //!  holds up Request() and Cancel() callers.
+    //------------------------------------------------------------------------
+    void KeyRequestScheduler::RunCallbacks()
+    {
+      std::lock_guard          cbLck(_callbackMtx);
+      std::vector<Completion>  completed;
+      {
+        std::lock_guard  lck(_mtx);
+        completed.swap(_completed);
+      }
+      for (auto & completion : completed) {
+        completion.callback(completion.key);
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    KeyRequestScheduler::Clock::duration
+    KeyRequestScheduler::Backoff(uint32_t attempts)
+    {
+      Clock::duration  backoff = k_maxBackoff;
+      if (attempts <= 16) {
+        backoff = std::min<Clock::duration>(k_initialBackoff
+                                            * (1U << (attempts - 1)),
+                                            k_maxBackoff);
+      }
+      //  Jitter so requests that failed together don't retry together.
+      std::uniform_int_distribution<Clock::rep>
+        dist(backoff.count() / 2, backoff.count());
+      return Clock::duration(dist(_rng));
+    }
+
+    //------------------------------------------------------------------------
+    KeyRequestScheduler::Clock::time_point
+    KeyRequestScheduler::NextWakeTime(Clock::time_point now) const
+    {
+      Clock::time_point  rc = now + std::chrono::seconds(1);
+      for (const auto & active : _active) {
+        rc = std::min(rc, active.second.deadline);
+      }
+      if (_active.size() < _maxActive) {
+        for (const auto & waiting : _waiting) {
+          rc = std::min(rc, waiting.notBefore);
+        }
+      }
+      return rc;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
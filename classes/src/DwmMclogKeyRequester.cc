@@ -46,6 +46,7 @@ extern "C" {
 }
 
 #include <iostream>
+#include <vector>
 
 #include "DwmFormatters.hh"
 #include "DwmCredenceKeyStash.hh"
@@ -66,10 +67,11 @@ namespace Dwm {
       if (0 <= _fd) {
         struct sockaddr_in  dstAddr = _servEndpoint;
         socklen_t  addrLen = sizeof(dstAddr);
-        char  buf[1500] = {0};
-        std::spanstream  ss{std::span{buf,sizeof(buf)}};
+        //  Replies can carry a compression dictionary.
+        std::vector<char>  buf(MessagePacket::k_maxPacketLen);
+        std::spanstream  ss{std::span{buf.data(),buf.size()}};
         _state.KX().PublicKey().Write(ss);
-        ssize_t  sendrc = sendto(_fd, buf, ss.tellp(), 0,
+        ssize_t  sendrc = sendto(_fd, buf.data(), ss.tellp(), 0,
                                  (const sockaddr *)&dstAddr, addrLen);
         if (sendrc == ss.tellp()) {
           _state.ChangeState(&KeyRequesterState::KXKeySent, _servEndpoint);
@@ -82,10 +84,11 @@ namespace Dwm {
             if (select(_fd+1, &fds, nullptr, nullptr, &timeout) > 0) {
               struct sockaddr_in  srcAddr;
               socklen_t           srcAddrLen = sizeof(srcAddr);
-              ssize_t  recvrc = recvfrom(_fd, buf, sizeof(buf), 0,
+              ssize_t  recvrc = recvfrom(_fd, buf.data(), buf.size(), 0,
                                          (sockaddr *)&srcAddr, &srcAddrLen);
               if (recvrc > 0) {
-                if (! _state.ProcessPacket(_fd, srcAddr, buf, recvrc)) {
+                if (! _state.ProcessPacket(_fd, srcAddr, buf.data(),
+                                           recvrc)) {
                   break;
                 }
               }
@@ -97,6 +100,10 @@ namespace Dwm {
           if (_state.CurrentState() == &KeyRequesterState::Success) {
             rc.LastUpdated(std::chrono::system_clock::now());
             rc.Value(_state.McastKey());
+            if (! _state.Dictionary().empty()) {
+              rc.Dictionary(std::make_shared<const std::string>
+                            (_state.Dictionary()));
+            }
           }
         }
         else {
@@ -121,10 +128,11 @@ namespace Dwm {
       if (0 <= _fd6) {
         struct sockaddr_in6  dstAddr = _servEndpoint;
         socklen_t  addrLen = sizeof(dstAddr);
-        char  buf[1500] = {0};
-        std::spanstream  ss{std::span{buf,sizeof(buf)}};
+        //  Replies can carry a compression dictionary.
+        std::vector<char>  buf(MessagePacket::k_maxPacketLen);
+        std::spanstream  ss{std::span{buf.data(),buf.size()}};
         _state.KX().PublicKey().Write(ss);
-        ssize_t  sendrc = sendto(_fd6, buf, ss.tellp(), 0,
+        ssize_t  sendrc = sendto(_fd6, buf.data(), ss.tellp(), 0,
                                  (const sockaddr *)&dstAddr, addrLen);
         if (sendrc == ss.tellp()) {
           _state.ChangeState(&KeyRequesterState::KXKeySent, _servEndpoint);
@@ -137,10 +145,11 @@ namespace Dwm {
             if (select(_fd6+1, &fds, nullptr, nullptr, &timeout) > 0) {
               struct sockaddr_in6  srcAddr;
               socklen_t            srcAddrLen = sizeof(srcAddr);
-              ssize_t  recvrc = recvfrom(_fd6, buf, sizeof(buf), 0,
+              ssize_t  recvrc = recvfrom(_fd6, buf.data(), buf.size(), 0,
                                          (sockaddr *)&srcAddr, &srcAddrLen);
               if (recvrc > 0) {
-                if (! _state.ProcessPacket(_fd6, srcAddr, buf, recvrc)) {
+                if (! _state.ProcessPacket(_fd6, srcAddr, buf.data(),
+                                           recvrc)) {
                   break;
                 }
               }
@@ -152,6 +161,10 @@ namespace Dwm {
           if (_state.CurrentState() == &KeyRequesterState::Success) {
             rc.LastUpdated(std::chrono::system_clock::now());
             rc.Value(_state.McastKey());
+            if (! _state.Dictionary().empty()) {
+              rc.Dictionary(std::make_shared<const std::string>
+                            (_state.Dictionary()));
+            }
           }
         }
         else {
@@ -40,14 +40,18 @@
 #include <vector>
 
 #include "DwmFormatters.hh"
-#include "DwmCredenceKeyStash.hh"
-#include "DwmCredenceKnownKeys.hh"
 #include "DwmCredenceXChaCha20Poly1305Istream.hh"
 #include "DwmCredenceXChaCha20Poly1305Ostream.hh"
 #include "DwmCredenceSigner.hh"
 #include "DwmCredenceUtils.hh"
+#include "DwmMclogCipherSuite.hh"
+#include "DwmMclogKeyDirectory.hh"
+#include "DwmMclogKeyRequestAdmission.hh"
 #include "DwmMclogKeyRequesterState.hh"
+#include "DwmMclogMessageBlock.hh"
+#include "DwmMclogPacketSummary.hh"
 #include "DwmMclogMessagePacket.hh"
+#include "DwmMclogPayloadCompressor.hh"
 
 namespace Dwm {
 
@@ -58,7 +62,8 @@ namespace Dwm {
                                          const std::string & keyDir)
         : _port(port), _keyDir(keyDir),
           _currentState(&KeyRequesterState::Initial),
-          _lastStateChangeTime(time((time_t *)0)), _kxKeyPair(), _sharedKey()
+          _lastStateChangeTime(time((time_t *)0)), _kxKeyPair(), _sharedKey(),
+          _dictionary()
     {}
     
     //------------------------------------------------------------------------
@@ -70,9 +75,9 @@ namespace Dwm {
     bool KeyRequesterState::SendIdAndSig(int fd, const UdpEndpoint & dst)
     {
       bool  rc = false;
-      Credence::Ed25519KeyPair  myKeys;
-      Credence::KeyStash  keyStash(_keyDir);
-      if (keyStash.Get(myKeys)) {
+      auto  keyDir = KeyDirectory::Get(_keyDir);
+      if (keyDir->HaveMyKeys()) {
+        const auto  & myKeys = keyDir->MyKeys();
         char  sendbuf[1500];
         MessagePacket  pkt(sendbuf, sizeof(sendbuf));
         pkt.Add(myKeys.PublicKey().Id());
@@ -81,6 +86,11 @@ namespace Dwm {
                                    myKeys.SecretKey().Key(),
                                    signedMsg)) {
           pkt.Add(signedMsg);
+          pkt.Add(LocalCipherSuites());
+          //  The payload formats we can read.
+          pkt.Add((uint8_t)(PayloadCompressor::k_zstd
+                            | MessageBlock::k_capability
+                            | PacketSummary::k_capability));
           if (pkt.SendTo(fd, _sharedKey, dst) > 0) {
             rc = true;
           }
@@ -99,13 +109,52 @@ namespace Dwm {
       return rc;
     }
     
+    //------------------------------------------------------------------------
+    bool KeyRequesterState::SendKXWithCookie(int fd, const UdpEndpoint & dst,
+                                             const std::string & cookie)
+    {
+      char  buf[1500];
+      std::spanstream  sps{std::span{buf,sizeof(buf)}};
+      _kxKeyPair.PublicKey().Write(sps);
+      if (StreamIO::Write(sps, Credence::ShortString<255>(cookie))) {
+        ssize_t  sendrc = -1;
+        if (dst.Addr().Family() == AF_INET) {
+          sockaddr_in  dstAddr = dst;
+          sendrc = sendto(fd, buf, sps.tellp(), 0,
+                          (const sockaddr *)&dstAddr, sizeof(dstAddr));
+        }
+        else {
+          sockaddr_in6  dstAddr = dst;
+          sendrc = sendto(fd, buf, sps.tellp(), 0,
+                          (const sockaddr *)&dstAddr, sizeof(dstAddr));
+        }
+        if (sendrc == sps.tellp()) {
+          return true;
+        }
+        FSyslog(LOG_ERR, "sendto({},{}) failed: {}", fd, dst, strerror(errno));
+      }
+      return false;
+    }
+    
     //------------------------------------------------------------------------
     bool KeyRequesterState::KXKeySent(int fd, const UdpEndpoint & src,
                                       char *buf, size_t buflen)
     {
       bool  rc = false;
       std::spanstream  sps{std::span{buf,buflen}};
-      if (StreamIO::Read(sps, _theirKX)) {
+      std::string      cookie;
+      if (StreamIO::Read(sps, _theirKX)
+          && KeyRequestAdmission::IsCookieReply(_theirKX.Value(), cookie)) {
+        //  The listener wants proof that we own our source address
+        //  before it does any work.  Resend our KX key with its cookie.
+        if (SendKXWithCookie(fd, src, cookie)) {
+          rc = true;
+        }
+        else {
+          ChangeState(&KeyRequesterState::Failure, src);
+        }
+      }
+      else if (sps) {
         _sharedKey = _kxKeyPair.SharedKey(_theirKX.Value());
         
         UdpEndpoint  dst(src);
@@ -129,8 +178,7 @@ namespace Dwm {
                                         const std::string & signedMsg)
     {
       bool  rc = false;
-      Credence::KnownKeys  knownKeys(_keyDir);
-      std::string  key = knownKeys.Find(id);
+      std::string  key = KeyDirectory::Get(_keyDir)->FindKnownKey(id);
       if (! key.empty()) {
         std::string  origMsg;
         if (Credence::Signer::Open(signedMsg, key, origMsg)) {
@@ -177,6 +225,18 @@ namespace Dwm {
           std::string  signedMsg;
           if (StreamIO::Read(pkt.Payload(), signedMsg)) {
             if (IsValidUser(_theirId, signedMsg)) {
+              uint8_t  suite;
+              if (StreamIO::Read(pkt.Payload(), suite)) {
+                FSyslog(LOG_INFO, "{} agreed to cipher suite {}", src,
+                        CipherSuiteName((CipherSuite)suite));
+                uint8_t  compression;
+                if (StreamIO::Read(pkt.Payload(), compression)
+                    && (compression & PayloadCompressor::k_zstd)
+                    && StreamIO::Read(pkt.Payload(), _dictionary)) {
+                  FSyslog(LOG_INFO, "{} compresses payloads, {} byte"
+                          " dictionary", src, _dictionary.size());
+                }
+              }
               rc = true;
               ChangeState(&KeyRequesterState::Success, src);
             }
@@ -39,12 +39,19 @@
 
 extern "C" {
   #include <sys/stat.h>
+  #include <sys/uio.h>
+  #include <fcntl.h>
   #include <grp.h>
+  #include <limits.h>
   #include <pwd.h>
   #include <unistd.h>
 }
 
+#include <algorithm>
+#include <cstring>
 #include <regex>
+#include <sstream>
+#include <utility>
 
 #include "DwmMclogLogFile.hh"
 #include "DwmMclogLogger.hh"
@@ -53,39 +60,15 @@ namespace Dwm {
 
   namespace Mclog {
 
-    //------------------------------------------------------------------------
-    static const std::map<std::string,std::string>  sg_compressionExt = {
-      { "bzip2", "bz2" },
-      { "gzip",  "gz"  }
-    };
-
-    //------------------------------------------------------------------------
-    static std::string CompressCommand(const std::string & compressConfig)
-    {
-      auto  it = sg_compressionExt.find(compressConfig);
-      if (it != sg_compressionExt.end()) {
-        return it->first;
-      }
-      return "bzip2";
-    }
-
-    //------------------------------------------------------------------------
-    static std::string ArchiveExtension(const std::string & compressConfig)
-    {
-      auto  it = sg_compressionExt.find(compressConfig);
-      if (it != sg_compressionExt.end()) {
-        return it->second;
-      }
-      return "bz2";
-    }
-    
     //------------------------------------------------------------------------
     LogFile::LogFile(const std::string & path, mode_t permissions,
                      RollPeriod period, int64_t maxsize, uint32_t keep,
                      FileFormat format)
         : _mtx(), _path(path), _permissions(permissions), _keep(keep),
-          _ofs(), _rollInterval(period), _rollSize(maxsize), _user(getuid()),
-          _group(getgid()), _compress("bzip2"), _format(format)
+          _fd(-1), _size(0), _rollInterval(period), _rollSize(maxsize),
+          _user(getuid()), _group(getgid()), _compress("bzip2"),
+          _format(format), _flushPolicy(), _pending(), _pendingBytes(0),
+          _pendingSince(), _compressor(nullptr)
     {}
 
     //------------------------------------------------------------------------
@@ -96,13 +79,19 @@ namespace Dwm {
       _path = std::move(logFile._path);
       _permissions = logFile._permissions;
       _keep = logFile._keep;
-      _ofs = std::move(logFile._ofs);
+      _fd = std::exchange(logFile._fd, -1);
+      _size = logFile._size;
       _rollInterval = logFile._rollInterval;
       _rollSize = logFile._rollSize;
       _user = logFile._user;
       _group = logFile._group;
       _compress = logFile._compress;
       _format = logFile._format;
+      _flushPolicy = logFile._flushPolicy;
+      _pending = std::move(logFile._pending);
+      _pendingBytes = std::exchange(logFile._pendingBytes, 0);
+      _pendingSince = logFile._pendingSince;
+      _compressor = logFile._compressor;
     }
 
     //------------------------------------------------------------------------
@@ -110,16 +99,23 @@ namespace Dwm {
     {
       if (&logFile != this) {
         std::scoped_lock  lck(_mtx, logFile._mtx);
+        CloseNoLock();
         _path = std::move(logFile._path);
         _permissions = logFile._permissions;
         _keep = logFile._keep;
-        _ofs = std::move(logFile._ofs);
+        _fd = std::exchange(logFile._fd, -1);
+        _size = logFile._size;
         _rollInterval = logFile._rollInterval;
         _rollSize = logFile._rollSize;
         _user = logFile._user;
         _group = logFile._group;
         _compress = std::move(logFile._compress);
         _format = logFile._format;
+        _flushPolicy = logFile._flushPolicy;
+        _pending = std::move(logFile._pending);
+        _pendingBytes = std::exchange(logFile._pendingBytes, 0);
+        _pendingSince = logFile._pendingSince;
+        _compressor = logFile._compressor;
       }
       return *this;
     }
@@ -175,13 +171,34 @@ namespace Dwm {
     //------------------------------------------------------------------------
     const std::string & LogFile::Compression(const std::string & compress)
     {
-      auto  it = sg_compressionExt.find(compress);
-      if (it != sg_compressionExt.end()) {
+      if (CompressionPool::Supported(compress)) {
         return (_compress = compress);
       }
       return (_compress = "bzip2");
     }
 
+    //------------------------------------------------------------------------
+    CompressionPool *LogFile::Compressor() const
+    { return _compressor; }
+
+    //------------------------------------------------------------------------
+    CompressionPool *LogFile::Compressor(CompressionPool *compressor)
+    {
+      std::lock_guard  lck(_mtx);
+      return (_compressor = compressor);
+    }
+
+    //------------------------------------------------------------------------
+    const FlushPolicy & LogFile::Flushing() const
+    { return _flushPolicy; }
+
+    //------------------------------------------------------------------------
+    const FlushPolicy & LogFile::Flushing(const FlushPolicy & flushPolicy)
+    {
+      std::lock_guard  lck(_mtx);
+      return (_flushPolicy = flushPolicy);
+    }
+
     //------------------------------------------------------------------------
     bool LogFile::NeedRollBeforeOpen() const
     {
@@ -250,7 +267,7 @@ namespace Dwm {
     bool LogFile::OpenNoLock()
     {
       bool  rc = false;
-      if (_ofs.is_open()) {
+      if (0 <= _fd) {
         MCLOG(Severity::info, "LogFile '{}' already open", _path.string());
         rc = true;
       }
@@ -259,8 +276,11 @@ namespace Dwm {
           Roll();
         }
         if (EnsureParentDirectory()) {
-          _ofs.open(_path, std::ios::out|std::ios::app);
-          if (static_cast<bool>(_ofs)) {
+          _fd = ::open(_path.string().c_str(),
+                       O_WRONLY|O_APPEND|O_CREAT|O_CLOEXEC, _permissions);
+          if (0 <= _fd) {
+            struct stat  statbuf;
+            _size = (0 == fstat(_fd, &statbuf)) ? statbuf.st_size : 0;
             rc = true;
             MCLOG(Severity::info, "LogFile '{}' opened", _path.string());
             SetPermissions();
@@ -283,36 +303,170 @@ namespace Dwm {
     void LogFile::Close()
     {
       std::lock_guard  lck(_mtx);
-      if (_ofs.is_open()) {
-        _ofs.close();
-      }
+      CloseNoLock();
       return;
     }
 
+    //------------------------------------------------------------------------
+    void LogFile::CloseNoLock()
+    {
+      if (0 <= _fd) {
+        FlushNoLock();
+        ::close(_fd);
+        _fd = -1;
+      }
+      _pending.clear();
+      _pendingBytes = 0;
+      return;
+    }
+    
     //------------------------------------------------------------------------
     bool LogFile::Process(const Message & msg)
     {
-      bool  rc = false;
       std::lock_guard  lck(_mtx);
-      if (_ofs.is_open()) {
-        if (RollCriteriaMet(msg)) {
-          _ofs.close();
-          Roll();
-          if (OpenNoLock()) {
-            MCLOG(Severity::info, "LogFile {} rolled", _path.string());
-          }
+      bool  rc = AppendNoLock(msg);
+      return (FlushNoLock() && rc);
+    }
+
+    //------------------------------------------------------------------------
+    bool LogFile::Append(const Message & msg)
+    {
+      std::lock_guard  lck(_mtx);
+      bool  rc = AppendNoLock(msg);
+      if (rc && _flushPolicy.Bytes()
+          && (_pendingBytes >= _flushPolicy.Bytes())) {
+        rc = FlushNoLock();
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    bool LogFile::Flush()
+    {
+      std::lock_guard  lck(_mtx);
+      return FlushNoLock();
+    }
+
+    //------------------------------------------------------------------------
+    bool LogFile::EndBatch(Clock::time_point now)
+    {
+      std::lock_guard  lck(_mtx);
+      if (_pending.empty()) {
+        return true;
+      }
+      if (_flushPolicy.PerBatch()
+          || ((now - _pendingSince) >= _flushPolicy.MaxDelay())) {
+        return FlushNoLock();
+      }
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    LogFile::Clock::time_point LogFile::FlushDeadline() const
+    {
+      std::lock_guard  lck(_mtx);
+      if (_pending.empty()) {
+        return Clock::time_point::max();
+      }
+      if (_flushPolicy.PerBatch()) {
+        return _pendingSince;
+      }
+      return (_pendingSince + _flushPolicy.MaxDelay());
+    }
+    
+    //------------------------------------------------------------------------
+    bool LogFile::AppendNoLock(const Message & msg)
+    {
+      if (0 > _fd) {
+        return false;
+      }
+      if (RollCriteriaMet(msg)) {
+        FlushNoLock();
+        ::close(_fd);
+        _fd = -1;
+        Roll();
+        if (! OpenNoLock()) {
+          return false;
         }
-        if (_format == FileFormat::binary) {
-          if (msg.Write(_ofs)) {
-            rc = (_ofs.flush() ? true : false);
-          }
+        MCLOG(Severity::info, "LogFile {} rolled", _path.string());
+      }
+      std::ostringstream  os;
+      if (_format == FileFormat::binary) {
+        if (! msg.Write(os)) {
+          return false;
         }
-        else {
-          if (_ofs << msg << std::flush) {
-            rc = true;
+      }
+      else {
+        os << msg;
+      }
+      if (_pending.empty()) {
+        _pendingSince = Clock::now();
+      }
+      _pending.push_back(std::move(os).str());
+      _pendingBytes += _pending.back().size();
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Writes everything pending with as few writev() calls as IOV_MAX
+    //!  allows, resuming after partial writes.
+    //------------------------------------------------------------------------
+    bool LogFile::FlushNoLock()
+    {
+      if (_pending.empty()) {
+        return true;
+      }
+      const size_t  maxIov = IOV_MAX;
+      bool  rc = (0 <= _fd);
+      std::vector<iovec>  iov;
+      iov.reserve(std::min(_pending.size(), maxIov));
+      size_t  next = 0;
+      while (rc && (next < _pending.size())) {
+        iov.clear();
+        for (size_t i = next;
+             (i < _pending.size()) && (iov.size() < maxIov); ++i) {
+          iov.push_back({ _pending[i].data(), _pending[i].size() });
+        }
+        size_t  iovidx = 0;
+        while (iovidx < iov.size()) {
+          ssize_t  written = ::writev(_fd, iov.data() + iovidx,
+                                      iov.size() - iovidx);
+          if (0 > written) {
+            if (EINTR == errno) {
+              continue;
+            }
+            MCLOG(Severity::err, "LogFile '{}' write failed: {}",
+                  _path.string(), strerror(errno));
+            rc = false;
+            break;
+          }
+          _size += written;
+          //  Skip what was written; adjust a partially written entry.
+          while ((iovidx < iov.size())
+                 && ((size_t)written >= iov[iovidx].iov_len)) {
+            written -= iov[iovidx].iov_len;
+            ++iovidx;
           }
+          if (written > 0) {
+            iov[iovidx].iov_base = (char *)iov[iovidx].iov_base + written;
+            iov[iovidx].iov_len -= written;
+          }
+        }
+        next += iov.size();
+      }
+      if (rc && _flushPolicy.Sync()) {
+#if (__APPLE__)
+        rc = (0 == fsync(_fd));
+#else
+        rc = (0 == fdatasync(_fd));
+#endif
+        if (! rc) {
+          MCLOG(Severity::err, "LogFile '{}' sync failed: {}",
+                _path.string(), strerror(errno));
         }
       }
+      _pending.clear();
+      _pendingBytes = 0;
       return rc;
     }
 
@@ -320,10 +474,8 @@ namespace Dwm {
     bool LogFile::RollCriteriaMet(const Message & msg)
     {
       if (_rollSize > 0) {
-        if (_ofs.is_open()) {
-          if (_ofs.tellp() >= _rollSize) {
-            return true;
-          }
+        if ((_size + (int64_t)_pendingBytes) >= _rollSize) {
+          return true;
         }
       }
       if (msg.Header().timestamp().Secs() >= _rollInterval.EndTime()) {
@@ -357,15 +509,23 @@ namespace Dwm {
       
       std::string  dst(_path.string() + ".0");
       fs::rename(_path, dst);
-      std::string  cmd(CompressCommand(_compress) + " " + dst
-                       + " > /dev/null 2>&1 &");
-      system(cmd.c_str());
+      if (_compressor) {
+        _compressor->Submit(dst, _compress);
+      }
+      else {
+        uint64_t  bytesIn, bytesOut;
+        CompressionPool::Compress(dst, _compress, bytesIn, bytesOut);
+      }
       return;
     }
 
     //------------------------------------------------------------------------
     void LogFile::Roll()
     {
+      //  Don't rename the previous roll's file while it's being compressed.
+      if (_compressor) {
+        _compressor->Wait(_path.string() + ".0");
+      }
       RollArchives();
       RollCurrent();
       _rollInterval.SetToCurrent();
@@ -382,7 +542,7 @@ namespace Dwm {
       auto  dir = _path.parent_path();
       auto  f = _path.filename();
       std::string  s(f.string() + "\\.([0-9]+)\\."
-                     + ArchiveExtension(_compress));
+                     + CompressionPool::Extension(_compress));
       std::regex   rgx(s, std::regex::ECMAScript|std::regex::optimize);
       std::smatch  sm;
       for (auto const & dirEntry : fs::directory_iterator{dir}) {
@@ -412,7 +572,7 @@ namespace Dwm {
     std::string LogFile::Archive::String() const
     {
       return (_base.string() + "." + std::to_string(_num)
-              + "." + ArchiveExtension(_compress));
+              + "." + CompressionPool::Extension(_compress));
     }
 
     //------------------------------------------------------------------------
@@ -37,6 +37,8 @@
 //!  @brief Dwm::Mclog::LogFiles implementation
 //---------------------------------------------------------------------------
 
+#include <algorithm>
+
 #include <boost/regex.hpp>
 
 #include "DwmMclogLogFiles.hh"
@@ -47,7 +49,8 @@ namespace Dwm {
 
     //------------------------------------------------------------------------
     LogFiles::LogFiles()
-        : _mtx(), _filesConfig(), _filteredLogConfigs(), _logFiles()
+        : _mtx(), _filesConfig(), _filteredLogConfigs(), _logFiles(),
+          _logPathCache(), _compressor(std::make_unique<CompressionPool>())
     {
     }
     
@@ -55,7 +58,9 @@ namespace Dwm {
     LogFiles::LogFiles(LogFiles && logFiles)
         : _mtx(), _filesConfig(std::move(logFiles._filesConfig)),
           _filteredLogConfigs(std::move(logFiles._filteredLogConfigs)),
-          _logFiles(std::move(logFiles._logFiles))
+          _logFiles(std::move(logFiles._logFiles)),
+          _logPathCache(std::move(logFiles._logPathCache)),
+          _compressor(std::move(logFiles._compressor))
     {
     }
 
@@ -68,6 +73,10 @@ namespace Dwm {
       }
       _logFiles.clear();
       _filteredLogConfigs.clear();
+      //  Finish compressing the files we rolled.
+      if (_compressor) {
+        _compressor->Stop();
+      }
     }
 
     //------------------------------------------------------------------------
@@ -82,6 +91,16 @@ namespace Dwm {
       _logPathCache.clear();
       
       _filesConfig = filesConfig;
+      if (! _compressor) {
+        _compressor = std::make_unique<CompressionPool>();
+      }
+      if ((! _compressor->Running())
+          || (_compressor->Threads() != _filesConfig.compressThreads)
+          || (_compressor->Niceness() != _filesConfig.compressNice)) {
+        _compressor->Stop();
+        _compressor->Start(_filesConfig.compressThreads,
+                           _filesConfig.compressNice);
+      }
       for (const auto & logcfg : _filesConfig.logs) {
         try {
           auto  filtLogCfg =
@@ -103,27 +122,83 @@ namespace Dwm {
       std::lock_guard  lck(_mtx);
       if (LogPathConfigs(msg, logPaths)) {
         for (const auto & lp : logPaths) {
-          auto  fit = _logFiles.find(lp.first);
-          if (fit != _logFiles.end()) {
-            rc &= fit->second.Process(msg);
-          }
-          else {
-            LogFile  logFile(lp.first, lp.second.permissions,
-                             lp.second.period, lp.second.size,
-                             lp.second.keep, lp.second.format);
-            logFile.User(lp.second.user);
-            logFile.Group(lp.second.group);
-            logFile.Compression(lp.second.compress);
-            auto [newit, dontCare] =
-              _logFiles.insert({lp.first, std::move(logFile)});
-            newit->second.Open();
-            rc &= newit->second.Process(msg);
+          rc &= OpenLogFile(lp.first, lp.second)->Process(msg);
+        }
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    bool LogFiles::Process(const std::deque<Message> & msgs)
+    {
+      bool  rc = true;
+      std::vector<std::pair<std::string,LogFileConfig &>>  logPaths;
+      std::vector<LogFile *>  touched;
+      std::lock_guard  lck(_mtx);
+      for (const auto & msg : msgs) {
+        if (LogPathConfigs(msg, logPaths)) {
+          for (const auto & lp : logPaths) {
+            LogFile  *logFile = OpenLogFile(lp.first, lp.second);
+            rc &= logFile->Append(msg);
+            if (std::find(touched.cbegin(), touched.cend(), logFile)
+                == touched.cend()) {
+              touched.push_back(logFile);
+            }
           }
         }
       }
+      auto  now = LogFile::Clock::now();
+      for (auto logFile : touched) {
+        rc &= logFile->EndBatch(now);
+      }
       return rc;
     }
 
+    //------------------------------------------------------------------------
+    bool LogFiles::Flush(LogFile::Clock::time_point now)
+    {
+      bool  rc = true;
+      std::lock_guard  lck(_mtx);
+      for (auto & lf : _logFiles) {
+        rc &= lf.second.EndBatch(now);
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    LogFile::Clock::time_point LogFiles::FlushDeadline() const
+    {
+      auto  rc = LogFile::Clock::time_point::max();
+      std::lock_guard  lck(_mtx);
+      for (const auto & lf : _logFiles) {
+        rc = std::min(rc, lf.second.FlushDeadline());
+      }
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Returns the open LogFile for @c path, opening it per
+    //!  @c logFileConfig if necessary.
+    //------------------------------------------------------------------------
+    LogFile *LogFiles::OpenLogFile(const std::string & path,
+                                   const LogFileConfig & logFileConfig)
+    {
+      auto  fit = _logFiles.find(path);
+      if (fit == _logFiles.end()) {
+        LogFile  logFile(path, logFileConfig.permissions,
+                         logFileConfig.period, logFileConfig.size,
+                         logFileConfig.keep, logFileConfig.format);
+        logFile.User(logFileConfig.user);
+        logFile.Group(logFileConfig.group);
+        logFile.Compression(logFileConfig.compress);
+        logFile.Flushing(logFileConfig.flush);
+        logFile.Compressor(_compressor.get());
+        fit = _logFiles.insert({path, std::move(logFile)}).first;
+        fit->second.Open();
+      }
+      return &(fit->second);
+    }
+
     //------------------------------------------------------------------------
     //!  
     //------------------------------------------------------------------------
@@ -135,6 +210,14 @@ namespace Dwm {
       }
       _logFiles.clear();
     }
+
+    //------------------------------------------------------------------------
+    CompressionPool::Counts LogFiles::HarvestCompressions()
+    {
+      std::lock_guard  lck(_mtx);
+      return (_compressor ? _compressor->Harvest()
+              : CompressionPool::Counts());
+    }
     
     //------------------------------------------------------------------------
     //!  
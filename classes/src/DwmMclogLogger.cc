@@ -85,7 +85,7 @@ namespace Dwm {
     Logger::Logger()
         : _origin("","",0), _facility(Facility::user),
           _minimumSeverity(Severity::debug), _logLocations(false),
-          _sinksMtx(), _sinks(), _loopbackSender(nullptr),
+          _sinksMtx(), _sinks(), _loopbackSender(nullptr), _batching(),
           _cerrSink(std::cerr), _syslogSink(nullptr)
     { }
 
@@ -113,6 +113,7 @@ namespace Dwm {
       _sinks.clear();
       if (sinks.empty()) {
         _loopbackSender = new LoopbackSender();
+        _loopbackSender->Batching(_batching);
         {
           _sinks.push_back(_loopbackSender);
         }
@@ -160,6 +161,17 @@ namespace Dwm {
       return rc;
     }
     
+    //------------------------------------------------------------------------
+    void Logger::Batching(const BatchPolicy & batching)
+    {
+      std::lock_guard  lck(_sinksMtx);
+      _batching = batching;
+      if (nullptr != _loopbackSender) {
+        _loopbackSender->Batching(_batching);
+      }
+      return;
+    }
+    
     //------------------------------------------------------------------------
     void Logger::SetSinks(const std::vector<MessageSink *> & sinks)
     {
@@ -53,7 +53,8 @@ namespace Dwm {
     //------------------------------------------------------------------------
     LoopbackSender::LoopbackSender()
         : _run(false), _ofd(-1), _msgs(), _thread(), _nextSendTime(),
-          _running(false)
+          _running(false), _batchingMtx(), _batching(),
+          _packetLen(MessagePacket::k_defaultPacketLen)
     {
       Start();
     }
@@ -69,6 +70,21 @@ namespace Dwm {
     {
       return _msgs.PushBack(msg);
     }
+
+    //------------------------------------------------------------------------
+    BatchPolicy LoopbackSender::Batching() const
+    {
+      std::lock_guard  lck(_batchingMtx);
+      return _batching;
+    }
+
+    //------------------------------------------------------------------------
+    void LoopbackSender::Batching(const BatchPolicy & batching)
+    {
+      std::lock_guard  lck(_batchingMtx);
+      _batching = batching;
+      return;
+    }
     
     //------------------------------------------------------------------------
     bool LoopbackSender::OpenSocket()
@@ -96,7 +112,7 @@ namespace Dwm {
     void LoopbackSender::SetSndBuf(int fd)
     {
       if (0 <= fd) {
-        std::vector<int>  trySizes{131072, 98304, 65536, 32768};
+        std::vector<int>  trySizes{262144, 131072, 98304, 65536, 32768};
         int  defaultsz;
         int  foundsz = 0;
         socklen_t  len = sizeof(defaultsz);
@@ -134,6 +150,7 @@ namespace Dwm {
       bool  rc = false;
       if (! _run.load()) {
         if (OpenSocket()) {
+          _packetLen = MessagePacket::LoopbackPacketLen();
           _run.store(true);
           _thread = std::thread(&LoopbackSender::Run, this);
           while (! _running) {
@@ -161,53 +178,86 @@ namespace Dwm {
     }
 
     //------------------------------------------------------------------------
-    bool LoopbackSender::SendPacket(MessagePacket & pkt)
+    bool LoopbackSender::SendBatch(PacketBatch & batch)
     {
       static const  UdpEndpoint  dstAddr4(Ipv4Address("127.0.0.1"),
                                           MCLOGD_DEFAULT_PORT);
-      ssize_t  sendrc = pkt.SendTo(_ofd, dstAddr4);
-      pkt.Reset();
-      return (0 < sendrc);
+      size_t  sent = batch.SendTo(_ofd, dstAddr4);
+      //  SendTo() seals staged messages into packets.
+      size_t  numPackets = batch.NumPackets();
+      batch.Reset();
+      return (sent == numPackets);
     }
     
+    //------------------------------------------------------------------------
+    void LoopbackSender::FlushBatch(PacketBatch & batch)
+    {
+      if (batch.HasPayload()) {
+        if (! SendBatch(batch)) {
+          Syslog(LOG_ERR, "SendBatch() failed");
+        }
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  We hold a partially filled packet until its first message has
+    //!  waited for the batching policy's MaxDelay(), or until we see a
+    //!  message at or above the policy's FlushSeverity().  Under light
+    //!  load this keeps latency low, under heavy load packets fill before
+    //!  the deadline.  Packets are sized for the loopback MTU, and a run
+    //!  of full packets is sent with one system call.  Messages are
+    //!  encoded as MessageBlocks.
     //------------------------------------------------------------------------
     void LoopbackSender::Run()
     {
 #if (__APPLE__)
       pthread_setname_np("LoopbackSender");
 #endif
-      char           buf[1200];
-      MessagePacket  pkt(buf, sizeof(buf));
+      PacketBatch    batch(_packetLen);
       Message        msg;
+      batch.Compact(true);
       _running.store(true);
       while (_run) {
-        if (_msgs.ConditionTimedWait(std::chrono::seconds(1))) {
-          auto  now = Clock::now();
-          while (_msgs.PopFront(msg)) {
-            if (! pkt.Add(msg)) {
-              if (! SendPacket(pkt)) {
-                Syslog(LOG_ERR, "SendPacket() failed");
-              }
-              _nextSendTime = now + std::chrono::milliseconds(1000);
-              pkt.Add(msg);
+        if (_msgs.Empty()) {
+          if (batch.HasPayload()) {
+            auto  now = Clock::now();
+            if (now < _nextSendTime) {
+              _msgs.ConditionTimedWait(_nextSendTime - now);
             }
           }
+          else {
+            _msgs.ConditionTimedWait(std::chrono::seconds(1));
+          }
         }
-        else {
-          auto  now = Clock::now();
-          if (pkt.HasPayload()) {
-            if (! SendPacket(pkt)) {
-              Syslog(LOG_ERR, "SendPacket() failed");
-            }
-            _nextSendTime = now + std::chrono::milliseconds(1000);
+        BatchPolicy  batching = Batching();
+        bool         flushNow = false;
+        while (_msgs.PopFront(msg)) {
+          if (! batch.HasPayload()) {
+            _nextSendTime = Clock::now() + batching.MaxDelay();
+          }
+          if (! batch.Add(msg)) {
+            FlushBatch(batch);
+            _nextSendTime = Clock::now() + batching.MaxDelay();
+            batch.Add(msg);
           }
+          flushNow |= batching.FlushNow(msg.Header().severity());
+        }
+        if (flushNow || batch.FullPackets()
+            || (Clock::now() >= _nextSendTime)) {
+          FlushBatch(batch);
         }
       }
-      if (pkt.HasPayload()) {
-        if (! SendPacket(pkt)) {
-          Syslog(LOG_ERR, "SendPacket() failed");
+      //  Don't lose anything that was queued before we were stopped.
+      while (_msgs.PopFront(msg)) {
+        if (! batch.Add(msg)) {
+          FlushBatch(batch);
+          batch.Add(msg);
         }
       }
+      while (batch.HasPayload()) {
+        FlushBatch(batch);
+      }
       _running.store(false);
       return;
     }
@@ -120,7 +120,7 @@ namespace Dwm {
         is >> std::ws;
         std::string  s;
         std::getline(is, s);
-        if (s.size() <= 1500) {
+        if (s.size() <= Message::k_maxTextLen) {
           msg._message = s;
         }
         else {
@@ -0,0 +1,219 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogMessageBlock.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::MessageBlock class implementation
+//---------------------------------------------------------------------------
+
+#include "DwmEncodedUnsigned.hh"
+#include "DwmIOUtils.hh"
+#include "DwmStreamIO.hh"
+#include "DwmMclogMessageBlock.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    static uint64_t ZigZag(int64_t n)
+    {
+      return (((uint64_t)n << 1) ^ (uint64_t)(n >> 63));
+    }
+
+    //------------------------------------------------------------------------
+    static int64_t UnZigZag(uint64_t n)
+    {
+      return (int64_t)((n >> 1) ^ (0 - (n & 1)));
+    }
+    
+    //------------------------------------------------------------------------
+    MessageBlock::MessageBlock()
+        : _started(false), _base(0), _origins()
+    {}
+
+    //------------------------------------------------------------------------
+    void MessageBlock::Clear()
+    {
+      _started = false;
+      _base = 0;
+      _origins.clear();
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    bool MessageBlock::Accepts(const Message & msg) const
+    {
+      return ((_origins.size() < k_maxOrigins)
+              || (FindOrigin(msg.Header().origin()) < _origins.size()));
+    }
+    
+    //------------------------------------------------------------------------
+    std::ostream & MessageBlock::Write(std::ostream & os, const Message & msg)
+    {
+      const MessageHeader  & hdr = msg.Header();
+      const std::string    & text = msg.Data();
+      size_t  idx = FindOrigin(hdr.origin());
+      if ((idx >= k_maxOrigins) || (text.size() > k_maxTextLen)) {
+        os.setstate(std::ios_base::failbit);
+        return os;
+      }
+      if (! _started) {
+        if (! (hdr.timestamp().Write(os) && StreamIO::Write(os, k_marker))) {
+          return os;
+        }
+      }
+      uint8_t     originIdx = idx;
+      uint8_t     priority = ((uint8_t)hdr.facility()
+                              | (uint8_t)hdr.severity());
+      EncodedU64  offset = Offset(hdr.timestamp());
+      EncodedU64  textLen = text.size();
+      if (StreamIO::Write(os, originIdx)
+          && ((idx < _origins.size()) || hdr.origin().Write(os))
+          && StreamIO::Write(os, priority)
+          && offset.Write(os) && textLen.Write(os)
+          && os.write(text.data(), text.size())) {
+        if (! _started) {
+          _base = hdr.timestamp().Microseconds();
+          _started = true;
+        }
+        if (idx == _origins.size()) {
+          _origins.push_back(hdr.origin());
+        }
+      }
+      return os;
+    }
+
+    //------------------------------------------------------------------------
+    uint64_t MessageBlock::StreamedLength(const Message & msg) const
+    {
+      const MessageHeader  & hdr = msg.Header();
+      uint64_t  rc = 0;
+      if (! _started) {
+        rc += (hdr.timestamp().StreamedLength()
+               + IOUtils::StreamedLength(k_marker));
+      }
+      rc += sizeof(uint8_t);  // origin index
+      if (FindOrigin(hdr.origin()) == _origins.size()) {
+        rc += hdr.origin().StreamedLength();
+      }
+      rc += sizeof(uint8_t);  // priority
+      rc += EncodedU64(Offset(hdr.timestamp())).StreamedLength();
+      rc += EncodedU64(msg.Data().size()).StreamedLength();
+      rc += msg.Data().size();
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    std::istream & MessageBlock::Read(std::istream & is,
+                                      std::deque<Message> & msgs)
+    {
+      Timestamp  base;
+      uint8_t    marker;
+      if (! (base.Read(is) && StreamIO::Read(is, marker))) {
+        return is;
+      }
+      if (k_marker != marker) {
+        is.setstate(std::ios_base::failbit);
+        return is;
+      }
+      std::vector<MessageOrigin>  origins;
+      while (std::istream::traits_type::eof() != is.peek()) {
+        uint8_t     originIdx, priority;
+        EncodedU64  offset, textLen;
+        if (! StreamIO::Read(is, originIdx)) {
+          break;
+        }
+        if (originIdx == origins.size()) {
+          MessageOrigin  origin;
+          if (! origin.Read(is)) {
+            break;
+          }
+          origins.push_back(std::move(origin));
+        }
+        else if (originIdx > origins.size()) {
+          is.setstate(std::ios_base::failbit);
+          break;
+        }
+        if (! (StreamIO::Read(is, priority) && offset.Read(is)
+               && textLen.Read(is))) {
+          break;
+        }
+        uint8_t  facility = priority & 0xF8;
+        if ((facility > (uint8_t)Facility::local7)
+            || ((uint64_t)textLen > k_maxTextLen)) {
+          is.setstate(std::ios_base::failbit);
+          break;
+        }
+        std::string  text((uint64_t)textLen, '\0');
+        if (! is.read(text.data(), text.size())) {
+          break;
+        }
+        Timestamp  ts(base.Microseconds() + UnZigZag(offset));
+        msgs.emplace_back(MessageHeader(ts, (Facility)facility,
+                                        (Severity)(priority & 0x07),
+                                        origins[originIdx]),
+                          std::move(text));
+      }
+      if (is.eof() && (! is.fail())) {
+        //  Clean end of the payload.
+        is.clear();
+      }
+      return is;
+    }
+    
+    //------------------------------------------------------------------------
+    size_t MessageBlock::FindOrigin(const MessageOrigin & origin) const
+    {
+      size_t  i = 0;
+      for ( ; i < _origins.size(); ++i) {
+        if (_origins[i] == origin) {
+          break;
+        }
+      }
+      return i;
+    }
+
+    //------------------------------------------------------------------------
+    uint64_t MessageBlock::Offset(const Timestamp & timestamp) const
+    {
+      if (! _started) {
+        return 0;
+      }
+      return ZigZag((int64_t)(timestamp.Microseconds() - _base));
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
@@ -37,6 +37,7 @@
 //!  @brief Dwm::Mclog::MessageFilterDriver implementation
 //---------------------------------------------------------------------------
 
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 #include <stdexcept>
@@ -100,6 +101,27 @@ namespace Dwm {
       }
       return rc;
     }
+
+    //------------------------------------------------------------------------
+    bool MessageFilterDriver::priority_only()
+    {
+      using Kind = MessageFilterParser::symbol_kind_type;
+      
+      std::lock_guard  lck(parsemtx);
+      return std::none_of(tokens.begin(), tokens.end(),
+                          [] (const SymbolType & token)
+                          {
+                            switch (token.kind()) {
+                              case Kind::S_HOST:
+                              case Kind::S_IDENT:
+                              case Kind::S_PID:
+                              case Kind::S_MSG:
+                                return true;
+                              default:
+                                return false;
+                            }
+                          });
+    }
     
   }  // namespace Mclog
 
@@ -0,0 +1,129 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogMessageFragment.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::MessageFragment class implementation
+//---------------------------------------------------------------------------
+
+#include <sstream>
+
+#include "DwmIOUtils.hh"
+#include "DwmStreamIO.hh"
+#include "DwmMclogMessageFragment.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    MessageFragment::MessageFragment()
+        : _timestamp(), _id(0), _index(0), _count(0), _data()
+    {}
+
+    //------------------------------------------------------------------------
+    MessageFragment::MessageFragment(uint32_t id, uint16_t index,
+                                     uint16_t count, std::string && data)
+        : _timestamp(), _id(id), _index(index), _count(count),
+          _data(std::move(data))
+    {}
+
+    //------------------------------------------------------------------------
+    std::istream & MessageFragment::Read(std::istream & is)
+    {
+      uint8_t  marker;
+      if (_timestamp.Read(is) && StreamIO::Read(is, marker)) {
+        if (k_marker == marker) {
+          if (StreamIO::ReadV(is, _id, _index, _count, _data)) {
+            if ((0 == _count) || (_index >= _count)
+                || (_count > k_maxCount)) {
+              is.setstate(std::ios_base::failbit);
+            }
+          }
+        }
+        else {
+          is.setstate(std::ios_base::failbit);
+        }
+      }
+      return is;
+    }
+
+    //------------------------------------------------------------------------
+    std::ostream & MessageFragment::Write(std::ostream & os) const
+    {
+      if (_timestamp.Write(os)) {
+        StreamIO::WriteV(os, k_marker, _id, _index, _count, _data);
+      }
+      return os;
+    }
+
+    //------------------------------------------------------------------------
+    uint64_t MessageFragment::StreamedLength() const
+    {
+      return (_timestamp.StreamedLength()
+              + IOUtils::StreamedLength(k_marker)
+              + IOUtils::StreamedLength(_id)
+              + IOUtils::StreamedLength(_index)
+              + IOUtils::StreamedLength(_count)
+              + IOUtils::StreamedLength(_data));
+    }
+
+    //------------------------------------------------------------------------
+    bool MessageFragment::Split(const Message & msg, uint32_t id,
+                                size_t maxLen,
+                                std::vector<MessageFragment> & frags)
+    {
+      uint64_t  overhead = MessageFragment().StreamedLength();
+      if (maxLen <= overhead) {
+        return false;
+      }
+      std::ostringstream  os;
+      if (! msg.Write(os)) {
+        return false;
+      }
+      std::string  bytes = os.str();
+      size_t  dataLen = maxLen - overhead;
+      size_t  count = (bytes.size() + dataLen - 1) / dataLen;
+      if ((0 == count) || (count > k_maxCount)) {
+        return false;
+      }
+      for (size_t i = 0; i < count; ++i) {
+        frags.emplace_back(id, i, count, bytes.substr(i * dataLen, dataLen));
+      }
+      return true;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
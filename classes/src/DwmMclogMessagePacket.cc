@@ -38,9 +38,17 @@
 //---------------------------------------------------------------------------
 
 extern "C" {
+  #include <sys/types.h>
+  #include <sys/ioctl.h>
+  #include <sys/socket.h>
+  #include <ifaddrs.h>
+  #include <net/if.h>
+  #include <netinet/in.h>
   #include <sodium.h>
+  #include <unistd.h>
 }
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
@@ -69,11 +77,40 @@ namespace Dwm {
       return false;
     }
 
+    //------------------------------------------------------------------------
+    bool MessagePacket::Payload(const char *data, size_t len,
+                                bool compressed)
+    {
+      if (len > PayloadCapacity()) {
+        return false;
+      }
+      memcpy(_buf + k_nonceLen, data, len);
+      _payload.clear();
+      _payload.seekp(len);
+      _payloadLength = len;
+      _compressed = compressed;
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    bool MessagePacket::Summarize(bool summarize)
+    {
+      if (HasPayload()) {
+        return false;
+      }
+      _summarize = summarize;
+      _payload = std::spanstream{std::span{_buf + k_nonceLen,
+                                           PayloadCapacity()}};
+      return true;
+    }
+    
     //------------------------------------------------------------------------
     void MessagePacket::Reset()
     {
       _payload.seekp(0);
       _payloadLength = 0;
+      _compressed = false;
+      _summary.Clear();
       return;
     }
     
@@ -129,39 +166,141 @@ namespace Dwm {
       return rc;
     }
 
+    //------------------------------------------------------------------------
+    bool MessagePacket::Encrypt(const std::string & secretKey,
+                                NonceSequence & nonces)
+    {
+      constexpr size_t  gcmOff = NonceSequence::k_gcmNonceOffset;
+      nonces.Next((uint8_t *)_buf);
+      if (_compressed) {
+        _buf[NonceSequence::k_suiteOffset] |= NonceSequence::k_compressedFlag;
+      }
+      if (_summarize) {
+        _buf[NonceSequence::k_suiteOffset] |= NonceSequence::k_summaryFlag;
+        _summary.Encode((uint8_t *)_buf + k_nonceLen + _payloadLength
+                        + k_macLen);
+      }
+      const uint8_t  *hdr = (const uint8_t *)_buf;
+      uint8_t        *data = (uint8_t *)_buf + k_nonceLen;
+      const uint8_t  *key = (const uint8_t *)secretKey.data();
+      uint8_t         ad[gcmOff + PacketSummary::k_len];
+      size_t          adLen = AssociatedData(nonces.Suite(), ad);
+      unsigned long long  cbuflen = _payloadLength + k_macLen;
+      int  encrc = -1;
+      if (nonces.Suite() == CipherSuite::aes256gcm) {
+        encrc = crypto_aead_aes256gcm_encrypt(data, &cbuflen,
+                                              data, _payloadLength,
+                                              ad, adLen,
+                                              nullptr, hdr + gcmOff, key);
+      }
+      else {
+        encrc = crypto_aead_xchacha20poly1305_ietf_encrypt(data, &cbuflen,
+                                                           data,
+                                                           _payloadLength,
+                                                           ad, adLen,
+                                                           nullptr, hdr,
+                                                           key);
+      }
+      return ((0 == encrc) && ((_payloadLength + k_macLen) == cbuflen));
+    }
+    
     //------------------------------------------------------------------------
     ssize_t MessagePacket::Decrypt(size_t recvlen,
                                    const std::string & secretKey)
     {
       ssize_t  rc = -1;
+      _payloadLength = 0;
+      _compressed = false;
+      _summarize = false;
+      _summary.Clear();
       if (recvlen > (k_nonceLen + k_macLen)) {
-        constexpr auto  xcc20p1305dec =
-          crypto_aead_xchacha20poly1305_ietf_decrypt;
-        unsigned long long plainLen = recvlen - (k_nonceLen + k_macLen);
-        if (xcc20p1305dec((uint8_t *)_buf + k_nonceLen,
-                          &plainLen, nullptr,
-                          (const uint8_t *)_buf + k_nonceLen,
-                          recvlen - k_nonceLen,
-                          nullptr, 0,
-                          (const uint8_t *)_buf,
-                          (const uint8_t *)secretKey.data()) == 0) {
-          rc = recvlen;
+        constexpr size_t  gcmOff = NonceSequence::k_gcmNonceOffset;
+        const uint8_t  *hdr = (const uint8_t *)_buf;
+        uint8_t        *data = (uint8_t *)_buf + k_nonceLen;
+        const uint8_t  *key = (const uint8_t *)secretKey.data();
+        CipherSuite     suite = CipherSuite::xchacha20poly1305;
+        std::string     prefix;
+        uint64_t        counter;
+        bool  tagged = NonceSequence::Parse(hdr, suite, prefix, counter);
+        _summarize = (tagged && (hdr[NonceSequence::k_suiteOffset]
+                                 & NonceSequence::k_summaryFlag));
+        size_t  cipherLen = recvlen - (k_nonceLen + SummaryLen());
+        int  decrc = -1;
+        if (cipherLen > k_macLen) {
+          unsigned long long  plainLen = cipherLen - k_macLen;
           _payloadLength = plainLen;
-          _payload = std::spanstream{std::span{_buf + k_nonceLen,              
+          uint8_t  ad[gcmOff + PacketSummary::k_len];
+          size_t   adLen = AssociatedData(suite, ad);
+          if (suite == CipherSuite::aes256gcm) {
+            if (LocalCipherSuites() & CipherSuiteBit(suite)) {
+              decrc = crypto_aead_aes256gcm_decrypt(data, &plainLen, nullptr,
+                                                    data, cipherLen,
+                                                    ad, adLen,
+                                                    hdr + gcmOff, key);
+            }
+          }
+          else if (suite == CipherSuite::xchacha20poly1305) {
+            //  Includes packets from older senders, with random nonces.
+            constexpr auto  xcc20p1305dec =
+              crypto_aead_xchacha20poly1305_ietf_decrypt;
+            decrc = xcc20p1305dec(data, &plainLen, nullptr,
+                                  data, cipherLen,
+                                  ad, adLen, hdr, key);
+          }
+        }
+        if (0 == decrc) {
+          rc = recvlen;
+          _payload = std::spanstream{std::span{_buf + k_nonceLen,
                                      _payloadLength}};
+          _compressed = (tagged && (hdr[NonceSequence::k_suiteOffset]
+                                    & NonceSequence::k_compressedFlag));
+          if (_summarize) {
+            _summary.Decode(data + _payloadLength + k_macLen);
+          }
         }
         else {
-          _payload = std::spanstream{std::span{_buf + k_nonceLen,0}};
           _payloadLength = 0;
+          _summarize = false;
         }
       }
-      else {
+      if (rc < 0) {
         _payload = std::spanstream{std::span{_buf + k_nonceLen,0}};
-        _payloadLength = 0;
       }
       return rc;
     }
 
+    //------------------------------------------------------------------------
+    //!  Writes the associated data for @c suite to @c ad, which must have
+    //!  room for the start of the nonce header and a PacketSummary.
+    //!  AES-256-GCM authenticates the part of the nonce header that isn't
+    //!  its nonce, and the summary after the MAC is authenticated with
+    //!  either suite.  Returns the length of the associated data.
+    //------------------------------------------------------------------------
+    size_t MessagePacket::AssociatedData(CipherSuite suite, uint8_t *ad) const
+    {
+      constexpr size_t  gcmOff = NonceSequence::k_gcmNonceOffset;
+      size_t  rc = 0;
+      if (suite == CipherSuite::aes256gcm) {
+        memcpy(ad, _buf, gcmOff);
+        rc = gcmOff;
+      }
+      if (_summarize) {
+        memcpy(ad + rc, _buf + k_nonceLen + _payloadLength + k_macLen,
+               PacketSummary::k_len);
+        rc += PacketSummary::k_len;
+      }
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    bool MessagePacket::Sequence(std::string & prefix,
+                                 uint64_t & counter) const
+    {
+      CipherSuite  suite;
+      return NonceSequence::Parse((const uint8_t *)_buf, suite, prefix,
+                                  counter);
+    }
+
     //------------------------------------------------------------------------
     ssize_t MessagePacket::RecvFrom(int fd, const std::string & secretKey,
                                     sockaddr_in *src)
@@ -264,6 +403,93 @@ namespace Dwm {
       return rc;
     }
     
+    //------------------------------------------------------------------------
+    size_t MessagePacket::InterfaceMtu(const std::string & intfName)
+    {
+      size_t  rc = 0;
+      if (intfName.empty() || (intfName.size() >= IFNAMSIZ)) {
+        return rc;
+      }
+      int  fd = socket(PF_INET, SOCK_DGRAM, 0);
+      if (0 <= fd) {
+        struct ifreq  ifr;
+        memset(&ifr, 0, sizeof(ifr));
+        strncpy(ifr.ifr_name, intfName.c_str(), IFNAMSIZ - 1);
+        if (0 == ioctl(fd, SIOCGIFMTU, &ifr)) {
+          if (ifr.ifr_mtu > 0) {
+            rc = ifr.ifr_mtu;
+          }
+        }
+        else {
+          FSyslog(LOG_ERR, "ioctl({},SIOCGIFMTU,{}) failed: {}",
+                  fd, intfName, strerror(errno));
+        }
+        ::close(fd);
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    size_t MessagePacket::InterfaceMtu(const Ipv4Address & intfAddr)
+    {
+      std::string  intfName;
+      struct ifaddrs  *ifAddrs;
+      if (getifaddrs(&ifAddrs) == 0) {
+        for (auto ifAddr = ifAddrs; ifAddr; ifAddr = ifAddr->ifa_next) {
+          if (ifAddr->ifa_addr && (ifAddr->ifa_addr->sa_family == AF_INET)) {
+            const sockaddr_in  *sa = (const sockaddr_in *)ifAddr->ifa_addr;
+            if (sa->sin_addr.s_addr == intfAddr.Raw()) {
+              intfName = ifAddr->ifa_name;
+              break;
+            }
+          }
+        }
+        freeifaddrs(ifAddrs);
+      }
+      return InterfaceMtu(intfName);
+    }
+
+    //------------------------------------------------------------------------
+    size_t MessagePacket::PacketLenForMtu(size_t mtu, bool ipv6)
+    {
+      //  IPv4 header (without options) + UDP header, or IPv6 header +
+      //  UDP header.
+      size_t  hdrLen = (ipv6 ? (40 + 8) : (20 + 8));
+      if (mtu <= hdrLen) {
+        return k_defaultPacketLen;
+      }
+      return std::clamp(mtu - hdrLen, k_minSendPacketLen, k_maxPacketLen);
+    }
+
+    //------------------------------------------------------------------------
+    size_t MessagePacket::LoopbackPacketLen()
+    {
+#if defined(__linux__)
+      static const std::string  loopbackIntf("lo");
+#else
+      static const std::string  loopbackIntf("lo0");
+#endif
+      return PacketLenForMtu(InterfaceMtu(loopbackIntf), false);
+    }
+
+    //------------------------------------------------------------------------
+    bool MessagePacket::PeekSummary(const char *data, size_t datalen,
+                                    PacketSummary & summary)
+    {
+      CipherSuite  suite;
+      std::string  prefix;
+      uint64_t     counter;
+      const uint8_t  *hdr = (const uint8_t *)data;
+      if ((datalen > (k_minPacketLen + PacketSummary::k_len))
+          && NonceSequence::Parse(hdr, suite, prefix, counter)
+          && (hdr[NonceSequence::k_suiteOffset]
+              & NonceSequence::k_summaryFlag)) {
+        summary.Decode(hdr + (datalen - PacketSummary::k_len));
+        return true;
+      }
+      return false;
+    }
+    
   }  // namespace Mclog
 
 }  // namespace Dwm
@@ -0,0 +1,223 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogMulticastKeyCache.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::MulticastKeyCache class implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+}
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "DwmFormatters.hh"
+#include "DwmStreamIO.hh"
+#include "DwmSysLogger.hh"
+#include "DwmMclogKeyDirectory.hh"
+#include "DwmMclogMulticastKeyCache.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    static constexpr uint32_t  k_cacheMagic = 0x4d434b43;  // 'MCKC'
+
+    //------------------------------------------------------------------------
+    MulticastKeyCache::MulticastKeyCache(const std::string *keyDir)
+        : _keyDir(keyDir), _mtx(), _entries(), _loadedPath(),
+          _loadedIno(0), _loadedMtime(0)
+    {}
+
+    //------------------------------------------------------------------------
+    bool MulticastKeyCache::Get(const UdpEndpoint & src,
+                                MulticastSourceKey & key)
+    {
+      std::lock_guard  lck(_mtx);
+      std::string  path = Path();
+      if (path.empty() || (! Load(path))) {
+        return false;
+      }
+      auto  it = _entries.find(MakeKey(src));
+      if ((it == _entries.end()) || IsExpired(it->second)) {
+        return false;
+      }
+      key.Value(it->second.first);
+      key.LastUpdated(MulticastSourceKey::Clock::
+                      from_time_t(it->second.second));
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    bool MulticastKeyCache::Put(const UdpEndpoint & src,
+                                const MulticastSourceKey & key)
+    {
+      std::lock_guard  lck(_mtx);
+      std::string  path = Path();
+      if (path.empty()) {
+        return false;
+      }
+      Load(path);  //  Merge with what others have saved.
+      _entries[MakeKey(src)] =
+        Entry(key.Value(),
+              MulticastSourceKey::Clock::to_time_t(key.LastUpdated()));
+      return Save(path);
+    }
+
+    //------------------------------------------------------------------------
+    void MulticastKeyCache::Invalidate(const UdpEndpoint & src,
+                                       const std::string & keyValue)
+    {
+      std::lock_guard  lck(_mtx);
+      std::string  path = Path();
+      if ((! path.empty()) && Load(path)) {
+        auto  it = _entries.find(MakeKey(src));
+        if ((it != _entries.end()) && (it->second.first == keyValue)) {
+          _entries.erase(it);
+          FSyslog(LOG_INFO, "Invalidated cached key for {}", src);
+          Save(path);
+        }
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    std::string MulticastKeyCache::Path() const
+    {
+      if ((nullptr == _keyDir) || _keyDir->empty()) {
+        return std::string();
+      }
+      std::string  dir = KeyDirectory::ExpandedPath(*_keyDir);
+      if (dir.empty()) {
+        return dir;
+      }
+      return dir + '/' + k_fileName;
+    }
+    
+    //------------------------------------------------------------------------
+    MulticastKeyCache::EntryKey
+    MulticastKeyCache::MakeKey(const UdpEndpoint & src)
+    {
+      return EntryKey((std::string)src.Addr(), src.Port());
+    }
+
+    //------------------------------------------------------------------------
+    bool MulticastKeyCache::IsExpired(const Entry & entry)
+    {
+      auto  updated = MulticastSourceKey::Clock::from_time_t(entry.second);
+      return ((MulticastSourceKey::Clock::now() - updated) > k_maxAge);
+    }
+    
+    //------------------------------------------------------------------------
+    bool MulticastKeyCache::Load(const std::string & path)
+    {
+      struct stat  statbuf;
+      if (0 != stat(path.c_str(), &statbuf)) {
+        _entries.clear();
+        _loadedPath.clear();
+        return false;
+      }
+      //  Every Save() renames a new file into place, so the inode number
+      //  changes even if the mtime doesn't.
+      if ((path == _loadedPath) && (statbuf.st_ino == _loadedIno)
+          && (statbuf.st_mtime == _loadedMtime)) {
+        return true;
+      }
+      _entries.clear();
+      _loadedPath.clear();
+      if ((statbuf.st_uid != geteuid()) || (statbuf.st_mode & 077)) {
+        FSyslog(LOG_ERR, "Ignoring {}: must be owned by uid {} with"
+                " mode 0600", path, geteuid());
+        return false;
+      }
+      std::ifstream  is(path);
+      if (! is) {
+        return false;
+      }
+      uint32_t  magic;
+      if ((! StreamIO::Read(is, magic)) || (k_cacheMagic != magic)
+          || (! StreamIO::Read(is, _entries))) {
+        FSyslog(LOG_ERR, "Failed to read {}", path);
+        _entries.clear();
+        return false;
+      }
+      _loadedPath = path;
+      _loadedIno = statbuf.st_ino;
+      _loadedMtime = statbuf.st_mtime;
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    bool MulticastKeyCache::Save(const std::string & path)
+    {
+      std::erase_if(_entries, [] (const auto & e)
+                              { return IsExpired(e.second); });
+      std::ostringstream  os;
+      if (! (StreamIO::Write(os, k_cacheMagic)
+             && StreamIO::Write(os, _entries))) {
+        return false;
+      }
+      std::string  data = os.str();
+      std::string  tmpPath = path + ".tmp." + std::to_string(getpid());
+      int  fd = open(tmpPath.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0600);
+      if (0 > fd) {
+        FSyslog(LOG_ERR, "open({}) failed: {}", tmpPath, strerror(errno));
+        return false;
+      }
+      bool  rc = (fchmod(fd, 0600) == 0)
+        && (write(fd, data.data(), data.size()) == (ssize_t)data.size());
+      rc = (close(fd) == 0) && rc;
+      if (rc && (0 == rename(tmpPath.c_str(), path.c_str()))) {
+        struct stat  statbuf;
+        if (0 == stat(path.c_str(), &statbuf)) {
+          _loadedPath = path;
+          _loadedIno = statbuf.st_ino;
+          _loadedMtime = statbuf.st_mtime;
+        }
+        return true;
+      }
+      FSyslog(LOG_ERR, "Failed to save {}: {}", path, strerror(errno));
+      unlink(tmpPath.c_str());
+      return false;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
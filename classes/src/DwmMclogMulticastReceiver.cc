@@ -38,11 +38,14 @@
 //---------------------------------------------------------------------------
 
 #include <algorithm>
+#include <vector>
 
 #include "DwmFormatters.hh"
 #include "DwmSysLogger.hh"
 #include "DwmCredenceXChaCha20Poly1305.hh"
 #include "DwmMclogKeyRequester.hh"
+#include "DwmMclogMessageFilterDriver.hh"
+#include "DwmMclogMessagePacket.hh"
 #include "DwmMclogMulticastReceiver.hh"
 #include "DwmMclogLogger.hh"
 
@@ -52,9 +55,11 @@ namespace Dwm {
 
     //------------------------------------------------------------------------
     MulticastReceiver::MulticastReceiver()
-        : _config(), _fd(-1), _fd6(-1), _acceptLocal(true), _sinksMutex(),
-          _sinks(), _thread(), _run(false),
-          _sources(&_config.service.keyDirectory, &_sinks)
+        : _config(), _fds(), _fds6(), _acceptLocal(true), _sinksMutex(),
+          _sinks(), _thread(), _run(false), _nacks(), _summaryFilter(),
+          _sources(&_config.service.keyDirectory, &_config.queues.backlog,
+                   &_nacks, &_summaryFilter),
+          _workers(&_sources, &_sinks, &_sinksMutex)
     {
       _stopfds[0] = -1;
       _stopfds[1] = -1;
@@ -67,36 +72,36 @@ namespace Dwm {
     }
 
     //------------------------------------------------------------------------
-    bool MulticastReceiver::BindSocket()
+    bool MulticastReceiver::BindSocket(int fd, const Ipv4Address & group)
     {
       bool  rc = false;
       int   on = 1;
-      if (setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) == 0) {
-        if (setsockopt(_fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) == 0) {
+      if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) == 0) {
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) == 0) {
           sockaddr_in  locAddr;
           memset(&locAddr, 0, sizeof(locAddr));
           locAddr.sin_family = PF_INET;
           locAddr.sin_port = htons(_config.mcast.dstPort);
-          locAddr.sin_addr.s_addr = _config.mcast.groupAddr.Raw();
+          locAddr.sin_addr.s_addr = group.Raw();
 #ifndef __linux__
           locAddr.sin_len = sizeof(locAddr);
 #endif
-          if (::bind(_fd, (sockaddr *)&locAddr, sizeof(locAddr)) == 0) {
+          if (::bind(fd, (sockaddr *)&locAddr, sizeof(locAddr)) == 0) {
             rc = true;
           }
           else {
             MCLOG(Severity::err, "bind({},{},{}) failed: {}",
-                  _fd, locAddr, sizeof(locAddr), strerror(errno));
+                  fd, locAddr, sizeof(locAddr), strerror(errno));
           }
         }
         else {
           MCLOG(Severity::err, "setsockopt({},SOL_SOCKET,SO_REUSEPORT)"
-                " failed: {}", _fd, strerror(errno));
+                " failed: {}", fd, strerror(errno));
         }
       }
       else {
         MCLOG(Severity::err, "setsockopt({},SOL_SOCKET,SO_REUSEADDR)"
-              " failed: {}", _fd, strerror(errno));
+              " failed: {}", fd, strerror(errno));
       }
       return rc;
     }
@@ -104,60 +109,61 @@ namespace Dwm {
     //------------------------------------------------------------------------
     //!  
     //------------------------------------------------------------------------
-    bool MulticastReceiver::BindSocket6()
+    bool MulticastReceiver::BindSocket6(int fd,
+                                        const Ipv6Address & group)
     {
       bool  rc = false;
       int   on = 1;
-      if (setsockopt(_fd6, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) == 0) {
-        if (setsockopt(_fd6, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) == 0) {
+      if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) == 0) {
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) == 0) {
           sockaddr_in6  locAddr;
           memset(&locAddr, 0, sizeof(locAddr));
           locAddr.sin6_family = PF_INET6;
           locAddr.sin6_port = htons(_config.mcast.dstPort);
-          locAddr.sin6_addr = (in6_addr)_config.mcast.groupAddr6;
+          locAddr.sin6_addr = (in6_addr)group;
 #ifndef __linux__
           locAddr.sin6_len = sizeof(locAddr);
 #else
           locAddr.sin6_scope_id = if_nametoindex(_config.mcast.intfName.c_str());
 #endif
-          if (::bind(_fd6, (sockaddr *)&locAddr, sizeof(locAddr)) == 0) {
+          if (::bind(fd, (sockaddr *)&locAddr, sizeof(locAddr)) == 0) {
             rc = true;
           }
           else {
             MCLOG(Severity::err, "bind({},{},{}) failed: {}",
-                  _fd6, locAddr, sizeof(locAddr), strerror(errno));
+                  fd, locAddr, sizeof(locAddr), strerror(errno));
           }
         }
         else {
           MCLOG(Severity::err, "setsockopt({},SOL_SOCKET,SO_REUSEPORT)"
-                " failed: {}", _fd6, strerror(errno));
+                " failed: {}", fd, strerror(errno));
         }
       }
       else {
         MCLOG(Severity::err, "setsockopt({},SOL_SOCKET,SO_REUSEADDR)"
-              " failed: {}", _fd6, strerror(errno));
+              " failed: {}", fd, strerror(errno));
       }
       return rc;
     }
     
     //------------------------------------------------------------------------
-    bool MulticastReceiver::JoinGroup()
+    bool MulticastReceiver::JoinGroup(int fd, const Ipv4Address & group)
     {
-      bool  shouldJoin = ((_config.mcast.groupAddr != Ipv4Address())
+      bool  shouldJoin = ((group != Ipv4Address())
                           && (_config.mcast.intfAddr != Ipv4Address()));
       if (shouldJoin) {
-        struct ip_mreq group;
-        group.imr_multiaddr.s_addr = _config.mcast.groupAddr.Raw();
-        group.imr_interface.s_addr = _config.mcast.intfAddr.Raw();
-        if (setsockopt(_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP,
-                       (char *)&group, sizeof(group)) == 0) {
+        struct ip_mreq  mreq;
+        mreq.imr_multiaddr.s_addr = group.Raw();
+        mreq.imr_interface.s_addr = _config.mcast.intfAddr.Raw();
+        if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP,
+                       (char *)&mreq, sizeof(mreq)) == 0) {
           MCLOG(Severity::info, "Joined group {} on {}",
-                _config.mcast.groupAddr, _config.mcast.intfAddr);
+                group, _config.mcast.intfAddr);
           return true;
         }
         else {
           MCLOG(Severity::err, "setsockopt({},IPPROTO_IP, IP_ADD_MEMBERSHIP,"
-                "{} {}) failed: {}", _fd, _config.mcast.groupAddr,
+                "{} {}) failed: {}", fd, group,
                 _config.mcast.intfAddr, strerror(errno));
           return false;
         }
@@ -166,30 +172,95 @@ namespace Dwm {
     }
 
     //------------------------------------------------------------------------
-    bool MulticastReceiver::JoinGroup6()
+    bool MulticastReceiver::JoinGroup6(int fd, const Ipv6Address & group)
     {
       bool  shouldJoin = ((! _config.mcast.intfName.empty())
-                          && (_config.mcast.groupAddr6 != Ipv6Address()));
+                          && (group != Ipv6Address()));
       bool  rc = false;
       if (shouldJoin) {
-        struct ipv6_mreq  group;
-        group.ipv6mr_multiaddr = _config.mcast.groupAddr6;
-        group.ipv6mr_interface = if_nametoindex(_config.mcast.intfName.c_str());
-        if (setsockopt(_fd6, IPPROTO_IPV6, IPV6_JOIN_GROUP,
-                       (char *)&group, sizeof(group)) == 0) {
+        struct ipv6_mreq  mreq;
+        mreq.ipv6mr_multiaddr = group;
+        mreq.ipv6mr_interface = if_nametoindex(_config.mcast.intfName.c_str());
+        if (setsockopt(fd, IPPROTO_IPV6, IPV6_JOIN_GROUP,
+                       (char *)&mreq, sizeof(mreq)) == 0) {
           rc = true;
           MCLOG(Severity::info, "MulticastReceiver joined {} on interface {}",
-                _config.mcast.groupAddr6, _config.mcast.intfName);
+                group, _config.mcast.intfName);
         }
         else {
           MCLOG(Severity::err, "MulticastReceiver failed to join {} on interface"
-                " {}: {}", _config.mcast.groupAddr6, _config.mcast.intfName,
+                " {}: {}", group, _config.mcast.intfName,
                 strerror(errno));
         }
       }
       return (shouldJoin ? rc : true);
     }
     
+    //------------------------------------------------------------------------
+    //!  Chooses the groups to join: those of each channel whose filter
+    //!  may pass a message that passes our summary filter, and the
+    //!  default groups if some message passing our summary filter may
+    //!  pass none of the channel filters.  A channel group missing for
+    //!  an address family is left out.
+    //------------------------------------------------------------------------
+    void MulticastReceiver::SelectGroups(std::vector<Ipv4Address> & groups,
+                                         std::vector<Ipv6Address> & groups6)
+      const
+    {
+      groups.clear();
+      groups6.clear();
+      std::vector<PacketSummaryFilter>  channelFilters;
+      for (const auto & chan : _config.mcast.channels) {
+        MessageFilterDriver  filter(chan.filter);
+        channelFilters.push_back(PacketSummaryFilter(filter));
+        if (_summaryFilter.Overlaps(channelFilters.back())) {
+          if (chan.groupAddr != Ipv4Address()) {
+            groups.push_back(chan.groupAddr);
+          }
+          if (chan.groupAddr6 != Ipv6Address()) {
+            groups6.push_back(chan.groupAddr6);
+          }
+        }
+        else {
+          MCLOG(Severity::info, "MulticastReceiver skipping channel {}",
+                chan.name);
+        }
+      }
+      if (_summaryFilter.PassesOutside(channelFilters)
+          || (groups.empty() && groups6.empty())) {
+        groups.insert(groups.begin(), _config.mcast.groupAddr);
+        groups6.insert(groups6.begin(), _config.mcast.groupAddr6);
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Returns a socket bound to @c group that has joined it, or -1 on
+    //!  failure.
+    //------------------------------------------------------------------------
+    int MulticastReceiver::OpenGroup(const Ipv4Address & group)
+    {
+      int  fd = socket(PF_INET, SOCK_DGRAM, 0);
+      if (0 <= fd) {
+        if ((! BindSocket(fd, group)) || (! JoinGroup(fd, group))) {
+          ::close(fd);  fd = -1;
+        }
+      }
+      return fd;
+    }
+    
+    //------------------------------------------------------------------------
+    int MulticastReceiver::OpenGroup6(const Ipv6Address & group)
+    {
+      int  fd = socket(PF_INET6, SOCK_DGRAM, 0);
+      if (0 <= fd) {
+        if ((! BindSocket6(fd, group)) || (! JoinGroup6(fd, group))) {
+          ::close(fd);  fd = -1;
+        }
+      }
+      return fd;
+    }
+    
     //------------------------------------------------------------------------
     bool MulticastReceiver::Open(const Config & cfg, bool acceptLocal)
     {
@@ -206,40 +277,33 @@ namespace Dwm {
       if (! (shouldJoin4 || shouldJoin6)) {
         return true;
       }
-      
-      if (shouldJoin4) {
-        if (0 > _fd) {
-          _fd = socket(PF_INET, SOCK_DGRAM, 0);
-          if (0 <= _fd) {
-            if (! BindSocket()) {
-              ::close(_fd);  _fd = -1;
-            }
-            else {
-              if (! JoinGroup()) {
-                ::close(_fd);  _fd = -1;
-              }
-            }
+
+      std::vector<Ipv4Address>  groups;
+      std::vector<Ipv6Address>  groups6;
+      SelectGroups(groups, groups6);
+      if (shouldJoin4 && _fds.empty()) {
+        for (const auto & group : groups) {
+          int  fd = OpenGroup(group);
+          if (0 <= fd) {
+            _fds.push_back(fd);
           }
         }
       }
-      if (shouldJoin6) {
-        if (0 > _fd6) {
-          _fd6 = socket(PF_INET6, SOCK_DGRAM, 0);
-          if (0 <= _fd6) {
-            if (! BindSocket6()) {
-              ::close(_fd6);  _fd6 = -1;
-            }
-            else {
-              if (! JoinGroup6()) {
-                ::close(_fd6);  _fd6 = -1;
-              }
-            }
+      if (shouldJoin6 && _fds6.empty()) {
+        for (const auto & group : groups6) {
+          int  fd = OpenGroup6(group);
+          if (0 <= fd) {
+            _fds6.push_back(fd);
           }
         }
       }
-      if ((shouldJoin4 && (0 <= _fd))
-          || (shouldJoin6 && (0 <= _fd6))) {
+      if ((! _fds.empty()) || (! _fds6.empty())) {
         if (0 == pipe(_stopfds)) {
+          if (! _nacks.Open()) {
+            MCLOG(Severity::warning, "Failed to open NACK sockets, lost"
+                  " packets will not be repaired");
+          }
+          _workers.Start(_config.mcast.ReceiveThreads());
           _run = true;
           _thread = std::thread(&MulticastReceiver::Run, this);
 #if (defined(__FreeBSD__) || defined(__linux__))
@@ -274,12 +338,16 @@ namespace Dwm {
       if (_thread.joinable()) {
         _thread.join();
       }
-      if (0 <= _fd) {
-        ::close(_fd);  _fd = -1;
+      _workers.Stop();
+      _nacks.Close();
+      for (int fd : _fds) {
+        ::close(fd);
       }
-      if (0 <= _fd6) {
-        ::close(_fd6);  _fd6 = -1;
+      _fds.clear();
+      for (int fd : _fds6) {
+        ::close(fd);
       }
+      _fds6.clear();
         
       //  Close the stop command pipe descriptors
       if (_stopfds[1] >= 0) {
@@ -338,19 +406,31 @@ namespace Dwm {
 #if (__APPLE__)
       pthread_setname_np("MulticastReceiver");
 #endif
-      if ((0 <= _fd) || (0 <= _fd6)) {
+      if ((! _fds.empty()) || (! _fds6.empty())) {
         fd_set        fds;
         sockaddr_in   fromAddr;
         sockaddr_in6  fromAddr6;
         int           maxfd;
+        //  Big enough for the largest packet any sender might be
+        //  configured to send.
+        std::vector<char>  buf(MessagePacket::k_maxPacketLen);
         
         auto  reset_fds = [&] () -> void
         {
           FD_ZERO(&fds);
-          if (0 <= _fd)  { FD_SET(_fd, &fds);  }
-          if (0 <= _fd6) { FD_SET(_fd6, &fds); }
+          maxfd = std::max({_nacks.Fd(), _nacks.Fd6(), _stopfds[0]});
+          for (int fd : _fds) {
+            FD_SET(fd, &fds);
+            maxfd = std::max(maxfd, fd);
+          }
+          for (int fd : _fds6) {
+            FD_SET(fd, &fds);
+            maxfd = std::max(maxfd, fd);
+          }
+          if (0 <= _nacks.Fd())  { FD_SET(_nacks.Fd(), &fds);  }
+          if (0 <= _nacks.Fd6()) { FD_SET(_nacks.Fd6(), &fds); }
           FD_SET(_stopfds[0], &fds);
-          maxfd = std::max({_fd, _fd6, _stopfds[0]}) + 1;
+          ++maxfd;
         };
         
         while (_run) {
@@ -359,10 +439,12 @@ namespace Dwm {
             if (FD_ISSET(_stopfds[0], &fds)) {
               break;
             }
-            if ((0 <= _fd) && FD_ISSET(_fd, &fds)) {
-              char  buf[1500];
+            for (int fd : _fds) {
+              if (! FD_ISSET(fd, &fds)) {
+                continue;
+              }
               socklen_t  fromAddrLen = sizeof(fromAddr);
-              ssize_t  recvrc = recvfrom(_fd, buf, sizeof(buf), 0,
+              ssize_t  recvrc = recvfrom(fd, buf.data(), buf.size(), 0,
                                          (sockaddr *)&fromAddr,              
                                          &fromAddrLen);
               Ipv4Address  fromIP(fromAddr.sin_addr.s_addr);
@@ -370,13 +452,15 @@ namespace Dwm {
                 UdpEndpoint  endPoint(fromAddr);
                 MCLOG(Severity::debug, "Received {} bytes from {}",
                       recvrc, endPoint);
-                _sources.ProcessPacket(endPoint, buf, recvrc);
+                _workers.Dispatch(endPoint, buf.data(), recvrc);
               }
             }
-            if ((0 <= _fd6) && FD_ISSET(_fd6, &fds)) {
-              char  buf[1500];
+            for (int fd : _fds6) {
+              if (! FD_ISSET(fd, &fds)) {
+                continue;
+              }
               socklen_t  fromAddrLen = sizeof(fromAddr6);
-              ssize_t  recvrc = recvfrom(_fd6, buf, sizeof(buf), 0,
+              ssize_t  recvrc = recvfrom(fd, buf.data(), buf.size(), 0,
                                          (sockaddr *)&fromAddr6,              
                                          &fromAddrLen);
               Ipv6Address  fromIP(fromAddr6.sin6_addr);
@@ -384,7 +468,27 @@ namespace Dwm {
                 UdpEndpoint  endPoint(fromAddr6);
                 MCLOG(Severity::debug, "Received {} bytes from {}",
                       recvrc, endPoint);
-                _sources.ProcessPacket(endPoint, buf, recvrc);
+                _workers.Dispatch(endPoint, buf.data(), recvrc);
+              }
+            }
+            //  Packets resent in reply to our NACKs.
+            if ((0 <= _nacks.Fd()) && FD_ISSET(_nacks.Fd(), &fds)) {
+              socklen_t  fromAddrLen = sizeof(fromAddr);
+              ssize_t  recvrc = recvfrom(_nacks.Fd(), buf.data(), buf.size(),
+                                         0, (sockaddr *)&fromAddr,
+                                         &fromAddrLen);
+              if (recvrc > 0) {
+                _workers.Dispatch(UdpEndpoint(fromAddr), buf.data(), recvrc);
+              }
+            }
+            if ((0 <= _nacks.Fd6()) && FD_ISSET(_nacks.Fd6(), &fds)) {
+              socklen_t  fromAddrLen = sizeof(fromAddr6);
+              ssize_t  recvrc = recvfrom(_nacks.Fd6(), buf.data(), buf.size(),
+                                         0, (sockaddr *)&fromAddr6,
+                                         &fromAddrLen);
+              if (recvrc > 0) {
+                _workers.Dispatch(UdpEndpoint(fromAddr6), buf.data(),
+                                  recvrc);
               }
             }
           }
@@ -42,6 +42,7 @@ extern "C" {
   #include <net/if.h>
 }
 
+#include <algorithm>
 #include <sstream>
 
 #include "DwmFormatters.hh"
@@ -50,6 +51,7 @@ extern "C" {
 #include "DwmMclogMulticastSender.hh"
 #include "DwmMclogMessagePacket.hh"
 #include "DwmMclogLogger.hh"
+#include "DwmMclogNack.hh"
 
 namespace Dwm {
 
@@ -57,16 +59,16 @@ namespace Dwm {
 
     //------------------------------------------------------------------------
     MulticastSender::MulticastSender()
-        : _fd(-1), _fd6(-1), _run(false), _thread(), _outQueue(), _config(),
-          _dstEndpoint(), _dstEndpoint6(), _key(), _keyRequestListener(),
-          _filterDriver(nullptr)
+        : _channels(), _run(false), _thread(), _drops(), _outQueue(),
+          _config(), _key(), _packetLen(MessagePacket::k_defaultPacketLen),
+          _keyRequestListener(), _compressor(), _compress(false),
+          _filterDriver(nullptr), _pacer(), _sampler()
     {
       Credence::KXKeyPair  key1;
       Credence::KXKeyPair  key2;
       _key = key2.SharedKey(key1.PublicKey().Value());
-      _nextSendTime = Clock::now() + std::chrono::milliseconds(1000);
 
-      _outQueue.MaxLength(1000);
+      _outQueue.Configure(_config.queues.multicast, &_drops);
     }
 
     //------------------------------------------------------------------------
@@ -77,165 +79,256 @@ namespace Dwm {
     }
 
     //------------------------------------------------------------------------
-    bool MulticastSender::OpenSocket()
+    //!  Asks the kernel to space out the packets we send on @c fd at no
+    //!  more than our configured byte rate, where supported (Linux with
+    //!  the fq queueing discipline).  Our TokenBucket enforces the rate
+    //!  either way; this only smooths the packets within a batch.
+    //------------------------------------------------------------------------
+    void MulticastSender::SetPacingRate(int fd) const
     {
-      bool  rc = false;
-      _fd = socket(PF_INET, SOCK_DGRAM, 0);
-      if (0 <= _fd) {
+#ifdef SO_MAX_PACING_RATE
+      uint64_t  byteRate = _config.mcast.pacing.ByteRate();
+      if (0 < byteRate) {
+        uint32_t  rate = std::min<uint64_t>(byteRate, UINT32_MAX);
+        if (setsockopt(fd, SOL_SOCKET, SO_MAX_PACING_RATE,
+                       &rate, sizeof(rate)) != 0) {
+          MCLOG(Severity::info, "setsockopt({},SOL_SOCKET,"
+                "SO_MAX_PACING_RATE,{}) failed: {}", fd, rate,
+                strerror(errno));
+        }
+      }
+#endif
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    int MulticastSender::OpenSocket(uint16_t port)
+    {
+      int  fd = socket(PF_INET, SOCK_DGRAM, 0);
+      if (0 <= fd) {
         sockaddr_in  bindAddr;
         memset(&bindAddr, 0, sizeof(bindAddr));
         bindAddr.sin_family = PF_INET;
         bindAddr.sin_addr.s_addr = _config.mcast.intfAddr.Raw();
-        bindAddr.sin_port = htons(_config.mcast.dstPort);
+        bindAddr.sin_port = htons(port);
 #ifndef __linux__
         bindAddr.sin_len = sizeof(bindAddr);
 #endif
-        if (setsockopt(_fd, IPPROTO_IP, IP_MULTICAST_IF, &bindAddr.sin_addr,
+        if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &bindAddr.sin_addr,
                        sizeof(bindAddr.sin_addr)) == 0) {
           MCLOG(Severity::info, "MulticastSender socket fd {} interface"
-                " set to {}", _fd, bindAddr.sin_addr);
-          if (0 == bind(_fd, (sockaddr *)&bindAddr, sizeof(bindAddr))) {
-            rc = true;
+                " set to {}", fd, bindAddr.sin_addr);
+          if (0 == bind(fd, (sockaddr *)&bindAddr, sizeof(bindAddr))) {
             socklen_t  socklen = sizeof(bindAddr);
-            getsockname(_fd, (sockaddr *)&bindAddr, &socklen);
+            getsockname(fd, (sockaddr *)&bindAddr, &socklen);
             MCLOG(Severity::info, "MulticastSender socket fd {} bound to {}",
-                    _fd, bindAddr);
+                    fd, bindAddr);
+            SetPacingRate(fd);
           }
           else {
             MCLOG(Severity::err, "bind({},{},{}) failed: {}",
-                  _fd, bindAddr, sizeof(bindAddr), strerror(errno));
-            ::close(_fd);  _fd = -1;
+                  fd, bindAddr, sizeof(bindAddr), strerror(errno));
+            ::close(fd);  fd = -1;
           }
         }
         else {
           MCLOG(Severity::err,
                 "setsockopt({},IPPROTO_IP,IP_MULTICAST_IF,{},{}) failed: {}",
-                _fd, bindAddr.sin_addr, sizeof(bindAddr.sin_addr),
+                fd, bindAddr.sin_addr, sizeof(bindAddr.sin_addr),
                 strerror(errno));
-          ::close(_fd);  _fd = -1;
+          ::close(fd);  fd = -1;
         }
       }
       else {
         MCLOG(Severity::err, "socket(PF_INET,SOCK_DGRAM,0) failed: {}",
               strerror(errno));
       }
-      return rc;
+      return fd;
     }
 
     //------------------------------------------------------------------------
-    bool MulticastSender::OpenSocket6()
+    int MulticastSender::OpenSocket6(uint16_t port)
     {
-      bool  rc = false;
       if (_config.mcast.intfName.empty()) {
         MCLOG(Severity::err, "intfName is empty in configuration but"
               " required for IPv6");
-        return false;
+        return -1;
       }
       
-      _fd6 = socket(PF_INET6, SOCK_DGRAM, 0);
-      if (0 <= _fd6) {
+      int  fd6 = socket(PF_INET6, SOCK_DGRAM, 0);
+      if (0 <= fd6) {
         unsigned int  intfIndex =
           if_nametoindex(_config.mcast.intfName.c_str());
         if (0 < intfIndex) {
-          if (setsockopt(_fd6, IPPROTO_IPV6, IPV6_MULTICAST_IF, &intfIndex,
+          if (setsockopt(fd6, IPPROTO_IPV6, IPV6_MULTICAST_IF, &intfIndex,
                        sizeof(intfIndex)) == 0) {
             MCLOG(Severity::info, "MulticastSender socket fd {} interface set"
-                  " to {} ({})", _fd6, intfIndex, _config.mcast.intfName);
+                  " to {} ({})", fd6, intfIndex, _config.mcast.intfName);
             sockaddr_in6  bindAddr;
             memset(&bindAddr, 0, sizeof(bindAddr));
             bindAddr.sin6_family = PF_INET6;
             bindAddr.sin6_addr = _config.mcast.intfAddr6;
-            bindAddr.sin6_port = htons(_config.mcast.dstPort);
+            bindAddr.sin6_port = htons(port);
 #ifndef __linux__
             bindAddr.sin6_len = sizeof(bindAddr);
 #endif
-            if (0 == bind(_fd6, (sockaddr *)&bindAddr, sizeof(bindAddr))) {
-              rc = true;
+            if (0 == bind(fd6, (sockaddr *)&bindAddr, sizeof(bindAddr))) {
               socklen_t  socklen = sizeof(bindAddr);
-              getsockname(_fd6, (sockaddr *)&bindAddr, &socklen);
+              getsockname(fd6, (sockaddr *)&bindAddr, &socklen);
               MCLOG(Severity::info, "MulticastSender socket fd {} bound to {}",
-                    _fd6, bindAddr);
+                    fd6, bindAddr);
+              SetPacingRate(fd6);
             }
             else {
               MCLOG(Severity::err, "bind({},{},{}) failed: {}",
-                    _fd6, bindAddr, sizeof(bindAddr), strerror(errno));
-              ::close(_fd6);  _fd6 = -1;
+                    fd6, bindAddr, sizeof(bindAddr), strerror(errno));
+              ::close(fd6);  fd6 = -1;
             }
           }
           else {
             MCLOG(Severity::err, "setsockopt({},IPPROTO_IPV6,IPV6_MULTICAST_IF,"
-                  "{},{}) failed: {}", _fd6, intfIndex, sizeof(intfIndex),
+                  "{},{}) failed: {}", fd6, intfIndex, sizeof(intfIndex),
                   strerror(errno));
-            ::close(_fd6);  _fd6 = -1;
+            ::close(fd6);  fd6 = -1;
           }
         }
         else {
           MCLOG(Severity::err,
                 "interface index not found for interface '{}': {}",
                 _config.mcast.intfName, strerror(errno));
-          ::close(_fd6);  _fd6 = -1;
+          ::close(fd6);  fd6 = -1;
         }
       }
       else {
         MCLOG(Severity::err, "socket(PF_INET6,SOCK_DGRAM,0) failed: {}",
               strerror(errno));
       }
-      return rc;
+      return fd6;
     }
 
+    //------------------------------------------------------------------------
+    //!  Sets up the default channel and the configured channels.  A
+    //!  channel without a group address for an address family we send
+    //!  on is left out, so its messages go to the default groups.
+    //------------------------------------------------------------------------
+    void MulticastSender::ConfigureChannels()
+    {
+      const MulticastConfig  & mcast = _config.mcast;
+      _channels.clear();
+      _channels.emplace_back();
+      _channels.back().name = "default";
+      _channels.back().dst = UdpEndpoint(mcast.groupAddr, mcast.dstPort);
+      _channels.back().dst6 = UdpEndpoint(mcast.groupAddr6, mcast.dstPort);
+      for (const auto & chanCfg : mcast.channels) {
+        if ((mcast.ShouldSendIpv4() && (chanCfg.groupAddr == Ipv4Address()))
+            || (mcast.ShouldSendIpv6()
+                && (chanCfg.groupAddr6 == Ipv6Address()))) {
+          MCLOG(Severity::err, "Multicast channel {} lacks a group address"
+                " we need, its messages will go to the default groups",
+                chanCfg.name);
+          continue;
+        }
+        Channel  chan;
+        chan.name = chanCfg.name;
+        chan.filter = std::make_unique<MessageFilterDriver>(chanCfg.filter);
+        chan.dst = UdpEndpoint(chanCfg.groupAddr, mcast.dstPort);
+        chan.dst6 = UdpEndpoint(chanCfg.groupAddr6, mcast.dstPort);
+        _channels.push_back(std::move(chan));
+      }
+      return;
+    }
+    
     //------------------------------------------------------------------------
     bool MulticastSender::DesiredSocketsOpen() const
     {
-      bool  v4ok =
-        (_config.mcast.ShouldSendIpv4() ? (0 <= _fd) : (0 > _fd));
-      bool  v6ok =
-        (_config.mcast.ShouldSendIpv6() ? (0 <= _fd6) : (0 > _fd6));
-
-      return (v4ok && v6ok);
+      bool  sendIpv4 = _config.mcast.ShouldSendIpv4();
+      bool  sendIpv6 = _config.mcast.ShouldSendIpv6();
+      return std::all_of(_channels.begin(), _channels.end(),
+                         [&] (const Channel & chan)
+                         { return ((sendIpv4 == (0 <= chan.fd))
+                                   && (sendIpv6 == (0 <= chan.fd6))); });
     }
     
+    //------------------------------------------------------------------------
+    //!  The default channel's sockets are bound to the destination port
+    //!  as always; the sockets of other channels get ephemeral ports.
     //------------------------------------------------------------------------
     bool MulticastSender::Open(const Config & config)
     {
       bool  rc = false;
       _config = config;
-      _dstEndpoint = UdpEndpoint(config.mcast.groupAddr, config.mcast.dstPort);
-      _dstEndpoint6 = UdpEndpoint(config.mcast.groupAddr6, config.mcast.dstPort);
+      _outQueue.Configure(_config.queues.multicast, &_drops);
+      _sampler.Configure(_config.queues.multicast.sampleThreshold,
+                         _config.queues.multicast.capacity);
       if (! config.mcast.outFilter.empty()) {
         _filterDriver = std::make_unique<MessageFilterDriver>(config.mcast.outFilter);
       }
       else {
         _filterDriver = nullptr;
       }
-
+      ConfigureChannels();
+      
       if (! _config.mcast.ShouldRunSender()) {
         return true;
       }
-      
-      if (_config.mcast.ShouldSendIpv4()) {
-        if (0 > _fd) {
-          if (! OpenSocket()) {
-            MCLOG(Severity::err, "Failed to open IPv4 socket");
+
+      std::vector<int>  fds, fds6;
+      for (size_t i = 0; i < _channels.size(); ++i) {
+        Channel   & chan = _channels[i];
+        uint16_t    port = (0 == i) ? _config.mcast.dstPort : 0;
+        if (_config.mcast.ShouldSendIpv4()) {
+          chan.fd = OpenSocket(port);
+          if (0 <= chan.fd) {
+            fds.push_back(chan.fd);
+          }
+          else {
+            MCLOG(Severity::err, "Failed to open IPv4 socket for channel"
+                  " {}", chan.name);
           }
         }
-        else {
-          MCLOG(Severity::err, "Ipv4 socket already open (fd {})", _fd);
+        if (_config.mcast.ShouldSendIpv6()) {
+          chan.fd6 = OpenSocket6(port);
+          if (0 <= chan.fd6) {
+            fds6.push_back(chan.fd6);
+          }
+          else {
+            MCLOG(Severity::err, "Failed to open IPv6 socket for channel"
+                  " {}", chan.name);
+          }
         }
       }
-      if (_config.mcast.ShouldSendIpv6()) {
-        if (0 > _fd6) {
-          if (! OpenSocket6()) {
-            MCLOG(Severity::err, "Failed to open IPv4 socket");
+      if (DesiredSocketsOpen()) {
+        _packetLen = PacketLen();
+        MCLOG(Severity::info, "MulticastSender packet length {}", _packetLen);
+        _pacer.Configure(_config.mcast.pacing, _packetLen);
+        if (_pacer.Enabled()) {
+          MCLOG(Severity::info, "MulticastSender pacing {} packets/s,"
+                " {} bytes/s, burst {}", _config.mcast.pacing.PacketRate(),
+                _config.mcast.pacing.ByteRate(),
+                _config.mcast.pacing.Burst());
+        }
+        for (auto & chan : _channels) {
+          chan.fec.Configure(_config.mcast.fecData, _config.mcast.fecParity);
+          chan.batch = std::make_unique<PacketBatch>(_packetLen);
+          if (chan.filter) {
+            MCLOG(Severity::info, "MulticastSender channel {} to {} {}",
+                  chan.name, chan.dst, chan.dst6);
           }
         }
-        else {
-          MCLOG(Severity::err, "Ipv6 socket already open (fd {})", _fd6);
+        if (_channels.front().fec.Enabled()) {
+          MCLOG(Severity::info, "MulticastSender FEC {} data + {} parity"
+                " packets", _config.mcast.fecData, _config.mcast.fecParity);
         }
-      }
-      if (DesiredSocketsOpen()) {
-        if (_keyRequestListener.Start(_fd, _fd6,
+        _compress = LoadDictionary();
+        auto  nackHandler = [this] (int fd, const UdpEndpoint & src,
+                                    const char *buf, size_t buflen)
+        { HandleNack(fd, src, buf, buflen); };
+        if (_keyRequestListener.Start(fds, fds6,
                                       &_config.service.keyDirectory,
-                                      &_key)) {
+                                      &_key,
+                                      (_compress ? &_compressor.Dictionary()
+                                       : nullptr),
+                                      nackHandler)) {
           _run = true;
           _thread = std::thread(&MulticastSender::Run, this);
 #if (defined(__FreeBSD__) || defined(__linux__))
@@ -269,25 +362,42 @@ namespace Dwm {
       _run = false;
       _outQueue.ConditionSignal();
       if (_thread.joinable()) { _thread.join();   }
-      if (0 <= _fd)           { ::close(_fd);   _fd = -1;  }
-      if (0 <= _fd6)          { ::close(_fd6);  _fd6 = -1; }
+      for (auto & chan : _channels) {
+        if (0 <= chan.fd)  { ::close(chan.fd);   chan.fd = -1;  }
+        if (0 <= chan.fd6) { ::close(chan.fd6);  chan.fd6 = -1; }
+      }
       return;
     }
 
     //------------------------------------------------------------------------
-    bool MulticastSender::PassesFilter(const Message & msg)
+    bool MulticastSender::PassesFilter(MessageFilterDriver *filter,
+                                       const Message & msg)
     {
-      if (nullptr == _filterDriver) {
+      if (nullptr == filter) {
         return true;
       }
       else {
         bool  filterPassed = false;
-        if (_filterDriver->parse(&msg, filterPassed)) {
+        if (filter->parse(&msg, filterPassed)) {
           return filterPassed;
         }
       }
       return false;
     }
+
+    //------------------------------------------------------------------------
+    //!  Returns the first non-default channel whose filter @c msg passes,
+    //!  else the default channel.
+    //------------------------------------------------------------------------
+    MulticastSender::Channel & MulticastSender::ChannelFor(const Message & msg)
+    {
+      for (size_t i = 1; i < _channels.size(); ++i) {
+        if (PassesFilter(_channels[i].filter.get(), msg)) {
+          return _channels[i];
+        }
+      }
+      return _channels.front();
+    }
     
     //------------------------------------------------------------------------
     //!  This function runs in the context of the caller; be aware of
@@ -296,27 +406,312 @@ namespace Dwm {
     //------------------------------------------------------------------------
     bool MulticastSender::Process(const Message & msg)
     {
-      if (PassesFilter(msg)) {
+      if (! _run) {
+        return false;
+      }
+      if (PassesFilter(_filterDriver.get(), msg)) {
+        uint32_t  rate;
+        if (! _sampler.Admit(msg, _outQueue.Length(), rate)) {
+          return false;
+        }
+        if (rate > 1) {
+          return _outQueue.PushBack(AdaptiveSampler::Annotate(msg, rate));
+        }
         return _outQueue.PushBack(msg);
       }
       return false;
     }
     
     //------------------------------------------------------------------------
-    bool MulticastSender::SendPacket(MessagePacket & pkt)
+    //!  Uses the configured packet size if there is one, else the largest
+    //!  packet that fits in the MTU of every interface we send on.
+    //------------------------------------------------------------------------
+    size_t MulticastSender::PacketLen() const
+    {
+      if (0 != _config.mcast.packetSize) {
+        return std::clamp((size_t)_config.mcast.packetSize,
+                          MessagePacket::k_minSendPacketLen,
+                          MessagePacket::k_maxPacketLen);
+      }
+      size_t  rc = MessagePacket::k_maxPacketLen;
+      if (0 <= _channels.front().fd) {
+        size_t  mtu = MessagePacket::InterfaceMtu(_config.mcast.intfAddr);
+        rc = std::min(rc, MessagePacket::PacketLenForMtu(mtu, false));
+      }
+      if (0 <= _channels.front().fd6) {
+        size_t  mtu = MessagePacket::InterfaceMtu(_config.mcast.intfName);
+        rc = std::min(rc, MessagePacket::PacketLenForMtu(mtu, true));
+      }
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Returns true if we should compress payloads, after loading the
+    //!  configured dictionary (if any).
+    //------------------------------------------------------------------------
+    bool MulticastSender::LoadDictionary()
+    {
+      if (_config.mcast.compress != "zstd") {
+        return false;
+      }
+      std::string  dict;
+      if ((! _config.mcast.dictionary.empty())
+          && (! PayloadCompressor::LoadDictionary(_config.mcast.dictionary,
+                                                  dict))) {
+        MCLOG(Severity::err, "Failed to load dictionary {}, multicast"
+              " payloads won't be compressed", _config.mcast.dictionary);
+        return false;
+      }
+      if (! _compressor.Dictionary(dict)) {
+        return false;
+      }
+      MCLOG(Severity::info, "MulticastSender compressing payloads, {} byte"
+            " dictionary", dict.size());
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Applies what every receiver currently supports to @c batch.
+    //------------------------------------------------------------------------
+    void MulticastSender::ConfigureBatch(PacketBatch & batch)
+    {
+      batch.Compressor(_keyRequestListener.MulticastCompression()
+                       ? &_compressor : nullptr);
+      batch.Compact(_keyRequestListener.MulticastMessageBlocks());
+      batch.Summarize(_keyRequestListener.MulticastSummaries());
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    bool MulticastSender::SendBatch(Channel & chan)
+    {
+      PacketBatch  & batch = *chan.batch;
+      size_t  numPackets = batch.NumPackets();
+      size_t  ip4sent = 0, ip6sent = 0;
+      CipherSuite  suite = _keyRequestListener.MulticastCipherSuite();
+      if (suite != chan.nonces.Suite()) {
+        MCLOG(Severity::info, "Multicast cipher suite {} -> {} (channel {})",
+              CipherSuiteName(chan.nonces.Suite()), CipherSuiteName(suite),
+              chan.name);
+        chan.nonces.Suite(suite);
+      }
+      if (batch.Encrypt(_key, chan.nonces)) {
+        //  Encrypt() seals staged (compressed) messages into packets.
+        numPackets = batch.NumPackets();
+        for (size_t i = 0; i < numPackets; ++i) {
+          const MessagePacket  & pkt = batch.Packet(i);
+          chan.retransmits->Add(pkt.Data(), pkt.Length());
+          chan.fec.Add(pkt.Data(), pkt.Length(), chan.parity);
+        }
+        if (0 <= chan.fd)  { ip4sent = batch.SendTo(chan.fd, chan.dst);    }
+        if (0 <= chan.fd6) { ip6sent = batch.SendTo(chan.fd6, chan.dst6);  }
+        size_t  bytes = 0;
+        for (size_t i = 0; i < numPackets; ++i) {
+          bytes += batch.Packet(i).Length();
+        }
+        _pacer.Consume(ip4sent + ip6sent, bytes * Copies(chan));
+        SendParity(chan);
+      }
+      batch.Reset();
+      ConfigureBatch(batch);
+
+      bool  rc = ((0 <= chan.fd) ? (ip4sent == numPackets) : true);
+      rc &= ((0 <= chan.fd6) ? (ip6sent == numPackets) : true);
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Runs in the KeyRequestListener thread.  Resends the packets
+    //!  requested by a NACK from @c src, which arrived on @c fd, from the
+    //!  retransmit ring of the channel that owns @c fd: to @c src
+    //!  alone, or to the group of @c fd's address family when enough
+    //!  receivers have missed the same packet.  Replies go out on @c fd so
+    //!  they come from the same endpoint as the original packets.
+    //------------------------------------------------------------------------
+    void MulticastSender::HandleNack(int fd, const UdpEndpoint & src,
+                                     const char *buf, size_t buflen)
     {
-      ssize_t  ip4rc = -1, ip6rc = -1;
-      if (pkt.Encrypt(_key)) {
-        if (0 <= _fd)  { ip4rc = pkt.SendTo(_fd, _dstEndpoint);   }
-        if (0 <= _fd6) { ip6rc = pkt.SendTo(_fd6, _dstEndpoint6); }
+      Nack  nack;
+      if (! nack.Decode(_key, buf, buflen)) {
+        MCLOG(Severity::debug, "Ignored invalid NACK from {}", src);
+        return;
       }
-      pkt.Reset();
+      auto  chan = std::find_if(_channels.begin(), _channels.end(),
+                                [fd] (const Channel & c)
+                                { return ((fd == c.fd) || (fd == c.fd6)); });
+      if (chan == _channels.end()) {
+        return;
+      }
+      std::vector<RetransmitRing::Retransmit>  repairs;
+      if (chan->retransmits->Repairs(nack, src, repairs)) {
+        const UdpEndpoint  & group = ((fd == chan->fd6) ? chan->dst6
+                                      : chan->dst);
+        for (const auto & repair : repairs) {
+          const UdpEndpoint  & dst = (repair.multicast ? group : src);
+          ssize_t  sendrc = -1;
+          if (dst.Addr().Family() == AF_INET) {
+            sockaddr_in  dstAddr = dst;
+            sendrc = sendto(fd, repair.data.data(), repair.data.size(), 0,
+                            (const sockaddr *)&dstAddr, sizeof(dstAddr));
+          }
+          else {
+            sockaddr_in6  dstAddr = dst;
+            sendrc = sendto(fd, repair.data.data(), repair.data.size(), 0,
+                            (const sockaddr *)&dstAddr, sizeof(dstAddr));
+          }
+          if (sendrc != (ssize_t)repair.data.size()) {
+            MCLOG(Severity::debug, "Failed to resend packet to {}: {}",
+                  dst, strerror(errno));
+          }
+        }
+        MCLOG(Severity::debug, "Resent {} of {} packets NACKed by {}",
+              repairs.size(), nack.NumCounters(), src);
+      }
+      return;
+    }
 
-      bool  rc = ((0 <= _fd) ? (ip4rc > 0) : true);
-      rc &= ((0 <= _fd6) ? (ip6rc > 0) : true);
+    //------------------------------------------------------------------------
+    //!  Sums the counts of our channels' retransmit rings.
+    //------------------------------------------------------------------------
+    RetransmitRing::Counts MulticastSender::HarvestRetransmitCounts()
+    {
+      RetransmitRing::Counts  counts;
+      for (auto & chan : _channels) {
+        counts += chan.retransmits->Harvest();
+      }
+      return counts;
+    }
+    
+    //------------------------------------------------------------------------
+    void MulticastSender::FlushBatch(Channel & chan)
+    {
+      if (chan.batch->HasPayload()) {
+        if (! SendBatch(chan)) {
+          MCLOG(Severity::err, "SendBatch() failed");
+        }
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Sends the parity for a partial FEC block, so the last packets
+    //!  before a lull are protected too.
+    //------------------------------------------------------------------------
+    void MulticastSender::FlushFec(Channel & chan)
+    {
+      if (chan.fec.Flush(chan.parity)) {
+        SendParity(chan);
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void MulticastSender::SendParity(Channel & chan)
+    {
+      auto  sendTo = [] (int fd, const UdpEndpoint & dst,
+                         const std::string & pkt)
+      {
+        ssize_t  sendrc = -1;
+        if (dst.Addr().Family() == AF_INET) {
+          sockaddr_in  dstAddr = dst;
+          sendrc = sendto(fd, pkt.data(), pkt.size(), 0,
+                          (const sockaddr *)&dstAddr, sizeof(dstAddr));
+        }
+        else {
+          sockaddr_in6  dstAddr = dst;
+          sendrc = sendto(fd, pkt.data(), pkt.size(), 0,
+                          (const sockaddr *)&dstAddr, sizeof(dstAddr));
+        }
+        if (sendrc != (ssize_t)pkt.size()) {
+          MCLOG(Severity::debug, "Failed to send parity to {}: {}",
+                dst, strerror(errno));
+        }
+      };
+      
+      for (const auto & pkt : chan.parity) {
+        if (0 <= chan.fd)  { sendTo(chan.fd, chan.dst, pkt);   }
+        if (0 <= chan.fd6) { sendTo(chan.fd6, chan.dst6, pkt); }
+        _pacer.Consume(Copies(chan), pkt.size() * Copies(chan));
+      }
+      chan.parity.clear();
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Returns the earliest time at which a channel's batch is due to be
+    //!  sent, or Clock::time_point::max() if no channel has a batch.
+    //------------------------------------------------------------------------
+    MulticastSender::Clock::time_point MulticastSender::NextSendTime() const
+    {
+      Clock::time_point  rc = Clock::time_point::max();
+      for (const auto & chan : _channels) {
+        if (chan.batch->HasPayload()) {
+          rc = std::min(rc, chan.nextSendTime);
+        }
+      }
       return rc;
     }
+
+    //------------------------------------------------------------------------
+    //!  Returns the number of sockets @c chan sends each packet on.
+    //------------------------------------------------------------------------
+    size_t MulticastSender::Copies(const Channel & chan)
+    {
+      return (((0 <= chan.fd) ? 1 : 0) + ((0 <= chan.fd6) ? 1 : 0));
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Adds @c msg to the batch for @c chan, flushing the batch first if
+    //!  it's full.  A message the empty batch still won't take is
+    //!  counted as a drop.
+    //------------------------------------------------------------------------
+    void MulticastSender::Batch(Channel & chan, const Message & msg)
+    {
+      if (chan.batch->Add(msg)) {
+        return;
+      }
+      FlushBatch(chan);
+      chan.nextSendTime = Clock::now() + _config.mcast.batching.MaxDelay();
+      if (! chan.batch->Add(msg)) {
+        const MessageOrigin  & origin = msg.Header().origin();
+        _drops.Add(msg.Header().severity(),
+                   origin.hostname() + '/' + origin.appname());
+        MCLOG(Severity::warning, "MulticastSender dropped {} byte message"
+              " from {}/{}: batch refused it", msg.StreamedLength(),
+              origin.hostname(), origin.appname());
+      }
+      return;
+    }
     
+    //------------------------------------------------------------------------
+    //!  Called while we're held back by our pacing.  Drops every queued
+    //!  message the pacing policy says to shed, wherever it sits in the
+    //!  queue.  The queue counts the drops, and the messages we keep
+    //!  drain in the same order as before.
+    //------------------------------------------------------------------------
+    void MulticastSender::Shed()
+    {
+      const PacingPolicy  & pacing = _config.mcast.pacing;
+      _outQueue.Shed([&] (Severity severity)
+                     { return pacing.Shed(severity); });
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    bool MulticastSender::FecPending() const
+    {
+      return std::any_of(_channels.begin(), _channels.end(),
+                         [] (const Channel & chan)
+                         { return chan.fec.Pending(); });
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Same batching scheme as LoopbackSender::Run(), using the batching
+    //!  policy from our multicast configuration, with a batch per channel.
+    //!  When FEC is enabled and we've been idle for the maximum batch
+    //!  delay, we send the parity for the partial blocks.  While our
+    //!  pacing holds us back, messages wait in _outQueue (or are shed),
+    //!  so the queue's drain policy decides what goes out first.
     //------------------------------------------------------------------------
     void MulticastSender::Run()
     {
@@ -324,37 +719,71 @@ namespace Dwm {
 #if (__APPLE__)
       pthread_setname_np("MulticastSender");
 #endif
-      char  buf[1200];
-      MessagePacket  pkt(buf, sizeof(buf));
+      for (auto & chan : _channels) {
+        ConfigureBatch(*chan.batch);
+      }
       Message  msg;
+      const BatchPolicy  & batching = _config.mcast.batching;
       while (_run) {
-        if (_outQueue.ConditionTimedWait(std::chrono::seconds(1))) {
-          auto  now = Clock::now();
-          while (_outQueue.PopFront(msg)) {
-            if (! pkt.Add(msg)) {
-              if (! SendPacket(pkt)) {
-                MCLOG(Severity::err, "SendPacket() failed");
+        if (! _pacer.Ready()) {
+          Shed();
+          std::this_thread::sleep_for(std::min(_pacer.Wait(),
+                                               k_maxPaceWait));
+          continue;
+        }
+        if (_outQueue.Empty()) {
+          auto  nextSendTime = NextSendTime();
+          if (nextSendTime != Clock::time_point::max()) {
+            auto  now = Clock::now();
+            if (now < nextSendTime) {
+              _outQueue.ConditionTimedWait(nextSendTime - now);
+            }
+          }
+          else if (FecPending()) {
+            _outQueue.ConditionTimedWait(batching.MaxDelay());
+            if (_outQueue.Empty()) {
+              for (auto & chan : _channels) {
+                FlushFec(chan);
               }
-              _nextSendTime = now + std::chrono::milliseconds(1000);
-              pkt.Add(msg);
             }
           }
+          else {
+            _outQueue.ConditionTimedWait(std::chrono::seconds(1));
+          }
         }
-        else {
-          auto  now = Clock::now();
-          if (pkt.HasPayload()) {
-            if (! SendPacket(pkt)) {
-              MCLOG(Severity::err, "SendPacket() failed");
-            }
-            _nextSendTime = now + std::chrono::milliseconds(1000);
+        while (_pacer.Ready() && _outQueue.PopFront(msg)) {
+          Channel  & chan = ChannelFor(msg);
+          if (! chan.batch->HasPayload()) {
+            chan.nextSendTime = Clock::now() + batching.MaxDelay();
+          }
+          Batch(chan, msg);
+          chan.flushNow |= batching.FlushNow(msg.Header().severity());
+        }
+        auto  now = Clock::now();
+        for (auto & chan : _channels) {
+          if ((chan.flushNow || chan.batch->FullPackets()
+               || (chan.batch->HasPayload() && (now >= chan.nextSendTime)))
+              && _pacer.Ready()) {
+            FlushBatch(chan);
+            chan.flushNow = false;
           }
         }
       }
+      //  Send whatever was queued before we were closed.
+      while (_outQueue.PopFront(msg)) {
+        Batch(ChannelFor(msg), msg);
+      }
+      for (auto & chan : _channels) {
+        //  Staged messages that didn't fit may remain.
+        while (chan.batch->HasPayload()) {
+          FlushBatch(chan);
+        }
+        FlushFec(chan);
+      }
       MCLOG(Severity::info, "MulticastSender thread done");
       return;
     }
     
-    
   }  // namespace Mclog
 
 }  // namespace Dwm
@@ -39,7 +39,8 @@
 
 #include "DwmMclogMessagePacket.hh"
 #include "DwmMclogMulticastSource.hh"
-#include "DwmMclogKeyRequester.hh"
+#include "DwmMclogFec.hh"
+#include "DwmMclogNack.hh"
 
 namespace Dwm {
 
@@ -165,65 +166,104 @@ namespace Dwm {
 
     //------------------------------------------------------------------------
     MulticastSource::MulticastSource()
-        : _endpoint(), _key(), _backlog(), _keyDir(nullptr), _sinks(nullptr),
-          _queryDone(true), _queryThread(), _lastReceiveTime()
+        : _endpoint(), _key(), _keyMtx(), _backlog(),
+          _reassembler(), _replay(), _stats(), _drops(nullptr),
+          _keyRequests(nullptr),
+          _keyCache(nullptr), _queryId(0),
+          _lastReceiveTime(), _nacks(nullptr), _nackPrefix(), _nackFrom(0),
+          _nextNackTime(), _fec(), _decompressor(), _plain(),
+          _summaryFilter(nullptr), _mirrored(false)
     {
-      _backlog.MaxLength(100);   // limit backlog to 100 entries (packets)
+      ConfigureBacklog(QueuesConfig().backlog);
     }
 
     //------------------------------------------------------------------------
     MulticastSource::~MulticastSource()
     {
-      while (! _queryDone) {
-      }
-      if (_queryThread.joinable()) {
-        _queryThread.join();
-      }
+      CancelQuery();
     }
     
     //------------------------------------------------------------------------
     MulticastSource::MulticastSource(const UdpEndpoint & srcEndpoint,
-                                     const std::string *keyDir,
-                                     vector<MessageSink *> *sinks)
-        : _endpoint(srcEndpoint), _key(), _backlog(), _keyDir(keyDir),
-          _sinks(sinks), _queryDone(true), _queryThread(), _lastReceiveTime()
+                                     KeyRequestScheduler *keyRequests,
+                                     MulticastKeyCache *keyCache,
+                                     const QueueConfig *backlogCfg,
+                                     DropCounters *drops,
+                                     NackSender *nacks,
+                                     const PacketSummaryFilter *summaryFilter)
+        : _endpoint(srcEndpoint), _key(), _keyMtx(), _backlog(),
+          _reassembler(), _replay(), _stats(), _drops(drops),
+          _keyRequests(keyRequests),
+          _keyCache(keyCache), _queryId(0),
+          _lastReceiveTime(), _nacks(nacks), _nackPrefix(), _nackFrom(0),
+          _nextNackTime(), _fec(), _decompressor(), _plain(),
+          _summaryFilter(summaryFilter), _mirrored(false)
     {
-      _backlog.MaxLength(100);   // limit backlog to 100 entries (packets)
+      ConfigureBacklog(backlogCfg ? *backlogCfg : QueuesConfig().backlog);
     }
 
     //------------------------------------------------------------------------
     MulticastSource::MulticastSource(const MulticastSource & src)
-        : _endpoint(src._endpoint), _key(src._key), _keyDir(src._keyDir),
-          _sinks(src._sinks), _queryDone(true), _queryThread(),
-          _lastReceiveTime(src._lastReceiveTime)
+        : _endpoint(src._endpoint), _key(src.Key()), _keyMtx(), _backlog(),
+          _reassembler(src._reassembler), _replay(src._replay),
+          _stats(src._stats), _drops(src._drops),
+          _keyRequests(src._keyRequests), _keyCache(src._keyCache),
+          _queryId(0),
+          _lastReceiveTime(src._lastReceiveTime), _nacks(src._nacks),
+          _nackPrefix(src._nackPrefix), _nackFrom(src._nackFrom),
+          _nextNackTime(src._nextNackTime), _fec(src._fec),
+          _decompressor(src._decompressor), _plain(),
+          _summaryFilter(src._summaryFilter), _mirrored(src._mirrored)
     {
+      ConfigureBacklog(src._backlog.Config());
       src._backlog.Copy(_backlog);
-      _backlog.MaxLength(100);   // limit backlog to 100 entries (packets)
     }
     
     //------------------------------------------------------------------------
     MulticastSource::MulticastSource(MulticastSource && src)
-        : _endpoint(std::move(src._endpoint)), _key(src._key),
-          _keyDir(src._keyDir), _sinks(src._sinks), _queryDone(true),
-          _queryThread(), _lastReceiveTime(src._lastReceiveTime)
+        : _endpoint(std::move(src._endpoint)), _key(src.Key()), _keyMtx(),
+          _backlog(),
+          _reassembler(src._reassembler), _replay(src._replay),
+          _stats(src._stats), _drops(src._drops),
+          _keyRequests(src._keyRequests), _keyCache(src._keyCache),
+          _queryId(0),
+          _lastReceiveTime(src._lastReceiveTime), _nacks(src._nacks),
+          _nackPrefix(std::move(src._nackPrefix)), _nackFrom(src._nackFrom),
+          _nextNackTime(src._nextNackTime), _fec(src._fec),
+          _decompressor(src._decompressor), _plain(),
+          _summaryFilter(src._summaryFilter), _mirrored(src._mirrored)
     {
+      //  The outstanding query's callback refers to src, not us.  We'll
+      //  start a new one if we still need a key.
+      src.CancelQuery();
+      ConfigureBacklog(src._backlog.Config());
       _backlog.Swap(src._backlog);
-      _backlog.MaxLength(100);   // limit backlog to 100 entries (packets)      
     }
     
     //------------------------------------------------------------------------
     MulticastSource & MulticastSource::operator = (const MulticastSource & src)
     {
       if (this != &src) {
+        CancelQuery();  // Don't copy the query, and ours is for a stale key
         _endpoint = src._endpoint;
-        _key = src._key;
-        _keyDir = src._keyDir;
-        _sinks = src._sinks;
+        Key(src.Key());
+        _keyRequests = src._keyRequests;
+        _keyCache = src._keyCache;
+        _drops = src._drops;
+        ConfigureBacklog(src._backlog.Config());
         src._backlog.Copy(_backlog);
-        while (! _queryDone) {
-        }
-        _queryDone.store(true);  // Don't copy thread, and our thread is done
+        _reassembler = src._reassembler;
+        _replay = src._replay;
+        _stats = src._stats;
         _lastReceiveTime = src._lastReceiveTime;
+        _nacks = src._nacks;
+        _nackPrefix = src._nackPrefix;
+        _nackFrom = src._nackFrom;
+        _nextNackTime = src._nextNackTime;
+        _fec = src._fec;
+        _decompressor = src._decompressor;
+        _summaryFilter = src._summaryFilter;
+        _mirrored = src._mirrored;
       }
       return *this;
     }
@@ -232,18 +272,28 @@ namespace Dwm {
     MulticastSource & MulticastSource::operator = (MulticastSource && src)
     {
       if (this != &src) {
-        while (! src._queryDone) {
-        }
-        while (! _queryDone) {
-        }
-        _queryDone.store(true);
+        src.CancelQuery();
+        CancelQuery();
         _endpoint = std::move(src._endpoint);
-        _key = src._key;
-        _keyDir = src._keyDir;
-        _sinks = src._sinks;
+        Key(src.Key());
+        _keyRequests = src._keyRequests;
+        _keyCache = src._keyCache;
+        _drops = src._drops;
         _backlog.Clear();
+        ConfigureBacklog(src._backlog.Config());
         src._backlog.Swap(_backlog);
+        _reassembler = src._reassembler;
+        _replay = src._replay;
+        _stats = src._stats;
         _lastReceiveTime = src._lastReceiveTime;
+        _nacks = src._nacks;
+        _nackPrefix = src._nackPrefix;
+        _nackFrom = src._nackFrom;
+        _nextNackTime = src._nextNackTime;
+        _fec = src._fec;
+        _decompressor = src._decompressor;
+        _summaryFilter = src._summaryFilter;
+        _mirrored = src._mirrored;
       }
       return *this;
     }
@@ -251,36 +301,45 @@ namespace Dwm {
     //------------------------------------------------------------------------
     MulticastSourceKey MulticastSource::Key() const
     {
+      std::lock_guard  lck(_keyMtx);
       return _key;
     }
     
     //------------------------------------------------------------------------
     void MulticastSource::Key(const MulticastSourceKey & key)
     {
+      std::lock_guard  lck(_keyMtx);
       _key = key;
       return;
     }
 
     //------------------------------------------------------------------------
-    bool MulticastSource::ProcessBacklog()
+    void MulticastSource::ConfigureBacklog(const QueueConfig & cfg)
+    {
+      //  Nothing but our own thread consumes the backlog, so blocking
+      //  would only stall the receiver.
+      QueueConfig  backlogCfg(cfg);
+      if (OverflowPolicy::block == backlogCfg.overflow) {
+        backlogCfg.overflow = OverflowPolicy::dropNewest;
+      }
+      _backlog.Configure(backlogCfg, _drops, (std::string)_endpoint);
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    bool MulticastSource::ProcessBacklog(vector<Message> & msgs)
     {
       string  mcastKey = Key().Value();
       
       if (! mcastKey.empty()) {
         while (! _backlog.Empty()) {
           BacklogEntry  ble;
-          if (_backlog.PopFront(ble)) {
+          if (_backlog.PopFront(ble)
+              && (! IsCopy(ble.Data(), ble.Datalen()))) {
             MessagePacket  pkt(ble.Data(), ble.Datalen());
             ssize_t  decrc = pkt.Decrypt(ble.Datalen(), mcastKey);
-            if (decrc > 0) {
-              Message  msg;
-              while (msg.Read(pkt.Payload())) {
-                if (nullptr != _sinks) {
-                  for (auto sink : *_sinks) {
-                    sink->Process(msg);
-                  }
-                }
-              }
+            if ((decrc > 0) && (! IsReplay(pkt))) {
+              Reassemble(pkt, msgs);
             }
           }
         }
@@ -302,36 +361,68 @@ namespace Dwm {
         else {
           FSyslog(LOG_DEBUG, "Dropped backlog entry of {} bytes from {}",
                  ble.Datalen(), _endpoint);
+          if (nullptr != _drops) {
+            _drops->Add(Severity::debug, (std::string)_endpoint);
+          }
         }
       }
       return;
     }
 
     //------------------------------------------------------------------------
-    bool MulticastSource::ProcessPacket(char *data, size_t datalen)
+    bool MulticastSource::ProcessPacket(char *data, size_t datalen,
+                                        vector<Message> & msgs, bool mirror)
     {
       bool  rc = false;
 
       _lastReceiveTime = std::chrono::system_clock::now();
       
+      if (FecParityHeader::IsParity(data, datalen)) {
+        ProcessParity(data, datalen, msgs);
+        return true;
+      }
+      if (IsCopy(data, datalen)) {
+        return true;
+      }
+      if (Skip(data, datalen, msgs)) {
+        return true;
+      }
+      
       string  mcastKey = Key().Value();
+      if (mcastKey.empty()) {
+        mcastKey = CachedKey();
+      }
       if (! mcastKey.empty()) {
-        ProcessBacklog();
+        ProcessBacklog(msgs);
 
+        //  Decryption is in place, so keep the ciphertext for the FEC
+        //  decoder.
+        string  raw;
+        if (_fec.Active()) {
+          raw.assign(data, datalen);
+        }
         MessagePacket  pkt(data, datalen);
         ssize_t  decrc = pkt.Decrypt(datalen, mcastKey);
         if (decrc > 0) {
-          Message  msg;
-          while (msg.Read(pkt.Payload())) {
-            rc = true;
-            if (nullptr != _sinks) {
-              for (auto sink : *_sinks) {
-                sink->Process(msg);
+          _mirrored = (_mirrored || mirror);
+          if (! IsReplay(pkt)) {
+            rc = Reassemble(pkt, msgs);
+            if (_fec.Active()) {
+              vector<string>  recovered;
+              if (_fec.AddData(std::move(raw), recovered)) {
+                ProcessRecovered(recovered, mcastKey, msgs);
               }
             }
+            RequestRepairs(pkt, mcastKey);
           }
         }
+        else if (mirror) {
+          DropUnauthenticated(datalen);
+        }
         else {
+          if (nullptr != _keyCache) {
+            _keyCache->Invalidate(_endpoint, mcastKey);
+          }
           Key(MulticastSourceKey(""));
           _backlog.PushBack(BacklogEntry(data, datalen));
           auto  expireTime = (std::chrono::system_clock::now()
@@ -341,6 +432,9 @@ namespace Dwm {
           }
         }
       }
+      else if (mirror) {
+        DropUnauthenticated(datalen);
+      }
       else {
         _backlog.PushBack(BacklogEntry(data, datalen));
         StartQuery();
@@ -351,6 +445,23 @@ namespace Dwm {
       return rc;
     }
 
+    //------------------------------------------------------------------------
+    //!  Drops a packet of @c datalen bytes that came from another endpoint
+    //!  with our sender's nonce prefix, but that we can't decrypt.  The
+    //!  prefix is sent in the clear, so anyone on the group can send such
+    //!  a packet.  Only packets from our own endpoint may reset our key
+    //!  or start a key query.
+    //------------------------------------------------------------------------
+    void MulticastSource::DropUnauthenticated(size_t datalen)
+    {
+      FSyslog(LOG_DEBUG, "Dropped undecryptable {} byte packet routed to {}",
+              datalen, _endpoint);
+      if (nullptr != _drops) {
+        _drops->Add(Severity::debug, (std::string)_endpoint);
+      }
+      return;
+    }
+
     //------------------------------------------------------------------------
     MulticastSource::Clock::time_point
     MulticastSource::LastReceiveTime() const
@@ -359,32 +470,288 @@ namespace Dwm {
     }
     
     //------------------------------------------------------------------------
-    void MulticastSource::StartQuery()
+    SourceStats MulticastSource::HarvestStats()
+    {
+      SourceStats  rc = _stats;
+      _stats = SourceStats();
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    bool MulticastSource::Reassemble(MessagePacket & pkt,
+                                     vector<Message> & msgs)
+    {
+      ++_stats.received;
+      if (pkt.Compressed()) {
+        if (! Decompress(pkt)) {
+          return false;
+        }
+        std::spanstream  sps{std::span{_plain.data(), _plain.size()}};
+        return NextMessages(sps, msgs);
+      }
+      return NextMessages(pkt.Payload(), msgs);
+    }
+
+    //------------------------------------------------------------------------
+    bool MulticastSource::NextMessages(std::istream & is,
+                                       vector<Message> & msgs)
+    {
+      bool  rc = false;
+      int64_t  now = chrono::duration_cast<chrono::microseconds>
+        (Clock::now().time_since_epoch()).count();
+      Message  msg;
+      while (_reassembler.NextMessage(is, _endpoint, msg)) {
+        const Timestamp  & ts = msg.Header().timestamp();
+        int64_t  sent = (ts.Secs() * 1000000) + ts.Usecs();
+        _stats.AddMessage(now - sent);
+        msgs.push_back(std::move(msg));
+        rc = true;
+      }
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Decompresses the payload of @c pkt into _plain.  If it was
+    //!  compressed with a dictionary we don't have, we need a fresh key
+    //!  exchange to get it; the packet is lost.
+    //------------------------------------------------------------------------
+    bool MulticastSource::Decompress(const MessagePacket & pkt)
     {
-      if (_queryDone.load()) {
-        if (_queryThread.joinable()) {
-          _queryThread.join();
+      auto  key = Key();
+      auto  dict = key.Dictionary();
+      if (dict != _decompressor.Dictionary()) {
+        _decompressor.Dictionary(dict);
+      }
+      if (_decompressor.WrongDictionary(pkt.PayloadData(),
+                                        pkt.PayloadLength())) {
+        auto  expireTime = (std::chrono::system_clock::now()
+                            - std::chrono::seconds(5));
+        if (key.LastUpdated() < expireTime) {
+          FSyslog(LOG_INFO, "Need compression dictionary from {}",
+                  _endpoint);
+          StartQuery();
         }
-        _queryDone.store(false);
-        _queryThread = std::thread(&MulticastSource::QueryForKey, this);
+        return false;
+      }
+      if (! _decompressor.Decompress(pkt.PayloadData(), pkt.PayloadLength(),
+                                     _plain)) {
+        FSyslog(LOG_DEBUG, "Failed to decompress packet from {}", _endpoint);
+        return false;
+      }
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    bool MulticastSource::IsReplay(const MessagePacket & pkt)
+    {
+      std::string  prefix;
+      uint64_t     counter;
+      if (pkt.Sequence(prefix, counter)
+          && (! _replay.Accept(prefix, counter, &_stats))) {
+        FSyslog(LOG_DEBUG, "Dropped duplicate or replayed packet {} from {}",
+                counter, _endpoint);
+        return true;
+      }
+      return false;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Returns true if the packet @c data of length @c datalen has a
+    //!  counter we've already accepted, i.e. it's a copy we needn't
+    //!  decrypt.
+    //------------------------------------------------------------------------
+    bool MulticastSource::IsCopy(const char *data, size_t datalen)
+    {
+      CipherSuite  suite;
+      std::string  prefix;
+      uint64_t     counter;
+      if ((datalen >= NonceSequence::k_headerLen)
+          && NonceSequence::Parse((const uint8_t *)data, suite, prefix,
+                                  counter)
+          && _replay.Seen(prefix, counter)) {
+        CountCopy();
+        return true;
+      }
+      return false;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Once the sender's other address family has sent us packets, we
+    //!  expect a copy of every packet, so copies aren't counted as
+    //!  duplicates.  We can't tell which copy of a packet came first.
+    //------------------------------------------------------------------------
+    void MulticastSource::CountCopy()
+    {
+      if (_mirrored) {
+        ++_stats.mirrored;
+      }
+      else {
+        ++_stats.duplicated;
       }
       return;
     }
     
     //------------------------------------------------------------------------
-    void MulticastSource::QueryForKey()
+    //!  Returns true if the packet @c data of length @c datalen carries a
+    //!  PacketSummary that our filter rejects, in which case we only note
+    //!  its counter and hand it to the FEC decoder, where it may help
+    //!  rebuild a packet we want.
+    //------------------------------------------------------------------------
+    bool MulticastSource::Skip(const char *data, size_t datalen,
+                               vector<Message> & msgs)
     {
-      Syslog(LOG_INFO, "MulticastSource::QueryForKey started");
-      
-      KeyRequester  keyRequester(_endpoint, *_keyDir);
-      auto  result = keyRequester.GetKey();
-      
-      Key(result);
-      _queryDone.store(true);
-      Syslog(LOG_INFO, "MulticastSource::QueryForKey done");
+      PacketSummary  summary;
+      if ((nullptr == _summaryFilter) || (! _summaryFilter->Active())
+          || (! MessagePacket::PeekSummary(data, datalen, summary))
+          || _summaryFilter->MayPass(summary)) {
+        return false;
+      }
+      CipherSuite  suite;
+      std::string  prefix;
+      uint64_t     counter;
+      if (NonceSequence::Parse((const uint8_t *)data, suite, prefix,
+                               counter)) {
+        if (_replay.Skipped(prefix, counter)) {
+          CountCopy();
+          return true;
+        }
+        _replay.Skip(prefix, counter);
+      }
+      ++_stats.skipped;
+      string  mcastKey = Key().Value();
+      if (_fec.Active() && (! mcastKey.empty())) {
+        vector<string>  recovered;
+        if (_fec.AddData(string(data, datalen), recovered)) {
+          ProcessRecovered(recovered, mcastKey, msgs);
+        }
+      }
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Parity is useless without the data packets it covers, so we
+    //!  don't backlog it while waiting for a key.
+    //------------------------------------------------------------------------
+    void MulticastSource::ProcessParity(const char *data, size_t datalen,
+                                        vector<Message> & msgs)
+    {
+      string  mcastKey = Key().Value();
+      if (! mcastKey.empty()) {
+        vector<string>  recovered;
+        if (_fec.AddParity(data, datalen, recovered)) {
+          ProcessRecovered(recovered, mcastKey, msgs);
+        }
+      }
       return;
     }
     
+    //------------------------------------------------------------------------
+    //!  A rebuilt packet that fails decryption is simply dropped; it
+    //!  doesn't mean our key is stale.
+    //------------------------------------------------------------------------
+    void MulticastSource::ProcessRecovered(vector<string> & recovered,
+                                           const string & mcastKey,
+                                           vector<Message> & msgs)
+    {
+      for (auto & data : recovered) {
+        MessagePacket  pkt(data.data(), data.size());
+        if (pkt.Decrypt(data.size(), mcastKey) <= 0) {
+          FSyslog(LOG_DEBUG, "Failed to decrypt FEC recovered packet from {}",
+                  _endpoint);
+        }
+        else if (! IsReplay(pkt)) {
+          ++_stats.recovered;
+          Reassemble(pkt, msgs);
+        }
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void MulticastSource::RequestRepairs(const MessagePacket & pkt,
+                                         const std::string & mcastKey)
+    {
+      std::string  prefix;
+      uint64_t     counter;
+      if ((nullptr == _nacks) || (! pkt.Sequence(prefix, counter))) {
+        return;
+      }
+      if (prefix != _nackPrefix) {
+        _nackPrefix = prefix;
+        _nackFrom = 0;
+      }
+      auto  now = Clock::now();
+      if (now < _nextNackTime) {
+        return;
+      }
+      vector<uint64_t>  missing;
+      //  Give FEC a block's worth of packets to repair a loss first.
+      uint64_t  delay = k_nackDelay + _fec.BlockSize();
+      if (_replay.Missing(prefix, _nackFrom, delay, missing)) {
+        Nack  nack(prefix);
+        for (auto c : missing) {
+          if (! nack.Add(c)) {
+            break;
+          }
+          _nackFrom = c + 1;
+        }
+        string  datagram;
+        if (nack.Encode(mcastKey, datagram)
+            && _nacks->Send(_endpoint, datagram)) {
+          _stats.nacked += nack.NumCounters();
+          FSyslog(LOG_DEBUG, "Sent NACK for {} packets to {}",
+                  nack.NumCounters(), _endpoint);
+        }
+        _nextNackTime = now + k_nackInterval;
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    std::string MulticastSource::CachedKey()
+    {
+      MulticastSourceKey  key;
+      if ((nullptr != _keyCache) && _keyCache->Get(_endpoint, key)) {
+        FSyslog(LOG_INFO, "Using cached key for {}", _endpoint);
+        Key(key);
+        return key.Value();
+      }
+      return std::string();
+    }
+    
+    //------------------------------------------------------------------------
+    void MulticastSource::StartQuery()
+    {
+      if ((nullptr != _keyRequests) && (0 == _queryId.load())) {
+        //  The callback may run before Request() returns, so mark the
+        //  query as pending and only record its ID if it's still pending.
+        uint64_t  pending = ~0ULL;
+        _queryId.store(pending);
+        uint64_t  queryId =
+          _keyRequests->Request(_endpoint,
+                                [this] (const MulticastSourceKey & key)
+                                {
+                                  Key(key);
+                                  if ((nullptr != _keyCache)
+                                      && (! key.Value().empty())) {
+                                    _keyCache->Put(_endpoint, key);
+                                  }
+                                  _queryId.store(0);
+                                });
+        _queryId.compare_exchange_strong(pending, queryId);
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void MulticastSource::CancelQuery()
+    {
+      uint64_t  queryId = _queryId.exchange(0);
+      if ((nullptr != _keyRequests) && (0 != queryId)) {
+        _keyRequests->Cancel(queryId);
+      }
+      return;
+    }
 
   }  // namespace Mclog
 
@@ -47,7 +47,8 @@ namespace Dwm {
     //!  
     //------------------------------------------------------------------------
     MulticastSourceKey::MulticastSourceKey()
-        : _mtx(), _value(), _lastRequested(), _lastQueried(), _lastUpdated()
+        : _mtx(), _value(), _lastRequested(), _lastQueried(), _lastUpdated(),
+          _dictionary()
     {}
     
     //------------------------------------------------------------------------
@@ -57,18 +58,27 @@ namespace Dwm {
 
     //------------------------------------------------------------------------
     MulticastSourceKey::MulticastSourceKey(const MulticastSourceKey & key)
-        : _mtx(), _value(key._value)
-    {}
+        : _mtx()
+    {
+      std::lock_guard  lck(key._mtx);
+      _value = key._value;
+      _lastRequested = key._lastRequested;
+      _lastQueried = key._lastQueried;
+      _lastUpdated = key._lastUpdated;
+      _dictionary = key._dictionary;
+    }
 
     //------------------------------------------------------------------------
     MulticastSourceKey &
     MulticastSourceKey::operator = (const MulticastSourceKey & key)
     {
       if (&key != this) {
+        std::scoped_lock  lck(_mtx, key._mtx);
         _value = key._value;
         _lastRequested = key._lastRequested;
         _lastQueried = key._lastQueried;
         _lastUpdated = key._lastUpdated;
+        _dictionary = key._dictionary;
       }
       return *this;
     }
@@ -135,6 +145,22 @@ namespace Dwm {
       _lastUpdated = lastUpdated;
       return;
     }
+
+    //------------------------------------------------------------------------
+    std::shared_ptr<const std::string> MulticastSourceKey::Dictionary() const
+    {
+      std::lock_guard  lck(_mtx);
+      return _dictionary;
+    }
+    
+    //------------------------------------------------------------------------
+    void
+    MulticastSourceKey::Dictionary(std::shared_ptr<const std::string> dict)
+    {
+      std::lock_guard  lck(_mtx);
+      _dictionary = std::move(dict);
+      return;
+    }
     
   }  // namespace Mclog
 
@@ -37,58 +37,261 @@
 //!  @brief Dwm::Mclog::MulticastSources implementation
 //---------------------------------------------------------------------------
 
+#include <algorithm>
+#include <functional>
+
+#include "DwmMclogCipherSuite.hh"
+#include "DwmMclogFec.hh"
 #include "DwmMclogMulticastSources.hh"
 
 namespace Dwm {
 
   namespace Mclog {
 
+    namespace {
+
+      //----------------------------------------------------------------------
+      //!  Sets @c prefix to the nonce prefix of the data or parity packet
+      //!  @c data of length @c datalen.  Returns false if it has none,
+      //!  i.e. it's from a sender too old to have one.
+      //----------------------------------------------------------------------
+      bool SenderPrefix(const char *data, size_t datalen,
+                        std::string & prefix)
+      {
+        if (FecParityHeader::IsParity(data, datalen)) {
+          FecParityHeader  hdr;
+          if (hdr.Parse(data, datalen)) {
+            prefix = std::move(hdr.prefix);
+            return true;
+          }
+          return false;
+        }
+        CipherSuite  suite;
+        uint64_t     counter;
+        return ((datalen >= NonceSequence::k_headerLen)
+                && NonceSequence::Parse((const uint8_t *)data, suite,
+                                        prefix, counter));
+      }
+      
+    }  // anonymous namespace
+
     //------------------------------------------------------------------------
     MulticastSources::MulticastSources()
-        : _sources(), _sinks(nullptr)
-    {}
+        : _keyCache(nullptr), _keyRequests(nullptr), _shards(),
+          _numSources(0), _keyDir(nullptr), _backlogCfg(nullptr),
+          _backlogDrops(), _nacks(nullptr), _summaryFilter(nullptr),
+          _sendersMtx(), _senders()
+    {
+      Shards(1);
+    }
     
     //------------------------------------------------------------------------
     MulticastSources::MulticastSources(const std::string *keyDir,
-                                       std::vector<MessageSink *> *sinks)
-        : _keyDir(keyDir), _sources(), _sinks(sinks)
-    {}
+                                       const QueueConfig *backlogCfg,
+                                       NackSender *nacks,
+                                       const PacketSummaryFilter *filter)
+        : _keyCache(keyDir), _keyRequests(keyDir), _shards(),
+          _numSources(0), _keyDir(keyDir), _backlogCfg(backlogCfg),
+          _backlogDrops(), _nacks(nacks), _summaryFilter(filter),
+          _sendersMtx(), _senders()
+    {
+      Shards(1);
+    }
 
+    //------------------------------------------------------------------------
+    void MulticastSources::Shards(size_t numShards)
+    {
+      numShards = std::max(numShards, (size_t)1);
+      if (numShards == _shards.size()) {
+        return;
+      }
+      std::vector<std::unique_ptr<SourceShard>>  oldShards;
+      oldShards.swap(_shards);
+      for (size_t i = 0; i < numShards; ++i) {
+        _shards.push_back(std::make_unique<SourceShard>());
+      }
+      //  Move the hash table nodes, not the sources, so outstanding key
+      //  requests remain valid.
+      for (auto & oldShard : oldShards) {
+        std::lock_guard  lck(oldShard->mtx);
+        while (! oldShard->sources.empty()) {
+          auto  node = oldShard->sources.extract(oldShard->sources.begin());
+          SourceShard  & shard = *(_shards[Shard(node.key())]);
+          shard.expiry.Schedule(node.key(), (node.mapped().LastReceiveTime()
+                                             + k_sourceTimeout));
+          shard.sources.insert(std::move(node));
+        }
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    size_t MulticastSources::Shard(const UdpEndpoint & src) const
+    {
+      if (_shards.size() < 2) {
+        return 0;
+      }
+      return (src.Hash() % _shards.size());
+    }
+    
+    //------------------------------------------------------------------------
+    size_t MulticastSources::Shard(const UdpEndpoint & src, const char *data,
+                                   size_t datalen)
+    {
+      if (_shards.size() < 2) {
+        return 0;
+      }
+      std::string  prefix;
+      UdpEndpoint  endpoint(src);
+      if (SenderPrefix(data, datalen, prefix)) {
+        FindSender(prefix, endpoint);
+      }
+      return Shard(endpoint);
+    }
+    
     //------------------------------------------------------------------------
     void MulticastSources::ProcessPacket(const UdpEndpoint & srcEndpoint,
-                                         char *data, size_t datalen)
+                                         char *data, size_t datalen,
+                                         std::vector<Message> & msgs)
     {
-      auto  it = _sources.find(srcEndpoint);
-      if (it != _sources.end()) {
+      //  Packets from another endpoint of a sender we know go to the
+      //  source that authenticated its prefix.  The prefix is in the
+      //  clear, so the source drops such a packet if it fails to
+      //  decrypt.
+      std::string  prefix;
+      UdpEndpoint  endpoint(srcEndpoint);
+      bool  known = (SenderPrefix(data, datalen, prefix)
+                     && FindSender(prefix, endpoint));
+      bool  mirror = (endpoint != srcEndpoint);
+      
+      SourceShard  & shard = *(_shards[Shard(endpoint)]);
+      std::lock_guard  lck(shard.mtx);
+      auto  [it, inserted] =
+        shard.sources.try_emplace(endpoint, endpoint, &_keyRequests,
+                                  &_keyCache, _backlogCfg, &_backlogDrops,
+                                  _nacks, _summaryFilter);
+      if (! inserted) {
         FSyslog(LOG_DEBUG, "Processing packet from {}", srcEndpoint);
-        it->second.ProcessPacket(data, datalen);
       }
-      else {
-        auto [nit, dontCare] =
-          _sources.insert({srcEndpoint,MulticastSource(srcEndpoint,_keyDir,_sinks)});
-        nit->second.ProcessPacket(data, datalen);
-        ClearOld();
-        FSyslog(LOG_INFO, "{} active multicast sources", _sources.size());
+      it->second.ProcessPacket(data, datalen, msgs, mirror);
+      if ((! known) && (! prefix.empty())
+          && it->second.Replay().Tracks(prefix)) {
+        AddSender(prefix, endpoint);
       }
+      auto  now = it->second.LastReceiveTime();
+      if (inserted) {
+        //  Each source has exactly one entry in the wheel, which is only
+        //  consumed by ClearOld().
+        shard.expiry.Schedule(endpoint, now + k_sourceTimeout);
+        ++_numSources;
+        FSyslog(LOG_INFO, "{} active multicast sources", _numSources.load());
+      }
+      ClearOld(shard, now);
       return;
     }
 
     //------------------------------------------------------------------------
-    void MulticastSources::ClearOld()
+    MulticastSources::StatsVector MulticastSources::HarvestStats()
     {
-      auto  expireTime = (std::chrono::system_clock::now()
-                          - std::chrono::seconds(20));
-      
-      std::erase_if(_sources,
-                    [&] (const auto & src)
-                    {
-                      if (src.second.LastReceiveTime() < expireTime) {
-                        FSyslog(LOG_INFO, "MulticastSource {} expired",
-                                src.first);
-                        return true;
-                      }
-                      return false;
-                    });
+      StatsVector  rc;
+      for (auto & shard : _shards) {
+        std::lock_guard  lck(shard->mtx);
+        for (auto & retired : shard->retired) {
+          rc.push_back(std::move(retired));
+        }
+        shard->retired.clear();
+        for (auto & [endpoint, source] : shard->sources) {
+          SourceStats  stats = source.HarvestStats();
+          if (! stats.Empty()) {
+            rc.push_back({endpoint, stats});
+          }
+        }
+      }
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  If we know the sender using @c prefix, sets @c endpoint to the
+    //!  endpoint of its source and returns true.
+    //------------------------------------------------------------------------
+    bool MulticastSources::FindSender(const std::string & prefix,
+                                      UdpEndpoint & endpoint)
+    {
+      std::shared_lock  lck(_sendersMtx);
+      auto  it = _senders.find(prefix);
+      if (it != _senders.end()) {
+        endpoint = it->second;
+        return true;
+      }
+      return false;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Notes that the source at @c endpoint authenticated a packet with
+    //!  @c prefix.  If another endpoint of the same sender got there
+    //!  first, it keeps the prefix.
+    //------------------------------------------------------------------------
+    void MulticastSources::AddSender(const std::string & prefix,
+                                     const UdpEndpoint & endpoint)
+    {
+      std::unique_lock  lck(_sendersMtx);
+      _senders.try_emplace(prefix, endpoint);
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Forgets the prefixes of @c source at @c endpoint, which is
+    //!  expiring.  A prefix the source already dropped from its
+    //!  ReplayWindow is left behind, but that takes a sender changing
+    //!  prefix more than ReplayWindow::k_maxPrefixes times on one
+    //!  endpoint without going quiet for k_sourceTimeout.
+    //------------------------------------------------------------------------
+    void MulticastSources::RemoveSender(const UdpEndpoint & endpoint,
+                                        const MulticastSource & source)
+    {
+      std::unique_lock  lck(_sendersMtx);
+      for (const auto & prefix : source.Replay().Prefixes()) {
+        auto  it = _senders.find(prefix);
+        if ((it != _senders.end()) && (it->second == endpoint)) {
+          _senders.erase(it);
+        }
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void MulticastSources::ClearOld(SourceShard & shard,
+                                    MulticastSource::Clock::time_point now)
+    {
+      shard.expired.clear();
+      if (0 == shard.expiry.Expire(now, shard.expired)) {
+        return;
+      }
+      size_t  numErased = 0;
+      for (const auto & endpoint : shard.expired) {
+        auto  it = shard.sources.find(endpoint);
+        if (it != shard.sources.end()) {
+          auto  expireTime = it->second.LastReceiveTime() + k_sourceTimeout;
+          if (expireTime <= now) {
+            SourceStats  stats = it->second.HarvestStats();
+            if ((! stats.Empty())
+                && (shard.retired.size() < k_maxRetiredStats)) {
+              shard.retired.push_back({endpoint, stats});
+            }
+            RemoveSender(endpoint, it->second);
+            shard.sources.erase(it);
+            ++numErased;
+          }
+          else {
+            shard.expiry.Schedule(endpoint, expireTime);
+          }
+        }
+      }
+      if (numErased) {
+        _numSources -= numErased;
+        FSyslog(LOG_INFO, "{} multicast sources expired, {} active",
+                numErased, _numSources.load());
+      }
       return;
     }
     
@@ -0,0 +1,204 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogNack.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::Nack class implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sodium.h>
+}
+
+#include <algorithm>
+
+#include "DwmMclogCipherSuite.hh"
+#include "DwmMclogNack.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    namespace {
+
+      constexpr size_t  k_counterLen = NonceSequence::k_counterLen;
+      constexpr size_t  k_rangeLen = k_counterLen + 2;
+      constexpr size_t  k_headerLen =
+        Nack::k_tag.size() + NonceSequence::k_prefixLen + 1;
+      constexpr std::string_view  k_macContext{"mclog NACK"};
+      
+      //----------------------------------------------------------------------
+      void PutUint(std::string & s, uint64_t val, size_t len)
+      {
+        for (size_t i = len; i > 0; --i) {
+          s.push_back((char)((val >> ((i - 1) * 8)) & 0xFF));
+        }
+        return;
+      }
+
+      //----------------------------------------------------------------------
+      uint64_t GetUint(const uint8_t *p, size_t len)
+      {
+        uint64_t  val = 0;
+        for (size_t i = 0; i < len; ++i) {
+          val = (val << 8) | p[i];
+        }
+        return val;
+      }
+      
+    }  // anonymous namespace
+    
+    //------------------------------------------------------------------------
+    Nack::Nack()
+        : _prefix(), _ranges()
+    {}
+
+    //------------------------------------------------------------------------
+    Nack::Nack(const std::string & prefix)
+        : _prefix(prefix), _ranges()
+    {}
+
+    //------------------------------------------------------------------------
+    bool Nack::Add(uint64_t counter)
+    {
+      if (! _ranges.empty()) {
+        Range  & last = _ranges.back();
+        if ((counter == (last.first + last.count)) && (last.count < 0xFFFF)) {
+          ++last.count;
+          return true;
+        }
+      }
+      if (_ranges.size() < k_maxRanges) {
+        _ranges.push_back(Range{counter, 1});
+        return true;
+      }
+      return false;
+    }
+
+    //------------------------------------------------------------------------
+    size_t Nack::NumCounters() const
+    {
+      size_t  rc = 0;
+      for (const auto & range : _ranges) {
+        rc += range.count;
+      }
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    bool Nack::Encode(const std::string & mcastKey,
+                      std::string & datagram) const
+    {
+      std::string  macKey;
+      if ((_prefix.size() != NonceSequence::k_prefixLen)
+          || _ranges.empty() || (_ranges.size() > k_maxRanges)
+          || (! MacKey(mcastKey, macKey))) {
+        return false;
+      }
+      datagram.assign(k_tag);
+      datagram += _prefix;
+      datagram.push_back((char)_ranges.size());
+      for (const auto & range : _ranges) {
+        PutUint(datagram, range.first, k_counterLen);
+        PutUint(datagram, range.count, 2);
+      }
+      unsigned char  mac[crypto_auth_BYTES];
+      crypto_auth(mac, (const unsigned char *)datagram.data(),
+                  datagram.size(), (const unsigned char *)macKey.data());
+      datagram.append((const char *)mac, sizeof(mac));
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    bool Nack::Decode(const std::string & mcastKey, const char *buf,
+                      size_t buflen)
+    {
+      _prefix.clear();
+      _ranges.clear();
+      if ((! IsNack(buf, buflen)) || (buflen < k_headerLen)) {
+        return false;
+      }
+      const uint8_t  *p = (const uint8_t *)buf;
+      size_t  numRanges = p[k_headerLen - 1];
+      size_t  dataLen = k_headerLen + (numRanges * k_rangeLen);
+      if ((0 == numRanges) || (numRanges > k_maxRanges)
+          || (buflen != (dataLen + crypto_auth_BYTES))) {
+        return false;
+      }
+      std::string  macKey;
+      if ((! MacKey(mcastKey, macKey))
+          || (0 != crypto_auth_verify(p + dataLen, p, dataLen,
+                                      (const unsigned char *)macKey.data()))) {
+        return false;
+      }
+      _prefix.assign(buf + k_tag.size(), NonceSequence::k_prefixLen);
+      for (p += k_headerLen; numRanges > 0; --numRanges, p += k_rangeLen) {
+        Range  range{GetUint(p, k_counterLen),
+                     (uint16_t)GetUint(p + k_counterLen, 2)};
+        if (range.count) {
+          _ranges.push_back(range);
+        }
+      }
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    bool Nack::IsNack(const char *buf, size_t buflen)
+    {
+      return ((buflen >= k_tag.size())
+              && std::equal(k_tag.begin(), k_tag.end(), buf));
+    }
+
+    //------------------------------------------------------------------------
+    //!  Derives the MAC key from the multicast key, so we don't use the
+    //!  same key with two different primitives.
+    //------------------------------------------------------------------------
+    bool Nack::MacKey(const std::string & mcastKey, std::string & macKey)
+    {
+      if ((mcastKey.size() < crypto_generichash_KEYBYTES_MIN)
+          || (mcastKey.size() > crypto_generichash_KEYBYTES_MAX)) {
+        return false;
+      }
+      const unsigned char  *ctx = (const unsigned char *)k_macContext.data();
+      macKey.resize(crypto_auth_KEYBYTES);
+      return (0 == crypto_generichash((unsigned char *)macKey.data(),
+                                      macKey.size(),
+                                      ctx, k_macContext.size(),
+                                      (const unsigned char *)mcastKey.data(),
+                                      mcastKey.size()));
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
@@ -0,0 +1,131 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogNackSender.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::NackSender class implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/types.h>
+  #include <sys/socket.h>
+  #include <netinet/in.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+}
+
+#include <cerrno>
+#include <cstring>
+
+#include "DwmFormatters.hh"
+#include "DwmSysLogger.hh"
+#include "DwmMclogNackSender.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    NackSender::NackSender()
+        : _fd(-1), _fd6(-1)
+    {}
+
+    //------------------------------------------------------------------------
+    NackSender::~NackSender()
+    {
+      Close();
+    }
+
+    //------------------------------------------------------------------------
+    bool NackSender::Open()
+    {
+      if (0 > _fd) {
+        _fd = socket(PF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (0 <= _fd) {
+          fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) | O_NONBLOCK);
+        }
+        else {
+          FSyslog(LOG_ERR, "Failed to open IPv4 NACK socket: {}",
+                  strerror(errno));
+        }
+      }
+      if (0 > _fd6) {
+        _fd6 = socket(PF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+        if (0 <= _fd6) {
+          fcntl(_fd6, F_SETFL, fcntl(_fd6, F_GETFL) | O_NONBLOCK);
+        }
+        else {
+          FSyslog(LOG_ERR, "Failed to open IPv6 NACK socket: {}",
+                  strerror(errno));
+        }
+      }
+      return ((0 <= _fd) || (0 <= _fd6));
+    }
+
+    //------------------------------------------------------------------------
+    void NackSender::Close()
+    {
+      if (0 <= _fd)   { ::close(_fd);   _fd = -1; }
+      if (0 <= _fd6)  { ::close(_fd6);  _fd6 = -1; }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    bool NackSender::Send(const UdpEndpoint & dst,
+                          const std::string & datagram)
+    {
+      ssize_t  sendrc = -1;
+      if (dst.Addr().Family() == AF_INET) {
+        if (0 <= _fd) {
+          sockaddr_in  dstAddr = dst;
+          sendrc = sendto(_fd, datagram.data(), datagram.size(), 0,
+                          (const sockaddr *)&dstAddr, sizeof(dstAddr));
+        }
+      }
+      else if (0 <= _fd6) {
+        sockaddr_in6  dstAddr = dst;
+        sendrc = sendto(_fd6, datagram.data(), datagram.size(), 0,
+                        (const sockaddr *)&dstAddr, sizeof(dstAddr));
+      }
+      if (sendrc != (ssize_t)datagram.size()) {
+        FSyslog(LOG_DEBUG, "Failed to send NACK to {}: {}", dst,
+                strerror(errno));
+        return false;
+      }
+      return true;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
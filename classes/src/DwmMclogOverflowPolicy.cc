@@ -0,0 +1,87 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogOverflowPolicy.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::OverflowPolicy implementation
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include "DwmMclogOverflowPolicy.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    using namespace std;
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    static constexpr array<pair<OverflowPolicy,const char *>,4>
+    g_overflowPolicyNames = {
+      make_pair(OverflowPolicy::block,              "block"),
+      make_pair(OverflowPolicy::dropNewest,         "dropNewest"),
+      make_pair(OverflowPolicy::dropOldest,         "dropOldest"),
+      make_pair(OverflowPolicy::dropLowestSeverity, "dropLowestSeverity")
+    };
+    
+    //------------------------------------------------------------------------
+    std::string OverflowPolicyName(OverflowPolicy policy)
+    {
+      if (auto it = ranges::find(g_overflowPolicyNames, policy,
+                                 &pair<OverflowPolicy,const char *>::first);
+          it != g_overflowPolicyNames.end()) {
+        return std::string(it->second);
+      }
+      return std::string();
+    }
+
+    //------------------------------------------------------------------------
+    OverflowPolicy OverflowPolicyValue(const std::string & name)
+    {
+      if (auto it = ranges::find(g_overflowPolicyNames, name,
+                                 &pair<OverflowPolicy,const char *>::second);
+          it != g_overflowPolicyNames.end()) {
+        return it->first;
+      }
+      return OverflowPolicy::dropNewest;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
@@ -0,0 +1,515 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogPacketBatch.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::PacketBatch class implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/socket.h>
+  #include <netinet/in.h>
+}
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <random>
+
+#include "DwmFormatters.hh"
+#include "DwmSysLogger.hh"
+#include "DwmMclogMessageFragment.hh"
+#include "DwmMclogPacketBatch.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    namespace {
+
+      //----------------------------------------------------------------------
+      PacketSummary MessageSummary(const Message & msg)
+      {
+        PacketSummary  rc;
+        rc.Add(msg.Header().facility(), msg.Header().severity());
+        return rc;
+      }
+      
+    }  // anonymous namespace
+    
+    //------------------------------------------------------------------------
+    PacketBatch::PacketBatch(size_t packetLen)
+        : _packetLen(std::clamp(packetLen, MessagePacket::k_minSendPacketLen,
+                                MessagePacket::k_maxPacketLen)),
+          _storage(), _packets(), _current(0),
+          _nextFragmentId(std::random_device()()), _iovs(),
+          _compressor(nullptr), _compact(false), _block(), _staged(),
+          _raw(), _rawEnds(), _rawSummaries(), _fitLen(0), _fitData(),
+          _trialLen(0), _scratch()
+    {
+      size_t  numPackets = std::clamp(k_maxBatchBytes / _packetLen,
+                                      (size_t)1, k_maxPackets);
+      _storage.resize(numPackets * _packetLen);
+      for (size_t i = 0; i < numPackets; ++i) {
+        _packets.emplace_back(_storage.data() + (i * _packetLen),
+                              _packetLen);
+      }
+      _iovs.resize(numPackets);
+#if (defined(__FreeBSD__) || defined(__linux__))
+      _mmsgs.resize(numPackets);
+#endif
+    }
+
+    //------------------------------------------------------------------------
+    bool PacketBatch::Add(const Message & msg)
+    {
+      if ((nullptr != _compressor) || _compact) {
+        return Stage(msg);
+      }
+      if (Add<Message>(msg)) {
+        _packets[_current].Summary() |= MessageSummary(msg);
+        return true;
+      }
+      if (msg.StreamedLength() > _packets[_current].PayloadCapacity()) {
+        return AddFragments(msg);
+      }
+      return false;
+    }
+
+    //------------------------------------------------------------------------
+    bool PacketBatch::Compressor(PayloadCompressor *compressor)
+    {
+      if (HasPayload()) {
+        return false;
+      }
+      _compressor = compressor;
+      RestartFit();
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    bool PacketBatch::Summarize(bool summarize)
+    {
+      if (HasPayload()) {
+        return false;
+      }
+      for (auto & pkt : _packets) {
+        pkt.Summarize(summarize);
+      }
+      RestartFit();
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    bool PacketBatch::Compact(bool compact)
+    {
+      if (HasPayload()) {
+        return false;
+      }
+      _compact = compact;
+      _block.Clear();
+      RestartFit();
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    bool PacketBatch::Encrypt(const std::string & secretKey,
+                              NonceSequence & nonces)
+    {
+      if (! _raw.empty()) {
+        //  Whatever doesn't fit stays staged for the next batch.
+        SealStaged();
+      }
+      size_t  numPackets = NumPackets();
+      for (size_t i = 0; i < numPackets; ++i) {
+        if (! _packets[i].Encrypt(secretKey, nonces)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    size_t PacketBatch::SendTo(int fd, const UdpEndpoint & dst)
+    {
+      if (! _raw.empty()) {
+        SealStaged();
+      }
+      size_t            numPackets = NumPackets();
+      sockaddr_storage  dstSock;
+      socklen_t         dstLen;
+      memset(&dstSock, 0, sizeof(dstSock));
+      if (dst.Addr().Family() == PF_INET) {
+        sockaddr_in  sa = dst;
+        memcpy(&dstSock, &sa, sizeof(sa));
+        dstLen = sizeof(sa);
+      }
+      else {
+        sockaddr_in6  sa = dst;
+        memcpy(&dstSock, &sa, sizeof(sa));
+        dstLen = sizeof(sa);
+      }
+      for (size_t i = 0; i < numPackets; ++i) {
+        _iovs[i].iov_base = (void *)_packets[i].Data();
+        _iovs[i].iov_len = _packets[i].Length();
+      }
+      
+      size_t  sent = 0;
+#if (defined(__FreeBSD__) || defined(__linux__))
+      for (size_t i = 0; i < numPackets; ++i) {
+        memset(&_mmsgs[i], 0, sizeof(_mmsgs[i]));
+        _mmsgs[i].msg_hdr.msg_name = &dstSock;
+        _mmsgs[i].msg_hdr.msg_namelen = dstLen;
+        _mmsgs[i].msg_hdr.msg_iov = &_iovs[i];
+        _mmsgs[i].msg_hdr.msg_iovlen = 1;
+      }
+      while (sent < numPackets) {
+        int  rc = sendmmsg(fd, _mmsgs.data() + sent, numPackets - sent, 0);
+        if (0 < rc) {
+          sent += rc;
+        }
+        else if (EINTR != errno) {
+          FSyslog(LOG_ERR, "sendmmsg({}) failed: {} ({})",
+                  dst, strerror(errno), errno);
+          break;
+        }
+      }
+#else
+      for ( ; sent < numPackets; ++sent) {
+        ssize_t  rc = sendto(fd, _iovs[sent].iov_base, _iovs[sent].iov_len,
+                             0, (const sockaddr *)&dstSock, dstLen);
+        if (rc != (ssize_t)_iovs[sent].iov_len) {
+          FSyslog(LOG_ERR, "sendto({}) failed: {} ({})",
+                  dst, strerror(errno), errno);
+          break;
+        }
+      }
+#endif
+      return sent;
+    }
+
+    //------------------------------------------------------------------------
+    bool PacketBatch::AddFragments(const Message & msg)
+    {
+      std::vector<MessageFragment>  frags;
+      if (! MessageFragment::Split(msg, _nextFragmentId,
+                                   _packets[_current].PayloadCapacity(),
+                                   frags)) {
+        FSyslog(LOG_ERR, "Failed to fragment {} byte message",
+                msg.StreamedLength());
+        return false;
+      }
+      size_t  first = _current + (_packets[_current].HasPayload() ? 1 : 0);
+      if ((first + frags.size()) > _packets.size()) {
+        return false;
+      }
+      PacketSummary  summary = MessageSummary(msg);
+      for (size_t i = 0; i < frags.size(); ++i) {
+        if (! _packets[first + i].Add(frags[i])) {
+          for (size_t j = first; j <= (first + i); ++j) {
+            _packets[j].Reset();
+          }
+          return false;
+        }
+        _packets[first + i].Summary() |= summary;
+      }
+      _current = first + frags.size() - 1;
+      ++_nextFragmentId;
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Stages @c msg for the current packet.  If it won't fit with
+    //!  what's already staged, the current packet is sealed and @c msg
+    //!  starts the next one.
+    //------------------------------------------------------------------------
+    bool PacketBatch::Stage(const Message & msg)
+    {
+      if (msg.StreamedLength() > _packets[_current].PayloadCapacity()) {
+        //  Too large for a packet of its own.  Fragments aren't
+        //  compressed or compacted.
+        return (SealStaged() && AddFragments(msg));
+      }
+      if (_packets[_current].HasPayload()) {
+        //  Current packet is already sealed.
+        if ((_current + 1) >= _packets.size()) {
+          return false;
+        }
+        ++_current;
+        RestartFit();
+      }
+      if (_compact && (! _block.Accepts(msg))) {
+        //  The block's origin table is full.
+        if ((_current + 1) >= _packets.size()) {
+          return false;
+        }
+        if (Seal()) {
+          ++_current;
+        }
+      }
+      size_t  prevLen = _raw.size();
+      if (! Append(msg)) {
+        return false;
+      }
+      if (_compact) {
+        _staged.push_back(msg);
+      }
+      if ((_raw.size() <= _trialLen) || Fits(_raw.size())) {
+        return true;
+      }
+      if ((_current + 1) >= _packets.size()) {
+        if (_compact) {
+          _staged.pop_back();
+          Reencode();
+        }
+        else {
+          _raw.resize(prevLen);
+          _rawEnds.pop_back();
+          _rawSummaries.pop_back();
+        }
+        return false;
+      }
+      if (Seal()) {
+        ++_current;
+      }
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Appends @c msg to the staged bytes, encoded as the next entry of
+    //!  _block if we're compact.
+    //------------------------------------------------------------------------
+    bool PacketBatch::Append(const Message & msg)
+    {
+      size_t  prevLen = _raw.size();
+      size_t  len = (_compact ? _block.StreamedLength(msg)
+                     : msg.StreamedLength());
+      _raw.resize(prevLen + len);
+      std::spanstream  sps{std::span{_raw.data() + prevLen, len}};
+      if (! (_compact ? _block.Write(sps, msg) : msg.Write(sps))) {
+        _raw.resize(prevLen);
+        return false;
+      }
+      _rawEnds.push_back(_raw.size());
+      _rawSummaries.push_back(MessageSummary(msg));
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Removes the first @c n staged messages, which have been sealed.
+    //!  When compact, the rest start a new block for the next packet.
+    //------------------------------------------------------------------------
+    void PacketBatch::Unstage(size_t n)
+    {
+      if (_compact) {
+        _staged.erase(_staged.begin(), _staged.begin() + n);
+        Reencode();
+        return;
+      }
+      size_t  sealedLen = _rawEnds[n - 1];
+      _raw.erase(0, sealedLen);
+      _rawEnds.erase(_rawEnds.begin(), _rawEnds.begin() + n);
+      _rawSummaries.erase(_rawSummaries.begin(), _rawSummaries.begin() + n);
+      for (auto & end : _rawEnds) {
+        end -= sealedLen;
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Re-encodes the staged messages as a new block.
+    //------------------------------------------------------------------------
+    void PacketBatch::Reencode()
+    {
+      _raw.clear();
+      _rawEnds.clear();
+      _rawSummaries.clear();
+      _block.Clear();
+      for (const auto & msg : _staged) {
+        Append(msg);
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Encodes the first @c len staged bytes into @c out for the current
+    //!  packet: compressed if that's smaller, else as-is.  Returns false
+    //!  (with @c out empty) if neither fits.
+    //------------------------------------------------------------------------
+    bool PacketBatch::Encode(size_t len, std::string & out, bool & compressed)
+    {
+      if ((len == _fitLen) && (! _fitData.empty())) {
+        out = _fitData;
+        compressed = true;
+        return true;
+      }
+      size_t  cap = _packets[_current].PayloadCapacity();
+      size_t  clen = 0;
+      if ((nullptr != _compressor)
+          && (len <= PayloadCompressor::k_maxRawLen)) {
+        out.resize(std::min(cap, len));
+        clen = _compressor->Compress(_raw.data(), len, out.data(),
+                                     out.size());
+      }
+      if ((0 < clen) && (clen < len)) {
+        out.resize(clen);
+        compressed = true;
+        return true;
+      }
+      if (len <= cap) {
+        out.assign(_raw, 0, len);
+        compressed = false;
+        return true;
+      }
+      out.clear();
+      return false;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Returns true if the first @c len staged bytes fit in the current
+    //!  packet, remembering the result.  We won't check again until the
+    //!  staged bytes are expected to have used three quarters of the
+    //!  remaining room, at the compression ratio seen so far.
+    //------------------------------------------------------------------------
+    bool PacketBatch::Fits(size_t len)
+    {
+      bool  compressed = false;
+      if (! Encode(len, _scratch, compressed)) {
+        return false;
+      }
+      size_t  cap = _packets[_current].PayloadCapacity();
+      _fitLen = len;
+      _trialLen = cap;
+      _fitData.clear();
+      if (compressed) {
+        _fitData.swap(_scratch);
+        _trialLen = len + ((((cap - _fitData.size()) * len)
+                            / _fitData.size()) * 3) / 4;
+      }
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Compresses as many staged messages as will fit into the current
+    //!  packet.  The rest remain staged.  Returns false, leaving the
+    //!  current packet empty, if the first staged message didn't fit and
+    //!  was dropped.
+    //------------------------------------------------------------------------
+    bool PacketBatch::Seal()
+    {
+      std::string  out;
+      bool         compressed = false;
+      size_t       n = _rawEnds.size();
+      if (! Encode(_raw.size(), out, compressed)) {
+        //  Binary search for the most messages that fit.  Those that
+        //  Fits() accepted do, and the first always fits uncompressed.
+        size_t  lo = std::max<size_t>(1, std::upper_bound(_rawEnds.begin(),
+                                                          _rawEnds.end(),
+                                                          _fitLen)
+                                      - _rawEnds.begin());
+        size_t  hi = n - 1;
+        if (! Encode(_rawEnds[lo - 1], out, compressed)) {
+          //  Shouldn't happen, since Stage() fragments any message too
+          //  large for a packet of its own.  Drop the first message
+          //  rather than send a garbled payload.
+          FSyslog(LOG_ERR, "Dropped {} byte staged message that doesn't"
+                  " fit in a packet", _rawEnds[0]);
+          Unstage(1);
+          RestartFit();
+          return false;
+        }
+        while (lo < hi) {
+          size_t  mid = (lo + hi + 1) / 2;
+          bool    midCompressed = false;
+          if (Encode(_rawEnds[mid - 1], _scratch, midCompressed)) {
+            lo = mid;
+            out.swap(_scratch);
+            compressed = midCompressed;
+          }
+          else {
+            hi = mid - 1;
+          }
+        }
+        n = lo;
+      }
+      _packets[_current].Payload(out.data(), out.size(), compressed);
+      for (size_t i = 0; i < n; ++i) {
+        _packets[_current].Summary() |= _rawSummaries[i];
+      }
+      Unstage(n);
+      RestartFit();
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Seals all staged messages.  Returns false if we ran out of
+    //!  packets first.
+    //------------------------------------------------------------------------
+    bool PacketBatch::SealStaged()
+    {
+      while (! _raw.empty()) {
+        if (_packets[_current].HasPayload()) {
+          if ((_current + 1) >= _packets.size()) {
+            return false;
+          }
+          ++_current;
+          RestartFit();
+        }
+        Seal();
+      }
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    void PacketBatch::RestartFit()
+    {
+      _fitLen = 0;
+      _fitData.clear();
+      _trialLen = _packets[_current].PayloadCapacity();
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void PacketBatch::Reset()
+    {
+      for (size_t i = 0; i <= _current; ++i) {
+        _packets[i].Reset();
+      }
+      _current = 0;
+      return;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
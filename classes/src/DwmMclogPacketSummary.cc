@@ -0,0 +1,147 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogPacketSummary.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::PacketSummary and Dwm::Mclog::PacketSummaryFilter
+//!  class implementations
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+
+#include "DwmMclogMessage.hh"
+#include "DwmMclogMessageFilterDriver.hh"
+#include "DwmMclogPacketSummary.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    void PacketSummary::Encode(uint8_t *buf) const
+    {
+      buf[0] = (_facilities >> 16) & 0xFF;
+      buf[1] = (_facilities >> 8) & 0xFF;
+      buf[2] = _facilities & 0xFF;
+      buf[3] = _severities;
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    void PacketSummary::Decode(const uint8_t *buf)
+    {
+      _facilities = (((uint32_t)buf[0] << 16) | ((uint32_t)buf[1] << 8)
+                     | buf[2]);
+      _severities = buf[3];
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    PacketSummaryFilter::PacketSummaryFilter()
+        : _active(false), _passing()
+    {
+      _passing.fill(0xFF);
+    }
+    
+    //------------------------------------------------------------------------
+    PacketSummaryFilter::PacketSummaryFilter(MessageFilterDriver & filter)
+        : _active(false), _passing()
+    {
+      _passing.fill(0xFF);
+      if (! filter.priority_only()) {
+        return;
+      }
+      for (size_t code = 0; code < _passing.size(); ++code) {
+        uint8_t  passing = 0;
+        for (uint8_t sev = 0; sev < 8; ++sev) {
+          MessageHeader  hdr(Timestamp(), (Facility)(code << 3),
+                             (Severity)sev, MessageOrigin());
+          Message  msg(hdr, std::string());
+          bool     result = false;
+          if ((! filter.parse(&msg, result)) || result) {
+            passing |= (1 << sev);
+          }
+        }
+        _passing[code] = passing;
+      }
+      _active = true;
+    }
+
+    //------------------------------------------------------------------------
+    bool PacketSummaryFilter::MayPass(const PacketSummary & summary) const
+    {
+      if (! _active) {
+        return true;
+      }
+      uint32_t  facilities = summary.Facilities();
+      for (size_t code = 0; facilities; ++code, facilities >>= 1) {
+        if ((facilities & 1) && (_passing[code] & summary.Severities())) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    //------------------------------------------------------------------------
+    bool PacketSummaryFilter::Overlaps(const PacketSummaryFilter & other)
+      const
+    {
+      for (size_t code = 0; code < _passing.size(); ++code) {
+        if (_passing[code] & other._passing[code]) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    //------------------------------------------------------------------------
+    bool PacketSummaryFilter::
+    PassesOutside(const std::vector<PacketSummaryFilter> & others) const
+    {
+      auto  remaining = _passing;
+      for (const auto & other : others) {
+        if (! other._active) {
+          return true;
+        }
+        for (size_t code = 0; code < remaining.size(); ++code) {
+          remaining[code] &= ~other._passing[code];
+        }
+      }
+      return std::any_of(remaining.begin(), remaining.end(),
+                         [] (uint8_t passing) { return (0 != passing); });
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
@@ -0,0 +1,244 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogPayloadCompressor.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::PayloadCompressor and
+//!  Dwm::Mclog::PayloadDecompressor class implementations
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <zdict.h>
+}
+
+#include <fstream>
+#include <iterator>
+
+#include "DwmFormatters.hh"
+#include "DwmSysLogger.hh"
+#include "DwmMclogPayloadCompressor.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    PayloadCompressor::PayloadCompressor()
+        : _cctx(ZSTD_createCCtx()), _cdict(nullptr), _dict()
+    {}
+
+    //------------------------------------------------------------------------
+    PayloadCompressor::~PayloadCompressor()
+    {
+      if (nullptr != _cdict) { ZSTD_freeCDict(_cdict); _cdict = nullptr; }
+      if (nullptr != _cctx)  { ZSTD_freeCCtx(_cctx);   _cctx = nullptr;  }
+    }
+
+    //------------------------------------------------------------------------
+    bool PayloadCompressor::Dictionary(const std::string & dict)
+    {
+      if (nullptr != _cdict) {
+        ZSTD_freeCDict(_cdict);
+        _cdict = nullptr;
+      }
+      _dict.clear();
+      if (dict.empty()) {
+        return true;
+      }
+      if (dict.size() > k_maxDictionaryLen) {
+        FSyslog(LOG_ERR, "Compression dictionary too large ({} bytes)",
+                dict.size());
+        return false;
+      }
+      _cdict = ZSTD_createCDict(dict.data(), dict.size(), k_level);
+      if (nullptr == _cdict) {
+        FSyslog(LOG_ERR, "Failed to create compression dictionary");
+        return false;
+      }
+      _dict = dict;
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    size_t PayloadCompressor::Compress(const char *src, size_t srcLen,
+                                       char *dst, size_t dstCap)
+    {
+      if (nullptr == _cctx) {
+        return 0;
+      }
+      size_t  rc;
+      if (nullptr != _cdict) {
+        rc = ZSTD_compress_usingCDict(_cctx, dst, dstCap, src, srcLen,
+                                      _cdict);
+      }
+      else {
+        rc = ZSTD_compressCCtx(_cctx, dst, dstCap, src, srcLen, k_level);
+      }
+      //  Usually just means it didn't fit in dstCap.
+      return (ZSTD_isError(rc) ? 0 : rc);
+    }
+
+    //------------------------------------------------------------------------
+    bool PayloadCompressor::
+    TrainDictionary(const std::vector<std::string> & samples, size_t maxLen,
+                    std::string & dict)
+    {
+      std::string          buf;
+      std::vector<size_t>  sizes;
+      sizes.reserve(samples.size());
+      for (const auto & sample : samples) {
+        buf += sample;
+        sizes.push_back(sample.size());
+      }
+      dict.resize(maxLen);
+      size_t  rc = ZDICT_trainFromBuffer(dict.data(), dict.size(),
+                                         buf.data(), sizes.data(),
+                                         sizes.size());
+      if (ZDICT_isError(rc)) {
+        FSyslog(LOG_ERR, "Failed to train dictionary from {} samples: {}",
+                samples.size(), ZDICT_getErrorName(rc));
+        dict.clear();
+        return false;
+      }
+      dict.resize(rc);
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    bool PayloadCompressor::LoadDictionary(const std::string & path,
+                                           std::string & dict)
+    {
+      std::ifstream  is(path, std::ios::binary);
+      if (! is) {
+        FSyslog(LOG_ERR, "Failed to open dictionary {}", path);
+        return false;
+      }
+      dict.assign(std::istreambuf_iterator<char>(is),
+                  std::istreambuf_iterator<char>());
+      if (dict.size() > k_maxDictionaryLen) {
+        FSyslog(LOG_ERR, "Dictionary {} is too large ({} bytes, max {})",
+                path, dict.size(), k_maxDictionaryLen);
+        dict.clear();
+        return false;
+      }
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    PayloadDecompressor::PayloadDecompressor()
+        : _dctx(ZSTD_createDCtx()), _ddict(nullptr), _dict(), _dictId(0)
+    {}
+
+    //------------------------------------------------------------------------
+    PayloadDecompressor::
+    PayloadDecompressor(const PayloadDecompressor & decomp)
+        : _dctx(ZSTD_createDCtx()), _ddict(nullptr), _dict(), _dictId(0)
+    {
+      Dictionary(decomp._dict);
+    }
+
+    //------------------------------------------------------------------------
+    PayloadDecompressor &
+    PayloadDecompressor::operator = (const PayloadDecompressor & decomp)
+    {
+      if (this != &decomp) {
+        Dictionary(decomp._dict);
+      }
+      return *this;
+    }
+    
+    //------------------------------------------------------------------------
+    PayloadDecompressor::~PayloadDecompressor()
+    {
+      if (nullptr != _ddict) { ZSTD_freeDDict(_ddict); _ddict = nullptr; }
+      if (nullptr != _dctx)  { ZSTD_freeDCtx(_dctx);   _dctx = nullptr;  }
+    }
+
+    //------------------------------------------------------------------------
+    void PayloadDecompressor::Dictionary(const DictPtr & dict)
+    {
+      if (nullptr != _ddict) {
+        ZSTD_freeDDict(_ddict);
+        _ddict = nullptr;
+      }
+      _dict = dict;
+      _dictId = 0;
+      if (_dict && (! _dict->empty())) {
+        _ddict = ZSTD_createDDict(_dict->data(), _dict->size());
+        _dictId = ZSTD_getDictID_fromDict(_dict->data(), _dict->size());
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    bool PayloadDecompressor::Decompress(const char *src, size_t srcLen,
+                                         std::string & out)
+    {
+      out.clear();
+      if (nullptr == _dctx) {
+        return false;
+      }
+      unsigned long long  rawLen = ZSTD_getFrameContentSize(src, srcLen);
+      if ((ZSTD_CONTENTSIZE_ERROR == rawLen)
+          || (ZSTD_CONTENTSIZE_UNKNOWN == rawLen)
+          || (rawLen > PayloadCompressor::k_maxRawLen)) {
+        return false;
+      }
+      out.resize(rawLen);
+      size_t  rc;
+      if (nullptr != _ddict) {
+        rc = ZSTD_decompress_usingDDict(_dctx, out.data(), out.size(),
+                                        src, srcLen, _ddict);
+      }
+      else {
+        rc = ZSTD_decompressDCtx(_dctx, out.data(), out.size(), src, srcLen);
+      }
+      if (ZSTD_isError(rc) || (rc != rawLen)) {
+        out.clear();
+        return false;
+      }
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    bool PayloadDecompressor::WrongDictionary(const char *src,
+                                              size_t srcLen) const
+    {
+      unsigned  dictId = ZSTD_getDictID_fromFrame(src, srcLen);
+      return ((0 != dictId) && (dictId != _dictId));
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
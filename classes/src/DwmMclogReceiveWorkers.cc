@@ -0,0 +1,203 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogReceiveWorkers.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::ReceiveWorkers implementation
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <string>
+
+#include "DwmMclogLogger.hh"
+#include "DwmMclogReceiveWorkers.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    ReceiveWorkers::ReceiveWorkers(MulticastSources *sources,
+                                   std::vector<MessageSink *> *sinks,
+                                   std::shared_mutex *sinksMutex)
+        : _sources(sources), _sinks(sinks), _sinksMutex(sinksMutex),
+          _quotas(nullptr), _workers(), _run(false), _poolMtx(), _pool(),
+          _drops()
+    {}
+
+    //------------------------------------------------------------------------
+    ReceiveWorkers::~ReceiveWorkers()
+    {
+      Stop();
+    }
+    
+    //------------------------------------------------------------------------
+    bool ReceiveWorkers::Start(size_t numWorkers)
+    {
+      if (! _workers.empty()) {
+        return false;
+      }
+      numWorkers = std::max(numWorkers, (size_t)1);
+      _sources->Shards(numWorkers);
+      _run = true;
+      for (size_t i = 0; i < numWorkers; ++i) {
+        auto  worker = std::make_unique<Worker>();
+        //  Drops are counted by source in Dispatch(), not by the queue.
+        worker->queue.Configure(QueueConfig(k_queueCapacity,
+                                            OverflowPolicy::dropNewest),
+                                nullptr);
+        worker->thread = std::thread(&ReceiveWorkers::Run, this,
+                                     worker.get());
+#if (defined(__FreeBSD__) || defined(__linux__))
+        std::string  threadName("RecvWorker" + std::to_string(i));
+        pthread_setname_np(worker->thread.native_handle(),
+                           threadName.c_str());
+#endif
+        _workers.push_back(std::move(worker));
+      }
+      MCLOG(Severity::info, "Started {} multicast receive workers",
+            numWorkers);
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    void ReceiveWorkers::Stop()
+    {
+      _run = false;
+      for (auto & worker : _workers) {
+        worker->queue.ConditionSignal();
+      }
+      for (auto & worker : _workers) {
+        if (worker->thread.joinable()) {
+          worker->thread.join();
+        }
+      }
+      _workers.clear();
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    bool ReceiveWorkers::Dispatch(const UdpEndpoint & src, const char *data,
+                                  size_t datalen)
+    {
+      if (_workers.empty()) {
+        return false;
+      }
+      Packet  pkt;
+      pkt.src = src;
+      pkt.data = Buffer();
+      pkt.data.assign(data, data + datalen);
+      //  Packets from a dual-stack sender's other endpoint go to the
+      //  worker for the source that will process them, so its messages
+      //  stay in order.
+      Worker  & worker = *(_workers[_sources->Shard(src, data, datalen)]);
+      if (! worker.queue.PushBack(std::move(pkt))) {
+        _drops.Add(Severity::debug, (std::string)src);
+        Release(std::move(pkt.data));
+        return false;
+      }
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    std::vector<char> ReceiveWorkers::Buffer()
+    {
+      std::vector<char>  buf;
+      std::lock_guard  lck(_poolMtx);
+      if (! _pool.empty()) {
+        buf.swap(_pool.back());
+        _pool.pop_back();
+      }
+      return buf;
+    }
+
+    //------------------------------------------------------------------------
+    void ReceiveWorkers::Release(std::vector<char> && buf)
+    {
+      std::lock_guard  lck(_poolMtx);
+      if (_pool.size() < k_maxPooledBuffers) {
+        _pool.push_back(std::move(buf));
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void ReceiveWorkers::Deliver(const std::vector<Message> & msgs)
+    {
+      std::shared_lock  lck(*_sinksMutex);
+      for (const auto & msg : msgs) {
+        if (_quotas && (! _quotas->Admit(msg))) {
+          continue;
+        }
+        for (auto sink : *_sinks) {
+          sink->Process(msg);
+        }
+      }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    void ReceiveWorkers::Run(Worker *worker)
+    {
+#if (__APPLE__)
+      pthread_setname_np("RecvWorker");
+#endif
+      std::deque<Packet>    pkts;
+      std::vector<Message>  msgs;
+      while (_run.load()) {
+        //  Bounded, since Stop()'s ConditionSignal() may land between
+        //  our check of _run and the wait, and no packet may follow.
+        worker->queue.ConditionTimedWait(std::chrono::seconds(1));
+        worker->queue.Swap(pkts);
+        for (auto & pkt : pkts) {
+          _sources->ProcessPacket(pkt.src, pkt.data.data(),
+                                  pkt.data.size(), msgs);
+          Release(std::move(pkt.data));
+        }
+        pkts.clear();
+        if (! msgs.empty()) {
+          Deliver(msgs);
+          msgs.clear();
+        }
+      }
+      worker->queue.Clear();
+      return;
+    }
+    
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
@@ -0,0 +1,272 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogReplayWindow.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::ReplayWindow class implementation
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <bit>
+
+#include "DwmMclogReplayWindow.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    ReplayWindow::ReplayWindow()
+        : _windows(), _rejected(0)
+    {}
+
+    //------------------------------------------------------------------------
+    bool ReplayWindow::Accept(const std::string & prefix, uint64_t counter,
+                              SourceStats *stats)
+    {
+      auto  it = std::find_if(_windows.begin(), _windows.end(),
+                              [&] (const Window & w)
+                              { return (w.prefix == prefix); });
+      if (it == _windows.end()) {
+        if (_windows.size() >= k_maxPrefixes) {
+          _windows.pop_back();
+        }
+        _windows.insert(_windows.begin(),
+                        Window{prefix, counter, 1, counter, {}});
+        return true;
+      }
+      if (it != _windows.begin()) {
+        std::rotate(_windows.begin(), it, std::next(it));
+        it = _windows.begin();
+      }
+      
+      Window  & w = *it;
+      if (counter > w.highest) {
+        uint64_t  lost = Advance(w, counter);
+        if (stats) {
+          stats->lost += lost;
+        }
+        return true;
+      }
+      uint64_t  behind = w.highest - counter;
+      if (behind < k_windowSize) {
+        uint64_t  bit = 1ULL << behind;
+        if (! (w.bitmap & bit)) {
+          w.bitmap |= bit;
+          w.floor = std::min(w.floor, counter);
+          if (stats) {
+            ++stats->reordered;
+          }
+          return true;
+        }
+        if (stats) {
+          ++stats->duplicated;
+        }
+      }
+      else if (stats) {
+        ++stats->late;
+      }
+      ++_rejected;
+      return false;
+    }
+
+    //------------------------------------------------------------------------
+    size_t ReplayWindow::Missing(const std::string & prefix, uint64_t from,
+                                 uint64_t minBehind,
+                                 std::vector<uint64_t> & counters) const
+    {
+      auto  it = std::find_if(_windows.begin(), _windows.end(),
+                              [&] (const Window & w)
+                              { return (w.prefix == prefix); });
+      if ((it == _windows.end()) || (it->highest < minBehind)) {
+        return 0;
+      }
+      const Window  & w = *it;
+      uint64_t  lo = std::max({from, w.floor,
+                               ((w.highest >= (k_windowSize - 1))
+                                ? (w.highest - (k_windowSize - 1)) : 0)});
+      uint64_t  hi = w.highest - minBehind;
+      uint64_t  seen = w.bitmap | SkippedBits(w);
+      size_t    rc = 0;
+      for (uint64_t counter = lo; counter <= hi; ++counter) {
+        if (! (seen & (1ULL << (w.highest - counter)))) {
+          counters.push_back(counter);
+          ++rc;
+        }
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    void ReplayWindow::Skip(const std::string & prefix, uint64_t counter)
+    {
+      auto  it = std::find_if(_windows.begin(), _windows.end(),
+                              [&] (const Window & w)
+                              { return (w.prefix == prefix); });
+      if ((it == _windows.end())
+          || ((counter + k_windowSize) <= it->highest)
+          || (NumSkipped(*it, counter, counter) > 0)) {
+        return;
+      }
+      auto  & runs = it->skipped;
+      if ((! runs.empty()) && ((runs.back().second + 1) == counter)) {
+        runs.back().second = counter;
+        return;
+      }
+      if (runs.size() >= k_maxSkipRuns) {
+        runs.erase(runs.begin());
+      }
+      runs.push_back({counter, counter});
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    bool ReplayWindow::Seen(const std::string & prefix,
+                            uint64_t counter) const
+    {
+      const Window  *w = Find(prefix);
+      if ((nullptr == w) || (counter > w->highest)) {
+        return false;
+      }
+      uint64_t  behind = w->highest - counter;
+      return ((behind < k_windowSize) && (w->bitmap & (1ULL << behind)));
+    }
+
+    //------------------------------------------------------------------------
+    bool ReplayWindow::Skipped(const std::string & prefix,
+                               uint64_t counter) const
+    {
+      const Window  *w = Find(prefix);
+      return ((nullptr != w) && (NumSkipped(*w, counter, counter) > 0));
+    }
+    
+    //------------------------------------------------------------------------
+    std::vector<std::string> ReplayWindow::Prefixes() const
+    {
+      std::vector<std::string>  rc;
+      for (const auto & w : _windows) {
+        rc.push_back(w.prefix);
+      }
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    const ReplayWindow::Window *
+    ReplayWindow::Find(const std::string & prefix) const
+    {
+      for (const auto & w : _windows) {
+        if (w.prefix == prefix) {
+          return &w;
+        }
+      }
+      return nullptr;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Slides @c w forward so that @c counter is its highest counter.
+    //!  Returns the number of counters at or above the window's floor
+    //!  that left the window (or skipped it entirely) without being seen.
+    //------------------------------------------------------------------------
+    uint64_t ReplayWindow::Advance(Window & w, uint64_t counter)
+    {
+      uint64_t  shift = counter - w.highest;
+      uint64_t  lost = 0;
+      //  Bits lo..hi of the bitmap leave the window, but only those for
+      //  counters at or above the floor could have been sent to us.
+      uint64_t  lo = (shift < k_windowSize) ? (k_windowSize - shift) : 0;
+      uint64_t  hi = std::min(k_windowSize - 1, w.highest - w.floor);
+      if (lo <= hi) {
+        uint64_t  numBits = hi - lo + 1;
+        uint64_t  mask = ((numBits < 64) ? ((1ULL << numBits) - 1) : ~0ULL);
+        mask <<= lo;
+        lost += numBits - std::popcount((w.bitmap | SkippedBits(w)) & mask);
+      }
+      if (shift > k_windowSize) {
+        //  Counters that were never inside the window.
+        lost += shift - k_windowSize;
+        lost -= NumSkipped(w, w.highest + 1, counter - k_windowSize);
+      }
+      w.bitmap = (shift < k_windowSize) ? ((w.bitmap << shift) | 1) : 1;
+      w.highest = counter;
+      if (counter >= k_windowSize) {
+        //  Forget runs of skipped counters that have left the window.
+        uint64_t  low = counter - (k_windowSize - 1);
+        std::erase_if(w.skipped, [low] (const auto & run)
+                      { return (run.second < low); });
+      }
+      return lost;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Returns a bitmap of the skipped counters in @c w, laid out like
+    //!  its bitmap of counters seen.
+    //------------------------------------------------------------------------
+    uint64_t ReplayWindow::SkippedBits(const Window & w)
+    {
+      uint64_t  low = ((w.highest >= (k_windowSize - 1))
+                       ? (w.highest - (k_windowSize - 1)) : 0);
+      uint64_t  rc = 0;
+      for (const auto & [first, last] : w.skipped) {
+        uint64_t  lo = std::max(first, low);
+        uint64_t  hi = std::min(last, w.highest);
+        if (lo <= hi) {
+          uint64_t  numBits = hi - lo + 1;
+          uint64_t  mask = ((numBits < 64) ? ((1ULL << numBits) - 1) : ~0ULL);
+          rc |= (mask << (w.highest - hi));
+        }
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Returns the number of skipped counters in @c w from @c first
+    //!  through @c last.
+    //------------------------------------------------------------------------
+    uint64_t ReplayWindow::NumSkipped(const Window & w, uint64_t first,
+                                      uint64_t last)
+    {
+      uint64_t  rc = 0;
+      for (const auto & run : w.skipped) {
+        uint64_t  lo = std::max(first, run.first);
+        uint64_t  hi = std::min(last, run.second);
+        if (lo <= hi) {
+          rc += hi - lo + 1;
+        }
+      }
+      return rc;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
@@ -0,0 +1,225 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogRetransmitRing.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::RetransmitRing class implementation
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+
+#include "DwmMclogCipherSuite.hh"
+#include "DwmMclogRetransmitRing.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    RetransmitRing::Counts &
+    RetransmitRing::Counts::operator += (const Counts & counts)
+    {
+      requested += counts.requested;
+      unicast += counts.unicast;
+      multicast += counts.multicast;
+      missed += counts.missed;
+      rateLimited += counts.rateLimited;
+      return *this;
+    }
+    
+    //------------------------------------------------------------------------
+    std::string RetransmitRing::Counts::Summary() const
+    {
+      using std::to_string;
+      return ("requested " + to_string(requested)
+              + ", unicast " + to_string(unicast)
+              + ", multicast " + to_string(multicast)
+              + ", missed " + to_string(missed)
+              + ", rate limited " + to_string(rateLimited));
+    }
+    
+    //------------------------------------------------------------------------
+    RetransmitRing::RetransmitRing(size_t capacity, double rate, double burst)
+        : _mtx(), _slots(std::max(capacity, (size_t)1)), _size(0),
+          _rate(rate), _burst(std::max(burst, 1.0)), _buckets(), _counts()
+    {}
+
+    //------------------------------------------------------------------------
+    void RetransmitRing::Add(const char *data, size_t len)
+    {
+      CipherSuite  suite;
+      std::string  prefix;
+      uint64_t     counter;
+      if ((len < NonceSequence::k_headerLen)
+          || (! NonceSequence::Parse((const uint8_t *)data, suite,
+                                     prefix, counter))) {
+        return;
+      }
+      std::lock_guard  lck(_mtx);
+      Slot  & slot = _slots[counter % _slots.size()];
+      if (slot.data.empty()) {
+        ++_size;
+      }
+      slot.prefix = std::move(prefix);
+      slot.counter = counter;
+      slot.data.assign(data, len);
+      slot.requesters.clear();
+      slot.multicast = false;
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    size_t RetransmitRing::Repairs(const Nack & nack, const UdpEndpoint & src,
+                                   std::vector<Retransmit> & repairs)
+    {
+      size_t  rc = 0;
+      auto    now = Clock::now();
+      std::lock_guard  lck(_mtx);
+      for (const auto & range : nack.Ranges()) {
+        _counts.requested += range.count;
+        for (uint64_t i = 0; i < range.count; ++i) {
+          if (! TakeToken(src, now)) {
+            _counts.rateLimited += range.count - i;
+            break;
+          }
+          if (Repair(nack.Prefix(), range.first + i, src, repairs)) {
+            ++rc;
+          }
+        }
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    size_t RetransmitRing::Size() const
+    {
+      std::lock_guard  lck(_mtx);
+      return _size;
+    }
+
+    //------------------------------------------------------------------------
+    void RetransmitRing::Clear()
+    {
+      std::lock_guard  lck(_mtx);
+      for (auto & slot : _slots) {
+        slot = Slot();
+      }
+      _size = 0;
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    RetransmitRing::Counts RetransmitRing::Harvest()
+    {
+      std::lock_guard  lck(_mtx);
+      Counts  rc = _counts;
+      _counts = Counts();
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    bool RetransmitRing::Repair(const std::string & prefix, uint64_t counter,
+                                const UdpEndpoint & src,
+                                std::vector<Retransmit> & repairs)
+    {
+      Slot  & slot = _slots[counter % _slots.size()];
+      if (slot.data.empty() || (slot.counter != counter)
+          || (slot.prefix != prefix)) {
+        ++_counts.missed;
+        return false;
+      }
+      if (std::find(slot.requesters.begin(), slot.requesters.end(), src)
+          == slot.requesters.end()) {
+        if (slot.requesters.size() < k_multicastThreshold) {
+          slot.requesters.push_back(src);
+        }
+      }
+      if ((! slot.multicast)
+          && (slot.requesters.size() >= k_multicastThreshold)) {
+        slot.multicast = true;
+        repairs.push_back(Retransmit{slot.data, true});
+        ++_counts.multicast;
+      }
+      else {
+        repairs.push_back(Retransmit{slot.data, false});
+        ++_counts.unicast;
+      }
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Same token bucket as KeyRequestAdmission, one token per packet.
+    //------------------------------------------------------------------------
+    bool RetransmitRing::TakeToken(const UdpEndpoint & src,
+                                   Clock::time_point now)
+    {
+      auto  refill = [&] (Bucket & bucket) {
+        std::chrono::duration<double>  elapsed = now - bucket.last;
+        bucket.tokens = std::min(_burst,
+                                 bucket.tokens + (elapsed.count() * _rate));
+        bucket.last = now;
+      };
+      
+      std::string  addr = (std::string)src.Addr();
+      auto  it = _buckets.find(addr);
+      if (it == _buckets.end()) {
+        if (_buckets.size() >= k_maxTrackedAddrs) {
+          for (auto bit = _buckets.begin(); bit != _buckets.end(); ) {
+            refill(bit->second);
+            if (bit->second.tokens >= _burst) {
+              bit = _buckets.erase(bit);
+            }
+            else {
+              ++bit;
+            }
+          }
+          if (_buckets.size() >= k_maxTrackedAddrs) {
+            return false;
+          }
+        }
+        it = _buckets.emplace(addr, Bucket{_burst, now}).first;
+      }
+      else {
+        refill(it->second);
+      }
+      if (it->second.tokens >= 1.0) {
+        it->second.tokens -= 1.0;
+        return true;
+      }
+      return false;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
@@ -0,0 +1,118 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogSourceStats.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::SourceStats implementation
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdio>
+
+#include "DwmMclogSourceStats.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    using namespace std;
+
+    namespace {
+
+      //----------------------------------------------------------------------
+      string Milliseconds(int64_t usecs)
+      {
+        char  buf[32];
+        snprintf(buf, sizeof(buf), "%.1fms", (double)usecs / 1000.0);
+        return buf;
+      }
+      
+    }  // anonymous namespace
+    
+    //------------------------------------------------------------------------
+    SourceStats::SourceStats()
+        : received(0), lost(0), reordered(0), duplicated(0), late(0),
+          nacked(0), recovered(0), skipped(0), mirrored(0), messages(0),
+          lagTotal(0), lagMax(0)
+    {}
+
+    //------------------------------------------------------------------------
+    void SourceStats::AddMessage(int64_t lagUsecs)
+    {
+      lagMax = (messages ? std::max(lagMax, lagUsecs) : lagUsecs);
+      lagTotal += lagUsecs;
+      ++messages;
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    SourceStats & SourceStats::operator += (const SourceStats & stats)
+    {
+      if (stats.messages) {
+        lagMax = (messages ? std::max(lagMax, stats.lagMax) : stats.lagMax);
+      }
+      received += stats.received;
+      lost += stats.lost;
+      reordered += stats.reordered;
+      duplicated += stats.duplicated;
+      late += stats.late;
+      nacked += stats.nacked;
+      recovered += stats.recovered;
+      skipped += stats.skipped;
+      mirrored += stats.mirrored;
+      messages += stats.messages;
+      lagTotal += stats.lagTotal;
+      return *this;
+    }
+
+    //------------------------------------------------------------------------
+    string SourceStats::Summary() const
+    {
+      string  rc = to_string(received) + " pkts, " + to_string(lost)
+        + " lost, " + to_string(reordered) + " reordered, "
+        + to_string(duplicated) + " dup, " + to_string(late) + " late, "
+        + to_string(nacked) + " nacked, " + to_string(recovered)
+        + " recovered, " + to_string(skipped) + " skipped, "
+        + to_string(mirrored) + " mirrored, " + to_string(messages)
+        + " msgs";
+      if (messages) {
+        rc += ", lag " + Milliseconds(LagMean()) + " mean "
+          + Milliseconds(lagMax) + " max";
+      }
+      return rc;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
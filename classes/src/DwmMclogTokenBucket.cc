@@ -0,0 +1,125 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file DwmMclogTokenBucket.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::TokenBucket class implementation
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+
+#include "DwmMclogTokenBucket.hh"
+
+namespace Dwm {
+
+  namespace Mclog {
+
+    //------------------------------------------------------------------------
+    TokenBucket::TokenBucket()
+        : _packetRate(0), _byteRate(0), _maxPackets(0), _maxBytes(0),
+          _packets(0), _bytes(0), _last()
+    {}
+
+    //------------------------------------------------------------------------
+    void TokenBucket::Configure(const PacingPolicy & policy, size_t packetLen,
+                                Clock::time_point now)
+    {
+      _packetRate = policy.PacketRate();
+      _byteRate = policy.ByteRate();
+      _maxPackets = policy.Burst();
+      _maxBytes = (double)policy.Burst() * packetLen;
+      _packets = _maxPackets;
+      _bytes = _maxBytes;
+      _last = now;
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    bool TokenBucket::Ready(Clock::time_point now)
+    {
+      if (! Enabled()) {
+        return true;
+      }
+      Refill(now);
+      return (((_packetRate <= 0) || (_packets > 0))
+              && ((_byteRate <= 0) || (_bytes > 0)));
+    }
+
+    //------------------------------------------------------------------------
+    //!  We need a positive balance in each limited bucket.  Rounds up,
+    //!  so the sender doesn't wake just before it may send.
+    //------------------------------------------------------------------------
+    std::chrono::microseconds TokenBucket::Wait(Clock::time_point now)
+    {
+      double  secs = 0;
+      if (! Ready(now)) {
+        if ((_packetRate > 0) && (_packets <= 0)) {
+          secs = std::max(secs, (1e-6 - _packets) / _packetRate);
+        }
+        if ((_byteRate > 0) && (_bytes <= 0)) {
+          secs = std::max(secs, (1e-6 - _bytes) / _byteRate);
+        }
+      }
+      return std::chrono::microseconds((int64_t)std::ceil(secs * 1e6));
+    }
+    
+    //------------------------------------------------------------------------
+    void TokenBucket::Consume(size_t packets, size_t bytes)
+    {
+      if (_packetRate > 0) {
+        _packets -= packets;
+      }
+      if (_byteRate > 0) {
+        _bytes -= bytes;
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    void TokenBucket::Refill(Clock::time_point now)
+    {
+      if (now > _last) {
+        std::chrono::duration<double>  elapsed = now - _last;
+        _packets = std::min(_maxPackets,
+                            _packets + (elapsed.count() * _packetRate));
+        _bytes = std::min(_maxBytes, _bytes + (elapsed.count() * _byteRate));
+        _last = now;
+      }
+      return;
+    }
+    
+  }  // namespace Mclog
+
+}  // namespace Dwm
@@ -37,6 +37,8 @@
 //!  @brief Dwm::Mclog::UdpEndpoint implementation
 //---------------------------------------------------------------------------
 
+#include <string_view>
+
 #include "DwmMclogUdpEndpoint.hh"
 
 namespace Dwm {
@@ -75,6 +77,23 @@ namespace Dwm {
       return sockAddr;
     }
     
+    //------------------------------------------------------------------------
+    size_t UdpEndpoint::Hash() const
+    {
+      size_t  h = 0;
+      if (_addr.Family() == AF_INET) {
+        h = std::hash<uint32_t>{}(_addr.Addr<Ipv4Address>()->Raw());
+      }
+      else if (_addr.Family() == AF_INET6) {
+        in6_addr  addr6 = *(_addr.Addr<Ipv6Address>());
+        std::string_view  bytes((const char *)&addr6, sizeof(addr6));
+        h = std::hash<std::string_view>{}(bytes);
+      }
+      //  Mix in the port as boost::hash_combine() does.
+      h ^= (std::hash<uint16_t>{}(_port) + 0x9e3779b9 + (h << 6) + (h >> 2));
+      return h;
+    }
+    
     //------------------------------------------------------------------------
     UdpEndpoint::operator std::string () const
     {
@@ -0,0 +1,191 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestAdaptiveSampler.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::AdaptiveSampler unit tests
+//---------------------------------------------------------------------------
+
+#include <string>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogAdaptiveSampler.hh"
+
+using namespace std;
+using Dwm::Mclog::AdaptiveSampler, Dwm::Mclog::Facility,
+      Dwm::Mclog::Message, Dwm::Mclog::MessageHeader,
+      Dwm::Mclog::MessageOrigin, Dwm::Mclog::Severity;
+using std::chrono::milliseconds;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static Message TestMessage(Severity sev, const string & text)
+{
+  MessageOrigin  origin("host1", "app1", 1234);
+  return Message(MessageHeader(Facility::user, sev, origin), text);
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestSelected()
+{
+  size_t  kept2 = 0, kept8 = 0;
+  for (int i = 0; i < 4096; ++i) {
+    Message  msg = TestMessage(Severity::debug, "event " + to_string(i));
+    UnitAssert(AdaptiveSampler::Selected(msg, 1));
+    bool  sel2 = AdaptiveSampler::Selected(msg, 2);
+    bool  sel8 = AdaptiveSampler::Selected(msg, 8);
+    //  Kept at a higher rate implies kept at a lower rate.
+    UnitAssert(sel2 || (! sel8));
+    kept2 += sel2;
+    kept8 += sel8;
+  }
+  UnitAssert((kept2 > 1800) && (kept2 < 2300));
+  UnitAssert((kept8 > 400) && (kept8 < 630));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestAnnotate()
+{
+  Message  msg = TestMessage(Severity::info, "something happened");
+  UnitAssert(1 == AdaptiveSampler::MarkedRate(msg));
+  
+  Message  marked = AdaptiveSampler::Annotate(msg, 4);
+  UnitAssert("something happened [sampled 1/4]" == marked.Data());
+  size_t  textLen = 0;
+  UnitAssert(4 == AdaptiveSampler::MarkedRate(marked, &textLen));
+  UnitAssert(msg.Data().size() == textLen);
+  //  The mark doesn't change the verdict.
+  for (uint32_t rate = 2; rate <= AdaptiveSampler::k_maxRate; rate *= 2) {
+    UnitAssert(AdaptiveSampler::Selected(msg, rate)
+               == AdaptiveSampler::Selected(marked, rate));
+  }
+  //  Sampling again keeps one mark, with the higher rate.
+  UnitAssert("something happened [sampled 1/4]"
+             == AdaptiveSampler::Annotate(marked, 2).Data());
+  UnitAssert("something happened [sampled 1/16]"
+             == AdaptiveSampler::Annotate(marked, 16).Data());
+
+  //  Room is made for the mark.
+  Message  big = TestMessage(Severity::info, string(1500, 'x'));
+  Message  bigMarked = AdaptiveSampler::Annotate(big, 2);
+  UnitAssert(1500 == bigMarked.Data().size());
+  UnitAssert(2 == AdaptiveSampler::MarkedRate(bigMarked));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestAdapt()
+{
+  AdaptiveSampler  sampler;
+  Message          debug = TestMessage(Severity::debug, "debug");
+  Message          notice = TestMessage(Severity::notice, "notice");
+  uint32_t         rate;
+  
+  UnitAssert(! sampler.Enabled());
+  UnitAssert(sampler.Admit(debug, 1000, rate));
+  UnitAssert(1 == rate);
+
+  sampler.Configure(50, 1000);
+  UnitAssert(sampler.Enabled());
+  auto  now = AdaptiveSampler::Clock::now();
+  //  The queue grew to 800 while we let in 1000 messages, so it drained
+  //  200.  All were sampleable, so we need to keep 1 in 5, hence 1 in 8.
+  for (int i = 0; i < 1000; ++i) {
+    UnitAssert(sampler.Admit(debug, (i * 800) / 1000, rate, now));
+  }
+  now += AdaptiveSampler::k_interval;
+  sampler.Admit(debug, 800, rate, now);
+  UnitAssert(8 == sampler.Rate());
+
+  //  notice and above are never sampled.
+  for (int i = 0; i < 100; ++i) {
+    UnitAssert(sampler.Admit(notice, 800, rate, now));
+    UnitAssert(1 == rate);
+  }
+  size_t  kept = 0;
+  for (int i = 0; i < 800; ++i) {
+    Message  msg = TestMessage(Severity::info, "info " + to_string(i));
+    if (sampler.Admit(msg, 800, rate, now)) {
+      UnitAssert(8 == rate);
+      ++kept;
+    }
+  }
+  UnitAssert((kept > 60) && (kept < 140));
+  auto  sampled = sampler.HarvestSampled();
+  UnitAssert(800 - kept == sampled.Total());
+  UnitAssert(0 == sampled.BySeverity(Severity::notice));
+
+  //  Still past the threshold but draining: hold.
+  now += AdaptiveSampler::k_interval;
+  sampler.Admit(debug, 700, rate, now);
+  UnitAssert(8 == sampler.Rate());
+  //  Well under the threshold: relax.
+  now += AdaptiveSampler::k_interval;
+  sampler.Admit(debug, 100, rate, now);
+  UnitAssert(4 == sampler.Rate());
+  now += AdaptiveSampler::k_interval;
+  sampler.Admit(debug, 100, rate, now);
+  UnitAssert(2 == sampler.Rate());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestSelected();
+  TestAnnotate();
+  TestAdapt();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
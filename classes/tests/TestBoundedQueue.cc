@@ -0,0 +1,341 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestBoundedQueue.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::BoundedQueue unit tests
+//---------------------------------------------------------------------------
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogBoundedQueue.hh"
+#include "DwmMclogMessage.hh"
+
+using namespace std;
+using Dwm::Mclog::BoundedQueue, Dwm::Mclog::DrainPolicy,
+      Dwm::Mclog::DropCounters, Dwm::Mclog::DropCounts, Dwm::Mclog::Message, Dwm::Mclog::MessageHeader,
+      Dwm::Mclog::MessageOrigin, Dwm::Mclog::OverflowPolicy,
+      Dwm::Mclog::QueueConfig, Dwm::Mclog::Severity;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static Message MakeMessage(Severity severity, const std::string & data,
+                           const char *app = "app1")
+{
+  MessageOrigin  origin("foo.mcplex.net", app, 1234);
+  MessageHeader  header(Dwm::Mclog::Facility::user, severity, origin);
+  return Message(header, data);
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestDropNewest()
+{
+  DropCounters           drops;
+  BoundedQueue<Message>  q;
+  q.Configure(QueueConfig(2, OverflowPolicy::dropNewest), &drops);
+  UnitAssert(q.PushBack(MakeMessage(Severity::debug, "1")));
+  UnitAssert(q.PushBack(MakeMessage(Severity::debug, "2")));
+  UnitAssert(! q.PushBack(MakeMessage(Severity::debug, "3")));
+  //  A more urgent lane evicts the newest entry of a less urgent lane.
+  UnitAssert(q.PushBack(MakeMessage(Severity::emerg, "4")));
+  UnitAssert(2 == q.Length());
+
+  Message  msg;
+  UnitAssert(q.PopFront(msg) && (msg.Data() == "4"));
+  UnitAssert(q.PopFront(msg) && (msg.Data() == "1"));
+  UnitAssert(! q.PopFront(msg));
+
+  DropCounts  counts = drops.Harvest();
+  UnitAssert(2 == counts.Total());
+  UnitAssert(2 == counts.BySeverity(Severity::debug));
+  UnitAssert(2 == counts.ByOrigin().at("foo.mcplex.net/app1"));
+  UnitAssert(0 == drops.Harvest().Total());
+  UnitAssert(2 == drops.Total());
+
+  //  Likewise across the normal and urgent lanes, and the least urgent
+  //  lane is evicted from first.
+  q.Configure(QueueConfig(3, OverflowPolicy::dropNewest), &drops);
+  UnitAssert(q.PushBack(MakeMessage(Severity::notice, "5")));
+  UnitAssert(q.PushBack(MakeMessage(Severity::warning, "6")));
+  UnitAssert(q.PushBack(MakeMessage(Severity::info, "7")));
+  UnitAssert(q.PushBack(MakeMessage(Severity::err, "8")));
+  UnitAssert(q.PushBack(MakeMessage(Severity::err, "9")));
+  UnitAssert(q.PopFront(msg) && (msg.Data() == "8"));
+  UnitAssert(q.PopFront(msg) && (msg.Data() == "9"));
+  UnitAssert(q.PopFront(msg) && (msg.Data() == "5"));
+  UnitAssert(! q.PopFront(msg));
+  counts = drops.Harvest();
+  UnitAssert(2 == counts.Total());
+  UnitAssert(1 == counts.BySeverity(Severity::info));
+  UnitAssert(1 == counts.BySeverity(Severity::warning));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestDropOldest()
+{
+  DropCounters           drops;
+  BoundedQueue<Message>  q;
+  q.Configure(QueueConfig(2, OverflowPolicy::dropOldest), &drops);
+  UnitAssert(q.PushBack(MakeMessage(Severity::err, "1")));
+  UnitAssert(q.PushBack(MakeMessage(Severity::debug, "2")));
+  //  The err message is older, but is never evicted by a debug message.
+  UnitAssert(q.PushBack(MakeMessage(Severity::debug, "3")));
+  UnitAssert(2 == q.Length());
+
+  Message  msg;
+  UnitAssert(q.PopFront(msg) && (msg.Data() == "1"));
+  UnitAssert(q.PopFront(msg) && (msg.Data() == "3"));
+
+  //  An urgent lane full of urgent messages drops the oldest of them.
+  UnitAssert(q.PushBack(MakeMessage(Severity::err, "4")));
+  UnitAssert(q.PushBack(MakeMessage(Severity::crit, "5")));
+  UnitAssert(! q.PushBack(MakeMessage(Severity::debug, "6")));
+  UnitAssert(q.PushBack(MakeMessage(Severity::alert, "7")));
+  UnitAssert(q.PopFront(msg) && (msg.Data() == "5"));
+  UnitAssert(q.PopFront(msg) && (msg.Data() == "7"));
+  
+  DropCounts  counts = drops.Harvest();
+  UnitAssert(3 == counts.Total());
+  UnitAssert(2 == counts.BySeverity(Severity::debug));
+  UnitAssert(1 == counts.BySeverity(Severity::err));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestDropLowestSeverity()
+{
+  DropCounters           drops;
+  BoundedQueue<Message>  q;
+  q.Configure(QueueConfig(3, OverflowPolicy::dropLowestSeverity), &drops);
+  UnitAssert(q.PushBack(MakeMessage(Severity::info, "1", "app1")));
+  UnitAssert(q.PushBack(MakeMessage(Severity::crit, "2", "app2")));
+  UnitAssert(q.PushBack(MakeMessage(Severity::info, "3", "app1")));
+  //  Evicts the oldest info message.
+  UnitAssert(q.PushBack(MakeMessage(Severity::err, "4", "app2")));
+  //  Nothing less severe than debug in the queue, so drop the new one.
+  UnitAssert(! q.PushBack(MakeMessage(Severity::debug, "5", "app3")));
+  //  Equal severity evicts the oldest with that severity.
+  UnitAssert(q.PushBack(MakeMessage(Severity::info, "6", "app1")));
+  
+  std::deque<Message>  msgs;
+  q.Swap(msgs);
+  UnitAssert(q.Empty());
+  if (UnitAssert(3 == msgs.size())) {
+    UnitAssert(msgs[0].Data() == "2");
+    UnitAssert(msgs[1].Data() == "4");
+    UnitAssert(msgs[2].Data() == "6");
+  }
+
+  DropCounts  counts = drops.Harvest();
+  UnitAssert(3 == counts.Total());
+  UnitAssert(2 == counts.BySeverity(Severity::info));
+  UnitAssert(1 == counts.BySeverity(Severity::debug));
+  UnitAssert(2 == counts.ByOrigin().at("foo.mcplex.net/app1"));
+  UnitAssert(1 == counts.ByOrigin().at("foo.mcplex.net/app3"));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestBlock()
+{
+  DropCounters           drops;
+  BoundedQueue<Message>  q;
+  QueueConfig            cfg(1, OverflowPolicy::block);
+  cfg.blockTimeout = std::chrono::milliseconds(10);
+  q.Configure(cfg, &drops);
+  UnitAssert(q.PushBack(MakeMessage(Severity::info, "1")));
+  
+  //  Times out and drops the new entry.
+  auto  start = std::chrono::steady_clock::now();
+  UnitAssert(! q.PushBack(MakeMessage(Severity::info, "2")));
+  UnitAssert((std::chrono::steady_clock::now() - start)
+             >= std::chrono::milliseconds(10));
+  
+  //  A consumer makes room while we're blocked.
+  std::thread  consumer([&] () {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    Message  msg;
+    q.PopFront(msg);
+  });
+  cfg.blockTimeout = std::chrono::seconds(5);
+  q.Configure(cfg, &drops);
+  UnitAssert(q.PushBack(MakeMessage(Severity::info, "3")));
+  consumer.join();
+
+  Message  msg;
+  UnitAssert(q.PopFront(msg) && (msg.Data() == "3"));
+  UnitAssert(1 == drops.Harvest().Total());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestReconfigure()
+{
+  DropCounters           drops;
+  BoundedQueue<Message>  q;
+  q.Configure(QueueConfig(4, OverflowPolicy::dropNewest), &drops);
+  for (int i = 0; i < 4; ++i) {
+    UnitAssert(q.PushBack(MakeMessage(Severity::info, to_string(i))));
+  }
+  q.Configure(QueueConfig(2, OverflowPolicy::dropNewest), &drops);
+  UnitAssert(2 == q.Length());
+  Message  msg;
+  UnitAssert(q.PopFront(msg) && (msg.Data() == "0"));
+  UnitAssert(2 == drops.Harvest().Total());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestDrain()
+{
+  static const vector<pair<Severity,string>>  entries = {
+    { Severity::debug,   "d0" }, { Severity::warning, "w0" },
+    { Severity::err,     "e0" }, { Severity::debug,   "d1" },
+    { Severity::err,     "e1" }, { Severity::notice,  "w1" },
+    { Severity::crit,    "e2" }, { Severity::emerg,   "e3" }
+  };
+  
+  BoundedQueue<Message>  q;
+  QueueConfig            cfg(100, OverflowPolicy::dropNewest);
+  cfg.drain = DrainPolicy::strict;
+  q.Configure(cfg, nullptr);
+  for (const auto & entry : entries) {
+    UnitAssert(q.PushBack(MakeMessage(entry.first, entry.second)));
+  }
+  UnitAssert(4 == q.LaneLength(0));
+  UnitAssert(2 == q.LaneLength(1));
+  UnitAssert(2 == q.LaneLength(2));
+  
+  std::string  order;
+  Message      msg;
+  while (q.PopFront(msg)) {
+    order += msg.Data();
+  }
+  UnitAssert(order == "e0e1e2e3w0w1d0d1");
+
+  cfg.drain = DrainPolicy::weighted;
+  cfg.weights = { 2, 1, 1 };
+  q.Configure(cfg, nullptr);
+  for (const auto & entry : entries) {
+    UnitAssert(q.PushBack(MakeMessage(entry.first, entry.second)));
+  }
+  std::deque<Message>  msgs;
+  q.Swap(msgs);
+  order.clear();
+  for (const auto & m : msgs) {
+    order += m.Data();
+  }
+  UnitAssert(order == "e0e1w0d0e2e3w1d1");
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Shedding drops matching entries from anywhere in the queue, without
+//!  disturbing the drain order of the rest.
+//----------------------------------------------------------------------------
+static void TestShed()
+{
+  static const vector<pair<Severity,string>>  entries = {
+    { Severity::debug,   "d0" }, { Severity::warning, "w0" },
+    { Severity::err,     "e0" }, { Severity::debug,   "d1" },
+    { Severity::err,     "e1" }, { Severity::notice,  "w1" },
+    { Severity::crit,    "e2" }, { Severity::emerg,   "e3" }
+  };
+
+  DropCounters           drops;
+  BoundedQueue<Message>  q;
+  QueueConfig            cfg(100, OverflowPolicy::dropNewest);
+  cfg.drain = DrainPolicy::weighted;
+  cfg.weights = { 2, 1, 1 };
+  q.Configure(cfg, &drops);
+  for (const auto & entry : entries) {
+    UnitAssert(q.PushBack(MakeMessage(entry.first, entry.second)));
+  }
+  UnitAssert(0 == q.Shed([] (Severity) { return false; }));
+  //  w1 is shed even though w0, ahead of it in its lane, is kept.
+  UnitAssert(3 == q.Shed([] (Severity sev)
+                         { return (sev >= Severity::notice); }));
+  UnitAssert(5 == q.Length());
+  DropCounts  counts = drops.Harvest();
+  UnitAssert(3 == counts.Total());
+  UnitAssert(2 == counts.BySeverity(Severity::debug));
+  UnitAssert(1 == counts.BySeverity(Severity::notice));
+
+  std::string  order;
+  Message      msg;
+  while (q.PopFront(msg)) {
+    order += msg.Data();
+  }
+  UnitAssert(order == "e0e1w0e2e3");
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestDropNewest();
+  TestDropOldest();
+  TestDropLowestSeverity();
+  TestBlock();
+  TestReconfigure();
+  TestDrain();
+  TestShed();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
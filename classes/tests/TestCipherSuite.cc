@@ -0,0 +1,198 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestCipherSuite.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::NonceSequence and MessagePacket encryption unit
+//!  tests
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sodium.h>
+}
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogCipherSuite.hh"
+#include "DwmMclogMessagePacket.hh"
+
+using namespace std;
+using Dwm::Mclog::CipherSuite, Dwm::Mclog::CipherSuiteBit,
+      Dwm::Mclog::BestCipherSuite, Dwm::Mclog::LocalCipherSuites,
+      Dwm::Mclog::MessagePacket, Dwm::Mclog::NonceSequence;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestNonceSequence()
+{
+  NonceSequence  nonces(CipherSuite::aes256gcm);
+  uint8_t        hdr1[NonceSequence::k_headerLen];
+  uint8_t        hdr2[NonceSequence::k_headerLen];
+  nonces.Next(hdr1);
+  nonces.Suite(CipherSuite::xchacha20poly1305);
+  nonces.Next(hdr2);
+
+  CipherSuite  suite;
+  string       prefix1, prefix2;
+  uint64_t     counter1, counter2;
+  UnitAssert(NonceSequence::Parse(hdr1, suite, prefix1, counter1));
+  UnitAssert(CipherSuite::aes256gcm == suite);
+  UnitAssert(NonceSequence::Parse(hdr2, suite, prefix2, counter2));
+  UnitAssert(CipherSuite::xchacha20poly1305 == suite);
+  UnitAssert(prefix1 == prefix2);
+  UnitAssert(prefix1.size() == NonceSequence::k_prefixLen);
+  UnitAssert((counter1 + 1) == counter2);
+
+  //  Another sequence has a different prefix.
+  NonceSequence  other;
+  other.Next(hdr2);
+  UnitAssert(NonceSequence::Parse(hdr2, suite, prefix2, counter2));
+  UnitAssert(prefix1 != prefix2);
+
+  //  The compressed and summary flags don't change the suite.
+  hdr1[NonceSequence::k_suiteOffset] |= NonceSequence::k_compressedFlag;
+  UnitAssert(NonceSequence::Parse(hdr1, suite, prefix1, counter1));
+  UnitAssert(CipherSuite::aes256gcm == suite);
+  hdr1[NonceSequence::k_suiteOffset] |= NonceSequence::k_summaryFlag;
+  UnitAssert(NonceSequence::Parse(hdr1, suite, prefix1, counter1));
+  UnitAssert(CipherSuite::aes256gcm == suite);
+  
+  memset(hdr1, 0, sizeof(hdr1));
+  UnitAssert(! NonceSequence::Parse(hdr1, suite, prefix1, counter1));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestSuiteSelection()
+{
+  uint8_t  chacha = CipherSuiteBit(CipherSuite::xchacha20poly1305);
+  uint8_t  aes = CipherSuiteBit(CipherSuite::aes256gcm);
+  UnitAssert(LocalCipherSuites() & chacha);
+  UnitAssert(BestCipherSuite(chacha) == CipherSuite::xchacha20poly1305);
+  UnitAssert(BestCipherSuite(chacha | aes) == CipherSuite::aes256gcm);
+  UnitAssert(BestCipherSuite(0) == CipherSuite::xchacha20poly1305);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestRoundTrip(CipherSuite suite)
+{
+  string  key(crypto_aead_xchacha20poly1305_ietf_KEYBYTES, '\0');
+  randombytes_buf(key.data(), key.size());
+  NonceSequence  nonces(suite);
+  
+  vector<char>   buf(512);
+  MessagePacket  pkt(buf.data(), buf.size());
+  UnitAssert(pkt.Add(string("hello")));
+  size_t  len = pkt.Length();
+  UnitAssert(pkt.Encrypt(key, nonces));
+
+  //  Decrypt a copy, since decryption is in place.
+  vector<char>   rbuf(buf.begin(), buf.begin() + len);
+  MessagePacket  rpkt(rbuf.data(), rbuf.size());
+  UnitAssert(rpkt.Decrypt(len, key) == (ssize_t)len);
+  string  s;
+  UnitAssert(Dwm::StreamIO::Read(rpkt.Payload(), s));
+  UnitAssert("hello" == s);
+  string    prefix;
+  uint64_t  counter;
+  UnitAssert(rpkt.Sequence(prefix, counter));
+  UnitAssert(0 == counter);
+
+  //  Every byte of the nonce header is authenticated, even the ones
+  //  AES-256-GCM doesn't use as its nonce.
+  for (size_t i = 0; i < NonceSequence::k_headerLen; ++i) {
+    vector<char>  tbuf(buf.begin(), buf.begin() + len);
+    tbuf[i] ^= 0x10;
+    MessagePacket  tpkt(tbuf.data(), tbuf.size());
+    UnitAssert(tpkt.Decrypt(len, key) < 0);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Packets from senders that use a random nonce must still decrypt.
+//----------------------------------------------------------------------------
+static void TestLegacyNonce()
+{
+  string  key(crypto_aead_xchacha20poly1305_ietf_KEYBYTES, '\0');
+  randombytes_buf(key.data(), key.size());
+  vector<char>   buf(512);
+  MessagePacket  pkt(buf.data(), buf.size());
+  UnitAssert(pkt.Add(string("legacy")));
+  size_t  len = pkt.Length();
+  UnitAssert(pkt.Encrypt(key));
+  MessagePacket  rpkt(buf.data(), buf.size());
+  UnitAssert(rpkt.Decrypt(len, key) == (ssize_t)len);
+  string  s;
+  UnitAssert(Dwm::StreamIO::Read(rpkt.Payload(), s));
+  UnitAssert("legacy" == s);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  if (UnitAssert(sodium_init() >= 0)) {
+    TestNonceSequence();
+    TestSuiteSelection();
+    TestRoundTrip(CipherSuite::xchacha20poly1305);
+    if (LocalCipherSuites() & CipherSuiteBit(CipherSuite::aes256gcm)) {
+      TestRoundTrip(CipherSuite::aes256gcm);
+    }
+    TestLegacyNonce();
+  }
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
@@ -0,0 +1,225 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestCompressionPool.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::CompressionPool unit tests
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/stat.h>
+  #include <bzlib.h>
+  #include <zlib.h>
+}
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogCompressionPool.hh"
+
+using namespace std;
+using Dwm::Mclog::CompressionPool;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static string WriteFile(const string & path, size_t lines)
+{
+  ostringstream  os;
+  for (size_t i = 0; i < lines; ++i) {
+    os << "line " << i << " of a rolled log file\n";
+  }
+  ofstream  ofs(path);
+  ofs << os.str();
+  ofs.close();
+  chmod(path.c_str(), 0640);
+  return os.str();
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static string Bunzip2(const string & path)
+{
+  string  s;
+  FILE  *f = fopen(path.c_str(), "rb");
+  if (f) {
+    int      bzerr = BZ_OK;
+    BZFILE  *bzf = BZ2_bzReadOpen(&bzerr, f, 0, 0, nullptr, 0);
+    char     buf[4096];
+    while (BZ_OK == bzerr) {
+      int  n = BZ2_bzRead(&bzerr, bzf, buf, sizeof(buf));
+      if (n > 0) {
+        s.append(buf, n);
+      }
+    }
+    BZ2_bzReadClose(&bzerr, bzf);
+    fclose(f);
+  }
+  return s;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static string Gunzip(const string & path)
+{
+  string  s;
+  gzFile  gzf = gzopen(path.c_str(), "rb");
+  if (gzf) {
+    char  buf[4096];
+    int   n;
+    while ((n = gzread(gzf, buf, sizeof(buf))) > 0) {
+      s.append(buf, n);
+    }
+    gzclose(gzf);
+  }
+  return s;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestCompress()
+{
+  namespace fs = std::filesystem;
+  
+  UnitAssert("bz2" == CompressionPool::Extension("bzip2"));
+  UnitAssert("gz" == CompressionPool::Extension("gzip"));
+  UnitAssert("bz2" == CompressionPool::Extension("zip"));
+  UnitAssert(! CompressionPool::Supported("zip"));
+  
+  const string  path("./TestCompressionPool1_log.0");
+  string  contents = WriteFile(path, 1000);
+  uint64_t  bytesIn = 0, bytesOut = 0;
+  UnitAssert(CompressionPool::Compress(path, "bzip2", bytesIn, bytesOut));
+  UnitAssert(! fs::exists(path));
+  UnitAssert(! fs::exists(path + ".bz2.tmp"));
+  UnitAssert(contents.size() == bytesIn);
+  UnitAssert(fs::file_size(path + ".bz2") == bytesOut);
+  UnitAssert(bytesOut < bytesIn);
+  UnitAssert(contents == Bunzip2(path + ".bz2"));
+  auto  perms = fs::status(path + ".bz2").permissions();
+  UnitAssert(fs::perms::none == (perms & fs::perms::others_read));
+  std::remove((path + ".bz2").c_str());
+
+  contents = WriteFile(path, 1000);
+  UnitAssert(CompressionPool::Compress(path, "gzip", bytesIn, bytesOut));
+  UnitAssert(! fs::exists(path));
+  UnitAssert(contents == Gunzip(path + ".gz"));
+  std::remove((path + ".gz").c_str());
+
+  //  A missing file fails without leaving anything behind.
+  UnitAssert(! CompressionPool::Compress(path, "gzip", bytesIn, bytesOut));
+  UnitAssert(! fs::exists(path + ".gz.tmp"));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestPool()
+{
+  namespace fs = std::filesystem;
+  
+  CompressionPool  pool;
+  UnitAssert(! pool.Running());
+
+  //  Without workers, files are compressed by Submit().
+  const string  path0("./TestCompressionPool2_log.0");
+  WriteFile(path0, 100);
+  UnitAssert(pool.Submit(path0, "gzip"));
+  UnitAssert(fs::exists(path0 + ".gz"));
+  std::remove((path0 + ".gz").c_str());
+  
+  UnitAssert(pool.Start(2, 5));
+  UnitAssert(! pool.Start(2, 5));
+  UnitAssert(pool.Running());
+  UnitAssert(2 == pool.Threads());
+  UnitAssert(5 == pool.Niceness());
+
+  vector<string>  paths;
+  for (int i = 0; i < 8; ++i) {
+    paths.push_back("./TestCompressionPool2_log." + to_string(i));
+    WriteFile(paths.back(), 500);
+    UnitAssert(pool.Submit(paths.back(), "bzip2"));
+  }
+  pool.Wait(paths.back());
+  UnitAssert(fs::exists(paths.back() + ".bz2"));
+  UnitAssert(pool.Submit("./TestCompressionPool2_missing", "bzip2"));
+  pool.WaitAll();
+  for (const auto & path : paths) {
+    UnitAssert(! fs::exists(path));
+    UnitAssert(fs::exists(path + ".bz2"));
+    std::remove((path + ".bz2").c_str());
+  }
+  auto  counts = pool.Harvest();
+  UnitAssert(9 == counts.completed);
+  UnitAssert(1 == counts.failed);
+  UnitAssert(counts.bytesOut < counts.bytesIn);
+  UnitAssert(pool.Harvest().Empty());
+
+  //  Stop() finishes queued files.
+  WriteFile(path0, 100);
+  UnitAssert(pool.Submit(path0, "gzip"));
+  pool.Stop();
+  UnitAssert(! pool.Running());
+  UnitAssert(fs::exists(path0 + ".gz"));
+  std::remove((path0 + ".gz").c_str());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestCompress();
+  TestPool();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
@@ -62,8 +62,38 @@ int main(int argc, char *argv[])
     UnitAssert(cfg.mcast.outFilter
                == "(" + cfg.filters["mydaemons"] + ") || ("
                + cfg.filters["myapps"] + ")");
+    UnitAssert(cfg.mcast.batching.MaxDelay()
+               == std::chrono::microseconds(2000));
+    UnitAssert(cfg.mcast.batching.FlushSeverity()
+               == Dwm::Mclog::Severity::warning);
+    UnitAssert(cfg.mcast.batching.FlushNow(Dwm::Mclog::Severity::err));
+    UnitAssert(! cfg.mcast.batching.FlushNow(Dwm::Mclog::Severity::notice));
+    UnitAssert(2000 == cfg.mcast.pacing.PacketRate());
+    UnitAssert(10000000 == cfg.mcast.pacing.ByteRate());
+    UnitAssert(64 == cfg.mcast.pacing.Burst());
+    UnitAssert(cfg.mcast.pacing.Shed(Dwm::Mclog::Severity::info));
+    UnitAssert(! cfg.mcast.pacing.Shed(Dwm::Mclog::Severity::notice));
+    UnitAssert(0 == cfg.mcast.packetSize);
+    UnitAssert(4 == cfg.mcast.receiveThreads);
+    UnitAssert(4 == cfg.mcast.ReceiveThreads());
+    UnitAssert(16 == cfg.mcast.fecData);
+    UnitAssert(2 == cfg.mcast.fecParity);
+    UnitAssert("zstd" == cfg.mcast.compress);
+    UnitAssert("/usr/local/etc/mclogd/mclog.dict" == cfg.mcast.dictionary);
+    if (UnitAssert(2 == cfg.mcast.channels.size())) {
+      UnitAssert("debug" == cfg.mcast.channels[0].name);
+      UnitAssert("severity = debug" == cfg.mcast.channels[0].filter);
+      UnitAssert(cfg.mcast.channels[0].groupAddr
+                 == Dwm::Ipv4Address("239.108.111.104"));
+      UnitAssert(cfg.mcast.channels[0].groupAddr6
+                 == Dwm::Ipv6Address("ff02::006d:636c:6f68"));
+      UnitAssert("mcblock" == cfg.mcast.channels[1].name);
+      UnitAssert(cfg.mcast.channels[1].groupAddr6 == Dwm::Ipv6Address());
+    }
   
     UnitAssert(cfg.files.logDirectory == "/usr/local/var/logs");
+    UnitAssert(4 == cfg.files.compressThreads);
+    UnitAssert(15 == cfg.files.compressNice);
     UnitAssert(false == cfg.loopback.ListenIpv4());
     UnitAssert(true == cfg.loopback.ListenIpv6());
     UnitAssert(3737 == cfg.loopback.port);
@@ -80,6 +110,40 @@ int main(int argc, char *argv[])
       UnitAssert(cfg.files.logs[0].size == 10000000);
       UnitAssert(cfg.files.logs[1].filter == "(ident = /mcblock|mccurtain|mcrover|mctally|qmcrover/) && (host = /.+\\.(mcplex\\.net|rfdm\\.com)/)");
       UnitAssert(cfg.files.logs[1].pathPattern == "%H/myapps");
+      UnitAssert(cfg.files.logs[0].flush.PerBatch());
+      UnitAssert(! cfg.files.logs[0].flush.Sync());
+      UnitAssert(std::chrono::milliseconds(250)
+                 == cfg.files.logs[1].flush.Interval());
+      UnitAssert(65536 == cfg.files.logs[1].flush.Bytes());
+      UnitAssert(cfg.files.logs[1].flush.Sync());
+    }
+
+    using Dwm::Mclog::DrainPolicy, Dwm::Mclog::OverflowPolicy;
+    UnitAssert(60 == cfg.queues.reportInterval);
+    UnitAssert(5000 == cfg.queues.files.capacity);
+    UnitAssert(OverflowPolicy::dropOldest == cfg.queues.files.overflow);
+    UnitAssert(1000 == cfg.queues.multicast.capacity);
+    UnitAssert(OverflowPolicy::dropLowestSeverity
+               == cfg.queues.multicast.overflow);
+    UnitAssert(DrainPolicy::strict == cfg.queues.multicast.drain);
+    UnitAssert((std::array<uint32_t,3>{ 16, 4, 1 })
+               == cfg.queues.multicast.weights);
+    UnitAssert(DrainPolicy::weighted == cfg.queues.files.drain);
+    UnitAssert(75 == cfg.queues.files.sampleThreshold);
+    UnitAssert(0 == cfg.queues.multicast.sampleThreshold);
+    UnitAssert(100 == cfg.queues.backlog.capacity);
+    UnitAssert(OverflowPolicy::block == cfg.queues.backlog.overflow);
+    UnitAssert(std::chrono::milliseconds(50)
+               == cfg.queues.backlog.blockTimeout);
+
+    if (UnitAssert(2 == cfg.quotas.size())) {
+      UnitAssert(cfg.quotas[0].filter.find("mcblock") != string::npos);
+      UnitAssert(10 == cfg.quotas[0].rate);
+      UnitAssert(100 == cfg.quotas[0].Burst());
+      UnitAssert("severity = debug" == cfg.quotas[1].filter);
+      UnitAssert(50 == cfg.quotas[1].rate);
+      UnitAssert(0 == cfg.quotas[1].burst);
+      UnitAssert(50 == cfg.quotas[1].Burst());
     }
   }
 
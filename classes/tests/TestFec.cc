@@ -0,0 +1,238 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestFec.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::FecEncoder and Dwm::Mclog::FecDecoder unit tests
+//---------------------------------------------------------------------------
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogCipherSuite.hh"
+#include "DwmMclogFec.hh"
+
+using namespace std;
+using Dwm::Mclog::FecDecoder, Dwm::Mclog::FecEncoder,
+      Dwm::Mclog::FecParityHeader, Dwm::Mclog::NonceSequence;
+
+//----------------------------------------------------------------------------
+//!  Returns @c n fake encrypted packets of varying lengths, with nonce
+//!  headers from @c nonces.
+//----------------------------------------------------------------------------
+static vector<string> Packets(NonceSequence & nonces, size_t n)
+{
+  vector<string>  rc;
+  for (size_t i = 0; i < n; ++i) {
+    string  pkt(NonceSequence::k_headerLen, '\0');
+    nonces.Next((uint8_t *)pkt.data());
+    for (size_t j = 0; j < (40 + ((i * 37) % 100)); ++j) {
+      pkt.push_back((char)((i * 31) + j));
+    }
+    rc.push_back(pkt);
+  }
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  Encodes @c data, then decodes it with the packets whose indices are
+//!  in @c lost missing.  Returns the number of packets rebuilt, all of
+//!  which must match the originals.
+//----------------------------------------------------------------------------
+static size_t RoundTrip(const vector<string> & data, size_t k, size_t m,
+                        const set<size_t> & lost)
+{
+  FecEncoder      encoder(k, m);
+  FecDecoder      decoder;
+  vector<string>  parity, recovered;
+  size_t          rc = 0;
+  for (size_t i = 0; i < data.size(); ++i) {
+    parity.clear();
+    encoder.Add(data[i].data(), data[i].size(), parity);
+    if (lost.find(i) == lost.end()) {
+      decoder.AddData(string(data[i]), recovered);
+    }
+    for (const auto & p : parity) {
+      UnitAssert(FecParityHeader::IsParity(p.data(), p.size()));
+      decoder.AddParity(p.data(), p.size(), recovered);
+    }
+  }
+  parity.clear();
+  encoder.Flush(parity);
+  for (const auto & p : parity) {
+    decoder.AddParity(p.data(), p.size(), recovered);
+  }
+  for (const auto & pkt : recovered) {
+    bool  found = false;
+    for (size_t i : lost) {
+      if (data[i] == pkt) {
+        found = true;
+      }
+    }
+    UnitAssert(found);
+    ++rc;
+  }
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestEncoder()
+{
+  NonceSequence   nonces;
+  auto            data = Packets(nonces, 10);
+  FecEncoder      disabled;
+  vector<string>  parity;
+  UnitAssert(! disabled.Enabled());
+  UnitAssert(0 == disabled.Add(data[0].data(), data[0].size(), parity));
+
+  FecEncoder  encoder(4, 2);
+  UnitAssert(encoder.Enabled());
+  for (size_t i = 0; i < 3; ++i) {
+    UnitAssert(0 == encoder.Add(data[i].data(), data[i].size(), parity));
+  }
+  UnitAssert(encoder.Pending());
+  UnitAssert(2 == encoder.Add(data[3].data(), data[3].size(), parity));
+  UnitAssert(! encoder.Pending());
+
+  FecParityHeader  hdr;
+  UnitAssert(hdr.Parse(parity[1].data(), parity[1].size()));
+  UnitAssert((4 == hdr.numData) && (2 == hdr.numParity) && (1 == hdr.index));
+  UnitAssert(0 == hdr.first);
+  UnitAssert(hdr.Covers(1) && hdr.Covers(3));
+  UnitAssert(! (hdr.Covers(0) || hdr.Covers(2) || hdr.Covers(5)));
+  UnitAssert(parity[1].size()
+             == (FecParityHeader::k_len
+                 + max(data[1].size(), data[3].size())));
+  
+  //  A partial block gets parity when flushed.
+  parity.clear();
+  UnitAssert(0 == encoder.Add(data[4].data(), data[4].size(), parity));
+  UnitAssert(1 == encoder.Flush(parity));
+  UnitAssert(hdr.Parse(parity[0].data(), parity[0].size()));
+  UnitAssert((1 == hdr.numData) && (4 == hdr.first));
+  UnitAssert(0 == encoder.Flush(parity));
+
+  //  Not a parity packet.
+  UnitAssert(! hdr.Parse(data[0].data(), data[0].size()));
+  UnitAssert(! FecParityHeader::IsParity(data[0].data(), data[0].size()));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestRecovery()
+{
+  NonceSequence  nonces;
+  auto           data = Packets(nonces, 40);
+
+  UnitAssert(0 == RoundTrip(data, 8, 1, {}));
+  //  One loss per parity group is recoverable.
+  UnitAssert(1 == RoundTrip(data, 8, 1, {3}));
+  UnitAssert(5 == RoundTrip(data, 8, 1, {0, 15, 16, 31, 39}));
+  //  Two losses in one group aren't.
+  UnitAssert(0 == RoundTrip(data, 8, 1, {2, 5}));
+  //  With 4 interleaved parity packets, a burst of 4 is.
+  UnitAssert(4 == RoundTrip(data, 8, 4, {10, 11, 12, 13}));
+  UnitAssert(0 == RoundTrip(data, 8, 4, {10, 14}));
+  //  Losses in the partial block at the end.
+  UnitAssert(2 == RoundTrip(data, 16, 2, {36, 37}));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestLateData()
+{
+  NonceSequence   nonces;
+  auto            data = Packets(nonces, 4);
+  FecEncoder      encoder(4, 1);
+  FecDecoder      decoder;
+  vector<string>  parity, recovered;
+  for (const auto & pkt : data) {
+    encoder.Add(pkt.data(), pkt.size(), parity);
+  }
+  UnitAssert(1 == parity.size());
+  UnitAssert(! decoder.Active());
+  decoder.AddData(string(data[0]), recovered);
+  decoder.AddData(string(data[1]), recovered);
+  //  Two missing, so the parity is held...
+  UnitAssert(0 == decoder.AddParity(parity[0].data(), parity[0].size(),
+                                    recovered));
+  UnitAssert(decoder.Active());
+  UnitAssert(4 == decoder.BlockSize());
+  //  ... until a reordered packet arrives.
+  UnitAssert(1 == decoder.AddData(string(data[3]), recovered));
+  UnitAssert((1 == recovered.size()) && (data[2] == recovered[0]));
+  UnitAssert(0 == decoder.AddData(string(data[2]), recovered));
+
+  //  Corrupt parity doesn't rebuild anything useful.
+  FecDecoder  decoder2;
+  recovered.clear();
+  string  bad(parity[0]);
+  bad[FecParityHeader::k_len - 1] ^= 0x7F;   // length
+  decoder2.AddData(string(data[0]), recovered);
+  decoder2.AddData(string(data[1]), recovered);
+  decoder2.AddData(string(data[2]), recovered);
+  decoder2.AddParity(bad.data(), bad.size(), recovered);
+  UnitAssert(recovered.empty() || (recovered[0] != data[3]));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestEncoder();
+  TestRecovery();
+  TestLateData();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
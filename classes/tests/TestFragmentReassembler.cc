@@ -0,0 +1,215 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestFragmentReassembler.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::MessageFragment and FragmentReassembler unit tests
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/socket.h>
+  #include <netinet/in.h>
+  #include <unistd.h>
+}
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogFragmentReassembler.hh"
+#include "DwmMclogPacketBatch.hh"
+
+using namespace std;
+using Dwm::Mclog::FragmentReassembler, Dwm::Mclog::Message,
+      Dwm::Mclog::MessageFragment, Dwm::Mclog::MessageHeader,
+      Dwm::Mclog::MessageOrigin, Dwm::Mclog::MessagePacket,
+      Dwm::Mclog::PacketBatch, Dwm::Mclog::Severity, Dwm::Mclog::UdpEndpoint;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static Message MakeMessage(size_t len, char c)
+{
+  MessageOrigin  origin("foo.mcplex.net", "app1", 1234);
+  MessageHeader  header(Dwm::Mclog::Facility::user, Severity::info, origin);
+  return Message(header, string(len, c));
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestSplit()
+{
+  Message  msg = MakeMessage(1400, 'a');
+  vector<MessageFragment>  frags;
+  UnitAssert(MessageFragment::Split(msg, 7, 400, frags));
+  UnitAssert(frags.size() > 3);
+  for (size_t i = 0; i < frags.size(); ++i) {
+    UnitAssert(frags[i].Id() == 7);
+    UnitAssert(frags[i].Index() == i);
+    UnitAssert(frags[i].Count() == frags.size());
+    UnitAssert(frags[i].StreamedLength() <= 400);
+  }
+
+  //  Fragments survive a round trip, and aren't mistaken for messages.
+  ostringstream  os;
+  UnitAssert(frags[1].Write(os));
+  istringstream  is(os.str());
+  MessageFragment  frag;
+  UnitAssert(frag.Read(is));
+  UnitAssert(frag.Data() == frags[1].Data());
+  is.clear();
+  is.seekg(0);
+  Message  msg2;
+  UnitAssert(! msg2.Read(is));
+
+  //  Too small to hold any data.
+  frags.clear();
+  UnitAssert(! MessageFragment::Split(msg, 1, 10, frags));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestReassemble()
+{
+  Message  msg = MakeMessage(1400, 'b');
+  vector<MessageFragment>  frags;
+  UnitAssert(MessageFragment::Split(msg, 42, 300, frags));
+
+  //  Out of order, with a duplicate.
+  FragmentReassembler  reassembler;
+  Message              out;
+  std::reverse(frags.begin(), frags.end());
+  UnitAssert(! reassembler.Add("src1", MessageFragment(frags[0]), out));
+  UnitAssert(! reassembler.Add("src1", MessageFragment(frags[0]), out));
+  UnitAssert(1 == reassembler.Pending());
+  for (size_t i = 1; i < frags.size() - 1; ++i) {
+    UnitAssert(! reassembler.Add("src1", MessageFragment(frags[i]), out));
+  }
+  //  Same ID from a different source is a different message.
+  UnitAssert(! reassembler.Add("src2", MessageFragment(frags.back()), out));
+  UnitAssert(2 == reassembler.Pending());
+  UnitAssert(reassembler.Add("src1", MessageFragment(frags.back()), out));
+  UnitAssert(out.Data() == msg.Data());
+  UnitAssert(1 == reassembler.Pending());
+  UnitAssert(0 == reassembler.Discarded());
+
+  //  Pending partial messages are bounded.
+  for (uint32_t id = 100; id < 100 + FragmentReassembler::k_maxPending; ++id) {
+    reassembler.Add("src3", MessageFragment(id, 0, 2, "x"), out);
+  }
+  UnitAssert(FragmentReassembler::k_maxPending == reassembler.Pending());
+  UnitAssert(1 == reassembler.Discarded());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestPacketBatch()
+{
+  int  rfd = socket(PF_INET, SOCK_DGRAM, 0);
+  int  sfd = socket(PF_INET, SOCK_DGRAM, 0);
+  if (! (UnitAssert(0 <= rfd) && UnitAssert(0 <= sfd))) {
+    return;
+  }
+  sockaddr_in  addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = PF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  socklen_t  addrLen = sizeof(addr);
+  UnitAssert(0 == ::bind(rfd, (sockaddr *)&addr, sizeof(addr)));
+  UnitAssert(0 == getsockname(rfd, (sockaddr *)&addr, &addrLen));
+
+  PacketBatch  batch(MessagePacket::k_minSendPacketLen);
+  Message      small = MakeMessage(50, 's');
+  Message      big = MakeMessage(1400, 'B');
+  UnitAssert(batch.Add(small));
+  UnitAssert(batch.Add(big));
+  UnitAssert(batch.Add(small));
+  size_t  numPackets = batch.NumPackets();
+  UnitAssert(numPackets > 3);
+  UnitAssert(batch.SendTo(sfd, UdpEndpoint(addr)) == numPackets);
+
+  //  Read the packets as a receiver would.
+  FragmentReassembler  reassembler;
+  vector<string>       received;
+  vector<char>         buf(MessagePacket::k_maxPacketLen);
+  Message              msg;
+  for (size_t i = 0; i < numPackets; ++i) {
+    MessagePacket  pkt(buf.data(), buf.size());
+    sockaddr_in    src;
+    if (UnitAssert(pkt.RecvFrom(rfd, &src) > 0)) {
+      while (reassembler.NextMessage(pkt.Payload(), "src", msg)) {
+        received.push_back(msg.Data());
+      }
+    }
+  }
+  if (UnitAssert(3 == received.size())) {
+    UnitAssert(received[0] == small.Data());
+    UnitAssert(received[1] == big.Data());
+    UnitAssert(received[2] == small.Data());
+  }
+  UnitAssert(0 == reassembler.Pending());
+  ::close(sfd);
+  ::close(rfd);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestSplit();
+  TestReassemble();
+  TestPacketBatch();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
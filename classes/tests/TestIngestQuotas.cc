@@ -0,0 +1,145 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestIngestQuotas.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::IngestQuotas unit tests
+//---------------------------------------------------------------------------
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogIngestQuotas.hh"
+
+using namespace std;
+using Dwm::Mclog::Facility, Dwm::Mclog::IngestQuotas, Dwm::Mclog::Message,
+      Dwm::Mclog::MessageHeader, Dwm::Mclog::MessageOrigin,
+      Dwm::Mclog::QuotaConfig, Dwm::Mclog::Severity;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static Message TestMessage(const char *host, const char *app, Severity sev)
+{
+  MessageOrigin  origin(host, app, 1234);
+  return Message(MessageHeader(Facility::user, sev, origin), "test");
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestNoQuotas()
+{
+  IngestQuotas  quotas;
+  Message       msg = TestMessage("host1", "app1", Severity::debug);
+  for (int i = 0; i < 1000; ++i) {
+    UnitAssert(quotas.Admit(msg));
+  }
+  auto  talkers = quotas.Harvest();
+  if (UnitAssert(1 == talkers.size())) {
+    UnitAssert("host1/app1" == talkers[0].origin);
+    UnitAssert(1000 == talkers[0].admitted);
+    UnitAssert(0 == talkers[0].suppressed);
+  }
+  UnitAssert(quotas.Harvest().empty());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestPerOrigin()
+{
+  QuotaConfig  qc;
+  qc.filter = "severity < err";
+  qc.rate = 1;
+  qc.burst = 5;
+  IngestQuotas  quotas;
+  quotas.Configure({ qc });
+
+  //  Each origin gets its own burst.
+  Message  info1 = TestMessage("host1", "app1", Severity::info);
+  Message  info2 = TestMessage("host1", "app2", Severity::info);
+  int  admitted1 = 0, admitted2 = 0;
+  for (int i = 0; i < 20; ++i) {
+    admitted1 += quotas.Admit(info1);
+  }
+  for (int i = 0; i < 10; ++i) {
+    admitted2 += quotas.Admit(info2);
+  }
+  UnitAssert(5 == admitted1);
+  UnitAssert(5 == admitted2);
+
+  //  Messages that pass no quota's filter aren't limited.
+  Message  err1 = TestMessage("host1", "app1", Severity::err);
+  for (int i = 0; i < 10; ++i) {
+    UnitAssert(quotas.Admit(err1));
+  }
+
+  auto  talkers = quotas.Harvest();
+  if (UnitAssert(2 == talkers.size())) {
+    UnitAssert("host1/app1" == talkers[0].origin);
+    UnitAssert(15 == talkers[0].admitted);
+    UnitAssert(15 == talkers[0].suppressed);
+    UnitAssert("host1/app2" == talkers[1].origin);
+    UnitAssert(5 == talkers[1].admitted);
+    UnitAssert(5 == talkers[1].suppressed);
+  }
+
+  //  Reconfiguring refills the buckets.
+  qc.burst = 0;
+  quotas.Configure({ qc });
+  UnitAssert(quotas.Admit(info1));
+  UnitAssert(! quotas.Admit(info1));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestNoQuotas();
+  TestPerOrigin();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
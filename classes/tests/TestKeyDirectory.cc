@@ -0,0 +1,124 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestKeyDirectory.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::KeyDirectory unit tests
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <unistd.h>
+}
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogKeyDirectory.hh"
+
+using namespace std;
+using Dwm::Mclog::KeyDirectory;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestExpandedPath()
+{
+  const char  *home = getenv("HOME");
+  if (nullptr != home) {
+    UnitAssert(KeyDirectory::ExpandedPath("~/.credence")
+               == (string(home) + "/.credence"));
+  }
+  UnitAssert(KeyDirectory::ExpandedPath("/usr/local/etc/mclogd")
+             == "/usr/local/etc/mclogd");
+  UnitAssert(KeyDirectory::ExpandedPath("").empty());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestReload(const string & dir)
+{
+  auto  keys1 = KeyDirectory::Get(dir);
+  UnitAssert(keys1);
+  UnitAssert(! keys1->HaveMyKeys());
+  UnitAssert(keys1->FindKnownKey("someone@somewhere").empty());
+  UnitAssert(KeyDirectory::Get(dir) == keys1);
+
+  //  Files other than the key files don't cause a reload.
+  string  otherPath = dir + "/mcast_keys";
+  ofstream(otherPath) << "x";
+  this_thread::sleep_for(chrono::milliseconds(1100));
+  UnitAssert(KeyDirectory::Get(dir) == keys1);
+
+  //  Changing known_keys does.
+  string  knownKeysPath = dir + "/known_keys";
+  ofstream(knownKeysPath) << "\n";
+  this_thread::sleep_for(chrono::milliseconds(1100));
+  auto  keys2 = KeyDirectory::Get(dir);
+  UnitAssert(keys2 != keys1);
+  UnitAssert(KeyDirectory::Get(dir) == keys2);
+  
+  unlink(otherPath.c_str());
+  unlink(knownKeysPath.c_str());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestExpandedPath();
+  char  dirTemplate[] = "/tmp/TestKeyDirectory.XXXXXX";
+  if (UnitAssert(nullptr != mkdtemp(dirTemplate))) {
+    TestReload(dirTemplate);
+    rmdir(dirTemplate);
+  }
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
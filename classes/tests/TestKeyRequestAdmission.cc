@@ -0,0 +1,222 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestKeyRequestAdmission.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::KeyRequestAdmission unit tests
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <arpa/inet.h>
+  #include <sodium.h>
+}
+
+#include <cstring>
+#include <spanstream>
+#include <sstream>
+
+#include "DwmCredenceShortString.hh"
+#include "DwmStreamIO.hh"
+#include "DwmUnitAssert.hh"
+#include "DwmMclogKeyRequestAdmission.hh"
+
+using namespace std;
+using Dwm::Mclog::KeyRequestAdmission, Dwm::Mclog::UdpEndpoint;
+using Verdict = KeyRequestAdmission::Verdict;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static UdpEndpoint Endpoint(const char *addr, uint16_t port)
+{
+  sockaddr_in  sockAddr;
+  memset(&sockAddr, 0, sizeof(sockAddr));
+  sockAddr.sin_family = AF_INET;
+  sockAddr.sin_port = htons(port);
+  inet_pton(AF_INET, addr, &sockAddr.sin_addr);
+  return UdpEndpoint(sockAddr);
+}
+
+//----------------------------------------------------------------------------
+//!  Returns a client's first (or, with @c cookie, second) handshake
+//!  packet.
+//----------------------------------------------------------------------------
+static string KXPacket(char fill, const string & cookie = string())
+{
+  ostringstream  os;
+  Dwm::StreamIO::Write(os, Dwm::Credence::ShortString<255>(string(32, fill)));
+  if (! cookie.empty()) {
+    Dwm::StreamIO::Write(os, Dwm::Credence::ShortString<255>(cookie));
+  }
+  return os.str();
+}
+
+//----------------------------------------------------------------------------
+//!  Sends @c pkt from @c src through @c admission and, if a cookie reply
+//!  comes back, extracts the cookie into @c cookie.
+//----------------------------------------------------------------------------
+static Verdict Admit(KeyRequestAdmission & admission, const UdpEndpoint & src,
+                     const string & pkt, size_t active, string & cookie)
+{
+  string   reply;
+  Verdict  verdict = admission.Admit(src, pkt.data(), pkt.size(), active,
+                                     reply);
+  if (Verdict::e_sendCookie == verdict) {
+    //  Never amplify.
+    UnitAssert(reply.size() < pkt.size());
+    ispanstream  is{span{reply.data(),reply.size()}};
+    Dwm::Credence::ShortString<255>  value;
+    UnitAssert(Dwm::StreamIO::Read(is, value));
+    UnitAssert(KeyRequestAdmission::IsCookieReply(value.Value(), cookie));
+  }
+  return verdict;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestCookie()
+{
+  KeyRequestAdmission  admission;
+  UdpEndpoint  client = Endpoint("192.168.1.10", 4000);
+  string       cookie;
+  UnitAssert(Admit(admission, client, KXPacket('a'), 0, cookie)
+             == Verdict::e_sendCookie);
+  UnitAssert(cookie.size() == KeyRequestAdmission::k_cookieLen);
+
+  //  The cookie is bound to the address, port and KX key.
+  string  unused;
+  UnitAssert(Admit(admission, Endpoint("192.168.1.11", 4000),
+                   KXPacket('a', cookie), 0, unused)
+             == Verdict::e_sendCookie);
+  UnitAssert(Admit(admission, Endpoint("192.168.1.10", 4001),
+                   KXPacket('a', cookie), 0, unused)
+             == Verdict::e_sendCookie);
+  UnitAssert(Admit(admission, client, KXPacket('b', cookie), 0, unused)
+             == Verdict::e_sendCookie);
+  UnitAssert(Admit(admission, client, KXPacket('a', cookie), 0, unused)
+             == Verdict::e_admit);
+
+  //  Garbage and wrong-sized keys are dropped without a reply.
+  string  garbage("\x01", 1);
+  UnitAssert(Admit(admission, client, garbage, 0, unused) == Verdict::e_drop);
+  ostringstream  os;
+  Dwm::StreamIO::Write(os, Dwm::Credence::ShortString<255>("short"));
+  UnitAssert(Admit(admission, client, os.str(), 0, unused)
+             == Verdict::e_drop);
+
+  auto  counts = admission.Harvest();
+  UnitAssert(counts.cookiesSent == 4);
+  UnitAssert(counts.badCookies == 3);
+  UnitAssert(counts.malformed == 2);
+  UnitAssert(counts.admitted == 1);
+  UnitAssert(counts.Rejected() == 2);
+  counts = admission.Harvest();
+  UnitAssert(0 == (counts.cookiesSent + counts.badCookies + counts.admitted
+                   + counts.Rejected()));
+
+  //  A client can't be told a cookie reply is a KX key.
+  UnitAssert(! KeyRequestAdmission::IsCookieReply(string(32, 'a'), unused));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestRateLimit()
+{
+  KeyRequestAdmission  admission(0.001, 2, 64);
+  UdpEndpoint  client = Endpoint("10.0.0.1", 5000);
+  for (int i = 0; i < 3; ++i) {
+    string  cookie, unused;
+    UnitAssert(Admit(admission, client, KXPacket('a'), 0, cookie)
+               == Verdict::e_sendCookie);
+    Verdict  expected = (i < 2) ? Verdict::e_admit : Verdict::e_drop;
+    UnitAssert(Admit(admission, client, KXPacket('a', cookie), 0, unused)
+               == expected);
+  }
+  //  Other addresses have their own buckets.
+  UdpEndpoint  other = Endpoint("10.0.0.2", 5000);
+  string  cookie, unused;
+  UnitAssert(Admit(admission, other, KXPacket('a'), 0, cookie)
+             == Verdict::e_sendCookie);
+  UnitAssert(Admit(admission, other, KXPacket('a', cookie), 0, unused)
+             == Verdict::e_admit);
+  auto  counts = admission.Harvest();
+  UnitAssert(counts.rateLimited == 1);
+  UnitAssert(counts.admitted == 3);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestHandshakeCap()
+{
+  KeyRequestAdmission  admission(100, 100, 2);
+  UdpEndpoint  client = Endpoint("10.0.0.3", 5000);
+  string  cookie, unused;
+  UnitAssert(Admit(admission, client, KXPacket('c'), 0, cookie)
+             == Verdict::e_sendCookie);
+  UnitAssert(Admit(admission, client, KXPacket('c', cookie), 1, unused)
+             == Verdict::e_admit);
+  UnitAssert(Admit(admission, client, KXPacket('c', cookie), 2, unused)
+             == Verdict::e_drop);
+  UnitAssert(admission.Harvest().overCapacity == 1);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  if (UnitAssert(sodium_init() >= 0)) {
+    TestCookie();
+    TestRateLimit();
+    TestHandshakeCap();
+  }
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
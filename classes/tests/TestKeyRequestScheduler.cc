@@ -0,0 +1,180 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestKeyRequestScheduler.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::KeyRequestScheduler unit tests
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/socket.h>
+  #include <netinet/in.h>
+  #include <unistd.h>
+}
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogKeyRequestScheduler.hh"
+
+using namespace std;
+using Dwm::Mclog::KeyRequestScheduler, Dwm::Mclog::MulticastSourceKey,
+      Dwm::Mclog::UdpEndpoint;
+
+//----------------------------------------------------------------------------
+//!  Opens a UDP socket on the loopback address that never replies.
+//----------------------------------------------------------------------------
+static int OpenSilentPeer(sockaddr_in & addr)
+{
+  int  fd = socket(PF_INET, SOCK_DGRAM, 0);
+  if (UnitAssert(0 <= fd)) {
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = PF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t  addrLen = sizeof(addr);
+    UnitAssert(0 == ::bind(fd, (sockaddr *)&addr, sizeof(addr)));
+    UnitAssert(0 == getsockname(fd, (sockaddr *)&addr, &addrLen));
+    timeval  timeout = { 5, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  }
+  return fd;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static bool WaitFor(const atomic<int> & count, int target)
+{
+  auto  endTime = chrono::steady_clock::now() + chrono::seconds(10);
+  while ((count.load() < target) && (chrono::steady_clock::now() < endTime)) {
+    this_thread::sleep_for(chrono::milliseconds(20));
+  }
+  return (count.load() >= target);
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestConcurrencyAndRetry()
+{
+  string       keyDir("/nonexistent");
+  sockaddr_in  addr1, addr2;
+  int          fd1 = OpenSilentPeer(addr1);
+  int          fd2 = OpenSilentPeer(addr2);
+  if ((0 > fd1) || (0 > fd2)) {
+    return;
+  }
+  
+  KeyRequestScheduler  scheduler(&keyDir, 1, chrono::milliseconds(100), 2);
+  atomic<int>          numDone = 0;
+  atomic<int>          numKeys = 0;
+  auto  callback = [&] (const MulticastSourceKey & key)
+  {
+    if (! key.Value().empty()) { ++numKeys; }
+    ++numDone;
+  };
+  UnitAssert(0 != scheduler.Request(UdpEndpoint(addr1), callback));
+  UnitAssert(0 != scheduler.Request(UdpEndpoint(addr2), callback));
+
+  //  Only one handshake at a time.
+  char  buf[1500];
+  UnitAssert(recv(fd1, buf, sizeof(buf), 0) > 0);
+  UnitAssert(1 == scheduler.Active());
+  
+  //  Each peer should see 2 attempts, then the callbacks are called with
+  //  no key.
+  UnitAssert(recv(fd1, buf, sizeof(buf), 0) > 0);
+  UnitAssert(recv(fd2, buf, sizeof(buf), 0) > 0);
+  UnitAssert(recv(fd2, buf, sizeof(buf), 0) > 0);
+  UnitAssert(WaitFor(numDone, 2));
+  UnitAssert(0 == numKeys.load());
+  UnitAssert(0 == scheduler.Active());
+  UnitAssert(0 == scheduler.Waiting());
+  
+  ::close(fd1);
+  ::close(fd2);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestCancel()
+{
+  string       keyDir("/nonexistent");
+  sockaddr_in  addr;
+  int          fd = OpenSilentPeer(addr);
+  if (0 > fd) {
+    return;
+  }
+  
+  KeyRequestScheduler  scheduler(&keyDir, 4, chrono::milliseconds(100), 1);
+  atomic<int>          numDone = 0;
+  uint64_t  id = scheduler.Request(UdpEndpoint(addr),
+                                   [&] (const MulticastSourceKey &)
+                                   { ++numDone; });
+  UnitAssert(0 != id);
+  scheduler.Cancel(id);
+  this_thread::sleep_for(chrono::milliseconds(300));
+  UnitAssert(0 == numDone.load());
+  UnitAssert(0 == scheduler.Active());
+  UnitAssert(0 == scheduler.Waiting());
+  ::close(fd);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestConcurrencyAndRetry();
+  TestCancel();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
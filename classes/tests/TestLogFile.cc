@@ -41,10 +41,38 @@ extern "C" {
   #include <sys/stat.h>
 }
 
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
 #include "DwmUnitAssert.hh"
 #include "DwmMclogLogFile.hh"
 
 using namespace std;
+using Dwm::Mclog::CompressionPool, Dwm::Mclog::FlushPolicy,
+      Dwm::Mclog::LogFile, Dwm::Mclog::Message;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static Message TestMessage(int i)
+{
+  Dwm::Mclog::MessageOrigin  origin("host1", "TestLogFile", 1234);
+  Dwm::Mclog::MessageHeader  header(Dwm::Mclog::Facility::user,
+                                    Dwm::Mclog::Severity::info, origin);
+  return Message(header, "message " + to_string(i));
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static string FileContents(const string & path)
+{
+  ifstream      is(path);
+  stringstream  ss;
+  ss << is.rdbuf();
+  return ss.str();
+}
 
 //----------------------------------------------------------------------------
 //!  
@@ -78,6 +106,111 @@ static void TestOpen()
   return;
 }
 
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestBuffered()
+{
+  const string  path("./TestLogFile3_log");
+  LogFile       logFile(path);
+  FlushPolicy   policy;
+  policy.Interval(std::chrono::seconds(60));
+  policy.Bytes(4096);
+  logFile.Flushing(policy);
+  if (! UnitAssert(logFile.Open())) {
+    return;
+  }
+  UnitAssert(LogFile::Clock::time_point::max() == logFile.FlushDeadline());
+  
+  ostringstream  expected;
+  for (int i = 0; i < 10; ++i) {
+    Message  msg = TestMessage(i);
+    UnitAssert(logFile.Append(msg));
+    expected << msg;
+  }
+  //  Nothing is written until the interval passes.
+  auto  now = LogFile::Clock::now();
+  UnitAssert(logFile.EndBatch(now));
+  UnitAssert(FileContents(path).empty());
+  UnitAssert(logFile.FlushDeadline() <= now + policy.Interval());
+  UnitAssert(logFile.EndBatch(now + policy.Interval()));
+  UnitAssert(expected.str() == FileContents(path));
+  UnitAssert(LogFile::Clock::time_point::max() == logFile.FlushDeadline());
+
+  //  Reaching the size limit writes immediately.
+  size_t  written = expected.str().size();
+  while ((expected.str().size() - written) < policy.Bytes()) {
+    Message  msg = TestMessage(expected.str().size());
+    UnitAssert(logFile.Append(msg));
+    expected << msg;
+  }
+  UnitAssert(expected.str() == FileContents(path));
+
+  //  Process() doesn't wait.
+  Message  msg = TestMessage(-1);
+  UnitAssert(logFile.Process(msg));
+  expected << msg;
+  UnitAssert(expected.str() == FileContents(path));
+
+  //  Per batch.
+  logFile.Flushing(FlushPolicy());
+  for (int i = 0; i < 3; ++i) {
+    msg = TestMessage(i);
+    UnitAssert(logFile.Append(msg));
+    expected << msg;
+  }
+  UnitAssert(expected.str() != FileContents(path));
+  UnitAssert(logFile.EndBatch());
+  UnitAssert(expected.str() == FileContents(path));
+
+  //  Close() writes what's buffered.
+  policy.Sync(true);
+  logFile.Flushing(policy);
+  msg = TestMessage(99);
+  UnitAssert(logFile.Append(msg));
+  expected << msg;
+  logFile.Close();
+  UnitAssert(expected.str() == FileContents(path));
+  std::remove(path.c_str());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestRoll()
+{
+  namespace fs = std::filesystem;
+  
+  const string     path("./TestLogFile4_log");
+  CompressionPool  pool;
+  UnitAssert(pool.Start(2, 0));
+  LogFile          logFile(path, 0644, Dwm::Mclog::RollPeriod::days_1,
+                           200, 3);
+  logFile.Compression("gzip");
+  logFile.Compressor(&pool);
+  if (! UnitAssert(logFile.Open())) {
+    return;
+  }
+  for (int i = 0; i < 50; ++i) {
+    UnitAssert(logFile.Process(TestMessage(i)));
+  }
+  logFile.Close();
+  pool.WaitAll();
+  UnitAssert(fs::exists(path + ".0.gz"));
+  UnitAssert(fs::exists(path + ".1.gz"));
+  UnitAssert(fs::exists(path + ".2.gz"));
+  UnitAssert(! fs::exists(path + ".3.gz"));
+  UnitAssert(! fs::exists(path + ".0"));
+  auto  counts = pool.Harvest();
+  UnitAssert(0 < counts.completed);
+  UnitAssert(0 == counts.failed);
+  for (auto f : { path, path + ".0.gz", path + ".1.gz", path + ".2.gz" }) {
+    std::remove(f.c_str());
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------
 //!  
 //----------------------------------------------------------------------------
@@ -88,6 +221,8 @@ int main(int argc, char *argv[])
   
   TestOpen();
   TestPermissions();
+  TestBuffered();
+  TestRoll();
 
   if (Assertions::Total().Failed()) {
     Assertions::Print(cerr, true);
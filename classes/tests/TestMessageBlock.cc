@@ -0,0 +1,246 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestMessageBlock.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::MessageBlock unit tests
+//---------------------------------------------------------------------------
+
+#include <deque>
+#include <sstream>
+#include <vector>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogFragmentReassembler.hh"
+#include "DwmMclogMessageBlock.hh"
+
+using namespace std;
+using Dwm::Mclog::Facility, Dwm::Mclog::FragmentReassembler,
+      Dwm::Mclog::Message, Dwm::Mclog::MessageBlock,
+      Dwm::Mclog::MessageFragment, Dwm::Mclog::MessageHeader,
+      Dwm::Mclog::MessageOrigin, Dwm::Mclog::Severity,
+      Dwm::Mclog::Timestamp;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static vector<Message> MakeMessages()
+{
+  MessageOrigin  origin1("foo.mcplex.net", "app1", 1234);
+  MessageOrigin  origin2("bar.mcplex.net", "app2", 5678);
+  uint64_t       now = Timestamp().Microseconds();
+  vector<Message>  msgs;
+  msgs.emplace_back(MessageHeader(Timestamp(now), Facility::user,
+                                  Severity::info, origin1), "first");
+  //  Earlier than the first, so a negative offset.
+  msgs.emplace_back(MessageHeader(Timestamp(now - 250), Facility::daemon,
+                                  Severity::err, origin2), "second");
+  msgs.emplace_back(MessageHeader(Timestamp(now + 5000000),
+                                  Facility::local7, Severity::debug,
+                                  origin1), string(300, 'x'));
+  msgs.emplace_back(MessageHeader(Timestamp(now + 1), Facility::kernel,
+                                  Severity::emerg, origin2), "");
+  return msgs;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestRoundTrip()
+{
+  vector<Message>  msgs = MakeMessages();
+  MessageBlock     block;
+  ostringstream    os;
+  uint64_t         plainLen = 0;
+  vector<size_t>   ends;
+  for (const auto & msg : msgs) {
+    uint64_t  len = block.StreamedLength(msg);
+    auto      pos = os.tellp();
+    UnitAssert(block.Write(os, msg));
+    UnitAssert((uint64_t)(os.tellp() - pos) == len);
+    ends.push_back(os.tellp());
+    plainLen += msg.StreamedLength();
+  }
+  UnitAssert(2 == block.NumOrigins());
+  UnitAssert(os.str().size() < plainLen);
+
+  istringstream   is(os.str());
+  deque<Message>  out;
+  UnitAssert(MessageBlock::Read(is, out));
+  if (UnitAssert(out.size() == msgs.size())) {
+    for (size_t i = 0; i < msgs.size(); ++i) {
+      UnitAssert(out[i] == msgs[i]);
+    }
+  }
+
+  //  Any prefix ending on an entry boundary is a valid block.
+  istringstream  pis(os.str().substr(0, ends[1]));
+  out.clear();
+  UnitAssert(MessageBlock::Read(pis, out));
+  UnitAssert(2 == out.size());
+
+  //  Readers that don't know about blocks don't mistake one for a
+  //  Message or a MessageFragment.
+  istringstream  mis(os.str());
+  Message        msg;
+  UnitAssert(! msg.Read(mis));
+  istringstream    fis(os.str());
+  MessageFragment  frag;
+  UnitAssert(! frag.Read(fis));
+
+  block.Clear();
+  UnitAssert(0 == block.NumOrigins());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestInvalid()
+{
+  vector<Message>  msgs = MakeMessages();
+  MessageBlock     block;
+  ostringstream    os;
+  UnitAssert(block.Write(os, msgs[0]));
+  size_t  end = os.tellp();
+  UnitAssert(block.Write(os, msgs[1]));
+
+  //  An origin index past the end of the table.  The first message is
+  //  kept.
+  string  bytes = os.str();
+  bytes[end] = 5;
+  istringstream   is(bytes);
+  deque<Message>  out;
+  UnitAssert(! MessageBlock::Read(is, out));
+  UnitAssert(1 == out.size());
+
+  //  Truncated mid-entry.
+  istringstream  tis(os.str().substr(0, os.str().size() - 1));
+  out.clear();
+  UnitAssert(! MessageBlock::Read(tis, out));
+  UnitAssert(1 == out.size());
+
+  //  Not a block.
+  ostringstream  mos;
+  UnitAssert(msgs[0].Write(mos));
+  istringstream  mis(mos.str());
+  out.clear();
+  UnitAssert(! MessageBlock::Read(mis, out));
+  UnitAssert(out.empty());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestOriginLimit()
+{
+  MessageBlock   block;
+  ostringstream  os;
+  for (size_t i = 0; i < MessageBlock::k_maxOrigins; ++i) {
+    MessageOrigin  origin("foo.mcplex.net", "app", i);
+    Message  msg(MessageHeader(Facility::user, Severity::info, origin), "x");
+    UnitAssert(block.Accepts(msg));
+    UnitAssert(block.Write(os, msg));
+  }
+  MessageOrigin  known("foo.mcplex.net", "app", 0);
+  MessageOrigin  unknown("foo.mcplex.net", "app", 1000000);
+  Message  msg1(MessageHeader(Facility::user, Severity::info, known), "x");
+  Message  msg2(MessageHeader(Facility::user, Severity::info, unknown), "x");
+  UnitAssert(block.Accepts(msg1));
+  UnitAssert(! block.Accepts(msg2));
+  UnitAssert(! block.Write(os, msg2));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestReassembler()
+{
+  vector<Message>  msgs = MakeMessages();
+  
+  //  A payload with a fragment followed by a block, as PacketBatch
+  //  makes after the last fragment of a large message.
+  MessageOrigin  origin("foo.mcplex.net", "app1", 1234);
+  Message  big(MessageHeader(Facility::user, Severity::info, origin),
+               string(1000, 'b'));
+  vector<MessageFragment>  frags;
+  UnitAssert(MessageFragment::Split(big, 9, 2000, frags));
+  UnitAssert(1 == frags.size());
+  ostringstream  os;
+  UnitAssert(frags[0].Write(os));
+  MessageBlock  block;
+  for (const auto & msg : msgs) {
+    UnitAssert(block.Write(os, msg));
+  }
+
+  FragmentReassembler  reassembler;
+  istringstream        is(os.str());
+  vector<Message>      out;
+  Message              msg;
+  while (reassembler.NextMessage(is, "src", msg)) {
+    out.push_back(msg);
+  }
+  if (UnitAssert(out.size() == (msgs.size() + 1))) {
+    UnitAssert(out[0].Data() == big.Data());
+    for (size_t i = 0; i < msgs.size(); ++i) {
+      UnitAssert(out[i + 1] == msgs[i]);
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestRoundTrip();
+  TestInvalid();
+  TestOriginLimit();
+  TestReassembler();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
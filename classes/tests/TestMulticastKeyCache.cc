@@ -0,0 +1,133 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestMulticastKeyCache.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::MulticastKeyCache unit tests
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/stat.h>
+  #include <unistd.h>
+}
+
+#include <cstdlib>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogMulticastKeyCache.hh"
+
+using namespace std;
+using Dwm::Ipv4Address, Dwm::Mclog::MulticastKeyCache,
+      Dwm::Mclog::MulticastSourceKey, Dwm::Mclog::UdpEndpoint;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static MulticastSourceKey MakeKey(const string & value,
+                                  chrono::hours age = chrono::hours(0))
+{
+  MulticastSourceKey  key(value);
+  key.LastUpdated(MulticastSourceKey::Clock::now() - age);
+  return key;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestCache(const string & keyDir)
+{
+  UdpEndpoint  src1(Ipv4Address("192.168.1.1"), 3456);
+  UdpEndpoint  src2(Ipv4Address("192.168.1.2"), 3456);
+  UdpEndpoint  src3(Ipv4Address("192.168.1.3"), 3456);
+  
+  MulticastKeyCache   cache1(&keyDir);
+  MulticastSourceKey  key;
+  UnitAssert(! cache1.Get(src1, key));
+  UnitAssert(cache1.Put(src1, MakeKey("key1")));
+  UnitAssert(cache1.Put(src2, MakeKey("key2")));
+  UnitAssert(cache1.Put(src3, MakeKey("key3", chrono::hours(13))));
+
+  struct stat  statbuf;
+  if (UnitAssert(0 == stat(cache1.Path().c_str(), &statbuf))) {
+    UnitAssert(0600 == (statbuf.st_mode & 0777));
+  }
+  
+  //  Another instance (e.g. a restarted mclogd) sees the saved keys,
+  //  but not the expired one.
+  MulticastKeyCache  cache2(&keyDir);
+  UnitAssert(cache2.Get(src1, key));
+  UnitAssert("key1" == key.Value());
+  UnitAssert(cache2.Get(src2, key));
+  UnitAssert("key2" == key.Value());
+  UnitAssert(! cache2.Get(src3, key));
+
+  //  Only the key that failed is invalidated.
+  cache2.Invalidate(src1, "stale");
+  UnitAssert(cache1.Get(src1, key));
+  cache2.Invalidate(src1, "key1");
+  UnitAssert(! cache1.Get(src1, key));
+  UnitAssert(cache1.Get(src2, key));
+
+  //  Refuse a cache file others can read.
+  chmod(cache1.Path().c_str(), 0644);
+  MulticastKeyCache  cache3(&keyDir);
+  UnitAssert(! cache3.Get(src2, key));
+  
+  unlink(cache1.Path().c_str());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  char  dirTemplate[] = "/tmp/TestMulticastKeyCache.XXXXXX";
+  if (UnitAssert(nullptr != mkdtemp(dirTemplate))) {
+    TestCache(dirTemplate);
+    rmdir(dirTemplate);
+  }
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
@@ -0,0 +1,114 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestMulticastSources.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::MulticastSources unit tests
+//---------------------------------------------------------------------------
+
+#include <set>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogCipherSuite.hh"
+#include "DwmMclogMulticastSources.hh"
+
+using namespace std;
+using Dwm::Ipv4Address, Dwm::Mclog::MulticastSources,
+      Dwm::Mclog::NonceSequence, Dwm::Mclog::UdpEndpoint;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestShards()
+{
+  MulticastSources  sources;
+  UnitAssert(1 == sources.Shards());
+
+  UdpEndpoint  src(Ipv4Address("192.168.1.1"), 3456);
+  UnitAssert(0 == sources.Shard(src));
+  UnitAssert(src.Hash()
+             == UdpEndpoint(Ipv4Address("192.168.1.1"), 3456).Hash());
+  UnitAssert(src.Hash()
+             != UdpEndpoint(Ipv4Address("192.168.1.1"), 3457).Hash());
+
+  //  Never fewer than one shard.
+  sources.Shards(0);
+  UnitAssert(1 == sources.Shards());
+  
+  sources.Shards(4);
+  UnitAssert(4 == sources.Shards());
+
+  //  A source always maps to the same shard, and sources are spread
+  //  across shards.
+  set<size_t>  shardsUsed;
+  for (uint32_t i = 1; i <= 64; ++i) {
+    UdpEndpoint  ep(Ipv4Address(htonl(0xC0A80100 + i)), 3456);
+    size_t  shard = sources.Shard(ep);
+    UnitAssert(shard < 4);
+    UnitAssert(shard == sources.Shard(ep));
+    shardsUsed.insert(shard);
+  }
+  UnitAssert(1 < shardsUsed.size());
+
+  //  Until a source has authenticated a sender's nonce prefix, packets
+  //  go to the shard of the endpoint they came from.
+  uint8_t  hdr[NonceSequence::k_headerLen];
+  NonceSequence().Next(hdr);
+  for (uint32_t i = 1; i <= 64; ++i) {
+    UdpEndpoint  ep(Ipv4Address(htonl(0xC0A80100 + i)), 3456);
+    UnitAssert(sources.Shard(ep)
+               == sources.Shard(ep, (const char *)hdr, sizeof(hdr)));
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestShards();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
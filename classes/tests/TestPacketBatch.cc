@@ -0,0 +1,311 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestPacketBatch.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::PacketBatch unit tests
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/socket.h>
+  #include <netinet/in.h>
+  #include <unistd.h>
+}
+
+#include <cstring>
+#include <spanstream>
+#include <vector>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogFragmentReassembler.hh"
+#include "DwmMclogMessage.hh"
+#include "DwmMclogPacketBatch.hh"
+#include "DwmMclogPayloadCompressor.hh"
+
+using namespace std;
+using Dwm::Mclog::FragmentReassembler, Dwm::Mclog::Message,
+      Dwm::Mclog::MessageHeader,
+      Dwm::Mclog::MessageOrigin, Dwm::Mclog::MessagePacket,
+      Dwm::Mclog::NonceSequence, Dwm::Mclog::PacketBatch,
+      Dwm::Mclog::PayloadCompressor, Dwm::Mclog::PayloadDecompressor,
+      Dwm::Mclog::Severity, Dwm::Mclog::UdpEndpoint;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static Message MakeMessage(int n)
+{
+  MessageOrigin  origin("foo.mcplex.net", "app1", 1234);
+  MessageHeader  header(Dwm::Mclog::Facility::user, Severity::info, origin);
+  return Message(header, string(100, 'a') + to_string(n));
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestPacketLenForMtu()
+{
+  UnitAssert(MessagePacket::PacketLenForMtu(1500, false) == 1472);
+  UnitAssert(MessagePacket::PacketLenForMtu(1500, true) == 1452);
+  UnitAssert(MessagePacket::PacketLenForMtu(9000, false) == 8972);
+  UnitAssert(MessagePacket::PacketLenForMtu(65536, false)
+             == MessagePacket::k_maxPacketLen);
+  UnitAssert(MessagePacket::PacketLenForMtu(576, false)
+             == MessagePacket::k_minSendPacketLen + 36);
+  UnitAssert(MessagePacket::PacketLenForMtu(0, false)
+             == MessagePacket::k_defaultPacketLen);
+  UnitAssert(MessagePacket::LoopbackPacketLen()
+             >= MessagePacket::k_minSendPacketLen);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestSendTo()
+{
+  int  rfd = socket(PF_INET, SOCK_DGRAM, 0);
+  int  sfd = socket(PF_INET, SOCK_DGRAM, 0);
+  if (! (UnitAssert(0 <= rfd) && UnitAssert(0 <= sfd))) {
+    return;
+  }
+  sockaddr_in  addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = PF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  socklen_t  addrLen = sizeof(addr);
+  UnitAssert(0 == ::bind(rfd, (sockaddr *)&addr, sizeof(addr)));
+  UnitAssert(0 == getsockname(rfd, (sockaddr *)&addr, &addrLen));
+  
+  PacketBatch  batch(MessagePacket::k_minSendPacketLen);
+  UnitAssert(! batch.HasPayload());
+  int  numMsgs = 0;
+  while (batch.Add(MakeMessage(numMsgs))) {
+    ++numMsgs;
+  }
+  UnitAssert(batch.HasPayload());
+  UnitAssert(numMsgs > (int)batch.NumPackets());
+  UnitAssert(batch.NumPackets() == PacketBatch::k_maxPackets);
+  UnitAssert(batch.FullPackets() == (PacketBatch::k_maxPackets - 1));
+
+  size_t  numPackets = batch.NumPackets();
+  UnitAssert(batch.SendTo(sfd, UdpEndpoint(addr)) == numPackets);
+  batch.Reset();
+  UnitAssert(! batch.HasPayload());
+  UnitAssert(0 == batch.NumPackets());
+
+  vector<char>  buf(MessagePacket::k_maxPacketLen);
+  int           numRecvd = 0;
+  for (size_t i = 0; i < numPackets; ++i) {
+    MessagePacket  pkt(buf.data(), buf.size());
+    sockaddr_in    src;
+    if (UnitAssert(pkt.RecvFrom(rfd, &src) > 0)) {
+      UnitAssert(pkt.Length() <= MessagePacket::k_minSendPacketLen);
+      Message  msg;
+      while (msg.Read(pkt.Payload())) {
+        UnitAssert(msg.Data() == (string(100, 'a') + to_string(numRecvd)));
+        ++numRecvd;
+      }
+    }
+  }
+  UnitAssert(numRecvd == numMsgs);
+  ::close(sfd);
+  ::close(rfd);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Compressed packets hold more messages, and the receiver gets them all
+//!  back in order, including those carried over to the next batch.
+//----------------------------------------------------------------------------
+static void TestCompressed()
+{
+  PayloadCompressor    comp;
+  PayloadDecompressor  decomp;
+  NonceSequence        nonces;
+  string  key(crypto_aead_xchacha20poly1305_ietf_KEYBYTES, 'k');
+
+  PacketBatch  plain(MessagePacket::k_minSendPacketLen);
+  int  numPlain = 0;
+  while (plain.Add(MakeMessage(numPlain))) {
+    ++numPlain;
+  }
+  
+  PacketBatch  batch(MessagePacket::k_minSendPacketLen);
+  UnitAssert(batch.Compressor(&comp));
+  int  numMsgs = 0;
+  while (batch.Add(MakeMessage(numMsgs))) {
+    ++numMsgs;
+  }
+  UnitAssert(numMsgs > numPlain);
+  UnitAssert(! batch.Compressor(nullptr));
+
+  int  numRecvd = 0;
+  int  numCompressed = 0;
+  while (batch.HasPayload()) {
+    if (! UnitAssert(batch.Encrypt(key, nonces))) {
+      break;
+    }
+    for (size_t i = 0; i < batch.NumPackets(); ++i) {
+      const MessagePacket  & sent = batch.Packet(i);
+      UnitAssert(sent.Length() <= MessagePacket::k_minSendPacketLen);
+      string         buf(sent.Data(), sent.Length());
+      MessagePacket  pkt(buf.data(), buf.size());
+      if (! UnitAssert(pkt.Decrypt(buf.size(), key) > 0)) {
+        continue;
+      }
+      string  payload(pkt.PayloadData(), pkt.PayloadLength());
+      if (pkt.Compressed()) {
+        ++numCompressed;
+        UnitAssert(decomp.Decompress(pkt.PayloadData(), pkt.PayloadLength(),
+                                     payload));
+      }
+      spanstream  sps{span{payload.data(), payload.size()}};
+      Message     msg;
+      while (msg.Read(sps)) {
+        UnitAssert(msg.Data() == (string(100, 'a') + to_string(numRecvd)));
+        ++numRecvd;
+      }
+    }
+    batch.Reset();
+  }
+  UnitAssert(0 < numCompressed);
+  UnitAssert(numRecvd == numMsgs);
+  UnitAssert(batch.Compressor(nullptr));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Compact packets hold more messages than plain ones, and the receiver
+//!  gets the same messages back, compressed or not.
+//----------------------------------------------------------------------------
+static void TestCompact()
+{
+  PayloadCompressor    comp;
+  PayloadDecompressor  decomp;
+  NonceSequence        nonces;
+  string  key(crypto_aead_xchacha20poly1305_ietf_KEYBYTES, 'k');
+  MessageOrigin  other("bar.mcplex.net", "app2", 5678);
+  //  Mostly from one origin, occasionally another.
+  auto  makeMessage = [&] (size_t n)
+  {
+    Message  msg = MakeMessage(n);
+    if (7 == (n % 8)) {
+      msg = Message(MessageHeader(Dwm::Mclog::Facility::daemon,
+                                  Severity::err, other), msg.Data());
+    }
+    return msg;
+  };
+  
+  for (PayloadCompressor *compressor : {(PayloadCompressor *)nullptr,
+                                        &comp}) {
+    PacketBatch  plain(MessagePacket::k_minSendPacketLen);
+    size_t       numPlain = 0;
+    while (plain.Add(makeMessage(numPlain))) {
+      ++numPlain;
+    }
+    
+    PacketBatch  batch(MessagePacket::k_minSendPacketLen);
+    UnitAssert(batch.Compressor(compressor));
+    UnitAssert(batch.Compact(true));
+    vector<Message>  sent;
+    for (;;) {
+      Message  msg = makeMessage(sent.size());
+      if (! batch.Add(msg)) {
+        break;
+      }
+      sent.push_back(msg);
+    }
+    if (nullptr == compressor) {
+      //  Our messages are nearly identical, so compressing plain
+      //  packets removes the repeated headers just as well.
+      UnitAssert(sent.size() > numPlain);
+    }
+    UnitAssert(! batch.Compact(false));
+
+    FragmentReassembler  reassembler;
+    vector<Message>      received;
+    while (batch.HasPayload()) {
+      if (! UnitAssert(batch.Encrypt(key, nonces))) {
+        break;
+      }
+      for (size_t i = 0; i < batch.NumPackets(); ++i) {
+        const MessagePacket  & pkt = batch.Packet(i);
+        string         buf(pkt.Data(), pkt.Length());
+        MessagePacket  rpkt(buf.data(), buf.size());
+        if (! UnitAssert(rpkt.Decrypt(buf.size(), key) > 0)) {
+          continue;
+        }
+        string  payload(rpkt.PayloadData(), rpkt.PayloadLength());
+        if (rpkt.Compressed()) {
+          UnitAssert(decomp.Decompress(rpkt.PayloadData(),
+                                       rpkt.PayloadLength(), payload));
+        }
+        spanstream  sps{span{payload.data(), payload.size()}};
+        Message     msg;
+        while (reassembler.NextMessage(sps, "src", msg)) {
+          received.push_back(msg);
+        }
+      }
+      batch.Reset();
+    }
+    UnitAssert(received == sent);
+    UnitAssert(batch.Compact(false));
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestPacketLenForMtu();
+  TestSendTo();
+  TestCompressed();
+  TestCompact();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
@@ -0,0 +1,318 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestPacketSummary.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::PacketSummary unit tests
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sodium.h>
+}
+
+#include <string>
+#include <vector>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogMessage.hh"
+#include "DwmMclogMessageFilterDriver.hh"
+#include "DwmMclogMessagePacket.hh"
+#include "DwmMclogPacketBatch.hh"
+#include "DwmMclogPacketSummary.hh"
+
+using namespace std;
+using Dwm::Mclog::CipherSuite, Dwm::Mclog::CipherSuiteBit,
+      Dwm::Mclog::Facility, Dwm::Mclog::LocalCipherSuites,
+      Dwm::Mclog::Message, Dwm::Mclog::MessageFilterDriver,
+      Dwm::Mclog::MessageHeader, Dwm::Mclog::MessageOrigin,
+      Dwm::Mclog::MessagePacket, Dwm::Mclog::NonceSequence,
+      Dwm::Mclog::PacketBatch, Dwm::Mclog::PacketSummary,
+      Dwm::Mclog::PacketSummaryFilter, Dwm::Mclog::Severity;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static PacketSummary MakeSummary(Facility facility, Severity severity)
+{
+  PacketSummary  rc;
+  rc.Add(facility, severity);
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestEncoding()
+{
+  PacketSummary  summary;
+  UnitAssert(summary.Empty());
+  summary.Add(Facility::kernel, Severity::emerg);
+  summary.Add(Facility::local7, Severity::debug);
+  summary |= MakeSummary(Facility::daemon, Severity::err);
+  UnitAssert(! summary.Empty());
+  UnitAssert(summary.Facilities() == ((1 << 0) | (1 << 3) | (1 << 23)));
+  UnitAssert(summary.Severities() == ((1 << 0) | (1 << 3) | (1 << 7)));
+
+  uint8_t  buf[PacketSummary::k_len];
+  summary.Encode(buf);
+  PacketSummary  decoded;
+  decoded.Decode(buf);
+  UnitAssert(decoded.Facilities() == summary.Facilities());
+  UnitAssert(decoded.Severities() == summary.Severities());
+
+  summary.Clear();
+  UnitAssert(summary.Empty());
+  UnitAssert(0 == summary.Severities());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestFilter()
+{
+  PacketSummary  info = MakeSummary(Facility::user, Severity::info);
+  PacketSummary  err = MakeSummary(Facility::user, Severity::err);
+  
+  PacketSummaryFilter  none;
+  UnitAssert(! none.Active());
+  UnitAssert(none.MayPass(info));
+  
+  MessageFilterDriver  sevDriver("severity >= err");
+  PacketSummaryFilter  sev(sevDriver);
+  UnitAssert(sev.Active());
+  UnitAssert(! sev.MayPass(info));
+  UnitAssert(sev.MayPass(err));
+  info |= err;
+  UnitAssert(sev.MayPass(info));
+
+  MessageFilterDriver  facDriver("facility = local0 && severity >= err");
+  PacketSummaryFilter  fac(facDriver);
+  UnitAssert(fac.Active());
+  UnitAssert(! fac.MayPass(err));
+  UnitAssert(fac.MayPass(MakeSummary(Facility::local0, Severity::crit)));
+  //  The summary doesn't pair facilities with severities, so this one
+  //  might pass.
+  PacketSummary  mixed = MakeSummary(Facility::local0, Severity::info);
+  mixed |= err;
+  UnitAssert(fac.MayPass(mixed));
+
+  //  We can't summarize the origin or text of messages.
+  MessageFilterDriver  hostDriver("severity >= err && host = \"foo\"");
+  PacketSummaryFilter  host(hostDriver);
+  UnitAssert(! host.Active());
+  UnitAssert(host.MayPass(MakeSummary(Facility::user, Severity::debug)));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Channel selection in MulticastReceiver relies on these.
+//----------------------------------------------------------------------------
+static void TestChannels()
+{
+  MessageFilterDriver  errDriver("severity >= err");
+  PacketSummaryFilter  errs(errDriver);
+  MessageFilterDriver  minorDriver("severity < err");
+  PacketSummaryFilter  minors(minorDriver);
+  MessageFilterDriver  localDriver("facility = local0 && severity >= err");
+  PacketSummaryFilter  local(localDriver);
+  MessageFilterDriver  hostDriver("severity >= err && host = \"foo\"");
+  PacketSummaryFilter  host(hostDriver);
+  PacketSummaryFilter  none;
+
+  UnitAssert(errs.Overlaps(local));
+  UnitAssert(local.Overlaps(errs));
+  UnitAssert(! errs.Overlaps(minors));
+  UnitAssert(! minors.Overlaps(local));
+  UnitAssert(none.Overlaps(minors));
+  UnitAssert(minors.Overlaps(host));
+
+  //  Every local0 error goes to the channel of errors.
+  UnitAssert(! local.PassesOutside({ errs }));
+  UnitAssert(! local.PassesOutside({ minors, errs }));
+  //  Errors from other facilities don't go to the local0 channel.
+  UnitAssert(errs.PassesOutside({ local }));
+  //  We can't tell which errors go to a channel selected by host.
+  UnitAssert(errs.PassesOutside({ host }));
+  UnitAssert(errs.PassesOutside({}));
+  UnitAssert(none.PassesOutside({ errs }));
+  UnitAssert(! none.PassesOutside({ errs, minors }));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestPacket(CipherSuite suite)
+{
+  string  key(crypto_aead_xchacha20poly1305_ietf_KEYBYTES, '\0');
+  randombytes_buf(key.data(), key.size());
+  NonceSequence  nonces(suite);
+  
+  vector<char>   buf(512);
+  MessagePacket  pkt(buf.data(), buf.size());
+  size_t  capacity = pkt.PayloadCapacity();
+  UnitAssert(pkt.Summarize(true));
+  UnitAssert((capacity - PacketSummary::k_len) == pkt.PayloadCapacity());
+  UnitAssert(pkt.Add(string("hello")));
+  UnitAssert(! pkt.Summarize(false));
+  pkt.Summary().Add(Facility::mail, Severity::warning);
+  size_t  len = pkt.Length();
+  UnitAssert(pkt.Encrypt(key, nonces));
+
+  PacketSummary  peeked;
+  UnitAssert(MessagePacket::PeekSummary(buf.data(), len, peeked));
+  UnitAssert(peeked.Facilities() == pkt.Summary().Facilities());
+  UnitAssert(peeked.Severities() == pkt.Summary().Severities());
+  
+  vector<char>   rbuf(buf.begin(), buf.begin() + len);
+  MessagePacket  rpkt(rbuf.data(), rbuf.size());
+  UnitAssert(rpkt.Decrypt(len, key) == (ssize_t)len);
+  string  s;
+  UnitAssert(Dwm::StreamIO::Read(rpkt.Payload(), s));
+  UnitAssert("hello" == s);
+  UnitAssert(rpkt.Summary().Facilities() == peeked.Facilities());
+  UnitAssert(rpkt.Summary().Severities() == peeked.Severities());
+
+  //  The summary is authenticated.
+  for (size_t i = len - PacketSummary::k_len; i < len; ++i) {
+    vector<char>  tbuf(buf.begin(), buf.begin() + len);
+    tbuf[i] ^= 0x01;
+    MessagePacket  tpkt(tbuf.data(), tbuf.size());
+    UnitAssert(tpkt.Decrypt(len, key) < 0);
+  }
+
+  //  Without a summary, there's nothing to peek at.
+  MessagePacket  plain(buf.data(), buf.size());
+  UnitAssert(plain.Add(string("hello")));
+  len = plain.Length();
+  UnitAssert(plain.Encrypt(key, nonces));
+  UnitAssert(! MessagePacket::PeekSummary(buf.data(), len, peeked));
+  MessagePacket  rplain(buf.data(), buf.size());
+  UnitAssert(rplain.Decrypt(len, key) == (ssize_t)len);
+  UnitAssert(rplain.Summary().Empty());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestBatch(bool compact)
+{
+  string  key(crypto_aead_xchacha20poly1305_ietf_KEYBYTES, '\0');
+  randombytes_buf(key.data(), key.size());
+  NonceSequence  nonces;
+  
+  PacketBatch  batch(1200);
+  UnitAssert(batch.Compact(compact));
+  UnitAssert(batch.Summarize(true));
+  MessageOrigin  origin("foo.mcplex.net", "app1", 1234);
+  //  Mostly info, with an occasional err.
+  size_t  numErrs = 0;
+  for (size_t i = 0; ; ++i) {
+    Severity  sev = ((i % 23) == 22) ? Severity::err : Severity::info;
+    Message  msg(MessageHeader(Facility::daemon, sev, origin),
+                 string(100, 'a') + to_string(i));
+    if (! batch.Add(msg)) {
+      break;
+    }
+    numErrs += (Severity::err == sev) ? 1 : 0;
+  }
+  UnitAssert(batch.Encrypt(key, nonces));
+  UnitAssert(batch.NumPackets() > 1);
+
+  PacketSummary  errSummary = MakeSummary(Facility::daemon, Severity::err);
+  size_t  numWithErrs = 0;
+  for (size_t i = 0; i < batch.NumPackets(); ++i) {
+    const MessagePacket  & pkt = batch.Packet(i);
+    vector<char>   buf(pkt.Data(), pkt.Data() + pkt.Length());
+    PacketSummary  summary;
+    UnitAssert(MessagePacket::PeekSummary(buf.data(), buf.size(), summary));
+    UnitAssert((1 << 3) == summary.Facilities());
+    UnitAssert(summary.Severities() & (1 << (int)Severity::info));
+    MessagePacket  rpkt(buf.data(), buf.size());
+    UnitAssert(rpkt.Decrypt(buf.size(), key) > 0);
+    //  The summary matches the packet's messages.
+    deque<Message>  msgs;
+    bool  hasErr = false;
+    if (compact) {
+      UnitAssert(Dwm::Mclog::MessageBlock::Read(rpkt.Payload(), msgs));
+    }
+    else {
+      Message  msg;
+      while (msg.Read(rpkt.Payload())) {
+        msgs.push_back(msg);
+      }
+    }
+    for (const auto & msg : msgs) {
+      hasErr |= (Severity::err == msg.Header().severity());
+    }
+    UnitAssert(hasErr == (bool)(summary.Severities()
+                                & errSummary.Severities()));
+    numWithErrs += hasErr ? 1 : 0;
+  }
+  UnitAssert(numWithErrs > 0);
+  UnitAssert(numWithErrs <= numErrs);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  if (UnitAssert(sodium_init() >= 0)) {
+    TestEncoding();
+    TestFilter();
+    TestChannels();
+    TestPacket(CipherSuite::xchacha20poly1305);
+    if (LocalCipherSuites() & CipherSuiteBit(CipherSuite::aes256gcm)) {
+      TestPacket(CipherSuite::aes256gcm);
+    }
+    TestBatch(false);
+    TestBatch(true);
+  }
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
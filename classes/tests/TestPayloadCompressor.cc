@@ -0,0 +1,186 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestPayloadCompressor.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::PayloadCompressor and
+//!  Dwm::Mclog::PayloadDecompressor unit tests
+//---------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogPayloadCompressor.hh"
+
+using namespace std;
+using Dwm::Mclog::PayloadCompressor, Dwm::Mclog::PayloadDecompressor;
+
+//----------------------------------------------------------------------------
+//!  Returns @c n log-like lines to train and test with.
+//----------------------------------------------------------------------------
+static vector<string> Samples(size_t n, size_t seed)
+{
+  static const vector<string>  hosts = { "ria", "kiva", "thrip", "depot" };
+  static const vector<string>  idents = { "sshd", "named", "mcroverd",
+                                          "mclogd", "dhcpd" };
+  vector<string>  rc;
+  for (size_t i = 0; i < n; ++i) {
+    size_t  r = (i * 7919) + seed;
+    rc.push_back("2026-03-14 12:" + to_string(r % 60) + ":"
+                 + to_string((r / 7) % 60) + " " + hosts[r % hosts.size()]
+                 + " daemon.info " + idents[r % idents.size()] + "["
+                 + to_string(1000 + (r % 9000))
+                 + "]: Accepted publickey for user"
+                 + to_string(r % 13) + " from 192.168.168."
+                 + to_string(r % 254) + " port " + to_string(20000 + r % 9999)
+                 + " ssh2\n");
+  }
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  Returns the concatenation of @c samples.
+//----------------------------------------------------------------------------
+static string Join(const vector<string> & samples)
+{
+  string  rc;
+  for (const auto & s : samples) {
+    rc += s;
+  }
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  Compresses @c raw with @c comp and decompresses with @c decomp.
+//!  Returns the compressed length, 0 on failure.
+//----------------------------------------------------------------------------
+static size_t RoundTrip(PayloadCompressor & comp,
+                        PayloadDecompressor & decomp, const string & raw)
+{
+  string  compressed(raw.size() + 64, '\0');
+  size_t  len = comp.Compress(raw.data(), raw.size(), compressed.data(),
+                              compressed.size());
+  if (UnitAssert(0 < len)) {
+    UnitAssert(! decomp.WrongDictionary(compressed.data(), len));
+    string  out;
+    if (UnitAssert(decomp.Decompress(compressed.data(), len, out))) {
+      UnitAssert(out == raw);
+    }
+  }
+  return len;
+}
+
+//----------------------------------------------------------------------------
+static void TestNoDictionary()
+{
+  PayloadCompressor    comp;
+  PayloadDecompressor  decomp;
+  string  raw = Join(Samples(8, 1));
+  size_t  len = RoundTrip(comp, decomp, raw);
+  UnitAssert(len < raw.size());
+
+  //  Won't fit.
+  string  small(8, '\0');
+  UnitAssert(0 == comp.Compress(raw.data(), raw.size(), small.data(),
+                                small.size()));
+  //  Garbage.
+  string  out;
+  UnitAssert(! decomp.Decompress(raw.data(), raw.size(), out));
+  UnitAssert(out.empty());
+  return;
+}
+
+//----------------------------------------------------------------------------
+static void TestDictionary()
+{
+  string  dict;
+  UnitAssert(PayloadCompressor::TrainDictionary(Samples(2000, 3), 4096,
+                                                dict));
+  UnitAssert((0 < dict.size()) && (dict.size() <= 4096));
+
+  PayloadCompressor    plainComp;
+  PayloadCompressor    comp;
+  UnitAssert(comp.Dictionary(dict));
+  UnitAssert(comp.Dictionary() == dict);
+  PayloadDecompressor  decomp;
+  decomp.Dictionary(make_shared<const string>(dict));
+
+  //  A packet's worth of messages not in the training set.
+  string  raw = Join(Samples(8, 5));
+  PayloadDecompressor  plainDecomp;
+  size_t  plainLen = RoundTrip(plainComp, plainDecomp, raw);
+  size_t  dictLen = RoundTrip(comp, decomp, raw);
+  UnitAssert(dictLen < plainLen);
+
+  //  Copies get their own contexts but share the dictionary.
+  PayloadDecompressor  copy(decomp);
+  UnitAssert(copy.Dictionary() == decomp.Dictionary());
+  RoundTrip(comp, copy, raw);
+  
+  //  A receiver without the dictionary knows it needs one.
+  string  compressed(raw.size(), '\0');
+  size_t  len = comp.Compress(raw.data(), raw.size(), compressed.data(),
+                              compressed.size());
+  UnitAssert(plainDecomp.WrongDictionary(compressed.data(), len));
+  string  out;
+  UnitAssert(! plainDecomp.Decompress(compressed.data(), len, out));
+
+  //  Too large.
+  UnitAssert(! comp.Dictionary(string(PayloadCompressor::k_maxDictionaryLen
+                                      + 1, 'x')));
+  UnitAssert(comp.Dictionary().empty());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestNoDictionary();
+  TestDictionary();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
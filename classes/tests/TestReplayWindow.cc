@@ -0,0 +1,281 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestReplayWindow.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::ReplayWindow unit tests
+//---------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogReplayWindow.hh"
+
+using namespace std;
+using Dwm::Mclog::ReplayWindow, Dwm::Mclog::SourceStats;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestWindow()
+{
+  ReplayWindow  window;
+  UnitAssert(window.Accept("a", 5));
+  UnitAssert(! window.Accept("a", 5));
+  UnitAssert(window.Accept("a", 3));     // reordered
+  UnitAssert(window.Accept("a", 200));
+  UnitAssert(! window.Accept("a", 100)); // too old
+  UnitAssert(window.Accept("a", 150));
+  UnitAssert(window.Accept("a", 200 - (ReplayWindow::k_windowSize - 1)));
+  UnitAssert(! window.Accept("a", 200 - ReplayWindow::k_windowSize));
+  UnitAssert(! window.Accept("a", 150));
+  UnitAssert(window.Rejected() == 4);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestPrefixes()
+{
+  ReplayWindow  window;
+  UnitAssert(window.Accept("a", 1000));
+  //  A restarted sender has a new prefix and starts over at 0.
+  UnitAssert(window.Accept("b", 0));
+  UnitAssert(window.Accept("b", 1));
+  UnitAssert(! window.Accept("a", 1000));
+  UnitAssert(! window.Accept("b", 1));
+
+  //  Only the most recently used prefixes are remembered.
+  for (size_t i = 0; i < ReplayWindow::k_maxPrefixes; ++i) {
+    UnitAssert(window.Accept(to_string(i), 0));
+  }
+  UnitAssert(window.Accept("a", 1000));
+  UnitAssert(! window.Accept(to_string(ReplayWindow::k_maxPrefixes - 1), 0));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestStats()
+{
+  ReplayWindow  window;
+  SourceStats   stats;
+  for (uint64_t i = 0; i < 10; ++i) {
+    if (5 != i) {
+      UnitAssert(window.Accept("a", i, &stats));
+    }
+  }
+  UnitAssert(window.Accept("a", 5, &stats));
+  UnitAssert(1 == stats.reordered);
+  UnitAssert(0 == stats.lost);
+
+  //  10..36 skip the window entirely.
+  UnitAssert(window.Accept("a", 100, &stats));
+  UnitAssert(27 == stats.lost);
+  //  37..99 leave the window unseen, 101..136 skip it.
+  UnitAssert(window.Accept("a", 200, &stats));
+  UnitAssert(126 == stats.lost);
+  
+  UnitAssert(! window.Accept("a", 200, &stats));
+  UnitAssert(1 == stats.duplicated);
+  UnitAssert(! window.Accept("a", 100, &stats));
+  UnitAssert(1 == stats.late);
+
+  //  Counters below the first one seen are not lost when they leave
+  //  the window.
+  SourceStats  stats2;
+  UnitAssert(window.Accept("b", 1000, &stats2));
+  UnitAssert(window.Accept("b", 1001, &stats2));
+  UnitAssert(window.Accept("b", 2000, &stats2));
+  //  1002..1936 skipped the window; 1937..1999 may still arrive.
+  UnitAssert(935 == stats2.lost);
+
+  SourceStats  total;
+  total.received = 10;
+  total += stats;
+  total += stats2;
+  UnitAssert((126 + 935) == total.lost);
+  UnitAssert(total.Impaired());
+  UnitAssert(! SourceStats().Impaired());
+  UnitAssert(SourceStats().Empty());
+  
+  total.AddMessage(2000);
+  total.AddMessage(4000);
+  UnitAssert(3000 == total.LagMean());
+  UnitAssert(4000 == total.lagMax);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestMissing()
+{
+  ReplayWindow      window;
+  vector<uint64_t>  missing;
+  UnitAssert(0 == window.Missing("a", 0, 3, missing));
+  
+  for (uint64_t i : { 10, 11, 13, 14, 17, 18, 19, 20 }) {
+    UnitAssert(window.Accept("a", i));
+  }
+  //  Nothing below the first counter seen, nothing within 3 of the
+  //  highest.
+  UnitAssert(3 == window.Missing("a", 0, 3, missing));
+  UnitAssert(vector<uint64_t>({12, 15, 16}) == missing);
+  missing.clear();
+  UnitAssert(1 == window.Missing("a", 16, 3, missing));
+  UnitAssert(vector<uint64_t>({16}) == missing);
+  missing.clear();
+  UnitAssert(0 == window.Missing("b", 0, 3, missing));
+
+  //  A repaired packet is no longer missing.
+  UnitAssert(window.Accept("a", 12));
+  UnitAssert(2 == window.Missing("a", 0, 3, missing));
+  missing.clear();
+  
+  //  Counters that have left the window are lost, not missing.
+  UnitAssert(window.Accept("a", 100));
+  UnitAssert(window.Missing("a", 0, 0, missing)
+             == (ReplayWindow::k_windowSize - 1));
+  UnitAssert((100 - (ReplayWindow::k_windowSize - 1)) == missing.front());
+  UnitAssert(99 == missing.back());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestSkip()
+{
+  ReplayWindow      window;
+  SourceStats       stats;
+  vector<uint64_t>  missing;
+
+  //  Nothing to skip until we've accepted a packet with the prefix.
+  window.Skip("a", 0);
+  UnitAssert(window.Accept("a", 1, &stats));
+  for (uint64_t i = 2; i < 10; ++i) {
+    window.Skip("a", i);
+  }
+  UnitAssert(window.Accept("a", 10, &stats));
+  UnitAssert(0 == window.Missing("a", 0, 0, missing));
+
+  //  Skipped counters aren't accepted or rejected on their account.
+  UnitAssert(window.Accept("a", 5, &stats));
+  UnitAssert(1 == stats.reordered);
+
+  //  11 was lost; 12..199 were skipped, including the ones that never
+  //  made it into the window.
+  for (uint64_t i = 12; i < 200; ++i) {
+    window.Skip("a", i);
+  }
+  UnitAssert(window.Accept("a", 200, &stats));
+  UnitAssert(1 == stats.lost);
+  UnitAssert(0 == window.Missing("a", 0, 0, missing));
+  //  201..236 were never in the window.
+  UnitAssert(window.Accept("a", 300, &stats));
+  UnitAssert((1 + 36) == stats.lost);
+  
+  //  Out of order skips.
+  window.Skip("a", 303);
+  window.Skip("a", 302);
+  UnitAssert(window.Accept("a", 304, &stats));
+  UnitAssert(1 == window.Missing("a", 300, 0, missing));
+  UnitAssert(vector<uint64_t>({301}) == missing);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestSeen()
+{
+  ReplayWindow  window;
+
+  UnitAssert(! window.Tracks("a"));
+  UnitAssert(! window.Seen("a", 1));
+  UnitAssert(window.Accept("a", 1));
+  UnitAssert(window.Tracks("a"));
+  UnitAssert(window.Seen("a", 1));
+  UnitAssert(! window.Seen("a", 2));
+  UnitAssert(! window.Seen("b", 1));
+
+  //  Seen() doesn't count as a rejection, and doesn't record anything.
+  UnitAssert(0 == window.Rejected());
+  UnitAssert(window.Accept("a", 2));
+  UnitAssert(window.Seen("a", 2));
+  
+  //  Counters that left the window haven't been seen as far as we know.
+  UnitAssert(window.Accept("a", 2 + ReplayWindow::k_windowSize));
+  UnitAssert(! window.Seen("a", 2));
+  UnitAssert(window.Seen("a", 2 + ReplayWindow::k_windowSize));
+
+  UnitAssert(! window.Skipped("a", 100));
+  window.Skip("a", 100);
+  UnitAssert(window.Skipped("a", 100));
+  UnitAssert(! window.Seen("a", 100));
+  UnitAssert(! window.Skipped("a", 101));
+
+  UnitAssert(window.Accept("b", 1));
+  UnitAssert(vector<string>({"b", "a"}) == window.Prefixes());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestWindow();
+  TestPrefixes();
+  TestStats();
+  TestMissing();
+  TestSkip();
+  TestSeen();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
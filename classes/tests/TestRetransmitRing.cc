@@ -0,0 +1,260 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestRetransmitRing.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::RetransmitRing and Dwm::Mclog::Nack unit tests
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <arpa/inet.h>
+}
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogCipherSuite.hh"
+#include "DwmMclogNack.hh"
+#include "DwmMclogRetransmitRing.hh"
+
+using namespace std;
+using Dwm::Mclog::Nack, Dwm::Mclog::NonceSequence,
+      Dwm::Mclog::RetransmitRing, Dwm::Mclog::UdpEndpoint;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static UdpEndpoint Endpoint(const char *addr, uint16_t port)
+{
+  sockaddr_in  sockAddr;
+  memset(&sockAddr, 0, sizeof(sockAddr));
+  sockAddr.sin_family = AF_INET;
+  sockAddr.sin_port = htons(port);
+  inet_pton(AF_INET, addr, &sockAddr.sin_addr);
+  return UdpEndpoint(sockAddr);
+}
+
+//----------------------------------------------------------------------------
+//!  Returns a fake packet: the next nonce header from @c nonces followed
+//!  by @c fill.
+//----------------------------------------------------------------------------
+static string NextPacket(NonceSequence & nonces, char fill)
+{
+  string  pkt(NonceSequence::k_headerLen, '\0');
+  nonces.Next((uint8_t *)pkt.data());
+  pkt.append(32, fill);
+  return pkt;
+}
+
+//----------------------------------------------------------------------------
+//!  Returns the nonce prefix of @c pkt.
+//----------------------------------------------------------------------------
+static string Prefix(const string & pkt)
+{
+  return pkt.substr(NonceSequence::k_prefixOffset, NonceSequence::k_prefixLen);
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestNack()
+{
+  string  key(32, 'k');
+  string  prefix(NonceSequence::k_prefixLen, 'p');
+  Nack    nack(prefix);
+  UnitAssert(nack.Empty());
+  string  datagram;
+  UnitAssert(! nack.Encode(key, datagram));
+  
+  for (uint64_t c : { 5, 6, 7, 10, 12, 13 }) {
+    UnitAssert(nack.Add(c));
+  }
+  UnitAssert(3 == nack.Ranges().size());
+  UnitAssert(6 == nack.NumCounters());
+  UnitAssert(nack.Encode(key, datagram));
+  UnitAssert(Nack::IsNack(datagram.data(), datagram.size()));
+  UnitAssert(! Nack::IsNack("MCN", 3));
+
+  Nack  decoded;
+  UnitAssert(decoded.Decode(key, datagram.data(), datagram.size()));
+  UnitAssert(prefix == decoded.Prefix());
+  UnitAssert(3 == decoded.Ranges().size());
+  UnitAssert(6 == decoded.NumCounters());
+  UnitAssert((10 == decoded.Ranges()[1].first)
+             && (1 == decoded.Ranges()[1].count));
+
+  //  Wrong key, tampering and truncation are all rejected.
+  UnitAssert(! decoded.Decode(string(32, 'x'), datagram.data(),
+                              datagram.size()));
+  UnitAssert(decoded.Empty());
+  string  tampered(datagram);
+  tampered[Nack::k_tag.size() + NonceSequence::k_prefixLen + 6] ^= 1;
+  UnitAssert(! decoded.Decode(key, tampered.data(), tampered.size()));
+  UnitAssert(! decoded.Decode(key, datagram.data(), datagram.size() - 1));
+
+  //  At most k_maxRanges ranges.
+  Nack  big(prefix);
+  for (uint64_t i = 0; i < Nack::k_maxRanges; ++i) {
+    UnitAssert(big.Add(i * 2));
+  }
+  UnitAssert(! big.Add(Nack::k_maxRanges * 2));
+  UnitAssert(big.Add((Nack::k_maxRanges * 2) - 1));
+  UnitAssert(big.Encode(key, datagram));
+  UnitAssert(decoded.Decode(key, datagram.data(), datagram.size()));
+  UnitAssert((Nack::k_maxRanges + 1) == decoded.NumCounters());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestRepairs()
+{
+  RetransmitRing  ring(8);
+  NonceSequence   nonces;
+  vector<string>  sent;
+  for (int i = 0; i < 10; ++i) {
+    sent.push_back(NextPacket(nonces, 'a' + i));
+    ring.Add(sent.back().data(), sent.back().size());
+  }
+  UnitAssert(8 == ring.Size());
+  //  Packets without a nonce header are ignored.
+  ring.Add("junk", 4);
+  UnitAssert(8 == ring.Size());
+
+  string  prefix = Prefix(sent[0]);
+  Nack    nack(prefix);
+  nack.Add(1);   // overwritten by 9
+  nack.Add(2);
+  nack.Add(3);
+  vector<RetransmitRing::Retransmit>  repairs;
+  UdpEndpoint  rcvr1 = Endpoint("192.168.1.1", 1234);
+  UnitAssert(2 == ring.Repairs(nack, rcvr1, repairs));
+  UnitAssert(2 == repairs.size());
+  UnitAssert(sent[2] == repairs[0].data);
+  UnitAssert(sent[3] == repairs[1].data);
+  UnitAssert((! repairs[0].multicast) && (! repairs[1].multicast));
+
+  //  Wrong prefix.
+  repairs.clear();
+  Nack  other(string(NonceSequence::k_prefixLen, 'z'));
+  other.Add(5);
+  UnitAssert(0 == ring.Repairs(other, rcvr1, repairs));
+
+  //  The third receiver to miss packet 2 gets it by multicast, once.
+  UdpEndpoint  rcvr2 = Endpoint("192.168.1.2", 1234);
+  UdpEndpoint  rcvr3 = Endpoint("192.168.1.3", 1234);
+  UdpEndpoint  rcvr4 = Endpoint("192.168.1.4", 1234);
+  Nack  nack2(prefix);
+  nack2.Add(2);
+  UnitAssert(1 == ring.Repairs(nack2, rcvr1, repairs));
+  UnitAssert(! repairs.back().multicast);
+  UnitAssert(1 == ring.Repairs(nack2, rcvr2, repairs));
+  UnitAssert(! repairs.back().multicast);
+  UnitAssert(1 == ring.Repairs(nack2, rcvr3, repairs));
+  UnitAssert(repairs.back().multicast);
+  UnitAssert(1 == ring.Repairs(nack2, rcvr4, repairs));
+  UnitAssert(! repairs.back().multicast);
+
+  auto  counts = ring.Harvest();
+  UnitAssert(8 == counts.requested);
+  UnitAssert(1 == counts.multicast);
+  UnitAssert(5 == counts.unicast);
+  UnitAssert(2 == counts.missed);
+  UnitAssert(0 == counts.rateLimited);
+  UnitAssert(ring.Harvest().Empty());
+  //  Summing, as MulticastSender does across its channels.
+  RetransmitRing::Counts  sum;
+  sum += counts;
+  sum += counts;
+  UnitAssert(16 == sum.requested);
+  UnitAssert(2 == sum.multicast);
+  UnitAssert(10 == sum.unicast);
+  UnitAssert(4 == sum.missed);
+
+  ring.Clear();
+  UnitAssert(0 == ring.Size());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestRateLimit()
+{
+  RetransmitRing  ring(64, 1.0, 4.0);
+  NonceSequence   nonces;
+  string          prefix;
+  for (int i = 0; i < 16; ++i) {
+    string  pkt = NextPacket(nonces, 'a');
+    prefix = Prefix(pkt);
+    ring.Add(pkt.data(), pkt.size());
+  }
+  Nack  nack(prefix);
+  for (uint64_t c = 0; c < 10; ++c) {
+    nack.Add(c);
+  }
+  vector<RetransmitRing::Retransmit>  repairs;
+  UnitAssert(4 == ring.Repairs(nack, Endpoint("10.0.0.1", 1), repairs));
+  //  Each address has its own bucket.
+  UnitAssert(4 == ring.Repairs(nack, Endpoint("10.0.0.2", 1), repairs));
+  auto  counts = ring.Harvest();
+  UnitAssert(20 == counts.requested);
+  UnitAssert(12 == counts.rateLimited);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestNack();
+  TestRepairs();
+  TestRateLimit();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
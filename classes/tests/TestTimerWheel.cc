@@ -0,0 +1,152 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestTimerWheel.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::TimerWheel unit tests
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogTimerWheel.hh"
+
+using namespace std;
+using Dwm::Mclog::TimerWheel;
+
+using Wheel = TimerWheel<string,chrono::system_clock>;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static bool Contains(const vector<string> & keys, const string & key)
+{
+  return (find(keys.begin(), keys.end(), key) != keys.end());
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestExpire()
+{
+  Wheel  wheel(chrono::seconds(1), 8);
+  auto   t0 = chrono::system_clock::time_point(chrono::seconds(1000));
+  vector<string>  expired;
+  
+  wheel.Schedule("a", t0 + chrono::seconds(2));
+  wheel.Schedule("b", t0 + chrono::seconds(5));
+  //  Further out than one revolution of the wheel.
+  wheel.Schedule("c", t0 + chrono::seconds(20));
+  UnitAssert(3 == wheel.Size());
+
+  UnitAssert(0 == wheel.Expire(t0, expired));
+  UnitAssert(0 == wheel.Expire(t0 + chrono::seconds(2), expired));
+  UnitAssert(1 == wheel.Expire(t0 + chrono::seconds(3), expired));
+  UnitAssert(Contains(expired, "a"));
+  UnitAssert(2 == wheel.Size());
+
+  //  'c' shares a slot with an earlier tick, and must stay.
+  expired.clear();
+  UnitAssert(1 == wheel.Expire(t0 + chrono::seconds(13), expired));
+  UnitAssert(Contains(expired, "b"));
+  UnitAssert(1 == wheel.Size());
+
+  //  Scheduling in the past fires on the next Expire() that passes a
+  //  tick.
+  expired.clear();
+  wheel.Schedule("d", t0);
+  UnitAssert(0 == wheel.Expire(t0 + chrono::seconds(13), expired));
+  UnitAssert(1 == wheel.Expire(t0 + chrono::seconds(14), expired));
+  UnitAssert(Contains(expired, "d"));
+
+  //  A long gap visits every slot once.
+  expired.clear();
+  UnitAssert(1 == wheel.Expire(t0 + chrono::seconds(100), expired));
+  UnitAssert(Contains(expired, "c"));
+  UnitAssert(0 == wheel.Size());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestMany()
+{
+  Wheel  wheel(chrono::seconds(1), 64);
+  auto   t0 = chrono::system_clock::time_point(chrono::seconds(5000));
+  vector<string>  expired;
+  
+  for (int i = 0; i < 1000; ++i) {
+    wheel.Schedule(to_string(i), t0 + chrono::seconds(i % 100));
+  }
+  size_t  total = 0;
+  for (int s = 1; s <= 101; ++s) {
+    total += wheel.Expire(t0 + chrono::seconds(s), expired);
+    //  Nothing fires before its time.
+    for (const auto & key : expired) {
+      UnitAssert((stoi(key) % 100) < s);
+    }
+    expired.clear();
+  }
+  UnitAssert(1000 == total);
+  UnitAssert(0 == wheel.Size());
+
+  wheel.Schedule("x", t0 + chrono::seconds(500));
+  wheel.Clear();
+  UnitAssert(0 == wheel.Size());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestExpire();
+  TestMany();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}
@@ -0,0 +1,164 @@
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  @file TestTokenBucket.cc
+//!  @author Daniel W. McRobb
+//!  @brief Dwm::Mclog::TokenBucket and Dwm::Mclog::PacingPolicy unit tests
+//---------------------------------------------------------------------------
+
+#include <chrono>
+
+#include "DwmUnitAssert.hh"
+#include "DwmMclogTokenBucket.hh"
+
+using namespace std;
+using Dwm::Mclog::PacingPolicy, Dwm::Mclog::Severity,
+      Dwm::Mclog::TokenBucket;
+using std::chrono::microseconds, std::chrono::milliseconds;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestPolicy()
+{
+  PacingPolicy  policy;
+  UnitAssert(! policy.Enabled());
+  UnitAssert(! policy.Shed(Severity::debug));
+  policy.PacketRate(100);
+  UnitAssert(policy.Enabled());
+  UnitAssert(PacingPolicy::k_maxBurst == policy.Burst(1000000));
+  UnitAssert(PacingPolicy::k_minBurst == policy.Burst(0));
+
+  policy.ShedSeverity(Severity::info);
+  UnitAssert(policy.Shed(Severity::debug));
+  UnitAssert(policy.Shed(Severity::info));
+  UnitAssert(! policy.Shed(Severity::notice));
+  //  We never shed errors.
+  policy.ShedSeverity(Severity::emerg);
+  UnitAssert(policy.Shed(Severity::warning));
+  UnitAssert(! policy.Shed(Severity::err));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestUnlimited()
+{
+  TokenBucket  bucket;
+  UnitAssert(! bucket.Enabled());
+  bucket.Consume(1000, 1000000);
+  UnitAssert(bucket.Ready());
+  UnitAssert(microseconds(0) == bucket.Wait());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestPacketRate()
+{
+  PacingPolicy  policy;
+  policy.PacketRate(1000);
+  policy.Burst(10);
+  
+  TokenBucket         bucket;
+  TokenBucket::Clock::time_point  now = TokenBucket::Clock::now();
+  bucket.Configure(policy, 1400, now);
+  UnitAssert(bucket.Enabled());
+  UnitAssert(bucket.Ready(now));
+  bucket.Consume(9, 9 * 1400);
+  UnitAssert(bucket.Ready(now));
+  //  A batch may overdraw the bucket.
+  bucket.Consume(4, 4 * 1400);
+  UnitAssert(! bucket.Ready(now));
+  //  3 packets in debt at 1 per millisecond.
+  microseconds  wait = bucket.Wait(now);
+  UnitAssert((wait > milliseconds(3)) && (wait < milliseconds(4)));
+  UnitAssert(! bucket.Ready(now + milliseconds(3)));
+  UnitAssert(bucket.Ready(now + wait));
+
+  //  An idle bucket fills to the burst and no further.
+  now += std::chrono::seconds(10);
+  UnitAssert(bucket.Ready(now));
+  bucket.Consume(10, 0);
+  UnitAssert(! bucket.Ready(now));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestByteRate()
+{
+  PacingPolicy  policy;
+  policy.ByteRate(1000000);
+  policy.Burst(4);
+  
+  TokenBucket         bucket;
+  TokenBucket::Clock::time_point  now = TokenBucket::Clock::now();
+  bucket.Configure(policy, 1000, now);
+  //  No packet limit.
+  bucket.Consume(1000, 3000);
+  UnitAssert(bucket.Ready(now));
+  bucket.Consume(1, 2000);
+  UnitAssert(! bucket.Ready(now));
+  microseconds  wait = bucket.Wait(now);
+  UnitAssert((wait > milliseconds(1)) && (wait < microseconds(1100)));
+  UnitAssert(bucket.Ready(now + wait));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  using Dwm::Assertions;
+
+  TestPolicy();
+  TestUnlimited();
+  TestPacketRate();
+  TestByteRate();
+  
+  int  rc = 1;
+  if (Assertions::Total().Failed()) {
+    Assertions::Print(cerr, true);
+  }
+  else {
+    cout << Assertions::Total() << " passed" << endl;
+    rc = 0;
+  }
+  return rc;
+}